@@ -344,6 +344,57 @@ void GPS_Math_DouglasPeucker(QVector<pointDP>& line, qreal d) {
   }
 }
 
+void GPS_Math_DouglasPeuckerTolerance(const QPolygonF& line, QVector<qreal>& tolerance) {
+  const qint32 N = line.size();
+  tolerance.fill(0, N);
+  if (N == 0) {
+    return;
+  }
+
+  tolerance[0] = NOFLOAT;
+  tolerance[N - 1] = NOFLOAT;
+
+  struct entry_t {
+    segment seg;
+    qreal limit;  //< the tolerance of the point that split the parent segment
+  };
+
+  QStack<entry_t> stack;
+  stack << entry_t{segment(0, N - 1), NOFLOAT};
+
+  while (!stack.isEmpty()) {
+    const entry_t entry = stack.pop();
+    const qint32 idx1 = entry.seg.idx1;
+    const qint32 idx2 = entry.seg.idx2;
+    if ((idx2 - idx1) < 2) {
+      continue;
+    }
+
+    // distance to the segment, not the line through both points, to handle closed lines, too
+    const QPointF& a = line[idx1];
+    const QPointF dab = line[idx2] - a;
+    const qreal len = sqrlen(dab);
+
+    qint32 idx = idx1 + 1;
+    qreal dmax = -1;
+    for (qint32 i = idx1 + 1; i < idx2; i++) {
+      const QPointF daq = line[i] - a;
+      const qreal t = len > 0 ? qBound(0.0, (dab.x() * daq.x() + dab.y() * daq.y()) / len, 1.0) : 0.0;
+      const qreal d = sqrlen(daq - t * dab);
+      if (d > dmax) {
+        idx = i;
+        dmax = d;
+      }
+    }
+
+    // a point can't be kept longer than the point its segment depends on
+    tolerance[idx] = qMin(qSqrt(dmax), entry.limit);
+
+    stack << entry_t{segment(idx1, idx), tolerance[idx]};
+    stack << entry_t{segment(idx, idx2), tolerance[idx]};
+  }
+}
+
 bool GPS_Math_LineCrossesRect(const QPointF& p1, const QPointF& p2, const QRectF& rect) {
   // the trivial case
   if (rect.contains(p1) || rect.contains(p2)) {
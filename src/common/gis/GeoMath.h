@@ -54,6 +54,18 @@ qreal GPS_Math_Distance(const qreal u1, const qreal v1, const qreal u2, const qr
 /// use for short distances, much quicker processing
 qreal GPS_Math_DistanceQuick(const qreal u1, const qreal v1, const qreal u2, const qreal v2);
 void GPS_Math_DouglasPeucker(QVector<pointDP>& line, qreal d);
+/**
+   @brief Rank all points of a line by the Douglas-Peucker algorithm
+
+   A point is kept by a Douglas-Peucker simplification with distance d as long as
+   its tolerance is larger than d. The first and the last point get NOFLOAT. This
+   allows to derive simplified lines for any distance without running the algorithm
+   again.
+
+   @param line       the line in a metric, cartesian coordinate system
+   @param tolerance  the tolerance for each point of the line
+ */
+void GPS_Math_DouglasPeuckerTolerance(const QPolygonF& line, QVector<qreal>& tolerance);
 QPointF GPS_Math_Wpt_Projection(const QPointF& pt1, qreal distance, qreal bearing);
 bool GPS_Math_LineCrossesRect(const QPointF& p1, const QPointF& p2, const QRectF& rect);
 qreal GPS_Math_DistPointPolyline(const QPolygonF& points, const QPointF& q);
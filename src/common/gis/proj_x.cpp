@@ -20,6 +20,10 @@
 
 #include <QDebug>
 #include <QPolygonF>
+#include <cmath>
+
+// the sphere used by EPSG:3857
+#define WEB_MERCATOR_RADIUS 6378137.0
 
 CProj::CProj(const QString& crsSrc, const QString& crsTar) { init(crsSrc.toLatin1(), crsTar.toLatin1()); }
 
@@ -72,6 +76,14 @@ void CProj::init(const char* crsSrc, const char* crsTar) {
   _isSrcLatLong = _isLatLong(_strProjSrc);
   _isTarLatLong = _isLatLong(_strProjTar);
 
+  // the default projection of the canvas and all tile servers does not need libproj
+  _fastPath = eFastPathNone;
+  if ((_strProjSrc.trimmed() == "EPSG:3857") && (_strProjTar.trimmed() == "EPSG:4326")) {
+    _fastPath = eFastPathMercToLonLat;
+  } else if ((_strProjSrc.trimmed() == "EPSG:4326") && (_strProjTar.trimmed() == "EPSG:3857")) {
+    _fastPath = eFastPathLonLatToMerc;
+  }
+
   if (nullptr == _pj) {
     qWarning() << "Failed to create projection:" << _strProjSrc << "->" << _strProjTar;
     return;
@@ -88,18 +100,33 @@ bool CProj::_isLatLong(const QString& crs) const {
   return PJ_TYPE_GEOGRAPHIC_2D_CRS == type;
 }
 
-void CProj::transform(QPolygonF& line, PJ_DIRECTION dir) const {
-  if (!isValid()) {
+void CProj::transform(QPolygonF& line, PJ_DIRECTION dir) const { transform(line.data(), line.size(), dir); }
+
+void CProj::transform(QPointF* pts, qint32 n, PJ_DIRECTION dir) const {
+  if (!isValid() || (n <= 0)) {
+    return;
+  }
+
+  if (_fastPath != eFastPathNone) {
+    _transformWebMercator(pts, n, dir);
     return;
   }
 
-  qreal factorPre = proj_degree_input(_pj, dir) ? RAD_TO_DEG : 1.0;
-  qreal factorPost = proj_degree_output(_pj, dir) ? DEG_TO_RAD : 1.0;
+  static_assert(sizeof(QPointF) == 2 * sizeof(double), "QPointF must be made of two doubles to pass it to libproj");
 
-  for (QPointF& pt : line) {
-    pt *= factorPre;
-    _transform(pt.rx(), pt.ry(), dir);
-    pt *= factorPost;
+  if (proj_degree_input(_pj, dir)) {
+    for (qint32 i = 0; i < n; i++) {
+      pts[i] *= RAD_TO_DEG;
+    }
+  }
+
+  proj_trans_generic(_pj, dir, &pts->rx(), sizeof(QPointF), n, &pts->ry(), sizeof(QPointF), n, nullptr, 0, 0,
+                     nullptr, 0, 0);
+
+  if (proj_degree_output(_pj, dir)) {
+    for (qint32 i = 0; i < n; i++) {
+      pts[i] *= DEG_TO_RAD;
+    }
   }
 }
 
@@ -108,6 +135,11 @@ void CProj::transform(QPointF& pt, PJ_DIRECTION dir) const {
     return;
   }
 
+  if (_fastPath != eFastPathNone) {
+    _transformWebMercator(&pt, 1, dir);
+    return;
+  }
+
   if (proj_degree_input(_pj, dir)) {
     pt *= RAD_TO_DEG;
   }
@@ -124,6 +156,14 @@ void CProj::transform(qreal& lon, qreal& lat, PJ_DIRECTION dir) const {
     return;
   }
 
+  if (_fastPath != eFastPathNone) {
+    QPointF pt(lon, lat);
+    _transformWebMercator(&pt, 1, dir);
+    lon = pt.x();
+    lat = pt.y();
+    return;
+  }
+
   if (proj_degree_input(_pj, dir)) {
     lon *= RAD_TO_DEG;
     lat *= RAD_TO_DEG;
@@ -144,6 +184,36 @@ void CProj::_transform(qreal& lon, qreal& lat, PJ_DIRECTION dir) const {
   lat = c.uv.v;
 }
 
+void CProj::_transformWebMercator(QPointF* pts, qint32 n, PJ_DIRECTION dir) const {
+  const bool toLonLat = (_fastPath == eFastPathMercToLonLat) == (dir == PJ_FWD);
+
+  /*
+      Like libproj the longitude is wrapped into the range of -180..180°. The
+      draw context relies on that when fixing coordinates across the date line.
+      Keep the loops free of function calls other than math to let the compiler
+      vectorize them.
+   */
+  if (toLonLat) {
+    for (qint32 i = 0; i < n; i++) {
+      qreal lon = pts[i].x() / WEB_MERCATOR_RADIUS;
+      if (std::fabs(lon) > M_PI) {
+        lon -= 2 * M_PI * std::floor((lon + M_PI) / (2 * M_PI));
+      }
+      pts[i].rx() = lon;
+      pts[i].ry() = std::atan(std::sinh(pts[i].y() / WEB_MERCATOR_RADIUS));
+    }
+  } else {
+    for (qint32 i = 0; i < n; i++) {
+      qreal lon = pts[i].x();
+      if (std::fabs(lon) > M_PI) {
+        lon -= 2 * M_PI * std::floor((lon + M_PI) / (2 * M_PI));
+      }
+      pts[i].rx() = lon * WEB_MERCATOR_RADIUS;
+      pts[i].ry() = std::asinh(std::tan(pts[i].y())) * WEB_MERCATOR_RADIUS;
+    }
+  }
+}
+
 bool CProj::validProjStr(const QString projStr, bool allowLonLatToo, fErrMessage errMessage) {
   bool res = false;
 
@@ -39,9 +39,25 @@ class CProj {
   void transform(qreal& lon, qreal& lat, PJ_DIRECTION dir) const;
   void transform(QPointF& pt, PJ_DIRECTION dir) const;
   void transform(QPolygonF& line, PJ_DIRECTION dir) const;
+
+  /**
+     @brief Transform a contiguous buffer of points in one go
+
+     Lon/lat coordinates are expected and returned in [rad] like for all other
+     transform() methods. The points are either passed to libproj as a single batch
+     or, for Web Mercator <-> WGS84, transformed without libproj at all.
+
+     @param pts   pointer to the first point
+     @param n     number of points
+     @param dir   the direction of the transformation
+   */
+  void transform(QPointF* pts, qint32 n, PJ_DIRECTION dir) const;
+
   bool isValid() const { return nullptr != _pj; }
   bool isSrcLatLong() const { return _isSrcLatLong; }
   bool isTarLatLong() const { return _isTarLatLong; }
+  /// true if the analytic EPSG:3857 <-> EPSG:4326 transformation is used instead of libproj
+  bool hasFastPath() const { return _fastPath != eFastPathNone; }
 
   QString getProjTar() const { return isValid() ? _strProjTar : ""; }
   QString getProjSrc() const { return isValid() ? _strProjSrc : ""; }
@@ -51,13 +67,17 @@ class CProj {
   static bool validProjStr(const QString projStr, bool allowLonLatToo, fErrMessage errMessage);
 
  private:
+  enum fast_path_e { eFastPathNone, eFastPathMercToLonLat, eFastPathLonLatToMerc };
+
   void _transform(qreal& lon, qreal& lat, PJ_DIRECTION dir) const;
+  void _transformWebMercator(QPointF* pts, qint32 n, PJ_DIRECTION dir) const;
   bool _isLatLong(const QString& crs) const;
 
   PJ_CONTEXT* _ctx = nullptr;
   PJ* _pj = nullptr;
   bool _isSrcLatLong = false;
   bool _isTarLatLong = false;
+  fast_path_e _fastPath = eFastPathNone;
 
   QString _strProjSrc;
   QString _strProjTar;
@@ -1174,11 +1174,7 @@ void CMainWindow::slotLoadGISData() {
   cfg.setValue("Paths/lastGisFilter", filter);
 }
 
-void CMainWindow::loadGISData(const QStringList& filenames) {
-  for (const QString& filename : filenames) {
-    widgetGisWorkspace->loadGisProject(filename);
-  }
-}
+void CMainWindow::loadGISData(const QStringList& filenames) { widgetGisWorkspace->loadGisProjects(filenames); }
 
 void CMainWindow::slotStoreView() {
   CCanvas* canvas = getVisibleCanvas();
@@ -253,54 +253,45 @@ void IDrawContext::convertRad2Px(QPolygonF& poly) const {
   convertRad2M(f);
 
   const int N = poly.size();
+  QPointF* pts = poly.data();
 
-  struct p_t {
-    qreal fixWest;
-    qreal fixEast;
+  struct fix_t {
+    qint32 idx;
+    qreal lon;
+    qreal lat;
   };
 
-  QVector<p_t> fixes(N, {NOFLOAT, NOFLOAT});
-
-  qreal* pY = &poly.data()->ry();
-  p_t* pFix = fixes.data();
-
   /*
       Proj4 makes a wrap around for values outside the
       range of -180..180°. But the draw context has no
       turnaround. It exceeds the values. We have to
-      apply fixes in that case.
+      apply fixes in that case. Most lines do not cross
+      the boundary. Thus only the affected points are
+      remembered.
    */
-  for (int i = 0; i < N; ++i, ++pFix, pY += 2) {
-    if (*pY < (-180 * DEG_TO_RAD)) {
-      pFix->fixWest = *pY;
-    }
-    if (*pY > (180 * DEG_TO_RAD)) {
-      pFix->fixEast = *pY;
+  QVector<fix_t> fixes;
+  for (int i = 0; i < N; ++i) {
+    if (qAbs(pts[i].x()) > (180 * DEG_TO_RAD)) {
+      fixes << fix_t{i, pts[i].x(), pts[i].y()};
     }
   }
 
-  proj.transform(poly, PJ_INV);
-
-  QPointF* pPt = poly.data();
-  pFix = fixes.data();
-  for (int i = 0; i < N; ++i, ++pFix, ++pPt) {
-    /*
-        The idea of the fix is to calculate a point
-        at the boundary with the same latitude and use it
-        as offset.
-     */
-    if (pFix->fixWest != NOFLOAT) {
-      QPointF o(-180 * DEG_TO_RAD, pFix->fixWest);
-      convertRad2M(o);
-      pPt->rx() = 2 * o.x() + pPt->x();
-    }
-    if (pFix->fixEast != NOFLOAT) {
-      QPointF o(180 * DEG_TO_RAD, pFix->fixEast);
-      convertRad2M(o);
-      pPt->rx() = 2 * o.x() + pPt->x();
-    }
+  // transform all points as one batch
+  proj.transform(pts, N, PJ_INV);
+
+  /*
+      The idea of the fix is to calculate a point
+      at the boundary with the same latitude and use it
+      as offset.
+   */
+  for (const fix_t& fix : qAsConst(fixes)) {
+    QPointF o(fix.lon < 0 ? -180 * DEG_TO_RAD : 180 * DEG_TO_RAD, fix.lat);
+    convertRad2M(o);
+    pts[fix.idx].rx() = 2 * o.x() + pts[fix.idx].x();
+  }
 
-    *pPt = (*pPt - f) / (scale * zoomFactor) + center;
+  for (int i = 0; i < N; ++i) {
+    pts[i] = (pts[i] - f) / (scale * zoomFactor) + center;
   }
 
   mutex.unlock();  // --------- stop serialize with thread
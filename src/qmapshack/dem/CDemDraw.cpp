@@ -277,8 +277,26 @@ qreal CDemDraw::getSlopeAt(const QPointF& pos, bool checkScale) {
 
 void CDemDraw::getElevationAt(const QPolygonF& pos, QPolygonF& ele) {
   for (int i = 0; i < pos.size(); i++) {
-    qreal tmp = getElevationAt(pos[i]);
-    ele[i].ry() = (tmp == NOFLOAT) ? NOFLOAT : tmp;
+    ele[i].ry() = NOFLOAT;
+  }
+
+  if (CDemItem::mutexActiveDems.tryLock()) {
+    if (demList) {
+      for (int i = 0; i < demList->count(); i++) {
+        CDemItem* item = demList->item(i);
+
+        if (!item || item->demfile.isNull()) {
+          // as all active maps have to be at the top of the list
+          // it is ok to break as soon as the first map with no
+          // active files is hit.
+          break;
+        }
+
+        // each DEM file fills the gaps left by the ones before
+        item->demfile->getElevationAt(pos, ele, false);
+      }
+    }
+    CDemItem::mutexActiveDems.unlock();
   }
 }
 
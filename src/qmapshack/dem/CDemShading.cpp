@@ -0,0 +1,290 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "dem/CDemShading.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "gis/proj_x.h"
+
+/*
+    Build an AVX2 and a baseline version of the row kernel and let the
+    dynamic loader pick the one matching the CPU. Other compilers and
+    platforms get the baseline version only.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define SHADING_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define SHADING_TARGETS
+#endif
+
+// hillshading: z factor, altitude and azimuth of the light source
+#define ZFACT 0.125
+#define ALT (45 * DEG_TO_RAD)
+#define AZ (315 * DEG_TO_RAD)
+
+/// all parameters prepared for the kernel
+struct CDemShading::kernel_t {
+  bool doHillshading;
+  bool doSlope;
+  bool doElevation;
+
+  bool checkNoData;  //< true if hasNoData is set and noData can be matched by a float
+  bool skipNoData;   //< true if noData can be matched by a float
+  float noData;
+
+  float hsScaleX;  //< 1 / (xscale * factorHillshading)
+  float hsScaleY;  //< 1 / (yscale * factorHillshading)
+  float hsSinAlt;
+  float hsCosAz;  //< z factor * cos(alt) * cos(az)
+  float hsSinAz;  //< z factor * cos(alt) * sin(az)
+  float hsZZ;     //< z factor * z factor
+
+  float slScaleX;    //< 1 / xscale
+  float slScaleY;    //< 1 / yscale
+  float slAlpha;     //< [rad] -> alpha value
+  float slSteps[5];  //< the slope color steps as limits of dx² + dy²
+
+  float eleFactor;
+  float eleLimit;
+  float eleLow;
+  float eleHi;
+  float eleScale;  //< 253 / (eleHi - eleLow)
+};
+
+/// scratch buffers and output lines of a row
+struct CDemShading::row_t {
+  float* gx;         //< w gradients in x
+  float* gy;         //< w gradients in y
+  float* colMax;     //< w + 2 maximum elevations of the three rows
+  uchar* colNoData;  //< w + 2 flags for no data in any of the three rows
+
+  uchar* hillshading;
+  uchar* slopeShading;
+  uchar* slopeColor;
+  uchar* elevationLimit;
+  uchar* elevationShading;
+};
+
+/**
+   @brief Arc tangent for t >= 0 without branches
+
+   Polynomial approximation after Abramowitz and Stegun 4.4.49 with an error
+   below 1.2e-5 rad. Values larger than 1 are mapped by atan(t) = pi/2 - atan(1/t).
+ */
+static inline float atanPositive(float t) {
+  const bool inv = t > 1.0f;
+  const float z = inv ? 1.0f / t : t;
+  const float z2 = z * z;
+  const float p = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+  return inv ? float(M_PI_2) - p : p;
+}
+
+void CDemShading::shade(const QVector<float>& data, qint32 w, qint32 h, const params_t& params, output_t& output) {
+  kernel_t k;
+  k.doHillshading = output.hillshading != nullptr;
+  k.doSlope = (output.slopeShading != nullptr) || (output.slopeColor != nullptr);
+  k.doElevation = (output.elevationLimit != nullptr) || (output.elevationShading != nullptr);
+
+  if (!k.doHillshading && !k.doSlope && !k.doElevation) {
+    return;
+  }
+
+  // the data is float, a no data value not representable by a float never matches
+  k.noData = params.noData;
+  k.skipNoData = double(k.noData) == params.noData;
+  k.checkNoData = params.hasNoData && k.skipNoData;
+
+  /*
+      The light's direction is applied without trigonometric functions:
+
+      sqrt(dx² + dy²) * sin(atan2(dy, dx) - az) = dy * cos(az) - dx * sin(az)
+   */
+  k.hsScaleX = 1.0 / (params.xscale * params.factorHillshading);
+  k.hsScaleY = 1.0 / (params.yscale * params.factorHillshading);
+  k.hsSinAlt = qSin(ALT);
+  k.hsCosAz = ZFACT * qCos(ALT) * qCos(AZ);
+  k.hsSinAz = ZFACT * qCos(ALT) * qSin(AZ);
+  k.hsZZ = ZFACT * ZFACT;
+
+  /*
+      slope = atan(sqrt(dx² + dy²) / 8)
+
+      As the function is monotonic, the slope color steps can be compared with
+      dx² + dy² directly.
+   */
+  k.slScaleX = 1.0 / params.xscale;
+  k.slScaleY = 1.0 / params.yscale;
+  k.slAlpha = 180.0 / M_PI * 255.0 / 90.0 * params.factorSlopeShading;
+  for (int i = 0; i < 5; i++) {
+    const qreal step = params.slopeSteps[i];
+    if (step < 0) {
+      k.slSteps[i] = -1;
+    } else if (step >= 90) {
+      k.slSteps[i] = std::numeric_limits<float>::infinity();
+    } else {
+      const qreal t = 8 * qTan(step * DEG_TO_RAD);
+      k.slSteps[i] = t * t;
+    }
+  }
+
+  k.eleFactor = params.elevationFactor;
+  k.eleLimit = params.elevationLimit;
+  k.eleLow = qMin(params.elevationShadeLow, params.elevationShadeHi);
+  k.eleHi = qMax(params.elevationShadeLow, params.elevationShadeHi);
+  k.eleScale = (k.eleHi > k.eleLow) ? 253.0f / (k.eleHi - k.eleLow) : 0.0f;
+
+  const qint32 wp2 = w + 2;
+  QVector<float> gx(w);
+  QVector<float> gy(w);
+  QVector<float> colMax(wp2);
+  QVector<uchar> colNoData(wp2);
+
+  row_t row;
+  row.gx = gx.data();
+  row.gy = gy.data();
+  row.colMax = colMax.data();
+  row.colNoData = colNoData.data();
+
+  const float* src = data.constData();
+  for (qint32 m = 0; m < h; m++) {
+    row.hillshading = output.hillshading ? output.hillshading->scanLine(m) : nullptr;
+    row.slopeShading = output.slopeShading ? output.slopeShading->scanLine(m) : nullptr;
+    row.slopeColor = output.slopeColor ? output.slopeColor->scanLine(m) : nullptr;
+    row.elevationLimit = output.elevationLimit ? output.elevationLimit->scanLine(m) : nullptr;
+    row.elevationShading = output.elevationShading ? output.elevationShading->scanLine(m) : nullptr;
+
+    const float* r0 = src + m * wp2;
+    shadeRow(r0, r0 + wp2, r0 + 2 * wp2, w, k, row);
+  }
+}
+
+SHADING_TARGETS
+void CDemShading::shadeRow(const float* r0, const float* r1, const float* r2, qint32 w, const kernel_t& k,
+                           row_t& row) {
+  const qint32 wp2 = w + 2;
+  float* gx = row.gx;
+  float* gy = row.gy;
+
+  if (k.doHillshading || k.doSlope) {
+    // the Sobel operator of the 3x3 window around each pixel
+    for (qint32 n = 0; n < w; n++) {
+      gx[n] = (r0[n] + r1[n] + r1[n] + r2[n]) - (r0[n + 2] + r1[n + 2] + r1[n + 2] + r2[n + 2]);
+      gy[n] = (r2[n] + r2[n + 1] + r2[n + 1] + r2[n + 2]) - (r0[n] + r0[n + 1] + r0[n + 1] + r0[n + 2]);
+    }
+  }
+
+  if (row.hillshading) {
+    uchar* out = row.hillshading;
+    for (qint32 n = 0; n < w; n++) {
+      const float dx = gx[n] * k.hsScaleX;
+      const float dy = gy[n] * k.hsScaleY;
+      const float cang =
+          (k.hsSinAlt - (dy * k.hsCosAz - dx * k.hsSinAz)) / std::sqrt(1.0f + k.hsZZ * (dx * dx + dy * dy));
+      const qint32 val = 1.0f + 254.0f * qMax(cang, 0.0f);
+      const bool isNoData = k.checkNoData & (r1[n + 1] == k.noData);
+      out[n] = isNoData ? 255 : val;
+    }
+  }
+
+  if (k.doSlope) {
+    uchar* noData = row.colNoData;
+    if (k.checkNoData) {
+      for (qint32 n = 0; n < wp2; n++) {
+        noData[n] = (r0[n] == k.noData) | (r1[n] == k.noData) | (r2[n] == k.noData);
+      }
+    } else {
+      std::fill(noData, noData + wp2, 0);
+    }
+
+    // keep dx² + dy² in gx
+    for (qint32 n = 0; n < w; n++) {
+      const float dx = gx[n] * k.slScaleX;
+      const float dy = gy[n] * k.slScaleY;
+      gx[n] = dx * dx + dy * dy;
+    }
+
+    if (row.slopeShading) {
+      uchar* out = row.slopeShading;
+      for (qint32 n = 0; n < w; n++) {
+        const qint32 alpha = qMin(255.0f, atanPositive(std::sqrt(gx[n]) * 0.125f) * k.slAlpha);
+        const bool isNoData = noData[n] | noData[n + 1] | noData[n + 2];
+        out[n] = isNoData ? 0 : alpha;
+      }
+    }
+
+    if (row.slopeColor) {
+      uchar* out = row.slopeColor;
+      for (qint32 n = 0; n < w; n++) {
+        // the highest step wins, even for unsorted custom steps
+        const float kk = gx[n];
+        qint32 c = kk > k.slSteps[0] ? 1 : 0;
+        c = kk > k.slSteps[1] ? 2 : c;
+        c = kk > k.slSteps[2] ? 3 : c;
+        c = kk > k.slSteps[3] ? 4 : c;
+        c = kk > k.slSteps[4] ? 5 : c;
+        // no data results in an infinite slope
+        const bool isNoData = noData[n] | noData[n + 1] | noData[n + 2];
+        out[n] = isNoData ? 5 : c;
+      }
+    }
+  }
+
+  if (k.doElevation) {
+    // the maximum (_not_ mean) of the window, ignoring no data
+    float* colMax = row.colMax;
+    for (qint32 n = 0; n < wp2; n++) {
+      float meters = -2.0f;
+      const bool skip0 = k.skipNoData && (r0[n] == k.noData);
+      const bool skip1 = k.skipNoData && (r1[n] == k.noData);
+      const bool skip2 = k.skipNoData && (r2[n] == k.noData);
+      meters = (!skip0 && (r0[n] > meters)) ? r0[n] : meters;
+      meters = (!skip1 && (r1[n] > meters)) ? r1[n] : meters;
+      meters = (!skip2 && (r2[n] > meters)) ? r2[n] : meters;
+      colMax[n] = meters;
+    }
+
+    for (qint32 n = 0; n < w; n++) {
+      float meters = colMax[n];
+      meters = colMax[n + 1] > meters ? colMax[n + 1] : meters;
+      meters = colMax[n + 2] > meters ? colMax[n + 2] : meters;
+      // keep the elevation in the user's unit in gy
+      gy[n] = meters * k.eleFactor;
+    }
+
+    if (row.elevationLimit) {
+      uchar* out = row.elevationLimit;
+      for (qint32 n = 0; n < w; n++) {
+        out[n] = gy[n] >= k.eleLimit ? 1 : 0;
+      }
+    }
+
+    if (row.elevationShading) {
+      uchar* out = row.elevationShading;
+      for (qint32 n = 0; n < w; n++) {
+        const float ele = gy[n];
+        const float val = qBound(0.0f, ele - k.eleLow, k.eleHi - k.eleLow) * k.eleScale;
+        const qint32 c = 1.0f + val;
+        out[n] = ele < k.eleLow ? 0 : (ele < k.eleHi ? c : 255);
+      }
+    }
+  }
+}
@@ -0,0 +1,99 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDEMSHADING_H
+#define CDEMSHADING_H
+
+#include <QImage>
+#include <QVector>
+#include <QtNumeric>
+
+/**
+   @brief Calculate all shading modes of a DEM tile in a single pass
+
+   The DEM data is a buffer of (w + 2) x (h + 2) values as the 3x3 window used by all
+   modes needs a border of one pixel. Instead of copying a window per pixel the kernels
+   work on three neighbouring rows at once and compute the gradients for a complete row.
+   The loops are free of branches and trigonometric functions. Thus the compiler is able
+   to vectorize them. On x86-64 Linux builds with GCC an AVX2 and a baseline (SSE2)
+   version are built and the matching one is selected at runtime.
+ */
+class CDemShading {
+ public:
+  struct params_t {
+    qreal xscale = 1.0;              //< [px/m]
+    qreal yscale = 1.0;              //< [px/m]
+    qreal factorHillshading = 1.0;   //< see IDem::slotSetFactorHillshade()
+    qreal factorSlopeShading = 1.0;  //< see IDem::slotSetFactorSlopeShade()
+    bool hasNoData = false;
+    double noData = 0;
+    qreal slopeSteps[5] = {0, 0, 0, 0, 0};  //< slope color steps [°]
+    qreal elevationLimit = 0;               //< in the user's elevation unit
+    qreal elevationShadeLow = 0;            //< in the user's elevation unit
+    qreal elevationShadeHi = 0;             //< in the user's elevation unit
+    qreal elevationFactor = 1.0;            //< conversion from meter to the user's elevation unit
+
+    bool operator==(const params_t& other) const {
+      for (int i = 0; i < 5; i++) {
+        if (slopeSteps[i] != other.slopeSteps[i]) {
+          return false;
+        }
+      }
+      return (xscale == other.xscale) && (yscale == other.yscale) && (factorHillshading == other.factorHillshading) &&
+             (factorSlopeShading == other.factorSlopeShading) && (hasNoData == other.hasNoData) &&
+             ((noData == other.noData) || (qIsNaN(noData) && qIsNaN(other.noData))) &&
+             (elevationLimit == other.elevationLimit) &&
+             (elevationShadeLow == other.elevationShadeLow) && (elevationShadeHi == other.elevationShadeHi) &&
+             (elevationFactor == other.elevationFactor);
+    }
+    bool operator!=(const params_t& other) const { return !(*this == other); }
+  };
+
+  /**
+     @brief The target images, one for each shading mode
+
+     Set the images of the enabled modes only. All images have to be w x h pixel with
+     8 bit per pixel (QImage::Format_Indexed8 or QImage::Format_Alpha8).
+   */
+  struct output_t {
+    QImage* hillshading = nullptr;
+    QImage* slopeShading = nullptr;
+    QImage* slopeColor = nullptr;
+    QImage* elevationLimit = nullptr;
+    QImage* elevationShading = nullptr;
+  };
+
+  /**
+     @brief Calculate all enabled shading modes
+
+     @param data    the DEM data of (w + 2) x (h + 2) values
+     @param w       the width of the output
+     @param h       the height of the output
+     @param params  the shading parameters
+     @param output  the images to write to
+   */
+  static void shade(const QVector<float>& data, qint32 w, qint32 h, const params_t& params, output_t& output);
+
+ private:
+  struct kernel_t;
+  struct row_t;
+
+  static void shadeRow(const float* r0, const float* r1, const float* r2, qint32 w, const kernel_t& k, row_t& row);
+};
+
+#endif  // CDEMSHADING_H
@@ -22,12 +22,43 @@
 #include <gdal_priv.h>
 
 #include <QtWidgets>
+#include <algorithm>
 
 #include "CMainWindow.h"
 #include "dem/CDemDraw.h"
 #include "helpers/CDraw.h"
 #include "units/IUnit.h"
 
+// maximum memory used by the cache of raw data blocks [KB]
+#define BLOCK_CACHE_SIZE (64 * 1024)
+// maximum memory used by the cache of shaded tiles [KB]
+#define TILE_CACHE_SIZE (64 * 1024)
+
+constexpr qint32 CDemVRT::kBlockSize;
+
+static inline quint64 blockKey(qint32 bx, qint32 by) { return (quint64(quint32(bx)) << 32) | quint32(by); }
+
+/**
+   @brief Copy a window of n x n values from a block
+
+   @return False if the window is not completely covered by the block.
+ */
+static bool getWindow(const QVector<float>& data, qint32 bx0, qint32 by0, qint32 bw, qint32 bh, qint32 x, qint32 y,
+                      qint32 n, float* win) {
+  if ((x < bx0) || (y < by0) || ((x + n) > (bx0 + bw)) || ((y + n) > (by0 + bh))) {
+    return false;
+  }
+
+  const float* src = data.constData() + (y - by0) * bw + (x - bx0);
+  for (qint32 r = 0; r < n; r++) {
+    for (qint32 c = 0; c < n; c++) {
+      win[r * n + c] = src[c];
+    }
+    src += bw;
+  }
+  return true;
+}
+
 CDemVRT::CDemVRT(const QString& filename, CDemDraw* parent) : IDem(parent), filename(filename) {
   qDebug() << "------------------------------";
   qDebug() << "VRT: try to open" << filename;
@@ -108,6 +139,9 @@ CDemVRT::CDemVRT(const QString& filename, CDemDraw* parent) : IDem(parent), file
   qDebug() << "FF" << trFwd;
   qDebug() << "RR" << trInv;
 
+  cacheBlocks.setMaxCost(BLOCK_CACHE_SIZE);
+  cacheTiles.setMaxCost(TILE_CACHE_SIZE);
+
   connect(dem, &CDemDraw::sigNeedsRedraw, this, &CDemVRT::slotNeedsRedraw);
 
   isActivated = true;
@@ -117,29 +151,45 @@ CDemVRT::~CDemVRT() { GDALClose(dataset); }
 
 void CDemVRT::slotNeedsRedraw() { threadPool.clear(); }
 
-qreal CDemVRT::getElevationAt(const QPointF& pos, bool checkScale) {
-  if (!proj.isValid() || (checkScale && outOfScale)) {
-    return NOFLOAT;
+bool CDemVRT::getBlock(qint32 bx, qint32 by, block_t& block) {
+  const quint64 key = blockKey(bx, by);
+  {
+    QMutexLocker lock(&mutexCacheBlocks);
+    const block_t* cached = cacheBlocks.object(key);
+    if (cached != nullptr) {
+      block = *cached;
+      return !block.data.isEmpty();
+    }
   }
 
-  float e[4];
-  QPointF pt = pos;
+  block.x = qMax(0, bx * kBlockSize - 1);
+  block.y = qMax(0, by * kBlockSize - 1);
+  block.w = qMin(xsize_px, (bx + 1) * kBlockSize + 2) - block.x;
+  block.h = qMin(ysize_px, (by + 1) * kBlockSize + 2) - block.y;
+  block.data.clear();
 
-  proj.transform(pt, PJ_INV);
+  if ((block.w > 0) && (block.h > 0)) {
+    block.data.resize(block.w * block.h);
 
-  if (!boundingBox.contains(pt)) {
-    return NOFLOAT;
+    QMutexLocker lock(&mutex);
+    CPLErr err = dataset->RasterIO(GF_Read, block.x, block.y, block.w, block.h, block.data.data(), block.w, block.h,
+                                   GDT_Float32, 1, 0, 0, 0, 0);
+    if (err != CE_None) {
+      // do not cache a failed read, e.g. a network error of a WCS server, to read it again next time
+      block.data.clear();
+      return false;
+    }
   }
 
-  pt = trInv.map(pt);
-
-  qreal x = pt.x() - qFloor(pt.x());
-  qreal y = pt.y() - qFloor(pt.y());
+  // blocks outside the dataset are cached, too, to not try them again and again
+  QMutexLocker lock(&mutexCacheBlocks);
+  cacheBlocks.insert(key, new block_t(block), qMax(1, int(block.data.size() * sizeof(float) / 1024)));
+  return !block.data.isEmpty();
+}
 
-  mutex.lock();
-  CPLErr err = dataset->RasterIO(GF_Read, qFloor(pt.x()), qFloor(pt.y()), 2, 2, &e, 2, 2, GDT_Float32, 1, 0, 0, 0, 0);
-  mutex.unlock();
-  if (err == CE_Failure) {
+qreal CDemVRT::getElevationFromBlock(const block_t& block, const QPointF& px) const {
+  float e[4];
+  if (!getWindow(block.data, block.x, block.y, block.w, block.h, qFloor(px.x()), qFloor(px.y()), 2, e)) {
     return NOFLOAT;
   }
 
@@ -147,6 +197,9 @@ qreal CDemVRT::getElevationAt(const QPointF& pos, bool checkScale) {
     return NOFLOAT;
   }
 
+  qreal x = px.x() - qFloor(px.x());
+  qreal y = px.y() - qFloor(px.y());
+
   qreal b1 = e[0];
   qreal b2 = e[1] - e[0];
   qreal b3 = e[2] - e[0];
@@ -157,6 +210,95 @@ qreal CDemVRT::getElevationAt(const QPointF& pos, bool checkScale) {
   return ele;
 }
 
+qreal CDemVRT::getElevationAt(const QPointF& pos, bool checkScale) {
+  if (!proj.isValid() || (checkScale && outOfScale)) {
+    return NOFLOAT;
+  }
+
+  QPointF pt = pos;
+
+  proj.transform(pt, PJ_INV);
+
+  if (!boundingBox.contains(pt)) {
+    return NOFLOAT;
+  }
+
+  pt = trInv.map(pt);
+  if ((pt.x() < 0) || (pt.y() < 0)) {
+    return NOFLOAT;
+  }
+
+  block_t block;
+  if (!getBlock(qFloor(pt.x()) / kBlockSize, qFloor(pt.y()) / kBlockSize, block)) {
+    return NOFLOAT;
+  }
+
+  return getElevationFromBlock(block, pt);
+}
+
+void CDemVRT::getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale) {
+  if (!proj.isValid() || (checkScale && outOfScale)) {
+    return;
+  }
+
+  // collect all points still without elevation
+  QVector<qint32> idx;
+  QPolygonF pts;
+  for (qint32 i = 0; i < pos.size(); i++) {
+    if (ele[i].y() == NOFLOAT) {
+      idx << i;
+      pts << pos[i];
+    }
+  }
+
+  if (pts.isEmpty()) {
+    return;
+  }
+
+  proj.transform(pts, PJ_INV);
+
+  struct query_t {
+    quint64 key;
+    qint32 bx;
+    qint32 by;
+    qint32 idx;
+    QPointF px;
+  };
+
+  QVector<query_t> queries;
+  queries.reserve(pts.size());
+  for (qint32 i = 0; i < pts.size(); i++) {
+    if (!boundingBox.contains(pts[i])) {
+      continue;
+    }
+
+    const QPointF& px = trInv.map(pts[i]);
+    if ((px.x() < 0) || (px.y() < 0)) {
+      continue;
+    }
+
+    const qint32 bx = qFloor(px.x()) / kBlockSize;
+    const qint32 by = qFloor(px.y()) / kBlockSize;
+    queries << query_t{blockKey(bx, by), bx, by, idx[i], px};
+  }
+
+  // process the points block by block to fetch each block just once
+  std::sort(queries.begin(), queries.end(), [](const query_t& q1, const query_t& q2) { return q1.key < q2.key; });
+
+  block_t block;
+  bool isValid = false;
+  for (qint32 i = 0; i < queries.size(); i++) {
+    const query_t& query = queries[i];
+    if ((i == 0) || (query.key != queries[i - 1].key)) {
+      isValid = getBlock(query.bx, query.by, block);
+    }
+
+    if (isValid) {
+      ele[query.idx].ry() = getElevationFromBlock(block, query.px);
+    }
+  }
+}
+
 qreal CDemVRT::getSlopeAt(const QPointF& pos, bool checkScale) {
   if (!proj.isValid() || (checkScale && outOfScale)) {
     return NOFLOAT;
@@ -171,19 +313,21 @@ qreal CDemVRT::getSlopeAt(const QPointF& pos, bool checkScale) {
   }
 
   pt = trInv.map(pt);
+  if ((pt.x() < 0) || (pt.y() < 0)) {
+    return NOFLOAT;
+  }
 
   qreal x = pt.x() - qFloor(pt.x());
   qreal y = pt.y() - qFloor(pt.y());
 
-  float win[eWinsize4x4];
-  {
-    QMutexLocker lock(&mutex);
+  block_t block;
+  if (!getBlock(qFloor(pt.x()) / kBlockSize, qFloor(pt.y()) / kBlockSize, block)) {
+    return NOFLOAT;
+  }
 
-    CPLErr err = dataset->RasterIO(GF_Read, qFloor(pt.x()) - 1, qFloor(pt.y()) - 1, 4, 4, &win, 4, 4, GDT_Float32, 1, 0,
-                                   0, 0, 0);
-    if (err != CE_None) {
-      return NOFLOAT;
-    }
+  float win[eWinsize4x4];
+  if (!getWindow(block.data, block.x, block.y, block.w, block.h, qFloor(pt.x()) - 1, qFloor(pt.y()) - 1, 4, win)) {
+    return NOFLOAT;
   }
 
   for (int i = 0; i < eWinsize4x4; i++) {
@@ -210,6 +354,14 @@ void CDemVRT::draw(IDrawContext::buffer_t& buf) {
     return;
   }
 
+  // drop all shaded tiles if any parameter has changed
+  const CDemShading::params_t& params = getShadingParams();
+  if (params != paramsCacheTiles) {
+    QMutexLocker lock(&mutexCacheTiles);
+    cacheTiles.clear();
+    paramsCacheTiles = params;
+  }
+
   // get pixel offset of top left buffer corner
   QPointF pp = buf.ref1;
   dem->convertRad2Px(pp);
@@ -276,12 +428,13 @@ void CDemVRT::draw(IDrawContext::buffer_t& buf) {
   qreal o2 = ((o1 + 0.4) >= 1.0) ? o1 : (o1 + 0.4);
   p.setOpacity(o1);
 
-  for (qint32 y = top - 1; y < bottom; y += h) {
+  // align the tiles to a fixed grid to be able to reuse cached tiles while panning
+  for (qint32 y = ((top - 1) / h) * h; y < bottom; y += h) {
     if (dem->needsRedraw()) {
       break;
     }
 
-    for (qint32 x = left - 1; x < right; x += w) {
+    for (qint32 x = ((left - 1) / w) * w; x < right; x += w) {
       if (dem->needsRedraw()) {
         break;
       }
@@ -295,41 +448,28 @@ void CDemVRT::draw(IDrawContext::buffer_t& buf) {
 
 void CDemVRT::drawTile(const qint32 x, const qint32 y, const qint32 w, const qint32 h, const qreal o1, const qreal o2,
                        QPainter& p) const {
-  /*
-      As the 3x3 window will create a border of one pixel
-      more data is read than displayed to compensate.
-   */
-  const qint32 wp2 = w + 2;
-  const qint32 hp2 = h + 2;
-  qreal wp2_used = wp2;
-  qreal hp2_used = hp2;
-  qreal w_used = w;
-  qreal h_used = h;
-
-  if ((x + wp2) > xsize_px) {
-    wp2_used = xsize_px - x;
-    w_used = wp2_used - 2;
+  // the 3x3 window needs a border of one pixel around the tile
+  qint32 w_used = w;
+  qint32 h_used = h;
+
+  if ((x + w + 2) > xsize_px) {
+    w_used = xsize_px - x - 2;
     if (w_used < 2) {
       return;
     }
   }
 
-  if ((y + hp2) > ysize_px) {
-    hp2_used = ysize_px - y;
-    h_used = hp2_used - 2;
+  if ((y + h + 2) > ysize_px) {
+    h_used = ysize_px - y - 2;
     if (h_used < 2) {
       return;
     }
   }
 
-  QVector<float> data(wp2_used * hp2_used);
-  {
-    QMutexLocker lock(&mutex);
-    CPLErr err = dataset->RasterIO(GF_Read, x, y, wp2_used, hp2_used, data.data(), wp2_used, hp2_used, GDT_Float32, 1,
-                                   0, 0, 0, 0);
-    if (err != CE_None) {
-      return;
-    }
+  const quint32 modes = getShadingModes();
+  shaded_tile_t tile;
+  if (!getShadedTile(x, y, w_used, h_used, modes, tile)) {
+    return;
   }
 
   QPolygonF l(4);
@@ -341,69 +481,120 @@ void CDemVRT::drawTile(const qint32 x, const qint32 y, const qint32 w, const qin
 
   proj.transform(l, PJ_FWD);
 
-  if (doHillshading()) {
+  if (modes & eShadingHillshading) {
     QPolygonF r = l;
-    QImage img(w_used, h_used, QImage::Format_Indexed8);
-    img.setColorTable(graytable);
-
-    hillshading(data, w_used, h_used, img);
+    QMutexLocker lock(&mutex);
+    drawTile(tile.hillshading, r, p);
+  }
 
-    {
-      QMutexLocker lock(&mutex);
-      drawTile(img, r, p);
-    }
+  if (modes & eShadingSlopeShading) {
+    QPolygonF r = l;
+    QMutexLocker lock(&mutex);
+    drawTile(tile.slopeShading, r, p);
   }
 
-  if (doSlopeShading()) {
+  if (modes & eShadingSlopeColor) {
     QPolygonF r = l;
-    QImage img(w_used, h_used, QImage::Format_Alpha8);
-    slopeShading(data, w_used, h_used, img);
+    QMutexLocker lock(&mutex);
+    p.setOpacity(o2);
+    drawTile(tile.slopeColor, r, p);
+    p.setOpacity(o1);
+  }
 
-    {
-      QMutexLocker lock(&mutex);
-      drawTile(img, r, p);
-    }
+  if (modes & eShadingElevationLimit) {
+    QPolygonF r = l;
+    QMutexLocker lock(&mutex);
+    p.setOpacity(o2);
+    drawTile(tile.elevationLimit, r, p);
+    p.setOpacity(o1);
   }
 
-  if (doSlopeColor()) {
+  if (modes & eShadingElevationShading) {
     QPolygonF r = l;
-    QImage img(w_used, h_used, QImage::Format_Indexed8);
-    img.setColorTable(slopetable);
-    slopecolor(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      p.setOpacity(o2);
-      drawTile(img, r, p);
-      p.setOpacity(o1);
+    QMutexLocker lock(&mutex);
+    drawTile(tile.elevationShading, r, p);
+  }
+}
+
+quint32 CDemVRT::getShadingModes() const {
+  quint32 modes = 0;
+  modes |= doHillshading() ? eShadingHillshading : 0;
+  modes |= doSlopeShading() ? eShadingSlopeShading : 0;
+  modes |= doSlopeColor() ? eShadingSlopeColor : 0;
+  modes |= doElevationLimit() ? eShadingElevationLimit : 0;
+  modes |= doElevationShading() ? eShadingElevationShading : 0;
+  return modes;
+}
+
+bool CDemVRT::getShadedTile(qint32 x, qint32 y, qint32 w, qint32 h, quint32 modes, shaded_tile_t& tile) const {
+  const quint64 key = blockKey(x, y);
+  {
+    QMutexLocker lock(&mutexCacheTiles);
+    const shaded_tile_t* cached = cacheTiles.object(key);
+    if ((cached != nullptr) && ((cached->modes & modes) == modes)) {
+      tile = *cached;
+      return true;
     }
   }
 
-  if (doElevationLimit()) {
-    QPolygonF r = l;
-    QImage img(w_used, h_used, QImage::Format_Indexed8);
-    img.setColorTable(elevationtable);
-    elevationLimit(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      p.setOpacity(o2);
-      drawTile(img, r, p);
-      p.setOpacity(o1);
+  /*
+      As the 3x3 window will create a border of one pixel
+      more data is read than displayed to compensate.
+   */
+  const qint32 wp2 = w + 2;
+  const qint32 hp2 = h + 2;
+  QVector<float> data(wp2 * hp2);
+  {
+    QMutexLocker lock(&mutex);
+    CPLErr err = dataset->RasterIO(GF_Read, x, y, wp2, hp2, data.data(), wp2, hp2, GDT_Float32, 1, 0, 0, 0, 0);
+    if (err != CE_None) {
+      return false;
     }
   }
 
-  if (doElevationShading()) {
-    QPolygonF r = l;
-    QImage img(w_used, h_used, QImage::Format_Indexed8);
-    img.setColorTable(elevationShadeTable);
-    elevationShading(data, w_used, h_used, img);
+  CDemShading::output_t output;
+  tile.modes = modes;
 
-    {
-      QMutexLocker lock(&mutex);
-      drawTile(img, r, p);
-    }
+  if (modes & eShadingHillshading) {
+    tile.hillshading = QImage(w, h, QImage::Format_Indexed8);
+    tile.hillshading.setColorTable(graytable);
+    output.hillshading = &tile.hillshading;
+  }
+
+  if (modes & eShadingSlopeShading) {
+    tile.slopeShading = QImage(w, h, QImage::Format_Alpha8);
+    output.slopeShading = &tile.slopeShading;
+  }
+
+  if (modes & eShadingSlopeColor) {
+    tile.slopeColor = QImage(w, h, QImage::Format_Indexed8);
+    tile.slopeColor.setColorTable(slopetable);
+    output.slopeColor = &tile.slopeColor;
+  }
+
+  if (modes & eShadingElevationLimit) {
+    tile.elevationLimit = QImage(w, h, QImage::Format_Indexed8);
+    tile.elevationLimit.setColorTable(elevationtable);
+    output.elevationLimit = &tile.elevationLimit;
+  }
+
+  if (modes & eShadingElevationShading) {
+    tile.elevationShading = QImage(w, h, QImage::Format_Indexed8);
+    tile.elevationShading.setColorTable(elevationShadeTable);
+    output.elevationShading = &tile.elevationShading;
   }
+
+  // calculate all enabled shading modes at once
+  shading(data, w, h, output);
+
+  int cnt = 0;
+  for (quint32 mode = modes; mode != 0; mode >>= 1) {
+    cnt += mode & 0x01;
+  }
+
+  QMutexLocker lock(&mutexCacheTiles);
+  cacheTiles.insert(key, new shaded_tile_t(tile), qMax(1, cnt * w * h / 1024));
+  return true;
 }
 
 void CDemVRT::drawElevationShadeScale(QPainter& p) const {
@@ -19,6 +19,7 @@
 #ifndef CDEMVRT_H
 #define CDEMVRT_H
 
+#include <QCache>
 #include <QMutex>
 #include <QThreadPool>
 
@@ -37,6 +38,7 @@ class CDemVRT : public IDem {
 
   qreal getElevationAt(const QPointF& pos, bool checkScale) override;
   qreal getSlopeAt(const QPointF& pos, bool checkScale) override;
+  void getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale) override;
 
  private slots:
   void slotNeedsRedraw();
@@ -47,8 +49,84 @@ class CDemVRT : public IDem {
   void drawTile(const qint32 x, const qint32 y, const qint32 w, const qint32 h,
                 const qreal o1, const qreal o2, QPainter& p) const;
 
+  enum shading_mode_e {
+    eShadingHillshading = 0x01,
+    eShadingSlopeShading = 0x02,
+    eShadingSlopeColor = 0x04,
+    eShadingElevationLimit = 0x08,
+    eShadingElevationShading = 0x10
+  };
+
+  /// @return a combination of shading_mode_e for all enabled shading modes
+  quint32 getShadingModes() const;
+
+  /// the shaded images of a tile, null images for modes not calculated
+  struct shaded_tile_t {
+    quint32 modes = 0;  //< the shading_mode_e of all calculated images
+    QImage hillshading;
+    QImage slopeShading;
+    QImage slopeColor;
+    QImage elevationLimit;
+    QImage elevationShading;
+  };
+
+  /**
+     @brief Get the shaded images of a tile from the cache or calculate them
+
+     @param x       the column of the top left corner of the tile's data
+     @param y       the row of the top left corner of the tile's data
+     @param w       the width of the tile without the border
+     @param h       the height of the tile without the border
+     @param modes   a combination of shading_mode_e needed
+     @param tile    a shallow copy of the images
+     @return False if the DEM data could not be read.
+   */
+  bool getShadedTile(qint32 x, qint32 y, qint32 w, qint32 h, quint32 modes, shaded_tile_t& tile) const;
+
+  /**
+     @brief A block of raw DEM data at full resolution
+
+     The block with index (bx, by) covers the pixels bx * kBlockSize to
+     (bx + 1) * kBlockSize - 1 plus one more on the top/left and two more on the
+     bottom/right side. Thus the 2x2 and 4x4 windows of all points within the
+     block can be read without touching the neighbours. At the border of the
+     dataset the block is clipped.
+   */
+  struct block_t {
+    qint32 x = 0;  //< column of the first value
+    qint32 y = 0;  //< row of the first value
+    qint32 w = 0;
+    qint32 h = 0;
+    QVector<float> data;
+  };
+
+  static constexpr qint32 kBlockSize = 256;
+
+  /**
+     @brief Get a block of data from the cache or read it from the dataset
+
+     A block failed to be read is not cached. It is read again by the next request.
+
+     @param bx      the block's column
+     @param by      the block's row
+     @param block   a shallow copy of the block
+     @return False if the block could not be read.
+   */
+  bool getBlock(qint32 bx, qint32 by, block_t& block);
+  qreal getElevationFromBlock(const block_t& block, const QPointF& px) const;
+
   mutable QMutex mutex;
 
+  /// raw data blocks by block column and row, the cost is in KB
+  QCache<quint64, block_t> cacheBlocks;
+  QMutex mutexCacheBlocks;
+
+  /// shaded tiles by the tile's top left pixel, the cost is in KB
+  mutable QCache<quint64, shaded_tile_t> cacheTiles;
+  mutable QMutex mutexCacheTiles;
+  /// the parameters used for the tiles in cacheTiles
+  CDemShading::params_t paramsCacheTiles;
+
   QString filename;
   /// instance of GDAL dataset
   GDALDataset* dataset;
@@ -24,47 +24,6 @@
 #include "dem/CDemDraw.h"
 #include "dem/CDemPropSetup.h"
 
-template <typename T>
-inline T getValue(QVector<T>& data, int x, int y, int dx) {
-  return data[x + y * dx];
-}
-
-template <typename T>
-inline void fillWindow(QVector<T>& data, int x, int y, int dx, T* w) {
-  w[0] = getValue(data, x - 1, y - 1, dx);
-  w[1] = getValue(data, x, y - 1, dx);
-  w[2] = getValue(data, x + 1, y - 1, dx);
-  w[3] = getValue(data, x - 1, y, dx);
-  w[4] = getValue(data, x, y, dx);
-  w[5] = getValue(data, x + 1, y, dx);
-  w[6] = getValue(data, x - 1, y + 1, dx);
-  w[7] = getValue(data, x, y + 1, dx);
-  w[8] = getValue(data, x + 1, y + 1, dx);
-}
-
-template <typename T>
-inline void fillWindow4x4(QVector<T>& data, qreal x, qreal y, int dx, T* w) {
-  x = qFloor(x);
-  y = qFloor(y);
-
-  w[0] = getValue(data, x - 1, y - 1, dx);
-  w[1] = getValue(data, x, y - 1, dx);
-  w[2] = getValue(data, x + 1, y - 1, dx);
-  w[3] = getValue(data, x + 2, y - 1, dx);
-  w[4] = getValue(data, x - 1, y, dx);
-  w[5] = getValue(data, x, y, dx);
-  w[6] = getValue(data, x + 1, y, dx);
-  w[7] = getValue(data, x + 2, y, dx);
-  w[8] = getValue(data, x - 1, y + 1, dx);
-  w[9] = getValue(data, x, y + 1, dx);
-  w[10] = getValue(data, x + 1, y + 1, dx);
-  w[11] = getValue(data, x + 2, y + 1, dx);
-  w[12] = getValue(data, x - 1, y + 2, dx);
-  w[13] = getValue(data, x, y + 2, dx);
-  w[14] = getValue(data, x + 1, y + 2, dx);
-  w[15] = getValue(data, x + 2, y + 2, dx);
-}
-
 const struct SlopePresets IDem::slopePresets[7]{
     /* http://www.alpenverein.de/bergsport/sicherheit/skitouren-schneeschuh-sicher-im-schnee/dav-snowcard_aid_10619.html
      */
@@ -101,6 +60,14 @@ IDem::IDem(CDemDraw* parent) : IDrawObject(parent), dem(parent) {
 
 IDem::~IDem() {}
 
+void IDem::getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale) {
+  for (int i = 0; i < pos.size(); i++) {
+    if (ele[i].y() == NOFLOAT) {
+      ele[i].ry() = getElevationAt(pos[i], checkScale);
+    }
+  }
+}
+
 void IDem::saveConfig(QSettings& cfg) {
   IDrawObject::saveConfig(cfg);
 
@@ -213,76 +180,34 @@ int IDem::getFactorHillshading() const {
   }
 }
 
-void IDem::hillshading(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
-
-#define ZFACT 0.125
-#define ZFACT_BY_ZFACT (ZFACT * ZFACT)
-#define SIN_ALT (qSin(45 * DEG_TO_RAD))
-#define ZFACT_COS_ALT (ZFACT * qCos(45 * DEG_TO_RAD))
-#define AZ (315 * DEG_TO_RAD)
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-
-      if (hasNoData && win[4] == noData) {
-        scan[n - 1] = 255;
-        continue;
-      }
-
-      qreal dx =
-          ((win[0] + win[3] + win[3] + win[6]) - (win[2] + win[5] + win[5] + win[8])) / (xscale * factorHillshading);
-      qreal dy =
-          ((win[6] + win[7] + win[7] + win[8]) - (win[0] + win[1] + win[1] + win[2])) / (yscale * factorHillshading);
-      qreal aspect = qAtan2(dy, dx);
-      qreal xx_plus_yy = dx * dx + dy * dy;
-      qreal cang =
-          (SIN_ALT - ZFACT_COS_ALT * qSqrt(xx_plus_yy) * qSin(aspect - AZ)) / qSqrt(1 + ZFACT_BY_ZFACT * xx_plus_yy);
-
-      if (cang <= 0.0) {
-        cang = 1.0;
-      } else {
-        cang = 1.0 + (254.0 * cang);
-      }
-
-      scan[n - 1] = cang;
-    }
-  }
+void IDem::shading(const QVector<float>& data, qint32 w, qint32 h, CDemShading::output_t& output) const {
+  CDemShading::shade(data, w, h, getShadingParams(), output);
 }
 
-int IDem::getFactorSlopeShading() const { return factorSlopeShading * 100.; }
-
-void IDem::slopeShading(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
-
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
+CDemShading::params_t IDem::getShadingParams() const {
+  CDemShading::params_t params;
+  params.xscale = xscale;
+  params.yscale = yscale;
+  params.factorHillshading = factorHillshading;
+  params.factorSlopeShading = factorSlopeShading;
+  params.hasNoData = hasNoData;
+  params.noData = noData;
+
+  const qreal* currentSlopeStepTable = getCurrentSlopeStepTable();
+  for (int i = 0; i < 5; i++) {
+    params.slopeSteps[i] = currentSlopeStepTable[i];
+  }
 
-      if (hasNoData && win[4] == noData) {
-        scan[n - 1] = 0;
-        continue;
-      }
+  params.elevationLimit = getElevationLimit();
+  params.elevationShadeLow = getElevationShadeLimitLow();
+  params.elevationShadeHi = getElevationShadeLimitHi();
+  params.elevationFactor = IUnit::self().elevationFactor;
 
-      qreal slope = slopeOfWindowInterp(win, eWinsize3x3, 0, 0);
-      if (slope == NOFLOAT) {
-        scan[n - 1] = 0;
-      } else {
-        int alphaValue = slope * 255. / 90.     // map slope angle to alpha [0 .. 255]
-                         * factorSlopeShading;  // apply slider value [0.25 .. 3.0]
-        if (alphaValue > 255) {
-          alphaValue = 255;
-        }
-        scan[n - 1] = alphaValue;
-      }
-    }
-  }
+  return params;
 }
 
+int IDem::getFactorSlopeShading() const { return factorSlopeShading * 100.; }
+
 qreal IDem::slopeOfWindowInterp(float* win2, winsize_e size, qreal x, qreal y) const {
   for (int i = 0; i < size; i++) {
     if (hasNoData && win2[i] == noData) {
@@ -333,103 +258,6 @@ qreal IDem::slopeOfWindowInterp(float* win2, winsize_e size, qreal x, qreal y) c
   return slope;
 }
 
-void IDem::slopecolor(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
-
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-      qreal slope = slopeOfWindowInterp(win, eWinsize3x3, 0, 0);
-
-      const qreal* currentSlopeStepTable = getCurrentSlopeStepTable();
-
-      if (slope > currentSlopeStepTable[4]) {
-        scan[n - 1] = 5;
-      } else if (slope > currentSlopeStepTable[3]) {
-        scan[n - 1] = 4;
-      } else if (slope > currentSlopeStepTable[2]) {
-        scan[n - 1] = 3;
-      } else if (slope > currentSlopeStepTable[1]) {
-        scan[n - 1] = 2;
-      } else if (slope > currentSlopeStepTable[0]) {
-        scan[n - 1] = 1;
-      } else {
-        scan[n - 1] = 0;
-      }
-    }
-  }
-}
-
-void IDem::elevationLimit(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
-
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-
-      // get maximum of window (_not_ mean)
-      //
-      qreal meters = -2.0;
-      for (unsigned int i = 0; i < eWinsize3x3; i++) {
-        if (win[i] != noData && win[i] > meters) {
-          meters = win[i];
-        }
-      }
-
-      qreal elevation;  // elevation in the units set by the user
-      QString unit;     // result not used
-      IUnit::self().meter2elevation(meters, elevation, unit);
-      if (elevation >= getElevationLimit()) {
-        scan[n - 1] = 1;
-      } else {
-        scan[n - 1] = 0;
-      }
-    }
-  }
-}
-
-void IDem::elevationShading(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
-
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-
-      // get maximum of window (_not_ mean)
-      //
-      qreal meters = -2.0;
-      for (unsigned int i = 0; i < eWinsize3x3; i++) {
-        if (win[i] != noData && win[i] > meters) {
-          meters = win[i];
-        }
-      }
-
-      qreal elevation;  // elevation in the units set by the user
-      QString unit;     // result not used
-      IUnit::self().meter2elevation(meters, elevation, unit);
-
-      // calc shade of elevation based and  clip set min and max values
-      int limitLow = std::min(getElevationShadeLimitLow(), getElevationShadeLimitHi());
-      int limitHi = std::max(getElevationShadeLimitLow(), getElevationShadeLimitHi());
-
-      if (elevation < limitLow) {
-        scan[n - 1] = 0;
-      } else if (elevation < limitHi) {
-        qreal relLimit = (elevation - limitLow) / (limitHi - limitLow);
-        scan[n - 1] = 1 + relLimit * 253;
-      } else {
-        scan[n - 1] = 255;
-      }
-    }
-  }
-}
-
 void IDem::slotShowElevationShadeScale(bool yes) { bShowElevationShadeScale = yes; }
 
 void IDem::drawTile(QImage& img, QPolygonF& l, QPainter& p) const { drawTileLQ(img, l, p, *dem, proj); }
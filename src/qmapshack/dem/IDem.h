@@ -25,6 +25,7 @@
 
 #include "canvas/IDrawContext.h"
 #include "canvas/IDrawObject.h"
+#include "dem/CDemShading.h"
 #include "gis/proj_x.h"
 
 #define CUSTOM_SLOPE_COLORTABLE (-1)
@@ -53,6 +54,19 @@ class IDem : public IDrawObject {
   virtual qreal getElevationAt(const QPointF& pos, bool checkScale) = 0;
   virtual qreal getSlopeAt(const QPointF& pos, bool checkScale) = 0;
 
+  /**
+     @brief Get the elevation of several points at once
+
+     Only points with an elevation of NOFLOAT are looked up. This way the result
+     of several DEM files can be merged. The default implementation queries point
+     by point.
+
+     @param pos         the positions [rad]
+     @param ele         the elevation is written to the y coordinate. Must have the size of pos.
+     @param checkScale  return no data if the DEM is out of scale
+   */
+  virtual void getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale);
+
   bool activated() const { return isActivated; }
 
   /**
@@ -124,15 +138,17 @@ class IDem : public IDrawObject {
   void slotShowElevationShadeScale(bool yes);
 
  protected:
-  void hillshading(QVector<float>& data, qreal w, qreal h, QImage& img) const;
-
-  void slopeShading(QVector<float>& data, qreal w, qreal h, QImage& img) const;
-
-  void slopecolor(QVector<float>& data, qreal w, qreal h, QImage& img) const;
-
-  void elevationLimit(QVector<float>& data, qreal w, qreal h, QImage& img) const;
+  /**
+     @brief Calculate all enabled shading modes in a single pass
+     @param data    DEM data of (w + 2) x (h + 2) values
+     @param w       width of the tile
+     @param h       height of the tile
+     @param output  the images of the enabled shading modes
+   */
+  void shading(const QVector<float>& data, qint32 w, qint32 h, CDemShading::output_t& output) const;
 
-  void elevationShading(QVector<float>& data, qreal w, qreal h, QImage& img) const;
+  /// @return the current shading parameters, e.g. to detect changes
+  CDemShading::params_t getShadingParams() const;
 
   /**
      @brief Slope in degrees based on a window. Origin is at point (1,1), counting from zero.
@@ -72,18 +72,18 @@ void IDevice::umount(const QString& path) {
 
 QString IDevice::getName() const { return text(CGisListWks::eColumnName); }
 
-void IDevice::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
+void IDevice::getItemsByPos(const QPointF& pos, const QRectF& area, QList<IGisItem*>& items) {
   const int N = childCount();
   for (int n = 0; n < N; n++) {
     IGisProject* project = dynamic_cast<IGisProject*>(child(n));
     if (project != nullptr) {
-      project->getItemsByPos(pos, items);
+      project->getItemsByPos(pos, area, items);
       continue;
     }
 
     IDevice* device = dynamic_cast<IDevice*>(child(n));
     if (device != nullptr) {
-      device->getItemsByPos(pos, items);
+      device->getItemsByPos(pos, area, items);
     }
   }
 }
@@ -279,7 +279,7 @@ bool IDevice::testForExternalProject(const QString& filename) {
   return false;
 }
 
-void IDevice::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
+void IDevice::drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) {
   const int N = childCount();
   for (int n = 0; n < N; n++) {
     IGisProject* project = dynamic_cast<IGisProject*>(child(n));
@@ -295,7 +295,7 @@ void IDevice::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& bl
   }
 }
 
-void IDevice::drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, const QFontMetricsF& fm,
+void IDevice::drawLabel(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, const QFontMetricsF& fm,
                         CGisDraw* gis) {
   const int N = childCount();
   for (int n = 0; n < N; n++) {
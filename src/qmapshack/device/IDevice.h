@@ -48,15 +48,15 @@ class IDevice : public QTreeWidgetItem {
 
   QString getName() const;
 
-  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items);
+  void getItemsByPos(const QPointF& pos, const QRectF& area, QList<IGisItem*>& items);
   void getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items);
   void getNogoAreas(QList<IGisItem*>& nogos);
   IGisItem* getItemByKey(const IGisItem::key_t& key);
   void getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items);
   void editItemByKey(const IGisItem::key_t& key);
 
-  void drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis);
-  void drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, const QFontMetricsF& fm,
+  void drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis);
+  void drawLabel(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, const QFontMetricsF& fm,
                  CGisDraw* gis);
   void drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis);
 
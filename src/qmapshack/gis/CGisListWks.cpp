@@ -37,25 +37,22 @@
 #include "gis/CGisDatabase.h"
 #include "gis/CGisListWks.h"
 #include "gis/CGisWorkspace.h"
+#include "gis/CSaveWorkspaceThread.h"
 #include "gis/CSelDevices.h"
+#include "gis/CWorkspaceLoader.h"
 #include "gis/IGisItem.h"
 #include "gis/db/CDBProject.h"
 #include "gis/db/CLostFoundProject.h"
 #include "gis/db/CSelectDBFolder.h"
 #include "gis/db/CSetupFolder.h"
 #include "gis/db/macros.h"
-#include "gis/fit/CFitProject.h"
 #include "gis/gpx/CGpxProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/IGisProject.h"
-#include "gis/qlb/CQlbProject.h"
 #include "gis/qms/CQmsProject.h"
 #include "gis/rte/CGisItemRte.h"
 #include "gis/search/CGeoSearch.h"
 #include "gis/search/CGeoSearchWeb.h"
-#include "gis/slf/CSlfProject.h"
-#include "gis/suunto/CSmlProject.h"
-#include "gis/tcx/CTcxProject.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/wpt/CGisItemWpt.h"
 #include "helpers/CProgressDialog.h"
@@ -66,7 +63,7 @@
 #include "setup/IAppSetup.h"
 
 #undef DB_VERSION
-#define DB_VERSION 4
+#define DB_VERSION 5
 
 class CGisListWksEditLock {
  public:
@@ -95,6 +92,8 @@ CGisListWks::CGisListWks(QWidget* parent) : QTreeWidget(parent) {
   db.open();
   configDB();
 
+  saver = new CSaveWorkspaceThread(db, this);
+
   // workspace project related actions
   actionEditPrj = addAction(QIcon("://icons/32x32/EditDetails.png"), tr("Edit.."), this, &CGisListWks::slotEditPrj);
   actionCopyPrj = addAction(QIcon("://icons/32x32/Copy.png"), tr("Copy to..."), this, &CGisListWks::slotCopyProject);
@@ -207,7 +206,11 @@ CGisListWks::CGisListWks(QWidget* parent) : QTreeWidget(parent) {
   actionEditPrxWpt =
       addAction(QIcon("://icons/32x32/WptEditProx.png"), tr("Change Proximity..."), this, &CGisListWks::slotEditPrxWpt);
 
-  connect(qApp, &QApplication::aboutToQuit, this, &CGisListWks::slotSaveWorkspace);
+  connect(qApp, &QApplication::aboutToQuit, this, [this]() {
+    stopRestore();
+    slotSaveWorkspace();
+    saver->flush();
+  });
   connect(this, &CGisListWks::customContextMenuRequested, this, &CGisListWks::slotContextMenu);
   connect(this, &CGisListWks::itemDoubleClicked, this, &CGisListWks::slotItemDoubleClicked);
   connect(this, &CGisListWks::itemChanged, this, &CGisListWks::slotItemChanged);
@@ -215,6 +218,8 @@ CGisListWks::CGisListWks(QWidget* parent) : QTreeWidget(parent) {
   SETTINGS;
   saveOnExit = cfg.value("Database/saveOnExit", saveOnExit).toBool();
   saveEvery = cfg.value("Database/saveEvery", saveEvery).toInt();
+  IGisItem::setCompression(
+      IGisItem::compression_e(cfg.value("Database/compression", IGisItem::eCompressionFast).toInt()));
 
   if (saveOnExit && (saveEvery > 0)) {
     QTimer::singleShot(saveEvery * 60000, this, &CGisListWks::slotSaveWorkspace);
@@ -241,7 +246,11 @@ CGisListWks::CGisListWks(QWidget* parent) : QTreeWidget(parent) {
   }
 }
 
-CGisListWks::~CGisListWks() {}
+CGisListWks::~CGisListWks() {
+  delete loader;
+  // the thread has to be stopped before the database connection it was cloned from is destroyed
+  delete saver;
+}
 
 void CGisListWks::configDB() {
   QSqlQuery query(db);
@@ -289,6 +298,7 @@ void CGisListWks::initDB() {
       "keyqms         TEXT NOT NULL,"
       "changed        BOOLEAN DEFAULT FALSE,"
       "visible        BOOLEAN DEFAULT TRUE,"
+      "pos            INTEGER DEFAULT 0,"
       "data           BLOB NOT NULL"
       ")",
       NO_CMD)
@@ -313,6 +323,9 @@ void CGisListWks::migrateDB(int version) {
   if (version < 4) {
     migrateDB3to4();
   }
+  if (version < 5) {
+    migrateDB4to5();
+  }
 
   // save the new version to the database
   QSqlQuery query(db);
@@ -361,6 +374,13 @@ void CGisListWks::migrateDB3to4() {
   }
 }
 
+void CGisListWks::migrateDB4to5() {
+  qDebug() << "migrating workspace.db from version 4 to version 5";
+  // add a new column `pos` to keep the order of the projects as rows are not rewritten anymore on each save
+  QSqlQuery query(db);
+  QUERY_RUN("ALTER TABLE workspace ADD COLUMN pos INTEGER DEFAULT 0;", NO_CMD)
+}
+
 void CGisListWks::setExternalMenu(QMenu* project) {
   menuNone = project;
   connect(CMainWindow::self().findChild<QAction*>("actionAddEmptyProject"), &QAction::triggered, this,
@@ -722,46 +742,74 @@ void CGisListWks::slotSaveWorkspace() {
     return;
   }
 
-  QSqlQuery query(db);
-  QUERY_RUN("DELETE FROM workspace", return )
+  if (loader != nullptr) {
+    // try again as soon as the workspace is restored
+    if (saveEvery) {
+      QTimer::singleShot(saveEvery * 60000, this, &CGisListWks::slotSaveWorkspace);
+    }
+    return;
+  }
 
   qDebug() << "slotSaveWorkspace()";
 
-  const int total = topLevelItemCount();
-  PROGRESS_SETUP(tr("Saving workspace. Please wait."), 0, total, this);
+  /*
+      Only projects changed since they have been written the last time are serialized.
+      The serialization of the items is cheap as the compressed data of their history
+      is just copied. The database is written by a thread. The GUI is blocked just
+      for taking the snapshot.
+   */
+  CSaveWorkspaceThread::snapshot_t snapshot;
+  snapshot.userFocus = IGisProject::getUserFocus();
+  snapshot.keep = keysNotRestored;
+  if (snapshot.userFocus.isEmpty() && keysNotRestored.contains(keyUserFocusRestore)) {
+    snapshot.userFocus = keyUserFocusRestore;
+  }
 
+  QSet<QString> keys;
+  QList<IGisProject*> projects;
+  const int total = topLevelItemCount();
   for (int i = 0; i < total; i++) {
-    PROGRESS(i, return );
-
     IGisProject* project = dynamic_cast<IGisProject*>(topLevelItem(i));
     if (nullptr == project) {
       continue;
     }
 
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream.setVersion(QDataStream::Qt_5_2);
-    stream.setByteOrder(QDataStream::LittleEndian);
+    CSaveWorkspaceThread::project_t entry;
+    entry.key = project->getKey();
+    entry.type = project->getType();
+    entry.name = project->getName();
+    entry.changed = project->isChanged();
+    entry.visible = (project->checkState(CGisListDB::eColumnCheckbox) == Qt::Checked);
+    entry.fingerprint = project->getFingerprint();
+
+    // rows can't be updated by key if the key is used twice
+    if (keys.contains(entry.key)) {
+      snapshot.full = true;
+    }
+    keys << entry.key;
 
-    project->IGisProject::operator>>(stream);
+    snapshot.projects << entry;
+    projects << project;
+  }
 
-    query.prepare(
-        "INSERT INTO workspace (type, keyqms, name, changed, visible, data) VALUES (:type, :keyqms, :name, :changed, "
-        ":visible, :data)");
-    query.bindValue(":type", project->getType());
-    query.bindValue(":keyqms", project->getKey());
-    query.bindValue(":name", project->getName());
-    query.bindValue(":changed", project->isChanged());
+  for (int i = 0; i < projects.size(); i++) {
+    CSaveWorkspaceThread::project_t& entry = snapshot.projects[i];
+    if (!snapshot.full && saver->isSaved(entry.key, entry.fingerprint)) {
+      continue;
+    }
 
-    bool visible = (project->checkState(CGisListDB::eColumnCheckbox) == Qt::Checked);
-    query.bindValue(":visible", visible);
-    query.bindValue(":data", data);
-    QUERY_EXEC(continue);
+    QDataStream stream(&entry.data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    projects[i]->IGisProject::operator>>(stream);
   }
 
-  query.prepare("UPDATE userfocus set focus=:focus");
-  query.bindValue(":focus", IGisProject::getUserFocus());
-  QUERY_EXEC();
+  // the thread opens its own connection and the file is locked exclusively by the one reading it
+  if (db.isOpen()) {
+    db.close();
+  }
+  saver->save(snapshot);
 
   if (saveEvery) {
     QTimer::singleShot(saveEvery * 60000, this, &CGisListWks::slotSaveWorkspace);
@@ -771,140 +819,145 @@ void CGisListWks::slotSaveWorkspace() {
 void CGisListWks::slotLoadWorkspace() {
   CGisListWksEditLock lock(true, IGisItem::mutexItems);
 
-  QSqlQuery query(db);
-
-  QUERY_RUN("SELECT type, keyqms, name, changed, visible, data FROM workspace", return )
-
-  {  // open context for progress dialog
-    const int total = query.size();
-    PROGRESS_SETUP(tr("Loading workspace. Please wait."), 0, total, this);
-    quint32 progCnt = 0;
-
-    while (query.next()) {
-      PROGRESS(progCnt++, return );
-
-      int type = query.value(0).toInt();
-      QString name = query.value(2).toString();
-      bool changed = query.value(3).toBool();
-      Qt::CheckState visible = query.value(4).toBool() ? Qt::Checked : Qt::Unchecked;
-      QByteArray data = query.value(5).toByteArray();
-
-      QDataStream stream(&data, QIODevice::ReadOnly);
-      stream.setVersion(QDataStream::Qt_5_2);
-      stream.setByteOrder(QDataStream::LittleEndian);
-
-      IGisProject* project = nullptr;
-      switch (type) {
-        case IGisProject::eTypeQms: {
-          project = new CQmsProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1a)
-          *project << stream;
-          break;
-        }
-
-        case IGisProject::eTypeQlb: {
-          project = new CQlbProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1a)
-          *project << stream;
-          break;
-        }
+  slotGeoSearch(static_cast<QAction*>(CMainWindow::self().findChild<QAction*>("actionGeoSearch"))->isChecked());
 
-        case IGisProject::eTypeGpx: {
-          project = new CGpxProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1b)
-          *project << stream;
-          break;
-        }
+  QSqlQuery query(db);
+  QUERY_RUN("SELECT focus FROM userfocus", NO_CMD);
+  if (query.next()) {
+    keyUserFocusRestore = query.value(0).toString();
+  }
 
-        case IGisProject::eTypeDb: {
-          CDBProject* dbProject;
-          project = dbProject = new CDBProject(this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1c)
+  // all rows not restored yet are kept in the database by a save
+  QUERY_RUN("SELECT keyqms FROM workspace", NO_CMD);
+  while (query.next()) {
+    keysNotRestored << query.value(0).toString();
+  }
 
-          project->IGisProject::operator<<(stream);
-          dbProject->restoreDBLink();
+  /*
+      The projects are restored in the background. The GUI thread reads the rows and
+      adds the restored projects to the workspace as they are done. Thus the main
+      window can be used while large workspaces are restored.
+   */
+  loader = new CWorkspaceLoader();
+  timerRestore = new QTimer(this);
+  connect(timerRestore, &QTimer::timeout, this, &CGisListWks::slotRestoreWorkspace);
+
+  queryRestore = QSqlQuery(db);
+  queryRestore.setForwardOnly(true);
+  if (!queryRestore.exec("SELECT type, keyqms, name, changed, visible, data FROM workspace ORDER BY pos, id")) {
+    qWarning() << "Execution of SQL-Statement `" << queryRestore.lastQuery() << "` failed:";
+    qWarning() << queryRestore.lastError();
+    finishRestore();
+    return;
+  }
 
-          if (!project->isValid()) {
-            delete project;
-            project = nullptr;
-          } else {
-            dbProject->postStatus(false);
-          }
-          break;
-        }
+  timerRestore->start(50);
+}
 
-        case IGisProject::eTypeSlf: {
-          project = new CSlfProject(name, false);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1d)
-          *project << stream;
+void CGisListWks::slotRestoreWorkspace() {
+  if (loader == nullptr) {
+    return;
+  }
 
-          // the CSlfProject does not - as the other C*Project - register itself in the list
-          // of currently opened projects. This is done manually here.
-          addProject(project);
-          break;
-        }
+  // keep enough rows queued to keep all threads busy, but don't read the whole database into memory
+  const qint32 maxInProgress = 2 * QThread::idealThreadCount();
+  bool atEnd = false;
+  while (loader->getCountInProgress() < maxInProgress) {
+    if (!queryRestore.next()) {
+      atEnd = true;
+      break;
+    }
 
-        case IGisProject::eTypeFit: {
-          project = new CFitProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+    CWorkspaceLoader::entry_t entry;
+    entry.type = queryRestore.value(0).toInt();
+    entry.key = queryRestore.value(1).toString();
+    entry.name = queryRestore.value(2).toString();
+    entry.changed = queryRestore.value(3).toBool();
+    entry.visible = queryRestore.value(4).toBool();
+    entry.data = queryRestore.value(5).toByteArray();
+    loader->add(entry);
+  }
+
+  const QList<CWorkspaceLoader::result_t>& results = loader->takeResults();
+  if (!results.isEmpty()) {
+    CGisListWksEditLock lock(false, IGisItem::mutexItems);
+    blockSignals(true);
+    for (const CWorkspaceLoader::result_t& result : results) {
+      const CWorkspaceLoader::entry_t& entry = result.entry;
+      keysNotRestored.remove(entry.key);
+
+      // projects the loader can't restore in parallel are restored by the GUI thread
+      IGisProject* project = result.loaded ? result.project : CWorkspaceLoader::restore(entry, this);
+      if (nullptr == project) {
+        continue;
+      }
 
-        case IGisProject::eTypeTcx: {
-          project = new CTcxProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+      if (!project->isValid()) {
+        delete project;
+        continue;
+      }
 
-        case IGisProject::eTypeSml: {
-          project = new CSmlProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+      if (project->treeWidget() == nullptr) {
+        addProject(project);
+      }
 
-        case IGisProject::eTypeLog: {
-          project = new CSmlProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+      if (result.loaded) {
+        // do the correlation skipped by the loader's thread
+        project->blockUpdateItems(false);
       }
 
-      if (nullptr != project) {
-        // Hiding the individual projects from the map (1a, 1b, 1c) could be done here within a single statement,
-        // but this results in a visible `the checkbox is being unchecked`, especially in case the project
-        // is large and takes some time to load.
-        // When done directly after construction there is no `blinking` of the check mark
+      project->setToolTip(eColumnName, project->getInfo());
+      if (entry.changed) {
+        project->setChanged();
+      }
 
-        project->setToolTip(eColumnName, project->getInfo());
-        if (changed) {
-          project->setChanged();
-        }
+      // the project is in the database already, there is no need to write it again until it changes
+      if (project->getKey() == entry.key) {
+        saver->setSaved(entry.key, project->getFingerprint());
       }
     }
-  }  // close context for progress dialog
-
-  slotGeoSearch(static_cast<QAction*>(CMainWindow::self().findChild<QAction*>("actionGeoSearch"))->isChecked());
+    blockSignals(false);
+    emit sigChanged();
+  }
 
-  for (const QString& filename : qlOpts->arguments) {
-    CGisWorkspace::self().loadGisProject(filename);
+  if (atEnd && (loader->getCountInProgress() == 0)) {
+    finishRestore();
   }
+}
 
-  QUERY_RUN("SELECT focus FROM userfocus", );
-  if (query.next()) {
-    QString key = query.value(0).toString();
-    IGisProject* project = getProjectByKey(key);
-    if (project != nullptr) {
-      project->gainUserFocus(true);
-    }
+void CGisListWks::finishRestore() {
+  delete loader;
+  loader = nullptr;
+  // this might be called by the timer's slot
+  timerRestore->deleteLater();
+  timerRestore = nullptr;
+  queryRestore.finish();
+
+  CGisListWksEditLock lock(true, IGisItem::mutexItems);
+
+  CGisWorkspace::self().loadGisProjects(qlOpts->arguments);
+
+  IGisProject* project = getProjectByKey(keyUserFocusRestore);
+  if (project != nullptr) {
+    project->gainUserFocus(true);
   }
 
   emit sigChanged();
 }
 
+void CGisListWks::stopRestore() {
+  if (loader == nullptr) {
+    return;
+  }
+
+  // projects restored but not taken yet are deleted and kept in the database as they are
+  delete loader;
+  loader = nullptr;
+  timerRestore->deleteLater();
+  timerRestore = nullptr;
+  queryRestore.finish();
+}
+
 void CGisListWks::showMenuProjectWks(const QPoint& p) {
   QMenu menu(this);
   menu.addAction(actionEditPrj);
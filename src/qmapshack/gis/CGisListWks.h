@@ -21,7 +21,9 @@
 #define CGISLISTWKS_H
 
 #include <QPointer>
+#include <QSet>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QTreeWidget>
 
 #include "gis/prj/IGisProject.h"
@@ -33,6 +35,9 @@ class CGeoSearch;
 class IGisProject;
 class CDBProject;
 class IDeviceWatcher;
+class CSaveWorkspaceThread;
+class CWorkspaceLoader;
+class QTimer;
 class QActionGroup;
 
 class CGisListWks : public QTreeWidget {
@@ -74,6 +79,7 @@ class CGisListWks : public QTreeWidget {
 
  private slots:
   void slotSaveWorkspace();
+  void slotRestoreWorkspace();
   void slotContextMenu(const QPoint& point);
   void slotSaveProject();
   void slotSaveAsProject();
@@ -138,6 +144,11 @@ class CGisListWks : public QTreeWidget {
   void migrateDB1to2();
   void migrateDB2to3();
   void migrateDB3to4();
+  void migrateDB4to5();
+  /// clean up after all projects are restored and load the files given by command line
+  void finishRestore();
+  /// abort restoring the workspace, the projects not restored yet are kept in the database
+  void stopRestore();
   void setVisibilityOnMap(bool visible);
   QAction* addSortAction(QObject* parent, QActionGroup* actionGroup, const QString& icon, const QString& text,
                          IGisProject::sorting_folder_e mode);
@@ -175,6 +186,16 @@ class CGisListWks : public QTreeWidget {
   }
 
   QSqlDatabase db;
+  /// writes the workspace to the database in the background
+  CSaveWorkspaceThread* saver = nullptr;
+  /// restores the workspace in the background, nullptr if done
+  CWorkspaceLoader* loader = nullptr;
+  QTimer* timerRestore = nullptr;
+  /// the rows of the workspace table to restore
+  QSqlQuery queryRestore;
+  /// the keys of all rows in the database not restored yet
+  QSet<QString> keysNotRestored;
+  QString keyUserFocusRestore;
 
   QActionGroup* actionGroupSort;
   QAction* actionSave;
@@ -30,12 +30,15 @@
 #include "gis/CGisDraw.h"
 #include "gis/CGisItemRate.h"
 #include "gis/IGisItem.h"
+#include "gis/IGisLine.h"
 #include "gis/db/CDBProject.h"
 #include "gis/db/CSelectDBFolder.h"
 #include "gis/db/CSetupFolder.h"
 #include "gis/gpx/CGpxProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
+#include "gis/prj/CProjectLoader.h"
 #include "gis/prj/IGisProject.h"
+#include "gis/proj_x.h"
 #include "gis/qms/CQmsProject.h"
 #include "gis/rte/CCreateRouteFromWpt.h"
 #include "gis/rte/CGisItemRte.h"
@@ -46,6 +49,7 @@
 #include "gis/wpt/CGisItemWpt.h"
 #include "gis/wpt/CProjWpt.h"
 #include "helpers/CInputDialog.h"
+#include "helpers/COccupancyGrid.h"
 #include "helpers/CProgressDialog.h"
 #include "helpers/CSelectCopyAction.h"
 #include "helpers/CSelectProjectDialog.h"
@@ -142,6 +146,82 @@ void CGisWorkspace::loadGisProject(const QString& filename) {
   emit sigChanged();
 }
 
+void CGisWorkspace::loadGisProjects(const QStringList& filenames) {
+  if (filenames.size() < 2) {
+    for (const QString& filename : filenames) {
+      loadGisProject(filename);
+    }
+    return;
+  }
+
+  QStringList failed;
+  QStringList duplicates;
+  {
+    CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
+    PROGRESS_SETUP(tr("Load projects..."), 0, filenames.size(), this);
+
+    CProjectLoader loader(filenames);
+    qint32 cnt = 0;
+    bool finished = false;
+    while (!finished) {
+      finished = loader.waitForDone(100);
+
+      const QList<CProjectLoader::result_t>& results = loader.takeResults();
+      treeWks->blockSignals(true);
+      {
+        QMutexLocker lock(&IGisItem::mutexItems);
+        for (const CProjectLoader::result_t& result : results) {
+          // file types the loader can't load in parallel are loaded by the GUI thread
+          IGisProject* project = result.loaded ? result.project : IGisProject::create(result.filename, nullptr);
+          if (project == nullptr) {
+            if (result.loaded) {
+              failed << result.filename;
+            }
+            continue;
+          }
+
+          if (treeWks->hasProject(project)) {
+            duplicates << project->getName();
+            delete project;
+            continue;
+          }
+
+          treeWks->addProject(project);
+
+          if (result.loaded) {
+            // do what has been skipped by the loader's threads as it needs dialogs
+            for (int i = 0; i < project->childCount(); i++) {
+              CGisItemTrk* trk = dynamic_cast<CGisItemTrk*>(project->child(i));
+              if (trk != nullptr) {
+                trk->checkForInvalidPoints();
+              }
+            }
+            project->blockUpdateItems(false);
+          }
+          project->setWorkspaceFilter(currentSearch);
+        }
+      }
+      treeWks->blockSignals(false);
+
+      cnt += results.size();
+      PROGRESS(cnt, break);
+    }
+  }
+
+  if (!duplicates.isEmpty()) {
+    QMessageBox::information(this, tr("Load project..."),
+                             tr("These projects are already in the workspace:\n%1").arg(duplicates.join("\n")),
+                             QMessageBox::Abort);
+  }
+
+  if (!failed.isEmpty()) {
+    QMessageBox::warning(this, tr("Load project..."), tr("Failed to load these files:\n%1").arg(failed.join("\n")),
+                         QMessageBox::Abort);
+  }
+
+  emit sigChanged();
+}
+
 void CGisWorkspace::slotSetGisLayerOpacity(int val) {
   CCanvas::gisLayerOpacity = qreal(val) / 100;
   CCanvas* canvas = CMainWindow::self().getVisibleCanvas();
@@ -323,19 +403,26 @@ IGisProject* CGisWorkspace::selectProject(bool forceSelect) {
   return project;
 }
 
-void CGisWorkspace::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
+void CGisWorkspace::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items, CGisDraw* gis) {
   QMutexLocker lock(&IGisItem::mutexItems);
 
+  // the area around the position in [rad] covering the largest tolerance of IGisItem::isCloseTo()
+  QPointF pt1 = pos - QPointF(IGisItem::kCloseToTolerance, IGisItem::kCloseToTolerance);
+  QPointF pt2 = pos + QPointF(IGisItem::kCloseToTolerance, IGisItem::kCloseToTolerance);
+  gis->convertPx2Rad(pt1);
+  gis->convertPx2Rad(pt2);
+  const QRectF area = QRectF(pt1, pt2).normalized();
+
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
     IGisProject* project = dynamic_cast<IGisProject*>(item);
     if (project) {
-      project->getItemsByPos(pos, items);
+      project->getItemsByPos(pos, area, items);
       continue;
     }
     IDevice* device = dynamic_cast<IDevice*>(item);
     if (device) {
-      device->getItemsByPos(pos, items);
+      device->getItemsByPos(pos, area, items);
       continue;
     }
   }
@@ -358,11 +445,19 @@ void CGisWorkspace::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
 
 void CGisWorkspace::getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items) {
   QMutexLocker lock(&IGisItem::mutexItems);
+
+  QSet<QString> keysProject;
+  for (const IGisItem::key_t& key : keys) {
+    keysProject << key.project;
+  }
+
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
     IGisProject* project = dynamic_cast<IGisProject*>(item);
     if (project) {
-      project->getItemsByKeys(keys, items);
+      if (keysProject.contains(project->getKey())) {
+        project->getItemsByKeys(keys, items);
+      }
       continue;
     }
     IDevice* device = dynamic_cast<IDevice*>(item);
@@ -407,6 +502,52 @@ void CGisWorkspace::getNogoAreas(QList<IGisItem*>& nogos) {
   }
 }
 
+void CGisWorkspace::getProjectNames(QList<QPair<QString, QString>>& projects) {
+  QMutexLocker lock(&IGisItem::mutexItems);
+  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
+    IGisProject* project = dynamic_cast<IGisProject*>(treeWks->topLevelItem(i));
+    if (project) {
+      projects << qMakePair(project->getKey(), project->getName());
+    }
+  }
+}
+
+bool CGisWorkspace::getProjectGeometry(const QString& key, QRectF& extent, QList<QPolygonF>& lines) {
+  QMutexLocker lock(&IGisItem::mutexItems);
+  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
+    IGisProject* project = dynamic_cast<IGisProject*>(treeWks->topLevelItem(i));
+    if ((project == nullptr) || (project->getKey() != key)) {
+      continue;
+    }
+
+    // a waypoint has an empty bounding rectangle, thus QRectF::united() can't be used
+    qreal west = NOFLOAT, east = -NOFLOAT, south = NOFLOAT, north = -NOFLOAT;
+    for (int n = 0; n < project->childCount(); n++) {
+      IGisItem* item = dynamic_cast<IGisItem*>(project->child(n));
+      if (item == nullptr) {
+        continue;
+      }
+
+      const QRectF& rect = item->getBoundingRect().normalized();
+      west = qMin(west, rect.left());
+      east = qMax(east, rect.right());
+      south = qMin(south, rect.top());
+      north = qMax(north, rect.bottom());
+
+      IGisLine* line = dynamic_cast<IGisLine*>(item);
+      if (line != nullptr) {
+        QPolygonF polyline;
+        line->getPolylineDegFromData(polyline);
+        lines << polyline;
+      }
+    }
+
+    extent = west <= east ? QRectF(QPointF(west, south) * RAD_TO_DEG, QPointF(east, north) * RAD_TO_DEG) : QRectF();
+    return true;
+  }
+  return false;
+}
+
 void CGisWorkspace::mouseMove(const QPointF& pos) {
   QMutexLocker lock(&IGisItem::mutexItems);
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
@@ -1099,7 +1240,7 @@ void CGisWorkspace::editPrxWpt(const QList<IGisItem::key_t>& keys) {
 
 void CGisWorkspace::draw(QPainter& p, const QPolygonF& viewport, CGisDraw* gis) {
   QFontMetricsF fm(CMainWindow::self().getMapFont());
-  QList<QRectF> blockedAreas;
+  COccupancyGrid blockedAreas;
 
   QMutexLocker lock(&IGisItem::mutexItems);
   // draw mandatory stuff first
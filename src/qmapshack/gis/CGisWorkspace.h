@@ -184,6 +184,15 @@ class CGisWorkspace : public QWidget, private Ui::IGisWorkspace {
   virtual ~CGisWorkspace();
 
   void loadGisProject(const QString& filename);
+  /**
+     @brief Load many files at once
+
+     The files are parsed in parallel by a CProjectLoader. The projects are added
+     to the workspace in the order of the files as soon as they are loaded.
+
+     @param filenames   the files to load
+   */
+  void loadGisProjects(const QStringList& filenames);
   /**
      @brief Draw all loaded data in the workspace that is visible
 
@@ -223,13 +232,14 @@ class CGisWorkspace : public QWidget, private Ui::IGisWorkspace {
 
      @param pos       the position in pixel
      @param items     an empty item list that will get filled with temporary pointers
+     @param gis       the draw context used to convert the position into the items' coordinates
    */
-  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items);
+  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items, CGisDraw* gis);
 
   /**
      @brief Get items matching the given area
 
-     @param area      a rectangle in screen pixel coordinates
+     @param area      a rectangle in [°]
      @param flags     flag field with IGisItem::selection_e flags set
      @param items     a list to receive the temporary pointers to the found items
    */
@@ -246,6 +256,23 @@ class CGisWorkspace : public QWidget, private Ui::IGisWorkspace {
 
   void getNogoAreas(QList<IGisItem*>& nogos);
 
+  /**
+     @brief Get the names of all projects in the workspace
+
+     @param projects  a list of (key, name) pairs
+   */
+  void getProjectNames(QList<QPair<QString, QString>>& projects);
+
+  /**
+     @brief Get the geometry of all items of a project
+
+     @param key       the project's key as returned by IGisProject::getKey()
+     @param extent    the bounding rectangle of all items as normalized rectangle in [°]
+     @param lines     receives the lines of all tracks and routes in [°]
+     @return False if there is no project with the key.
+   */
+  bool getProjectGeometry(const QString& key, QRectF& extent, QList<QPolygonF>& lines);
+
   /**
      @brief Delete all items with matching key from workspace
 
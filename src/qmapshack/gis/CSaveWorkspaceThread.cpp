@@ -0,0 +1,247 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/CSaveWorkspaceThread.h"
+
+#include <QtSql>
+
+#include "gis/db/macros.h"
+
+CSaveWorkspaceThread::CSaveWorkspaceThread(QSqlDatabase& db, QObject* parent) : QThread(parent), dbParent(db) {}
+
+CSaveWorkspaceThread::~CSaveWorkspaceThread() {
+  {
+    QMutexLocker lock(&mutex);
+    quit = true;
+    condition.wakeAll();
+  }
+  // a pending snapshot is still written before the thread terminates
+  wait();
+}
+
+static const CSaveWorkspaceThread::project_t* findData(const CSaveWorkspaceThread::snapshot_t& snapshot,
+                                                        const QString& key) {
+  for (const CSaveWorkspaceThread::project_t& project : snapshot.projects) {
+    if (project.key == key && !project.data.isEmpty()) {
+      return &project;
+    }
+  }
+  return nullptr;
+}
+
+// copy the data of projects from a snapshot not written to the ones without data in the next one
+static void takeOverData(const CSaveWorkspaceThread::snapshot_t& from, CSaveWorkspaceThread::snapshot_t& to) {
+  for (CSaveWorkspaceThread::project_t& project : to.projects) {
+    if (!project.data.isEmpty()) {
+      continue;
+    }
+    const CSaveWorkspaceThread::project_t* other = findData(from, project.key);
+    if (other != nullptr && other->fingerprint == project.fingerprint) {
+      project.data = other->data;
+    }
+  }
+}
+
+bool CSaveWorkspaceThread::isSaved(const QString& key, const QByteArray& fingerprint) const {
+  QMutexLocker lock(&mutex);
+  // the most recent data written for the project wins
+  const project_t* project = hasPending ? findData(pending, key) : nullptr;
+  if (project == nullptr && busy) {
+    project = findData(writing, key);
+  }
+  if (project != nullptr) {
+    return project->fingerprint == fingerprint;
+  }
+  return saved.value(key) == fingerprint;
+}
+
+void CSaveWorkspaceThread::setSaved(const QString& key, const QByteArray& fingerprint) {
+  QMutexLocker lock(&mutex);
+  saved[key] = fingerprint;
+}
+
+void CSaveWorkspaceThread::save(const snapshot_t& snapshot) {
+  QMutexLocker lock(&mutex);
+  snapshot_t next = snapshot;
+  if (hasPending) {
+    // projects not serialized as their data has been in the replaced snapshot
+    takeOverData(pending, next);
+  }
+  // the snapshot might have failed after the projects of the next one have been tested by isSaved()
+  takeOverData(failed, next);
+  failed = snapshot_t();
+  pending = next;
+  hasPending = true;
+  condition.wakeAll();
+
+  if (!isRunning()) {
+    start();
+  }
+}
+
+void CSaveWorkspaceThread::flush() {
+  QMutexLocker lock(&mutex);
+  while (hasPending || busy) {
+    condition.wait(&mutex);
+  }
+}
+
+void CSaveWorkspaceThread::run() {
+  {
+    /*
+        As database connections can't be shared between threads the database connection
+        has to be cloned
+     */
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(dbParent, "Workspace2");
+    if (db.open()) {
+      QSqlQuery query(db);
+      QUERY_RUN("PRAGMA locking_mode=EXCLUSIVE", NO_CMD)
+      QUERY_RUN("PRAGMA synchronous=OFF", NO_CMD)
+      QUERY_RUN("PRAGMA temp_store=MEMORY", NO_CMD)
+    } else {
+      qWarning() << "Failed to open workspace database:" << db.lastError();
+    }
+
+    QMutexLocker lock(&mutex);
+    while (true) {
+      while (!hasPending && !quit) {
+        condition.wait(&mutex);
+      }
+      if (!hasPending) {
+        break;
+      }
+
+      writing = pending;
+      pending = snapshot_t();
+      hasPending = false;
+      busy = true;
+
+      lock.unlock();
+      const bool success = db.isOpen() && write(writing, db);
+      lock.relock();
+
+      if (success) {
+        // the data of projects without data is in the database with the fingerprint they have been queued with
+        QHash<QString, QByteArray> fingerprints;
+        for (const project_t& project : writing.projects) {
+          fingerprints[project.key] = project.fingerprint;
+        }
+        saved = fingerprints;
+      } else {
+        // write all projects with the next snapshot
+        saved.clear();
+        if (hasPending) {
+          // projects not serialized as their data has been in the failed snapshot
+          takeOverData(writing, pending);
+        } else {
+          failed = writing;
+        }
+      }
+
+      writing = snapshot_t();
+      busy = false;
+      condition.wakeAll();
+    }
+
+    db.close();
+  }
+
+  QSqlDatabase::removeDatabase("Workspace2");
+}
+
+bool CSaveWorkspaceThread::write(const snapshot_t& snapshot, QSqlDatabase& db) {
+  QSqlQuery query(db);
+
+  QUERY_RUN("BEGIN TRANSACTION", return false)
+
+  try {
+    QSet<QString> keys;
+    for (const project_t& project : snapshot.projects) {
+      keys << project.key;
+    }
+
+    // remove projects closed since the last write, or all rows for a full write
+    QList<qint64> ids;
+    QUERY_RUN("SELECT id, keyqms FROM workspace", throw query.lastError().text())
+    while (query.next()) {
+      const QString& key = query.value(1).toString();
+      if (snapshot.keep.contains(key)) {
+        continue;
+      }
+      if (snapshot.full || !keys.contains(key)) {
+        ids << query.value(0).toLongLong();
+      }
+    }
+
+    for (qint64 id : ids) {
+      query.prepare("DELETE FROM workspace WHERE id=:id");
+      query.bindValue(":id", id);
+      QUERY_EXEC(throw query.lastError().text())
+    }
+
+    for (int pos = 0; pos < snapshot.projects.size(); pos++) {
+      const project_t& project = snapshot.projects[pos];
+
+      if (project.data.isEmpty()) {
+        query.prepare(
+            "UPDATE workspace SET name=:name, changed=:changed, visible=:visible, pos=:pos WHERE keyqms=:keyqms");
+        query.bindValue(":name", project.name);
+        query.bindValue(":changed", project.changed);
+        query.bindValue(":visible", project.visible);
+        query.bindValue(":pos", pos);
+        query.bindValue(":keyqms", project.key);
+        QUERY_EXEC(throw query.lastError().text())
+
+        if (query.numRowsAffected() != 1) {
+          throw QString("Project %1 is missing in the workspace database").arg(project.key);
+        }
+        continue;
+      }
+
+      if (!snapshot.full) {
+        query.prepare("DELETE FROM workspace WHERE keyqms=:keyqms");
+        query.bindValue(":keyqms", project.key);
+        QUERY_EXEC(throw query.lastError().text())
+      }
+
+      query.prepare(
+          "INSERT INTO workspace (type, keyqms, name, changed, visible, pos, data) VALUES (:type, :keyqms, :name, "
+          ":changed, :visible, :pos, :data)");
+      query.bindValue(":type", project.type);
+      query.bindValue(":keyqms", project.key);
+      query.bindValue(":name", project.name);
+      query.bindValue(":changed", project.changed);
+      query.bindValue(":visible", project.visible);
+      query.bindValue(":pos", pos);
+      query.bindValue(":data", project.data);
+      QUERY_EXEC(throw query.lastError().text())
+    }
+
+    query.prepare("UPDATE userfocus set focus=:focus");
+    query.bindValue(":focus", snapshot.userFocus);
+    QUERY_EXEC(throw query.lastError().text())
+
+    QUERY_RUN("COMMIT", throw query.lastError().text())
+  } catch (const QString& msg) {
+    qWarning() << "Failed to save workspace:" << msg;
+    QUERY_RUN("ROLLBACK", NO_CMD)
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,125 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CSAVEWORKSPACETHREAD_H
+#define CSAVEWORKSPACETHREAD_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QThread>
+#include <QWaitCondition>
+
+/**
+   @brief Write snapshots of the workspace to workspace.db
+
+   The snapshot is taken by the GUI thread. It contains the serialized data of
+   all projects changed since they have been written the last time. The data
+   of all other projects is already in the database. Their rows just get
+   updated.
+
+   A snapshot is written within a single transaction. If the transaction
+   fails the database is left as it has been after the last successful write.
+
+   The thread keeps its own connection to the database until it is destroyed.
+   As the workspace database is opened in exclusive locking mode any other
+   connection to the file has to be closed before the first snapshot is saved.
+ */
+class CSaveWorkspaceThread : public QThread {
+  Q_OBJECT
+ public:
+  struct project_t {
+    QString key;
+    qint32 type = 0;
+    QString name;
+    bool changed = false;
+    bool visible = true;
+    /// the MD5 hash of the project's data, see IGisProject::getFingerprint()
+    QByteArray fingerprint;
+    /// the serialized project, empty if the project has not changed since the last write
+    QByteArray data;
+  };
+
+  struct snapshot_t {
+    /// all projects in the order of the workspace
+    QList<project_t> projects;
+    QString userFocus;
+    /// replace all rows instead of updating them, all projects must have data
+    bool full = false;
+    /// the keys of rows to keep as they are, e.g. of projects not restored yet
+    QSet<QString> keep;
+  };
+
+  CSaveWorkspaceThread(QSqlDatabase& db, QObject* parent);
+  virtual ~CSaveWorkspaceThread();
+
+  /**
+     @brief Test if a project has to be serialized for the next snapshot
+
+     The data of a project is in the database after all queued snapshots have been
+     written if it is part of the snapshot waiting to be written, of the one being
+     written or already in the database. The data of a snapshot replaced or failed
+     to be written is passed on to the next one.
+
+     @param key           the project's key
+     @param fingerprint   the project's fingerprint, see IGisProject::getFingerprint()
+     @return True if the project's data will be in the database without being written again
+   */
+  bool isSaved(const QString& key, const QByteArray& fingerprint) const;
+  /// Mark a project's data as present in the database, e.g. after it has been loaded from it
+  void setSaved(const QString& key, const QByteArray& fingerprint);
+
+  /**
+     @brief Queue a snapshot to be written
+
+     A snapshot still waiting to be written is replaced by the new one.
+
+     @param snapshot  the snapshot taken by the GUI thread
+   */
+  void save(const snapshot_t& snapshot);
+
+  /// Block until all queued snapshots are written
+  void flush();
+
+ protected:
+  void run() override;
+
+ private:
+  bool write(const snapshot_t& snapshot, QSqlDatabase& db);
+
+  mutable QMutex mutex;
+  QWaitCondition condition;
+
+  /// database connection from the main thread
+  QSqlDatabase& dbParent;
+
+  snapshot_t pending;
+  /// the snapshot being written by the thread
+  snapshot_t writing;
+  /// the last snapshot failed to be written if there has been none queued to take over its data
+  snapshot_t failed;
+  bool hasPending = false;
+  bool busy = false;
+  bool quit = false;
+
+  /// the fingerprints of the projects as they are in the database
+  QHash<QString, QByteArray> saved;
+};
+
+#endif  // CSAVEWORKSPACETHREAD_H
@@ -0,0 +1,202 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/CWorkspaceLoader.h"
+
+#include <QtCore>
+
+#include "gis/CGisListDB.h"
+#include "gis/db/CDBProject.h"
+#include "gis/fit/CFitProject.h"
+#include "gis/gpx/CGpxProject.h"
+#include "gis/qlb/CQlbProject.h"
+#include "gis/qms/CQmsProject.h"
+#include "gis/slf/CSlfProject.h"
+#include "gis/suunto/CSmlProject.h"
+#include "gis/tcx/CTcxProject.h"
+#include "gis/trk/CGisItemTrk.h"
+
+CWorkspaceLoader::~CWorkspaceLoader() {
+  cancel();
+  threadPool.waitForDone();
+
+  for (qint32 n = next; n < results.size(); n++) {
+    delete results[n].project;
+  }
+}
+
+bool CWorkspaceLoader::isThreadSafe(const entry_t& entry) {
+  // A database project needs the database connection of the GUI thread. All other
+  // projects are created by name. The constructors read a file if the name is an
+  // existing file. This might show dialogs.
+  return (entry.type != IGisProject::eTypeDb) && !QFileInfo::exists(entry.name);
+}
+
+IGisProject* CWorkspaceLoader::restore(const entry_t& entry, CGisListWks* parent) {
+  QDataStream stream(entry.data);
+  stream.setVersion(QDataStream::Qt_5_2);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  const Qt::CheckState visible = entry.visible ? Qt::Checked : Qt::Unchecked;
+
+  // Hiding the individual projects from the map could be done after the switch within a single statement,
+  // but this results in a visible `the checkbox is being unchecked`, especially in case the project
+  // is large and takes some time to load.
+  // When done directly after construction there is no `blinking` of the check mark
+  IGisProject* project = nullptr;
+  switch (entry.type) {
+    case IGisProject::eTypeQms: {
+      project = new CQmsProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeQlb: {
+      project = new CQlbProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeGpx: {
+      project = new CGpxProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeDb: {
+      CDBProject* dbProject;
+      project = dbProject = new CDBProject(parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+
+      project->IGisProject::operator<<(stream);
+      dbProject->restoreDBLink();
+
+      if (!project->isValid()) {
+        delete project;
+        project = nullptr;
+      } else {
+        dbProject->postStatus(false);
+      }
+      break;
+    }
+
+    case IGisProject::eTypeSlf: {
+      // the CSlfProject does not - as the other C*Project - register itself in the list
+      // of currently opened projects. This has to be done by the caller.
+      project = new CSlfProject(entry.name, false);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeFit: {
+      project = new CFitProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeTcx: {
+      project = new CTcxProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeSml: {
+      project = new CSmlProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+
+    case IGisProject::eTypeLog: {
+      project = new CSmlProject(entry.name, parent);
+      project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+      *project << stream;
+      break;
+    }
+  }
+
+  return project;
+}
+
+void CWorkspaceLoader::add(const entry_t& entry) {
+  QMutexLocker lock(&mutex);
+
+  const qint32 idx = results.size();
+  result_t result;
+  result.entry = entry;
+  results << result;
+  done << !isThreadSafe(entry);
+
+  if (!done.last()) {
+    threadPool.start([this, idx]() { load(idx); });
+  }
+}
+
+qint32 CWorkspaceLoader::getCountInProgress() {
+  QMutexLocker lock(&mutex);
+  return results.size() - next;
+}
+
+bool CWorkspaceLoader::waitForDone(int msecs) { return threadPool.waitForDone(msecs); }
+
+QList<CWorkspaceLoader::result_t> CWorkspaceLoader::takeResults() {
+  QMutexLocker lock(&mutex);
+
+  QList<result_t> list;
+  while ((next < results.size()) && done[next]) {
+    list << results[next];
+    results[next] = result_t();
+    next++;
+  }
+  return list;
+}
+
+void CWorkspaceLoader::load(qint32 idx) {
+  entry_t entry;
+  {
+    QMutexLocker lock(&mutex);
+    entry = results[idx].entry;
+  }
+
+  IGisProject* project = nullptr;
+  const bool loaded = !canceled;
+  if (loaded) {
+    project = restore(entry, nullptr);
+  }
+
+  // CGisItemTrk::operator<< skips deriving the secondary data within a thread
+  const int N = project == nullptr ? 0 : project->childCount();
+  for (int i = 0; i < N; i++) {
+    CGisItemTrk* trk = dynamic_cast<CGisItemTrk*>(project->child(i));
+    if (trk != nullptr) {
+      trk->deriveSecondaryData();
+    }
+  }
+
+  QMutexLocker lock(&mutex);
+  results[idx].entry.data.clear();
+  results[idx].project = project;
+  results[idx].loaded = loaded;
+  done[idx] = true;
+}
@@ -0,0 +1,123 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CWORKSPACELOADER_H
+#define CWORKSPACELOADER_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+class CGisListWks;
+class IGisProject;
+
+/**
+   @brief Restore the projects stored in workspace.db in parallel
+
+   The rows of the workspace table are read by the GUI thread and passed to the
+   loader one by one. Each project is restored by a thread of the loader's thread
+   pool into a project without parent, like CProjectLoader does for files. This
+   includes the decompression of the items and the derivation of the secondary
+   data of all tracks.
+
+   The GUI thread collects the projects by takeResults() in the order of the rows
+   and adds them to the workspace. Projects that can't be restored by a thread
+   other than the GUI thread are passed as result without a project. They have to
+   be restored by the caller with restore().
+ */
+class CWorkspaceLoader {
+ public:
+  /// a row of the workspace table
+  struct entry_t {
+    qint32 type = 0;
+    QString key;
+    QString name;
+    bool changed = false;
+    bool visible = true;
+    QByteArray data;
+  };
+
+  struct result_t {
+    /// the row the project is restored from, the data is kept only if the project has not been restored yet
+    entry_t entry;
+    /// the restored project or nullptr if restoring failed or was not done
+    IGisProject* project = nullptr;
+    /// true if the project has been restored by the thread pool
+    bool loaded = false;
+  };
+
+  CWorkspaceLoader() = default;
+  /// cancel restoring and delete all projects not taken yet
+  virtual ~CWorkspaceLoader();
+
+  /// @return true if the project of that row can be restored by a thread other than the GUI thread
+  static bool isThreadSafe(const entry_t& entry);
+
+  /**
+     @brief Create a project from a row of the workspace table
+
+     @param entry     the row
+     @param parent    the workspace or nullptr for a project without parent
+     @return The project or nullptr if the project is invalid.
+   */
+  static IGisProject* restore(const entry_t& entry, CGisListWks* parent);
+
+  /// queue a row to be restored
+  void add(const entry_t& entry);
+
+  /// @return the number of rows added but not taken yet
+  qint32 getCountInProgress();
+
+  /**
+     @brief Wait for the thread pool to finish all rows added so far
+
+     @param msecs   the timeout in [ms]
+     @return True if all rows are done.
+   */
+  bool waitForDone(int msecs);
+
+  /**
+     @brief Take all results that are done and not taken yet
+
+     The results are passed in the order of the rows.
+
+     @return A list of results. The caller takes ownership of the projects.
+   */
+  QList<result_t> takeResults();
+
+  /// do not start to restore any further rows
+  void cancel() { canceled = 1; }
+
+ private:
+  void load(qint32 idx);
+
+  QThreadPool threadPool;
+  QAtomicInt canceled = 0;
+
+  QMutex mutex;
+  /// the results by index of the row, the data of the row is released as soon as it is done
+  QVector<result_t> results;
+  /// set true as soon as the result of the row's index is done
+  QVector<bool> done;
+  /// the index of the next result to take
+  qint32 next = 0;
+};
+
+#endif  // CWORKSPACELOADER_H
@@ -48,6 +48,8 @@ const QString IGisItem::noName = IGisItem::tr("[no name]");
 
 QVector<IGisItem::color_t> IGisItem::colorMap;
 
+IGisItem::compression_e IGisItem::compression = IGisItem::eCompressionFast;
+
 IGisItem::IGisItem(IGisProject* parent, type_e typ, int idx) : QTreeWidgetItem(parent, typ) {
   int n = -1;
   setFlags(QTreeWidgetItem::flags() & ~Qt::ItemIsDropEnabled);
@@ -58,6 +60,7 @@ IGisItem::IGisItem(IGisProject* parent, type_e typ, int idx) : QTreeWidgetItem(p
 
   key.project = parent->getKey();
   key.device = parent->getDeviceKey();
+  parent->invalidateIndex();
 
   if (idx >= 0) {
     parent->removeChild(this);
@@ -120,7 +123,10 @@ IGisItem::IGisItem(IGisProject* parent, type_e typ, int idx) : QTreeWidgetItem(p
   }
 }
 
-IGisItem::~IGisItem() {}
+IGisItem::~IGisItem() {
+  // the project's index refers to the item by its position in the list of children
+  invalidateIndex();
+}
 
 void IGisItem::init() {
   colorMap = {{"Black", tr("Black"), QColor(Qt::black), QString("://icons/8x8/bullet_black.png"),
@@ -196,6 +202,18 @@ QMenu* IGisItem::getColorMenu(const QString& title, QObject* obj, const char* sl
 
 IGisProject* IGisItem::getParentProject() const { return dynamic_cast<IGisProject*>(parent()); }
 
+/**
+   @brief Get the hash of a history event's data
+
+   The hash is taken from the uncompressed data. Thus it does not depend on
+   the compression selected by the user.
+ */
+static QString getHashOfData(const QByteArray& data) {
+  QCryptographicHash md5(QCryptographicHash::Md5);
+  md5.addData(IGisItem::getUncompressedData(data));
+  return md5.result().toHex();
+}
+
 void IGisItem::genKey() const {
   if (key.item.isEmpty()) {
     QByteArray buffer;
@@ -205,6 +223,11 @@ void IGisItem::genKey() const {
 
     *this >> stream;
 
+    // keys must not depend on the compression selected by the user
+    if (getCompression() != eCompressionBest) {
+      buffer = getCompressedData(buffer, eCompressionBest);
+    }
+
     QCryptographicHash md5(QCryptographicHash::Md5);
     md5.addData(buffer);
     key.item = md5.result().toHex();
@@ -244,6 +267,7 @@ void IGisItem::loadFromDb(quint64 id, QSqlDatabase& db) {
         key.item = keyFromDB;
         updateHistory();
       }
+      invalidateIndex();
     }
 
     lastDatabaseHash = query.value(2).toString();
@@ -379,9 +403,7 @@ void IGisItem::changed(const QString& what, const QString& icon) {
 
   *this >> stream;
 
-  QCryptographicHash md5(QCryptographicHash::Md5);
-  md5.addData(event.data);
-  event.hash = md5.result().toHex();
+  event.hash = getHashOfData(event.data);
 
   history.histIdxCurrent = history.events.size() - 1;
 
@@ -402,9 +424,7 @@ void IGisItem::updateHistory() {
 
   *this >> stream;
 
-  QCryptographicHash md5(QCryptographicHash::Md5);
-  md5.addData(event.data);
-  event.hash = md5.result().toHex();
+  event.hash = getHashOfData(event.data);
 
   updateDecoration(eMarkChanged, eMarkNone);
 }
@@ -441,9 +461,7 @@ void IGisItem::setupHistory() {
     stream.setVersion(QDataStream::Qt_5_2);
     *this >> stream;
 
-    QCryptographicHash md5(QCryptographicHash::Md5);
-    md5.addData(event.data);
-    event.hash = md5.result().toHex();
+    event.hash = getHashOfData(event.data);
 
     history.histIdxInitial = history.events.size() - 1;
   }
@@ -834,6 +852,19 @@ void IGisItem::setNogoFlag(bool yes) {
   } else {
     flags &= ~eFlagNogo;
   }
+  invalidateIndex();
+}
+
+void IGisItem::setBoundingRect(const QRectF& rect) {
+  boundingRect = rect;
+  invalidateIndex();
+}
+
+void IGisItem::invalidateIndex() {
+  IGisProject* project = getParentProject();
+  if (project != nullptr) {
+    project->invalidateIndex();
+  }
 }
 
 const QBrush& IGisItem::getNogoTextureBrush() {
@@ -36,6 +36,7 @@
 #include "units/IUnit.h"
 
 class CGisDraw;
+class COccupancyGrid;
 class IScrOpt;
 class IMouse;
 class QSqlDatabase;
@@ -313,6 +314,8 @@ class IGisItem : public QTreeWidgetItem {
      @return If no point can be found NOPOINTF is returned.
    */
   virtual bool isCloseTo(const QPointF& pos) = 0;
+  /// the largest distance in pixel isCloseTo() of any item type accepts
+  static constexpr qreal kCloseToTolerance = 22;
 
   virtual bool isWithin(const QRectF& area, selflags_t mode) = 0;
 
@@ -361,9 +364,9 @@ class IGisItem : public QTreeWidgetItem {
    */
   virtual bool setReadOnlyMode(bool readOnly);
 
-  virtual void drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) = 0;
+  virtual void drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) = 0;
   virtual void drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis) {}
-  virtual void drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, const QFontMetricsF& fm,
+  virtual void drawLabel(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, const QFontMetricsF& fm,
                          CGisDraw* gis) = 0;
   virtual void drawHighlight(QPainter& p) = 0;
 
@@ -515,6 +518,39 @@ class IGisItem : public QTreeWidgetItem {
 
   static const QVector<color_t>& getColorMap() { return colorMap; }
 
+  /// zlib levels selectable for the serialized data of items, all of them can be read by qUncompress()
+  enum compression_e { eCompressionNone = 0, eCompressionFast = 1, eCompressionBest = 9 };
+
+  /**
+     @brief Set the compression used by operator>> of all items
+
+     Serializing items is done for the history of each change, the workspace and
+     the GIS database. With large tracks the best compression makes these CPU bound.
+
+     @param level     the compression level
+   */
+  static void setCompression(compression_e level) { compression = level; }
+  static compression_e getCompression() { return compression; }
+
+  /**
+     @brief Get the data written by operator>> with the payload compressed by another level
+
+     @param data      the data as written by operator>>
+     @param level     the compression level to use
+     @return The data as operator>> would have written it with the given compression.
+   */
+  static QByteArray getCompressedData(const QByteArray& data, compression_e level);
+
+  /**
+     @brief Get the data written by operator>> with the payload uncompressed
+
+     The result does not depend on the compression used. It can't be read by operator<<.
+
+     @param data      the data as written by operator>>
+     @return The magic, the version and the uncompressed payload.
+   */
+  static QByteArray getUncompressedData(const QByteArray& data);
+
   virtual const searchValue_t getValueByKeyword(searchProperty_e keyword) = 0;
 
   qreal getRating() const;
@@ -552,6 +588,10 @@ class IGisItem : public QTreeWidgetItem {
   bool isVisible(const QPointF& point, const QPolygonF& viewport, CGisDraw* gis);
   bool isWithin(const QRectF& area, selflags_t flags, const QPolygonF& points);
   void setNogoFlag(bool yes);
+  /// set the dimensions of the item and tell the parent project to update its index
+  void setBoundingRect(const QRectF& rect);
+  /// tell the parent project to update its index of item positions and keys
+  void invalidateIndex();
 
   /**
      @brief Converts a string with HTML tags to a string without HTML depending on the device
@@ -586,6 +626,7 @@ class IGisItem : public QTreeWidgetItem {
   };
 
   static QVector<color_t> colorMap;
+  static compression_e compression;
 
   /// labeling the GisItems
   qreal rating = 0;
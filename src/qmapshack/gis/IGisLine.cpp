@@ -38,15 +38,28 @@ SGisLine::SGisLine(const QPolygonF& line) {
 }
 
 void SGisLine::updateElevation(CDemDraw* dem) {
+  // query all points and subpoints at once
+  QPolygonF pos;
+  for (const IGisLine::point_t& pt : *this) {
+    pos << pt.coord;
+    for (const IGisLine::subpt_t& sub : pt.subpts) {
+      pos << sub.coord;
+    }
+  }
+
+  QPolygonF ele(pos.size());
+  dem->getElevationAt(pos, ele);
+
+  int idx = 0;
   for (int i = 0; i < size(); i++) {
     IGisLine::point_t& pt = (*this)[i];
-    qreal ele = dem->getElevationAt(pt.coord);
-    pt.ele = (ele == NOFLOAT) ? NOINT : qRound(ele);
+    pt.ele = (ele[idx].y() == NOFLOAT) ? NOINT : qRound(ele[idx].y());
+    idx++;
 
     for (int n = 0; n < pt.subpts.size(); n++) {
       IGisLine::subpt_t& sub = pt.subpts[n];
-      qreal ele = dem->getElevationAt(sub.coord);
-      sub.ele = (ele == NOFLOAT) ? NOINT : qRound(ele);
+      sub.ele = (ele[idx].y() == NOFLOAT) ? NOINT : qRound(ele[idx].y());
+      idx++;
     }
   }
 }
@@ -24,11 +24,16 @@
 
 #include "config.h"
 #include "gis/CGisWorkspace.h"
+#include "gis/IGisItem.h"
 #include "helpers/CSettings.h"
 
 CSetupWorkspace::CSetupWorkspace(CGisWorkspace* workspace, QWidget* parent) : QDialog(parent), workspace(workspace) {
   setupUi(this);
 
+  comboCompression->addItem(tr("none"), IGisItem::eCompressionNone);
+  comboCompression->addItem(tr("fast"), IGisItem::eCompressionFast);
+  comboCompression->addItem(tr("best"), IGisItem::eCompressionBest);
+
   SETTINGS;
   cfg.beginGroup("Database");
   checkSaveOnExit->setChecked(cfg.value("saveOnExit", true).toBool());
@@ -36,6 +41,8 @@ CSetupWorkspace::CSetupWorkspace(CGisWorkspace* workspace, QWidget* parent) : QD
   checkDbUpdate->setChecked(cfg.value("listenUpdate", false).toBool());
   linePort->setText(cfg.value("port", "34123").toString());
   checkDeviceSupport->setChecked(cfg.value("device support", true).toBool());
+  const int idx = comboCompression->findData(cfg.value("compression", IGisItem::eCompressionFast).toInt());
+  comboCompression->setCurrentIndex(idx < 0 ? 1 : idx);
   cfg.endGroup();
 
   checkShowTags->setChecked(!workspace->areTagsHidden());
@@ -53,6 +60,7 @@ void CSetupWorkspace::accept() {
   cfg.setValue("listenUpdate", checkDbUpdate->isChecked());
   cfg.setValue("port", linePort->text());
   cfg.setValue("device support", checkDeviceSupport->isChecked());
+  cfg.setValue("compression", comboCompression->currentData());
   cfg.endGroup();
 
   workspace->setTagsHidden(!checkShowTags->isChecked());
@@ -45,7 +45,8 @@ void CFitProject::loadFitFromFile(const QString& filename, bool showErrorMsg) {
   try {
     tryOpeningFitFile(filename);
   } catch (QString& errormsg) {
-    if (showErrorMsg) {
+    // no message box if loaded by the worker threads of CProjectLoader
+    if (showErrorMsg && (QThread::currentThread() == qApp->thread())) {
       QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
                             errormsg, QMessageBox::Abort);
     } else {
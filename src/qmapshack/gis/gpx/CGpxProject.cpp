@@ -71,8 +71,13 @@ void CGpxProject::loadGpx(const QString& filename) {
   try {
     loadGpx(filename, this);
   } catch (QString& errormsg) {
-    QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
-                          errormsg, QMessageBox::Abort);
+    // a project loaded by a worker thread must not show a message box
+    if (QThread::currentThread() == qApp->thread()) {
+      QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
+                            errormsg, QMessageBox::Abort);
+    } else {
+      qWarning() << "Failed to load file" << filename << ":" << errormsg;
+    }
     valid = false;
   }
 }
@@ -94,32 +99,35 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
     throw tr("Failed to open %1").arg(filename);
   }
 
-  // load file content to xml document
-  QDomDocument xml;
-  QString msg;
-  int line;
-  int column;
-  if (!xml.setContent(&file, false, &msg, &line, &column)) {
-    file.close();
-    throw tr("Failed to read: %1\nline %2, column %3:\n %4").arg(filename).arg(line).arg(column).arg(msg);
-  }
-  file.close();
+  QXmlStreamReader xml(&file);
+  // like QDomDocument::setContent() without namespace processing. Thus
+  // elements are identified by their qualified name, e.g. "gpxtpx:hr".
+  xml.setNamespaceProcessing(false);
+
+  auto throwOnError = [&]() {
+    if (xml.hasError()) {
+      throw tr("Failed to read: %1\nline %2, column %3:\n %4")
+          .arg(filename)
+          .arg(xml.lineNumber())
+          .arg(xml.columnNumber())
+          .arg(xml.errorString());
+    }
+  };
 
-  int N;
-  QDomElement xmlGpx = xml.documentElement();
-  if (xmlGpx.tagName() != "gpx") {
+  xml.readNextStartElement();
+  throwOnError();
+  if (xml.qualifiedName() != "gpx") {
     throw tr("Not a GPX file: %1").arg(filename);
   }
 
   // Read all attributes and find any registrations for actually known extensions.
   // This is used to properly detect valid .gpx files using uncommon namespaces.
-  QDomNamedNodeMap attributes = xmlGpx.attributes();
-  for (int i = 0; i < attributes.size(); ++i) {
+  const QXmlStreamAttributes& attributes = xml.attributes();
+  for (const QXmlStreamAttribute& att : attributes) {
     const QString xmlns("xmlns");
-    QDomAttr att = attributes.item(i).toAttr();
 
-    if (att.name().startsWith(xmlns + ":")) {
-      QString ns = att.name().mid(xmlns.length() + 1);
+    if (att.qualifiedName().startsWith(xmlns + ":")) {
+      QString ns = att.qualifiedName().mid(xmlns.length() + 1).toString();
 
       if (att.value() == gpxtpx_ns) {
         CKnownExtension::initGarminTPXv1(IUnit::self(), ns);
@@ -129,7 +137,37 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
     }
   }
 
-  const QDomElement& xmlExtension = xmlGpx.namedItem("extensions").toElement();
+  /*
+      The items are created after reading the whole file. The project's key is
+      stored at the end of the file, but it is needed to create the items.
+   */
+  QDomDocument doc;
+  QDomElement xmlMetadata;
+  QDomElement xmlExtension;
+  QList<QDomElement> xmlTrks;
+  QList<QVector<CTrackData::trkseg_t>> trkSegs;
+  QList<QDomElement> xmlRtes;
+  QList<QDomElement> xmlWpts;
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "trk") {
+      trkSegs << QVector<CTrackData::trkseg_t>();
+      xmlTrks << CGisItemTrk::readTrk(xml, doc, trkSegs.last());
+    } else if (tag == "rte") {
+      xmlRtes << readDom(xml, doc);
+    } else if (tag == "wpt") {
+      xmlWpts << readDom(xml, doc);
+    } else if (tag == "metadata") {
+      xmlMetadata = readDom(xml, doc);
+    } else if (tag == "extensions") {
+      xmlExtension = readDom(xml, doc);
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+  file.close();
+  throwOnError();
+
   if (xmlExtension.namedItem("ql:key").isElement()) {
     project->key = xmlExtension.namedItem("ql:key").toElement().text();
   }
@@ -151,7 +189,6 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
     project->invalidDataOk = bool(xmlExtension.namedItem("ql:invalidDataOk").toElement().text().toInt() != 0);
   }
 
-  const QDomNode& xmlMetadata = xmlGpx.namedItem("metadata");
   if (xmlMetadata.isElement()) {
     project->readMetadata(xmlMetadata, project->metadata);
   }
@@ -159,24 +196,15 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
   /** @note   If you change the order of the item types read you have to
               take care of the order enforced in IGisItem().
    */
-  const QDomNodeList& xmlTrks = xmlGpx.elementsByTagName("trk");
-  N = xmlTrks.count();
-  for (int n = 0; n < N; ++n) {
-    const QDomNode& xmlTrk = xmlTrks.item(n);
-    new CGisItemTrk(xmlTrk, project);
+  for (int n = 0; n < xmlTrks.size(); ++n) {
+    new CGisItemTrk(xmlTrks[n], trkSegs[n], project);
   }
 
-  const QDomNodeList& xmlRtes = xmlGpx.elementsByTagName("rte");
-  N = xmlRtes.count();
-  for (int n = 0; n < N; ++n) {
-    const QDomNode& xmlRte = xmlRtes.item(n);
+  for (const QDomElement& xmlRte : qAsConst(xmlRtes)) {
     new CGisItemRte(xmlRte, project);
   }
 
-  const QDomNodeList& xmlWpts = xmlGpx.elementsByTagName("wpt");
-  N = xmlWpts.count();
-  for (int n = 0; n < N; ++n) {
-    const QDomNode& xmlWpt = xmlWpts.item(n);
+  for (const QDomElement& xmlWpt : qAsConst(xmlWpts)) {
     CGisItemWpt* wpt = new CGisItemWpt(xmlWpt, project);
 
     /*
@@ -191,7 +219,7 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
   }
 
   const QDomNodeList& xmlAreas = xmlExtension.elementsByTagName("ql:area");
-  N = xmlAreas.count();
+  const int N = xmlAreas.count();
   for (int n = 0; n < N; ++n) {
     const QDomNode& xmlArea = xmlAreas.item(n);
     new CGisItemOvlArea(xmlArea, project);
@@ -203,6 +231,50 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
   project->valid = true;
 }
 
+QDomElement CGpxProject::readDom(QXmlStreamReader& xml, QDomDocument& doc) {
+  QDomElement elem = doc.createElement(xml.qualifiedName().toString());
+  const QXmlStreamAttributes& attributes = xml.attributes();
+  for (const QXmlStreamAttribute& att : attributes) {
+    elem.setAttribute(att.qualifiedName().toString(), att.value().toString());
+  }
+
+  // the stream may split text, e.g. at entities. Thus it is collected up to the next element.
+  QString text;
+  auto appendText = [&]() {
+    if (!text.trimmed().isEmpty()) {
+      elem.appendChild(doc.createTextNode(text));
+    }
+    text.clear();
+  };
+
+  while (!xml.atEnd()) {
+    switch (xml.readNext()) {
+      case QXmlStreamReader::StartElement:
+        appendText();
+        elem.appendChild(readDom(xml, doc));
+        break;
+
+      case QXmlStreamReader::Characters:
+        if (xml.isCDATA()) {
+          appendText();
+          elem.appendChild(doc.createCDATASection(xml.text().toString()));
+        } else {
+          text += xml.text();
+        }
+        break;
+
+      case QXmlStreamReader::EndElement:
+        appendText();
+        return elem;
+
+      default:
+        break;
+    }
+  }
+
+  return elem;
+}
+
 bool CGpxProject::saveAs(const QString& fn, IGisProject& project, bool strictGpx11) {
   QString _fn_ = fn;
   QFileInfo fi(_fn_);
@@ -23,6 +23,7 @@
 
 class CGisListWks;
 class CGisDraw;
+class QXmlStreamReader;
 
 class CGpxProject : public IGisProject {
   Q_DECLARE_TR_FUNCTIONS(CGpxProject)
@@ -40,8 +41,30 @@ class CGpxProject : public IGisProject {
 
   static bool saveAs(const QString& fn, IGisProject& project, bool strictGpx11);
 
+  /**
+     @brief Load a GPX file into a project
+
+     The file is read as a stream. Track points, the bulk of most files, are decoded
+     directly from the stream. All other elements are small. They are copied into a
+     DOM and read by the DOM based code.
+
+     @param filename  the file to load
+     @param project   the project to add the items to
+   */
   static void loadGpx(const QString& filename, CGpxProject* project);
 
+  /**
+     @brief Copy the current element of a stream with all its children into a DOM
+
+     Like QDomDocument::setContent() whitespace only text is dropped. The stream
+     is left at the element's end.
+
+     @param xml   the stream positioned at the start of an element
+     @param doc   the document to create the nodes with
+     @return The element.
+   */
+  static QDomElement readDom(QXmlStreamReader& xml, QDomDocument& doc);
+
  private:
   void loadGpx(const QString& filename);
 };
@@ -20,6 +20,7 @@
 #include <QtXml>
 
 #include "device/CDeviceGarmin.h"
+#include "gis/gpx/CGpxProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/IGisProject.h"
 #include "gis/rte/CGisItemRte.h"
@@ -331,6 +332,177 @@ static void writeXml(QDomNode& ext, const QHash<QString, QVariant>& extensions)
   }
 }
 
+// The functions below read the current element of a stream like the ones above read
+// a named child of a DOM node. The stream is left at the end of the element.
+
+static inline QString readText(QXmlStreamReader& xml) {
+  // like QDomElement::text() including the text of all child elements
+  return xml.readElementText(QXmlStreamReader::IncludeChildElements);
+}
+
+static void readXml(QXmlStreamReader& xml, qint32& value) {
+  const QString& text = readText(xml);
+  bool ok = false;
+  qint32 tmp = text.toInt(&ok);
+  if (!ok) {
+    tmp = qRound(text.toDouble(&ok));
+  }
+  if (ok) {
+    value = tmp;
+  }
+}
+
+static void readXml(QXmlStreamReader& xml, QString& value) { value = readText(xml); }
+
+static void readXml(QXmlStreamReader& xml, QDateTime& value) { IUnit::parseTimestamp(readText(xml), value); }
+
+static void readXml(QXmlStreamReader& xml, IGisItem::link_t& link) {
+  link.uri.setUrl(xml.attributes().value("href").toString());
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "text") {
+      readXml(xml, link.text);
+    } else if (tag == "type") {
+      readXml(xml, link.type);
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+}
+
+static void readXml(QXmlStreamReader& xml, const QString& parentTags, QHash<QString, QVariant>& extensions) {
+  const QString& tag = xml.qualifiedName().toString();
+  if ((tag.left(8) == "ql:flags") || (tag.left(11) == "ql:activity")) {
+    xml.skipCurrentElement();
+    return;
+  }
+
+  // Like the DOM based reader: if the first child is text, the element is a value. Else
+  // its child elements are read. Whitespace only text is no child, like in the DOM.
+  enum content_e { eContentUnknown, eContentValue, eContentElements };
+  content_e content = eContentUnknown;
+
+  const QString& tags = parentTags.isEmpty() ? tag : parentTags + "|" + tag;
+  QString text;
+  while (!xml.atEnd()) {
+    const QXmlStreamReader::TokenType token = xml.readNext();
+    if (token == QXmlStreamReader::EndElement) {
+      break;
+    }
+
+    if (token == QXmlStreamReader::Characters) {
+      if (content != eContentElements) {
+        text += xml.text();
+      }
+    } else if (token == QXmlStreamReader::StartElement) {
+      if (content == eContentUnknown) {
+        content = text.trimmed().isEmpty() ? eContentElements : eContentValue;
+      }
+
+      if (content == eContentValue) {
+        text += readText(xml);
+      } else {
+        readXml(xml, tags, extensions);
+      }
+    }
+  }
+
+  if ((content == eContentValue) || ((content == eContentUnknown) && !text.trimmed().isEmpty())) {
+    extensions[tags] = text;
+  }
+}
+
+static void readTrkptExt(QXmlStreamReader& xml, CTrackData::trkpt_t& trkpt) {
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "ql:flags") {
+      bool ok = false;
+      const quint32 tmp = readText(xml).toUInt(&ok);
+      if (ok) {
+        trkpt.flags = tmp;
+      }
+    } else if (tag == "ql:activity") {
+      bool ok = false;
+      const qint32 tmp = readText(xml).toInt(&ok);
+      trkpt.activity = ok ? trkact_t(tmp) : CTrackData::trkpt_t::eAct20None;
+    } else {
+      readXml(xml, "", trkpt.extensions);
+    }
+  }
+
+  trkpt.sanitizeFlags();
+  trkpt.extensions.squeeze();
+}
+
+static void readTrkpt(QXmlStreamReader& xml, CTrackData::trkpt_t& trkpt) {
+  const QXmlStreamAttributes& attr = xml.attributes();
+  trkpt.lat = attr.value("lat").toDouble();
+  trkpt.lon = attr.value("lon").toDouble();
+
+  // some GPX 1.0 backward compatibility
+  QString url;
+  QString urlname;
+
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "ele") {
+      readXml(xml, trkpt.ele);
+    } else if (tag == "time") {
+      readXml(xml, trkpt.time);
+    } else if (tag == "extensions") {
+      readTrkptExt(xml, trkpt);
+    } else if (tag == "magvar") {
+      readXml(xml, trkpt.magvar);
+    } else if (tag == "geoidheight") {
+      readXml(xml, trkpt.geoidheight);
+    } else if (tag == "name") {
+      readXml(xml, trkpt.name);
+    } else if (tag == "cmt") {
+      readXml(xml, trkpt.cmt);
+    } else if (tag == "desc") {
+      readXml(xml, trkpt.desc);
+    } else if (tag == "src") {
+      readXml(xml, trkpt.src);
+    } else if (tag == "link") {
+      IGisItem::link_t link;
+      readXml(xml, link);
+      trkpt.links << link;
+    } else if (tag == "sym") {
+      readXml(xml, trkpt.sym);
+    } else if (tag == "type") {
+      readXml(xml, trkpt.type);
+    } else if (tag == "fix") {
+      readXml(xml, trkpt.fix);
+    } else if (tag == "sat") {
+      readXml(xml, trkpt.sat);
+    } else if (tag == "hdop") {
+      readXml(xml, trkpt.hdop);
+    } else if (tag == "vdop") {
+      readXml(xml, trkpt.vdop);
+    } else if (tag == "pdop") {
+      readXml(xml, trkpt.pdop);
+    } else if (tag == "ageofdgpsdata") {
+      readXml(xml, trkpt.ageofdgpsdata);
+    } else if (tag == "dgpsid") {
+      readXml(xml, trkpt.dgpsid);
+    } else if (tag == "url") {
+      readXml(xml, url);
+    } else if (tag == "urlname") {
+      readXml(xml, urlname);
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+
+  if (!url.isEmpty()) {
+    IGisItem::link_t link;
+    link.uri.setUrl(url);
+    link.text = urlname;
+
+    trkpt.links << link;
+  }
+}
+
 void IGisProject::readMetadata(const QDomNode& xml, metadata_t& metadata) {
   readXml(xml, "name", metadata.name);
   readXml(xml, "desc", metadata.desc);
@@ -660,13 +832,7 @@ void CGisItemWpt::writeGcExt(QDomNode& xmlCache) {
 }
 
 void CGisItemTrk::readTrk(const QDomNode& xml, CTrackData& trk) {
-  readXml(xml, "name", trk.name);
-  readXml(xml, "cmt", trk.cmt);
-  readXml(xml, "desc", trk.desc);
-  readXml(xml, "src", trk.src);
-  readXml(xml, "link", trk.links);
-  readXml(xml, "number", trk.number);
-  readXml(xml, "type", trk.type);
+  readTrkHead(xml, trk);
 
   const QDomNodeList& trksegs = xml.toElement().elementsByTagName("trkseg");
   int N = trksegs.count();
@@ -693,6 +859,42 @@ void CGisItemTrk::readTrk(const QDomNode& xml, CTrackData& trk) {
     }
   }
 
+  deriveSecondaryData();
+}
+
+QDomElement CGisItemTrk::readTrk(QXmlStreamReader& xml, QDomDocument& doc, QVector<CTrackData::trkseg_t>& segs) {
+  QDomElement xmlTrk = doc.createElement("trk");
+
+  while (xml.readNextStartElement()) {
+    if (xml.qualifiedName() != "trkseg") {
+      xmlTrk.appendChild(CGpxProject::readDom(xml, doc));
+      continue;
+    }
+
+    segs.append(CTrackData::trkseg_t());
+    CTrackData::trkseg_t& seg = segs.last();
+    while (xml.readNextStartElement()) {
+      if (xml.qualifiedName() == "trkpt") {
+        seg.pts.append(CTrackData::trkpt_t());
+        readTrkpt(xml, seg.pts.last());
+      } else {
+        xml.skipCurrentElement();
+      }
+    }
+  }
+
+  return xmlTrk;
+}
+
+void CGisItemTrk::readTrkHead(const QDomNode& xml, CTrackData& trk) {
+  readXml(xml, "name", trk.name);
+  readXml(xml, "cmt", trk.cmt);
+  readXml(xml, "desc", trk.desc);
+  readXml(xml, "src", trk.src);
+  readXml(xml, "link", trk.links);
+  readXml(xml, "number", trk.number);
+  readXml(xml, "type", trk.type);
+
   // decode some well known extensions
   const QDomNode& ext = xml.namedItem("extensions");
   if (ext.isElement()) {
@@ -704,8 +906,6 @@ void CGisItemTrk::readTrk(const QDomNode& xml, CTrackData& trk) {
     readXml(gpxx, "gpxx:DisplayColor", trk.color);
     setColor(str2color(trk.color));
   }
-
-  deriveSecondaryData();
 }
 
 void CGisItemTrk::save(QDomNode& gpx, bool strictGpx11) {
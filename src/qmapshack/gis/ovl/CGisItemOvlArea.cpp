@@ -29,6 +29,7 @@
 #include "gis/prj/IGisProject.h"
 #include "gis/proj_x.h"
 #include "helpers/CDraw.h"
+#include "helpers/COccupancyGrid.h"
 
 #define DEFAULT_COLOR 4
 #define MIN_DIST_CLOSE_TO 10
@@ -200,7 +201,8 @@ void CGisItemOvlArea::deriveSecondaryData() {
     }
   }
 
-  boundingRect = QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD));
+  setBoundingRect(
+      QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD)));
 
   QPolygonF line(area.pts.size());
   for (int i = 1; i < area.pts.size(); i++) {
@@ -228,7 +230,8 @@ void CGisItemOvlArea::deriveSecondaryData() {
   area.area = qAbs(area.area / 2);
 }
 
-void CGisItemOvlArea::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& /*blockedAreas*/, CGisDraw* gis) {
+void CGisItemOvlArea::drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& /*blockedAreas*/,
+                               CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
 
   polygonArea.clear();
@@ -272,7 +275,7 @@ void CGisItemOvlArea::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRe
   p.restore();
 }
 
-void CGisItemOvlArea::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, QList<QRectF>& blockedAreas,
+void CGisItemOvlArea::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, COccupancyGrid& blockedAreas,
                                 const QFontMetricsF& fm, CGisDraw* /*gis*/) {
   QMutexLocker lock(&mutexItems);
 
@@ -0,0 +1,89 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/prj/CProjectLoader.h"
+
+#include <QtCore>
+
+#include "gis/prj/IGisProject.h"
+
+CProjectLoader::CProjectLoader(const QStringList& filenames) {
+  const qint32 N = filenames.size();
+  results.resize(N);
+  done.resize(N);
+
+  for (qint32 n = 0; n < N; n++) {
+    results[n].filename = filenames[n];
+    done[n] = !isThreadSafe(filenames[n]);
+  }
+
+  for (qint32 n = 0; n < N; n++) {
+    if (!done.at(n)) {
+      threadPool.start([this, n]() { load(n); });
+    }
+  }
+}
+
+CProjectLoader::~CProjectLoader() {
+  cancel();
+  threadPool.waitForDone();
+
+  for (qint32 n = next; n < results.size(); n++) {
+    delete results[n].project;
+  }
+}
+
+bool CProjectLoader::isThreadSafe(const QString& filename) {
+  // These file types show no dialogs while loading and do not rely on any parent. All
+  // other types are loaded by the GUI thread as before.
+  static const QSet<QString> suffixes = {"gpx", "fit", "tcx", "slf"};
+  return suffixes.contains(QFileInfo(filename).suffix().toLower());
+}
+
+bool CProjectLoader::waitForDone(int msecs) { return threadPool.waitForDone(msecs); }
+
+QList<CProjectLoader::result_t> CProjectLoader::takeResults() {
+  QMutexLocker lock(&mutex);
+
+  QList<result_t> list;
+  while ((next < results.size()) && done[next]) {
+    list << results[next];
+    results[next].project = nullptr;
+    next++;
+  }
+  return list;
+}
+
+void CProjectLoader::load(qint32 idx) {
+  QString filename;
+  {
+    QMutexLocker lock(&mutex);
+    filename = results[idx].filename;
+  }
+
+  IGisProject* project = nullptr;
+  const bool loaded = !canceled;
+  if (loaded) {
+    project = IGisProject::create(filename, nullptr);
+  }
+
+  QMutexLocker lock(&mutex);
+  results[idx].project = project;
+  results[idx].loaded = loaded;
+  done[idx] = true;
+}
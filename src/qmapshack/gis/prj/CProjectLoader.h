@@ -0,0 +1,96 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CPROJECTLOADER_H
+#define CPROJECTLOADER_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+class IGisProject;
+
+/**
+   @brief Load many project files in parallel
+
+   Each file is parsed by a thread of the loader's thread pool into a project
+   without parent. Thus the project is not part of the workspace and can be
+   created without locking the workspace. This includes the derivation of the
+   secondary data of all tracks.
+
+   The thread that owns the loader collects the projects by takeResults() in the
+   order of the files and adds them to the workspace. File types not safe to be
+   parsed by a thread other than the GUI thread are passed as result without a
+   project. They have to be loaded by the caller.
+ */
+class CProjectLoader {
+ public:
+  struct result_t {
+    QString filename;
+    /// the loaded project or nullptr if loading failed or was not done
+    IGisProject* project = nullptr;
+    /// true if the file has been loaded by the thread pool
+    bool loaded = false;
+  };
+
+  CProjectLoader(const QStringList& filenames);
+  /// cancel loading and delete all projects not taken yet
+  virtual ~CProjectLoader();
+
+  /// @return true if a file of that type can be loaded by a thread other than the GUI thread
+  static bool isThreadSafe(const QString& filename);
+
+  /**
+     @brief Wait for the thread pool to finish all files
+
+     @param msecs   the timeout in [ms]
+     @return True if all files are done.
+   */
+  bool waitForDone(int msecs);
+
+  /**
+     @brief Take all results that are done and not taken yet
+
+     The results are passed in the order of the files. Thus a file taking long
+     to load will block the results of the following files until it is done.
+
+     @return A list of results. The caller takes ownership of the projects.
+   */
+  QList<result_t> takeResults();
+
+  /// do not start to load any further files
+  void cancel() { canceled = 1; }
+
+ private:
+  void load(qint32 idx);
+
+  QThreadPool threadPool;
+  QAtomicInt canceled = 0;
+
+  QMutex mutex;
+  /// the results by index of the file
+  QVector<result_t> results;
+  /// set true as soon as the result of the file's index is done
+  QVector<bool> done;
+  /// the index of the next result to take
+  qint32 next = 0;
+};
+
+#endif  // CPROJECTLOADER_H
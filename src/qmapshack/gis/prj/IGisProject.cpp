@@ -21,6 +21,7 @@
 #include "gis/prj/IGisProject.h"
 
 #include <QtWidgets>
+#include <numeric>
 
 #include "CMainWindow.h"
 #include "device/IDevice.h"
@@ -32,6 +33,7 @@
 #include "gis/gpx/CGpxProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/CDetailsPrj.h"
+#include "gis/proj_x.h"
 #include "gis/qlb/CQlbProject.h"
 #include "gis/qms/CQmsProject.h"
 #include "gis/rte/CGisItemRte.h"
@@ -304,12 +306,20 @@ void IGisProject::updateItems() {
     return;
   }
 
-  if (!changedRoadbookMode) {
+  if (!changedRoadbookMode && !pendingCorrelation) {
     if ((hashTrkWpt[0] == hashTrkWpt[1]) || (getItemCountByType(IGisItem::eTypeTrk) == 0)) {
       return;
     }
   }
+
+  // The correlation uses a progress dialog. If the project is loaded by a worker
+  // thread the correlation is postponed to the next update by the GUI thread.
+  if (QThread::currentThread() != qApp->thread()) {
+    pendingCorrelation = true;
+    return;
+  }
   changedRoadbookMode = false;
+  pendingCorrelation = false;
 
   quint32 total = cntTrkPts * cntWpts;
   quint32 current = 0;
@@ -444,6 +454,36 @@ void IGisProject::markAsSaved() {
   }
 }
 
+QByteArray IGisProject::getFingerprint() const {
+  QByteArray buffer;
+  QDataStream stream(&buffer, QIODevice::WriteOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+
+  writeHeader(stream);
+
+  for (int i = 0; i < childCount(); i++) {
+    IGisItem* item = dynamic_cast<IGisItem*>(child(i));
+    if (nullptr == item) {
+      continue;
+    }
+
+    const IGisItem::history_t& history = item->getHistory();
+    stream << quint8(item->type());
+    stream << item->getKey().item;
+    stream << history.histIdxInitial;
+    stream << history.histIdxCurrent;
+    // the data of an event is replaced by an empty array when the history is cut
+    for (const IGisItem::history_event_t& event : history.events) {
+      stream << event.hash << qint32(event.data.size());
+    }
+    stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
+    stream << item->getLastDatabaseHash();
+  }
+
+  return QCryptographicHash::hash(buffer, QCryptographicHash::Md5);
+}
+
 QString IGisProject::getName() const { return metadata.name; }
 
 QString IGisProject::getNameEx() const {
@@ -495,38 +535,58 @@ QString IGisProject::getInfo() const {
 }
 
 IGisItem* IGisProject::getItemByKey(const IGisItem::key_t& key) {
-  for (int i = 0; i < childCount(); i++) {
-    IGisItem* item = dynamic_cast<IGisItem*>(child(i));
-    if (nullptr == item) {
-      continue;
-    }
+  qint32 i;
+  {
+    QMutexLocker lock(&mutexIndex);
+    updateIndex();
+    i = indexKeys.value(key.item, -1);
+  }
 
-    if (item->getKey() == key) {
-      return item;
-    }
+  IGisItem* item = dynamic_cast<IGisItem*>(child(i));
+  if ((nullptr == item) || (item->getKey() != key)) {
+    return nullptr;
   }
-  return nullptr;
+  return item;
 }
 
 void IGisProject::getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items) {
-  for (int i = 0; i < childCount(); i++) {
-    IGisItem* item = dynamic_cast<IGisItem*>(child(i));
-    if (nullptr == item) {
+  QMutexLocker lock(&mutexIndex);
+  updateIndex();
+
+  QVector<qint32> found;
+  for (const IGisItem::key_t& key : keys) {
+    if (key.project != getKey()) {
       continue;
     }
 
-    if (keys.contains(item->getKey())) {
-      items << item;
+    const qint32 i = indexKeys.value(key.item, -1);
+    IGisItem* item = dynamic_cast<IGisItem*>(child(i));
+    if ((nullptr != item) && (item->getKey() == key)) {
+      found << i;
     }
   }
+
+  std::sort(found.begin(), found.end());
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+  for (qint32 i : qAsConst(found)) {
+    items << dynamic_cast<IGisItem*>(child(i));
+  }
 }
 
-void IGisProject::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
+void IGisProject::getItemsByPos(const QPointF& pos, const QRectF& area, QList<IGisItem*>& items) {
   if (!isVisible()) {
     return;
   }
 
-  for (int i = 0; i < childCount(); i++) {
+  QVector<qint32> candidates;
+  {
+    QMutexLocker lock(&mutexIndex);
+    updateIndex();
+    index.query(area, candidates);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (qint32 i : qAsConst(candidates)) {
     IGisItem* item = dynamic_cast<IGisItem*>(child(i));
     if (nullptr == item || item->isHidden()) {
       continue;
@@ -543,7 +603,15 @@ void IGisProject::getItemsByArea(const QRectF& area, IGisItem::selflags_t flags,
     return;
   }
 
-  for (int i = 0; i < childCount(); i++) {
+  QVector<qint32> candidates;
+  {
+    QMutexLocker lock(&mutexIndex);
+    updateIndex();
+    index.query(QRectF(area.topLeft() * DEG_TO_RAD, area.bottomRight() * DEG_TO_RAD), candidates);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (qint32 i : qAsConst(candidates)) {
     IGisItem* item = dynamic_cast<IGisItem*>(child(i));
     if (nullptr == item || item->isHidden()) {
       continue;
@@ -560,7 +628,14 @@ void IGisProject::getNogoAreas(QList<IGisItem*>& nogos) const {
     return;
   }
 
-  for (int i = 0; i < childCount(); i++) {
+  QVector<qint32> candidates;
+  {
+    QMutexLocker lock(&mutexIndex);
+    updateIndex();
+    candidates = indexNogos;
+  }
+
+  for (qint32 i : qAsConst(candidates)) {
     IGisItem* item = dynamic_cast<IGisItem*>(child(i));
     if (item != nullptr && !item->isHidden() && item->isNogo()) {
       nogos << item;
@@ -568,6 +643,87 @@ void IGisProject::getNogoAreas(QList<IGisItem*>& nogos) const {
   }
 }
 
+bool IGisProject::updateIndex() const {
+  /*
+      Take the generation before building the index. If an item changes while
+      the index is built the generation is incremented and the index is rebuilt
+      by the next query.
+   */
+  const qint32 generation = indexGeneration.loadAcquire();
+  if (generation == indexGenerationBuilt) {
+    return false;
+  }
+
+  const int N = childCount();
+  QVector<QRectF> rects;
+  QVector<qint32> values;
+  rects.reserve(N);
+  values.reserve(N);
+  indexNogos.clear();
+  indexKeys.clear();
+  indexKeys.reserve(N);
+
+  for (int i = 0; i < N; i++) {
+    const IGisItem* item = dynamic_cast<const IGisItem*>(child(i));
+    if (item == nullptr) {
+      continue;
+    }
+
+    rects << item->getBoundingRect();
+    values << i;
+    if (item->isNogo()) {
+      indexNogos << i;
+    }
+    // keep the first one if a key is not unique
+    const QString& keyItem = item->getKey().item;
+    if (!indexKeys.contains(keyItem)) {
+      indexKeys.insert(keyItem, i);
+    }
+  }
+
+  index.build(rects, values);
+  indexGenerationBuilt = generation;
+  return true;
+}
+
+const QVector<qint32>& IGisProject::getItemsToDraw(const QPolygonF& viewport) {
+  /*
+      Items leaving the viewport have to be drawn once more. Otherwise they keep
+      their screen coordinates of the last draw and would still respond to the
+      mouse. If the index has been rebuilt the child indices of the last draw
+      are not valid anymore. Thus all items are drawn.
+   */
+  // the corners of the viewport might be outside the projection's valid area
+  const QRectF& area = viewport.boundingRect();
+  const bool valid = qIsFinite(area.left()) && qIsFinite(area.top()) && qIsFinite(area.width()) &&
+                     qIsFinite(area.height());
+
+  bool rebuilt;
+  QVector<qint32> candidates;
+  {
+    QMutexLocker lock(&mutexIndex);
+    rebuilt = updateIndex();
+    if (valid) {
+      index.query(area, candidates);
+    }
+  }
+
+  if (rebuilt || !valid) {
+    itemsToDraw.resize(childCount());
+    std::iota(itemsToDraw.begin(), itemsToDraw.end(), 0);
+    if (!valid) {
+      candidates = itemsToDraw;
+    }
+  } else {
+    itemsToDraw = itemsDrawn + candidates;
+    std::sort(itemsToDraw.begin(), itemsToDraw.end());
+    itemsToDraw.erase(std::unique(itemsToDraw.begin(), itemsToDraw.end()), itemsToDraw.end());
+  }
+
+  itemsDrawn = candidates;
+  return itemsToDraw;
+}
+
 void IGisProject::mouseMove(const QPointF& pos) {
   if (!isVisible()) {
     return;
@@ -584,51 +740,38 @@ void IGisProject::mouseMove(const QPointF& pos) {
 }
 
 bool IGisProject::delItemByKey(const IGisItem::key_t& key, QMessageBox::StandardButtons& last) {
-  for (int i = childCount(); i > 0; i--) {
-    IGisItem* item = dynamic_cast<IGisItem*>(child(i - 1));
-    if (nullptr == item) {
-      continue;
-    }
-
-    if (item->getKey() == key) {
-      if (last != QMessageBox::YesToAll) {
-        QString msg = tr("Are you sure you want to delete '%1' from project '%2'?")
-                          .arg(item->getName(), text(CGisListWks::eColumnName));
-        last = QMessageBox::question(CMainWindow::getBestWidgetForParent(), tr("Delete..."), msg,
-                                     QMessageBox::YesToAll | QMessageBox::Cancel | QMessageBox::Ok | QMessageBox::No,
-                                     QMessageBox::Ok);
-        if ((last == QMessageBox::No) || (last == QMessageBox::Cancel)) {
-          // as each item in the project has to be unique, we can stop searching.
-          return false;
-        }
-      }
-      delete item;
-
-      /*
-          Database projects are a bit different. Deleting an item does not really
-          mean the project is changed as the item is still stored in the database.
-       */
-      if (type != eTypeDb) {
-        setChanged();
-      }
+  IGisItem* item = getItemByKey(key);
+  if (nullptr == item) {
+    return false;
+  }
 
-      // as each item in the project has to be unique, we can stop searching.
-      return true;
+  if (last != QMessageBox::YesToAll) {
+    QString msg = tr("Are you sure you want to delete '%1' from project '%2'?")
+                      .arg(item->getName(), text(CGisListWks::eColumnName));
+    last = QMessageBox::question(CMainWindow::getBestWidgetForParent(), tr("Delete..."), msg,
+                                 QMessageBox::YesToAll | QMessageBox::Cancel | QMessageBox::Ok | QMessageBox::No,
+                                 QMessageBox::Ok);
+    if ((last == QMessageBox::No) || (last == QMessageBox::Cancel)) {
+      return false;
     }
   }
-  return false;
+  delete item;
+
+  /*
+      Database projects are a bit different. Deleting an item does not really
+      mean the project is changed as the item is still stored in the database.
+   */
+  if (type != eTypeDb) {
+    setChanged();
+  }
+
+  return true;
 }
 
 void IGisProject::editItemByKey(const IGisItem::key_t& key) {
-  for (int i = childCount(); i > 0; i--) {
-    IGisItem* item = dynamic_cast<IGisItem*>(child(i - 1));
-    if (nullptr == item) {
-      continue;
-    }
-
-    if (item->getKey() == key) {
-      item->edit();
-    }
+  IGisItem* item = getItemByKey(key);
+  if (nullptr != item) {
+    item->edit();
   }
 }
 
@@ -708,13 +851,15 @@ void IGisProject::insertCopyOfItem(IGisItem* item, int off, CSelectCopyAction::r
   }
 }
 
-void IGisProject::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
+void IGisProject::drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) {
   if (!isVisible()) {
     return;
   }
 
-  for (int i = 0; i < childCount(); i++) {
+  for (qint32 i : getItemsToDraw(viewport)) {
     if (gis->needsRedraw()) {
+      // make sure the items not drawn are drawn the next time
+      itemsDrawn = itemsToDraw;
       break;
     }
 
@@ -742,13 +887,14 @@ void IGisProject::drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis) {
   }
 }
 
-void IGisProject::drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas,
+void IGisProject::drawLabel(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas,
                             const QFontMetricsF& fm, CGisDraw* gis) {
   if (!isVisible()) {
     return;
   }
 
-  for (int i = 0; i < childCount(); i++) {
+  // the items of the last call to drawItem()
+  for (qint32 i : qAsConst(itemsToDraw)) {
     if (gis->needsRedraw()) {
       break;
     }
@@ -942,6 +1088,7 @@ void IGisProject::sortItems() {
   }
 
   addChildren(items);
+  invalidateIndex();
   if (projectFilter != nullptr) {
     projectFilter->showLineEdit(&projectSearch);
   }
@@ -20,14 +20,18 @@
 #ifndef IGISPROJECT_H
 #define IGISPROJECT_H
 
+#include <QAtomicInt>
 #include <QDebug>
+#include <QHash>
 #include <QMessageBox>
+#include <QMutex>
 #include <QPointer>
 #include <QTreeWidgetItem>
 
 #include "gis/IGisItem.h"
 #include "gis/search/CProjectFilterItem.h"
 #include "gis/search/CSearch.h"
+#include "helpers/CPackedRTree.h"
 #include "helpers/CSelectCopyAction.h"
 
 class CGisListWks;
@@ -253,12 +257,19 @@ class IGisProject : public QTreeWidgetItem {
    */
   virtual QString getInfo() const;
   /**
-     @brief Get a temporary pointer to the item with matching key
-     @param key
-     @return If no item is found 0 is returned.
+     @brief Find the item with matching key
+
+     @param key       the item's key as it is returned from IGisItem::getKey()
+     @return If no item is found nullptr is returned.
    */
   IGisItem* getItemByKey(const IGisItem::key_t& key);
 
+  /**
+     @brief Find all items with matching keys
+
+     @param keys      the keys of the items, keys of other projects are ignored
+     @param items     a list to receive the items in the order of the project
+   */
   void getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items);
   /**
      @brief Get a list of items that are close to a given pixel coordinate of the screen
@@ -266,14 +277,24 @@ class IGisProject : public QTreeWidgetItem {
      @note: The returned pointers are just for temporary use. Best you use them to get the item's key.
 
      @param pos       the coordinate on the screen in pixel
+     @param area      the area [rad] around pos that covers the hit test of all items
      @param items     a list the item's pointer is stored to.
    */
-  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items);
+  void getItemsByPos(const QPointF& pos, const QRectF& area, QList<IGisItem*>& items);
 
   void getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items);
 
   void getNogoAreas(QList<IGisItem*>& nogos) const;
 
+  /**
+     @brief Mark the spatial and key index of all items as outdated
+
+     The index is rebuilt by the next query. Call it whenever an item is added or
+     removed, the order of the items changes or the bounding rectangle or the key
+     of an item changes.
+   */
+  void invalidateIndex() { indexGeneration.ref(); }
+
   int getItemCountByType(IGisItem::type_e type) const { return cntItemsByType[type]; }
 
   qreal getTotalDistance() const { return totalDistance; }
@@ -360,8 +381,8 @@ class IGisProject : public QTreeWidgetItem {
    */
   bool isChanged() const;
 
-  void drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis);
-  void drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, const QFontMetricsF& fm,
+  void drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis);
+  void drawLabel(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, const QFontMetricsF& fm,
                  CGisDraw* gis);
   void drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis);
 
@@ -385,6 +406,18 @@ class IGisProject : public QTreeWidgetItem {
    */
   virtual QDataStream& operator>>(QDataStream& stream) const;
 
+  /**
+     @brief Get a fingerprint of the data serialized by operator>>
+
+     The history of the items is not hashed. The hashes of its events are used
+     instead. Thus the fingerprint is cheap compared to the serialization and
+     can be used to detect changes since the project has been serialized the
+     last time.
+
+     @return A MD5 hash.
+   */
+  QByteArray getFingerprint() const;
+
   /**
      @brief writeMetadata
      @param doc
@@ -455,6 +488,8 @@ class IGisProject : public QTreeWidgetItem {
 
  protected:
   void genKey() const;
+  /// serialize the project's header without the items
+  void writeHeader(QDataStream& stream) const;
   virtual void setupName(const QString& defaultName);
   void markAsSaved();
   void readMetadata(const QDomNode& xml, metadata_t& metadata);
@@ -462,6 +497,16 @@ class IGisProject : public QTreeWidgetItem {
   void updateItemCounters();
   void updateDecoration();
   void updateDecoration(bool saved);
+  /**
+     @brief Rebuild the spatial index if it is outdated
+
+     The caller has to lock mutexIndex and keep it locked while reading the index.
+
+     @return True if the index has been rebuilt.
+   */
+  bool updateIndex() const;
+  /// @return child indices of all items to be drawn for the viewport, in the order of the children
+  const QVector<qint32>& getItemsToDraw(const QPolygonF& viewport);
   void sortItems();
   void sortItems(QList<IGisItem*>& items) const;
 
@@ -499,6 +544,7 @@ class IGisProject : public QTreeWidgetItem {
   bool noUpdate = false;
   bool noCorrelation = false;
   bool changedRoadbookMode = false;
+  bool pendingCorrelation = false;    ///< the correlation has been skipped by a thread other than the GUI thread
   bool autoSave = false;              ///< flag to show if auto save is on or off
   bool autoSavePending = false;       ///< flag to show if auto save event has been sent. will be reset by save()
   bool invalidDataOk = false;         ///< if set invalid data in GIS items will not raise any dialog
@@ -528,6 +574,23 @@ class IGisProject : public QTreeWidgetItem {
   CSearch workspaceSearch = CSearch("");
 
   CProjectFilterItem* projectFilter = nullptr;
+
+  /// the bounding rectangles [rad] of all items by child index
+  mutable CPackedRTree<qint32> index;
+  /// child indices of all nogo items, updated with the index
+  mutable QVector<qint32> indexNogos;
+  /// child indices of all items by IGisItem::key_t::item, updated with the index
+  mutable QHash<QString, qint32> indexKeys;
+  /// incremented by invalidateIndex() from any thread
+  QAtomicInt indexGeneration = 0;
+  /// the generation the index has been built for
+  mutable qint32 indexGenerationBuilt = -1;
+  /// the index is queried by the GUI and the draw thread, serialize rebuilding and reading it
+  mutable QMutex mutexIndex;
+  /// child indices of all items in the viewport of the last call to drawItem()
+  QVector<qint32> itemsDrawn;
+  /// child indices of all items to pass to drawItem() and drawLabel()
+  QVector<qint32> itemsToDraw;
 };
 Q_DECLARE_METATYPE(IGisProject*)
 
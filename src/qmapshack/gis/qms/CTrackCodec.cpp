@@ -0,0 +1,615 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/qms/CTrackCodec.h"
+
+#include <QtCore>
+
+#define VER_TRKCODEC quint8(1)
+
+namespace {
+using trkpt_t = CTrackData::trkpt_t;
+
+/// the resolution of fixed point coordinates [1/°]
+constexpr qreal kScale = 1e9;
+
+/// the bits of the presence mask of a point
+enum field_e {
+  eFieldFlags = 0x00000001,
+  eFieldActivity = 0x00000002,
+  eFieldEle = 0x00000004,
+  eFieldTimeUtc = 0x00000008,
+  eFieldTimeOther = 0x00000010,
+  eFieldMagvar = 0x00000020,
+  eFieldGeoidheight = 0x00000040,
+  eFieldName = 0x00000080,
+  eFieldCmt = 0x00000100,
+  eFieldDesc = 0x00000200,
+  eFieldSrc = 0x00000400,
+  eFieldLinks = 0x00000800,
+  eFieldSym = 0x00001000,
+  eFieldType = 0x00002000,
+  eFieldFix = 0x00004000,
+  eFieldSat = 0x00008000,
+  eFieldHdop = 0x00010000,
+  eFieldVdop = 0x00020000,
+  eFieldPdop = 0x00040000,
+  eFieldAgeOfDgpsData = 0x00080000,
+  eFieldDgpsId = 0x00100000,
+  eFieldExtensions = 0x00200000
+};
+
+/// the type tags of extension values
+enum value_e { eValueString = 0, eValueDouble = 1, eValueInt = 2, eValueVariant = 3 };
+
+quint64 zigzag(qint64 value) { return (quint64(value) << 1) ^ quint64(value >> 63); }
+
+qint64 unzigzag(quint64 value) { return qint64(value >> 1) ^ -qint64(value & 1); }
+
+// deltas are calculated with unsigned arithmetic to wrap around instead of overflowing
+qint64 delta(qint64 value, qint64 prev) { return qint64(quint64(value) - quint64(prev)); }
+
+qint64 undelta(qint64 delta, qint64 prev) { return qint64(quint64(prev) + quint64(delta)); }
+
+class CWriter {
+ public:
+  void putVarint(quint64 value) {
+    while (value >= 0x80) {
+      data.append(char(value | 0x80));
+      value >>= 7;
+    }
+    data.append(char(value));
+  }
+
+  void putZigzag(qint64 value) { putVarint(zigzag(value)); }
+
+  void putDouble(qreal value) {
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    char buffer[sizeof(bits)];
+    qToLittleEndian(bits, buffer);
+    data.append(buffer, sizeof(buffer));
+  }
+
+  void putBytes(const QByteArray& bytes) {
+    putVarint(bytes.size());
+    data.append(bytes);
+  }
+
+  /**
+     @brief Write a coordinate as fixed point delta or as raw double
+
+     The LSB of the first varint tells the two apart.
+   */
+  void putCoord(qreal value, qint64& prev) {
+    if (qAbs(value) < 1000) {
+      const qint64 fixed = qRound64(value * kScale);
+      if (fixed / kScale == value) {
+        putVarint(zigzag(fixed - prev) << 1);
+        prev = fixed;
+        return;
+      }
+    }
+    putVarint(1);
+    putDouble(value);
+  }
+
+  QByteArray data;
+};
+
+class CReader {
+ public:
+  explicit CReader(const QByteArray& data) : data(data) {}
+
+  quint64 getVarint() {
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos >= data.size()) {
+        error = true;
+        return 0;
+      }
+      const quint8 byte = quint8(data[pos++]);
+      value |= quint64(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    error = true;
+    return 0;
+  }
+
+  qint64 getZigzag() { return unzigzag(getVarint()); }
+
+  qreal getDouble() {
+    if (remaining() < qint64(sizeof(quint64))) {
+      error = true;
+      return NOFLOAT;
+    }
+    const quint64 bits = qFromLittleEndian<quint64>(data.constData() + pos);
+    pos += sizeof(bits);
+
+    qreal value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  QByteArray getBytes() {
+    const quint64 size = getVarint();
+    if (size > quint64(remaining())) {
+      error = true;
+      return QByteArray();
+    }
+    const QByteArray bytes = data.mid(pos, size);
+    pos += size;
+    return bytes;
+  }
+
+  qreal getCoord(qint64& prev) {
+    const quint64 value = getVarint();
+    if (value & 1) {
+      if (value != 1) {
+        error = true;
+      }
+      return getDouble();
+    }
+    prev = undelta(unzigzag(value >> 1), prev);
+    return prev / kScale;
+  }
+
+  qint64 remaining() const { return data.size() - pos; }
+
+  /// @return True if all data has been read without error
+  bool isComplete() const { return !error && (pos == data.size()); }
+
+  bool error = false;
+
+ private:
+  const QByteArray data;
+  qint32 pos = 0;
+};
+
+quint32 getMask(const trkpt_t& pt) {
+  quint32 mask = 0;
+  if (pt.flags != 0) {
+    mask |= eFieldFlags;
+  }
+  if (pt.activity != trkpt_t::eAct20None) {
+    mask |= eFieldActivity;
+  }
+  if (pt.ele != NOINT) {
+    mask |= eFieldEle;
+  }
+  if (pt.time.isValid() && (pt.time.timeSpec() == Qt::UTC)) {
+    mask |= eFieldTimeUtc;
+  } else if (!pt.time.isNull()) {
+    mask |= eFieldTimeOther;
+  }
+  if (pt.magvar != NOINT) {
+    mask |= eFieldMagvar;
+  }
+  if (pt.geoidheight != NOINT) {
+    mask |= eFieldGeoidheight;
+  }
+  if (!pt.name.isEmpty()) {
+    mask |= eFieldName;
+  }
+  if (!pt.cmt.isEmpty()) {
+    mask |= eFieldCmt;
+  }
+  if (!pt.desc.isEmpty()) {
+    mask |= eFieldDesc;
+  }
+  if (!pt.src.isEmpty()) {
+    mask |= eFieldSrc;
+  }
+  if (!pt.links.isEmpty()) {
+    mask |= eFieldLinks;
+  }
+  if (!pt.sym.isEmpty()) {
+    mask |= eFieldSym;
+  }
+  if (!pt.type.isEmpty()) {
+    mask |= eFieldType;
+  }
+  if (!pt.fix.isEmpty()) {
+    mask |= eFieldFix;
+  }
+  if (pt.sat != NOINT) {
+    mask |= eFieldSat;
+  }
+  if (pt.hdop != NOINT) {
+    mask |= eFieldHdop;
+  }
+  if (pt.vdop != NOINT) {
+    mask |= eFieldVdop;
+  }
+  if (pt.pdop != NOINT) {
+    mask |= eFieldPdop;
+  }
+  if (pt.ageofdgpsdata != NOINT) {
+    mask |= eFieldAgeOfDgpsData;
+  }
+  if (pt.dgpsid != NOINT) {
+    mask |= eFieldDgpsId;
+  }
+  if (!pt.extensions.isEmpty()) {
+    mask |= eFieldExtensions;
+  }
+  return mask;
+}
+
+void writeAttributes(QDataStream& stream, quint32 mask, const trkpt_t& pt) {
+  if (mask & eFieldTimeOther) {
+    stream << pt.time;
+  }
+  if (mask & eFieldMagvar) {
+    stream << pt.magvar;
+  }
+  if (mask & eFieldGeoidheight) {
+    stream << pt.geoidheight;
+  }
+  if (mask & eFieldName) {
+    stream << pt.name;
+  }
+  if (mask & eFieldCmt) {
+    stream << pt.cmt;
+  }
+  if (mask & eFieldDesc) {
+    stream << pt.desc;
+  }
+  if (mask & eFieldSrc) {
+    stream << pt.src;
+  }
+  if (mask & eFieldLinks) {
+    stream << quint32(pt.links.size());
+    for (const IGisItem::link_t& link : pt.links) {
+      stream << link.uri << link.text << link.type;
+    }
+  }
+  if (mask & eFieldSym) {
+    stream << pt.sym;
+  }
+  if (mask & eFieldType) {
+    stream << pt.type;
+  }
+  if (mask & eFieldFix) {
+    stream << pt.fix;
+  }
+  if (mask & eFieldSat) {
+    stream << pt.sat;
+  }
+  if (mask & eFieldHdop) {
+    stream << pt.hdop;
+  }
+  if (mask & eFieldVdop) {
+    stream << pt.vdop;
+  }
+  if (mask & eFieldPdop) {
+    stream << pt.pdop;
+  }
+  if (mask & eFieldAgeOfDgpsData) {
+    stream << pt.ageofdgpsdata;
+  }
+  if (mask & eFieldDgpsId) {
+    stream << pt.dgpsid;
+  }
+}
+
+void readAttributes(QDataStream& stream, quint32 mask, trkpt_t& pt) {
+  if (mask & eFieldTimeOther) {
+    stream >> pt.time;
+  }
+  if (mask & eFieldMagvar) {
+    stream >> pt.magvar;
+  }
+  if (mask & eFieldGeoidheight) {
+    stream >> pt.geoidheight;
+  }
+  if (mask & eFieldName) {
+    stream >> pt.name;
+  }
+  if (mask & eFieldCmt) {
+    stream >> pt.cmt;
+  }
+  if (mask & eFieldDesc) {
+    stream >> pt.desc;
+  }
+  if (mask & eFieldSrc) {
+    stream >> pt.src;
+  }
+  if (mask & eFieldLinks) {
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+      IGisItem::link_t link;
+      stream >> link.uri >> link.text >> link.type;
+      pt.links << link;
+    }
+  }
+  if (mask & eFieldSym) {
+    stream >> pt.sym;
+  }
+  if (mask & eFieldType) {
+    stream >> pt.type;
+  }
+  if (mask & eFieldFix) {
+    stream >> pt.fix;
+  }
+  if (mask & eFieldSat) {
+    stream >> pt.sat;
+  }
+  if (mask & eFieldHdop) {
+    stream >> pt.hdop;
+  }
+  if (mask & eFieldVdop) {
+    stream >> pt.vdop;
+  }
+  if (mask & eFieldPdop) {
+    stream >> pt.pdop;
+  }
+  if (mask & eFieldAgeOfDgpsData) {
+    stream >> pt.ageofdgpsdata;
+  }
+  if (mask & eFieldDgpsId) {
+    stream >> pt.dgpsid;
+  }
+}
+
+QByteArray variantToBytes(const QVariant& value) {
+  QByteArray bytes;
+  QDataStream stream(&bytes, QIODevice::WriteOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+  stream << value;
+  return bytes;
+}
+
+QVariant bytesToVariant(const QByteArray& bytes, bool& error) {
+  QDataStream stream(bytes);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+
+  QVariant value;
+  stream >> value;
+  if (stream.status() != QDataStream::Ok) {
+    error = true;
+  }
+  return value;
+}
+
+void writeExtensions(CWriter& writer, const trkpt_t& pt, QStringList& keys, QHash<QString, quint32>& idxKeys) {
+  writer.putVarint(pt.extensions.size());
+  for (auto it = pt.extensions.cbegin(); it != pt.extensions.cend(); ++it) {
+    auto idx = idxKeys.constFind(it.key());
+    if (idx == idxKeys.cend()) {
+      idx = idxKeys.insert(it.key(), keys.size());
+      keys << it.key();
+    }
+
+    // the key's index and the value's type tag share a single varint
+    const QVariant& value = it.value();
+    switch (value.userType()) {
+      case QMetaType::QString:
+        writer.putVarint((quint64(*idx) << 2) | eValueString);
+        writer.putBytes(value.toString().toUtf8());
+        break;
+
+      case QMetaType::Double:
+        writer.putVarint((quint64(*idx) << 2) | eValueDouble);
+        writer.putDouble(value.toDouble());
+        break;
+
+      case QMetaType::Int:
+        writer.putVarint((quint64(*idx) << 2) | eValueInt);
+        writer.putZigzag(value.toInt());
+        break;
+
+      default:
+        writer.putVarint((quint64(*idx) << 2) | eValueVariant);
+        writer.putBytes(variantToBytes(value));
+    }
+  }
+}
+
+void readExtensions(CReader& reader, trkpt_t& pt, const QStringList& keys) {
+  const quint64 count = reader.getVarint();
+  for (quint64 n = 0; (n < count) && !reader.error; n++) {
+    const quint64 tag = reader.getVarint();
+    const quint64 idx = tag >> 2;
+    if (idx >= quint64(keys.size())) {
+      reader.error = true;
+      return;
+    }
+
+    QVariant& value = pt.extensions[keys[int(idx)]];
+    switch (tag & 0x03) {
+      case eValueString:
+        value = QString::fromUtf8(reader.getBytes());
+        break;
+
+      case eValueDouble:
+        value = reader.getDouble();
+        break;
+
+      case eValueInt:
+        value = qint32(reader.getZigzag());
+        break;
+
+      case eValueVariant:
+        value = bytesToVariant(reader.getBytes(), reader.error);
+        break;
+    }
+  }
+}
+}  // namespace
+
+void CTrackCodec::encode(const QVector<CTrackData::trkseg_t>& segs, QDataStream& stream) {
+  CWriter header;
+  CWriter masks;
+  CWriter flags;
+  CWriter lon;
+  CWriter lat;
+  CWriter ele;
+  CWriter time;
+  CWriter extensions;
+
+  QByteArray attributes;
+  QDataStream attr(&attributes, QIODevice::WriteOnly);
+  attr.setByteOrder(QDataStream::LittleEndian);
+  attr.setVersion(QDataStream::Qt_5_2);
+
+  QStringList keys;
+  QHash<QString, quint32> idxKeys;
+
+  qint64 prevLon = 0;
+  qint64 prevLat = 0;
+  qint64 prevEle = 0;
+  qint64 prevTime = 0;
+
+  header.putVarint(segs.size());
+  for (const CTrackData::trkseg_t& seg : segs) {
+    header.putVarint(seg.pts.size());
+
+    for (const trkpt_t& pt : seg.pts) {
+      const quint32 mask = getMask(pt);
+      masks.putVarint(mask);
+
+      if (mask & eFieldFlags) {
+        flags.putVarint(pt.flags);
+      }
+      if (mask & eFieldActivity) {
+        flags.putZigzag(pt.activity);
+      }
+
+      lon.putCoord(pt.lon, prevLon);
+      lat.putCoord(pt.lat, prevLat);
+
+      if (mask & eFieldEle) {
+        ele.putZigzag(pt.ele - prevEle);
+        prevEle = pt.ele;
+      }
+
+      if (mask & eFieldTimeUtc) {
+        const qint64 msec = pt.time.toMSecsSinceEpoch();
+        time.putZigzag(delta(msec, prevTime));
+        prevTime = msec;
+      }
+
+      writeAttributes(attr, mask, pt);
+
+      if (mask & eFieldExtensions) {
+        writeExtensions(extensions, pt, keys, idxKeys);
+      }
+    }
+  }
+
+  stream << VER_TRKCODEC;
+  stream << header.data << masks.data << flags.data << lon.data << lat.data << ele.data << time.data;
+  stream << attributes << keys << extensions.data;
+}
+
+bool CTrackCodec::decode(QDataStream& stream, QVector<CTrackData::trkseg_t>& segs) {
+  segs.clear();
+
+  quint8 version = 0;
+  QByteArray bytesHeader, bytesMasks, bytesFlags, bytesLon, bytesLat, bytesEle, bytesTime, attributes, bytesExt;
+  QStringList keys;
+
+  stream >> version;
+  stream >> bytesHeader >> bytesMasks >> bytesFlags >> bytesLon >> bytesLat >> bytesEle >> bytesTime;
+  stream >> attributes >> keys >> bytesExt;
+
+  if ((stream.status() != QDataStream::Ok) || (version > VER_TRKCODEC)) {
+    return false;
+  }
+
+  CReader header(bytesHeader);
+  CReader masks(bytesMasks);
+  CReader flags(bytesFlags);
+  CReader lon(bytesLon);
+  CReader lat(bytesLat);
+  CReader ele(bytesEle);
+  CReader time(bytesTime);
+  CReader extensions(bytesExt);
+
+  QDataStream attr(attributes);
+  attr.setByteOrder(QDataStream::LittleEndian);
+  attr.setVersion(QDataStream::Qt_5_2);
+
+  qint64 prevLon = 0;
+  qint64 prevLat = 0;
+  qint64 prevEle = 0;
+  qint64 prevTime = 0;
+
+  // Each segment takes at least one byte of the header and each point at least one byte of
+  // the masks. Checking the counts against that prevents huge allocations for corrupt data.
+  const quint64 nSegs = header.getVarint();
+  if (header.error || (nSegs > quint64(header.remaining()))) {
+    return false;
+  }
+
+  segs.resize(nSegs);
+  for (CTrackData::trkseg_t& seg : segs) {
+    const quint64 nPts = header.getVarint();
+    if (header.error || (nPts > quint64(masks.remaining()))) {
+      segs.clear();
+      return false;
+    }
+
+    seg.pts.resize(nPts);
+    for (trkpt_t& pt : seg.pts) {
+      const quint32 mask = quint32(masks.getVarint());
+
+      if (mask & eFieldFlags) {
+        pt.flags = quint32(flags.getVarint());
+      }
+      if (mask & eFieldActivity) {
+        pt.activity = trkact_t(flags.getZigzag());
+      }
+
+      pt.lon = lon.getCoord(prevLon);
+      pt.lat = lat.getCoord(prevLat);
+
+      if (mask & eFieldEle) {
+        prevEle = undelta(ele.getZigzag(), prevEle);
+        pt.ele = qint32(prevEle);
+      }
+
+      if (mask & eFieldTimeUtc) {
+        prevTime = undelta(time.getZigzag(), prevTime);
+        pt.time = QDateTime::fromMSecsSinceEpoch(prevTime, Qt::UTC);
+      }
+
+      readAttributes(attr, mask, pt);
+
+      if (mask & eFieldExtensions) {
+        readExtensions(extensions, pt, keys);
+      }
+
+      pt.sanitizeFlags();
+    }
+  }
+
+  const bool success = header.isComplete() && masks.isComplete() && flags.isComplete() && lon.isComplete() &&
+                       lat.isComplete() && ele.isComplete() && time.isComplete() && extensions.isComplete() &&
+                       (attr.status() == QDataStream::Ok) && attr.atEnd();
+  if (!success) {
+    segs.clear();
+  }
+  return success;
+}
@@ -0,0 +1,65 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTRACKCODEC_H
+#define CTRACKCODEC_H
+
+#include <QDataStream>
+#include <QVector>
+
+#include "gis/trk/CTrackData.h"
+
+/**
+   @brief Compact binary encoding of the track points used by the QMS format since VER_TRK 8
+
+   Older versions stream every track point as a full IGisItem::wpt_t with all its
+   strings and a hash of extensions. This codec splits the points into columns
+   instead:
+
+   - a presence mask per point with a bit for each optional field
+   - flags and activity, if set
+   - longitude and latitude as fixed point values with 1e-9 degree resolution, coded as
+     delta to the previous point. Values that can't be restored exactly that way are
+     stored as raw double.
+   - elevation and UTC timestamp [ms] as delta to the previous point that has one
+   - all other GPX tags of a waypoint, only for the points that have them
+   - the extensions with their keys replaced by an index into a dictionary of keys
+
+   Deltas are zigzag coded variable length integers. The columns compress well with zlib.
+ */
+class CTrackCodec {
+ public:
+  /**
+     @brief Write the segments of a track to a stream
+
+     @param segs    the segments to write
+     @param stream  the stream to write to
+   */
+  static void encode(const QVector<CTrackData::trkseg_t>& segs, QDataStream& stream);
+
+  /**
+     @brief Read the segments of a track from a stream
+
+     @param stream  the stream to read from
+     @param segs    the segments read. Is cleared if the data is corrupt.
+     @return True on success.
+   */
+  static bool decode(QDataStream& stream, QVector<CTrackData::trkseg_t>& segs);
+};
+
+#endif  // CTRACKCODEC_H
@@ -22,13 +22,14 @@
 #include "gis/db/CDBProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/IGisProject.h"
+#include "gis/qms/CTrackCodec.h"
 #include "gis/rte/CGisItemRte.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/wpt/CGisItemWpt.h"
 #include "helpers/CLimit.h"
 #include "helpers/CValue.h"
 
-#define VER_TRK quint8(7)
+#define VER_TRK quint8(8)
 #define VER_WPT quint8(4)
 #define VER_RTE quint8(4)
 #define VER_AREA quint8(2)
@@ -486,6 +487,54 @@ QDataStream& operator>>(QDataStream& stream, CEnergyCycling::energy_set_t& e) {
   return stream;
 }
 
+/**
+   @brief Split the data written by operator>> of an item
+
+   @param data      the data as written by operator>>
+   @param header    receives the magic and the version
+   @param payload   receives the compressed payload
+   @return False if the data is not valid.
+ */
+static bool splitItemData(const QByteArray& data, QByteArray& header, QByteArray& payload) {
+  constexpr int headerSize = MAGIC_SIZE + sizeof(quint8);
+  if (data.size() < headerSize) {
+    return false;
+  }
+
+  QDataStream stream(data);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+  stream.skipRawData(headerSize);
+  stream >> payload;
+
+  header = data.left(headerSize);
+  return stream.status() == QDataStream::Ok;
+}
+
+QByteArray IGisItem::getCompressedData(const QByteArray& data, compression_e level) {
+  QByteArray header, payload;
+  if (!splitItemData(data, header, payload)) {
+    return data;
+  }
+
+  QByteArray result;
+  QDataStream stream(&result, QIODevice::WriteOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+  stream.writeRawData(header.constData(), header.size());
+  stream << qCompress(qUncompress(payload), level);
+  return result;
+}
+
+QByteArray IGisItem::getUncompressedData(const QByteArray& data) {
+  QByteArray header, payload;
+  if (!splitItemData(data, header, payload)) {
+    return data;
+  }
+
+  return header + qUncompress(payload);
+}
+
 // ---------------- main objects ---------------------------------
 
 QDataStream& CGisItemTrk::operator>>(QDataStream& stream) const {
@@ -517,11 +566,11 @@ QDataStream& CGisItemTrk::operator>>(QDataStream& stream) const {
 
   out << energyCycling.getEnergyTrkSet();
 
-  out << trk.segs;
+  CTrackCodec::encode(trk.segs, out);
 
   stream.writeRawData(MAGIC_TRK, MAGIC_SIZE);
   stream << VER_TRK;
-  stream << qCompress(buffer, 9);
+  stream << qCompress(buffer, getCompression());
   return stream;
 }
 
@@ -599,13 +648,20 @@ QDataStream& CGisItemTrk::operator<<(QDataStream& stream) {
   }
 
   trk.segs.clear();
-  in >> trk.segs;
+  if (version > 7) {
+    if (!CTrackCodec::decode(in, trk.segs)) {
+      qWarning() << "Failed to decode track points of" << trk.name;
+    }
+  } else {
+    in >> trk.segs;
+  }
 
   /* [Issue #408] Export of a database is broken
 
       Exporting the database is done in a thread other than the main GUI thread.
       As deriveSecondaryData() might call some GUI elements it has to be bypassed
-      when restoring a track within an thread.
+      when restoring a track within an thread. CWorkspaceLoader restores tracks
+      within a thread, too. It derives the secondary data itself.
    */
   if (QThread::currentThread() == qApp->thread()) {
     deriveSecondaryData();
@@ -689,7 +745,7 @@ QDataStream& CGisItemWpt::operator>>(QDataStream& stream) const {
 
   stream.writeRawData(MAGIC_WPT, MAGIC_SIZE);
   stream << VER_WPT;
-  stream << qCompress(buffer, 9);
+  stream << qCompress(buffer, getCompression());
 
   return stream;
 }
@@ -776,7 +832,7 @@ QDataStream& CGisItemRte::operator>>(QDataStream& stream) const {
 
   stream.writeRawData(MAGIC_RTE, MAGIC_SIZE);
   stream << VER_RTE;
-  stream << qCompress(buffer, 9);
+  stream << qCompress(buffer, getCompression());
 
   return stream;
 }
@@ -857,7 +913,7 @@ QDataStream& CGisItemOvlArea::operator>>(QDataStream& stream) const {
 
   stream.writeRawData(MAGIC_AREA, MAGIC_SIZE);
   stream << VER_AREA;
-  stream << qCompress(buffer, 9);
+  stream << qCompress(buffer, getCompression());
 
   return stream;
 }
@@ -969,7 +1025,7 @@ QDataStream& IGisProject::operator<<(QDataStream& stream) {
   return stream;
 }
 
-QDataStream& IGisProject::operator>>(QDataStream& stream) const {
+void IGisProject::writeHeader(QDataStream& stream) const {
   stream.writeRawData(MAGIC_PROJ, MAGIC_SIZE);
   stream << VER_PROJECT;
 
@@ -988,6 +1044,10 @@ QDataStream& IGisProject::operator>>(QDataStream& stream) const {
                   (invalidDataOk ? eFlagInvalidDataOk : 0) |
                   (autoSyncToDev ? eFlagAutoSyncToDev : 0));  // collect trivial flags in one field.
   stream << qint32(sortingFolder);
+}
+
+QDataStream& IGisProject::operator>>(QDataStream& stream) const {
+  writeHeader(stream);
 
   for (int i = 0; i < childCount(); i++) {
     CGisItemTrk* item = dynamic_cast<CGisItemTrk*>(child(i));
@@ -1088,24 +1148,7 @@ QDataStream& CDBProject::operator<<(QDataStream& stream) {
 }
 
 QDataStream& CDBProject::operator>>(QDataStream& stream) const {
-  stream.writeRawData(MAGIC_PROJ, MAGIC_SIZE);
-  stream << VER_PROJECT;
-
-  stream << filename;
-  stream << metadata.name;
-  stream << metadata.desc;
-  stream << metadata.author;
-  stream << metadata.copyright;
-  stream << metadata.links;
-  stream << metadata.time;
-  stream << metadata.keywords;
-  stream << metadata.bounds;
-  stream << key;
-  stream << qint32(sortingRoadbook);
-  stream << qint8((noCorrelation ? eFlagNoCorrelation : 0) | (autoSave ? eFlagAutoSave : 0) |
-                  (invalidDataOk ? eFlagInvalidDataOk : 0) |
-                  (autoSyncToDev ? eFlagAutoSyncToDev : 0));  // collect trivial flags in one field.
-  stream << qint32(sortingFolder);
+  writeHeader(stream);
 
   return stream;
 }
@@ -34,6 +34,7 @@
 #include "gis/rte/CScrOptRte.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "helpers/CDraw.h"
+#include "helpers/COccupancyGrid.h"
 #include "helpers/CWptIconManager.h"
 #include "units/IUnit.h"
 
@@ -236,7 +237,8 @@ void CGisItemRte::deriveSecondaryData() {
     }
   }
 
-  boundingRect = QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD));
+  setBoundingRect(
+      QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD)));
 }
 
 void CGisItemRte::edit() {
@@ -449,7 +451,7 @@ void CGisItemRte::looseUserFocus() {
   }
 }
 
-void CGisItemRte::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
+void CGisItemRte::drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
 
   line.clear();
@@ -581,7 +583,7 @@ void CGisItemRte::drawItem(QPainter& p, const QRectF& /*viewport*/, CGisDraw* gi
   }
 }
 
-void CGisItemRte::drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas,
+void CGisItemRte::drawLabel(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas,
                             const QFontMetricsF& fm, CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
   if (!isVisible(boundingRect, viewport, gis)) {
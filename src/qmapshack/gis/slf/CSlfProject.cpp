@@ -34,8 +34,12 @@ CSlfProject::CSlfProject(const QString& filename, bool readFile)
     try {
       CSlfReader::readFile(filename, this);
     } catch (QString& errormsg) {
-      QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
-                            errormsg, QMessageBox::Abort);
+      if (QThread::currentThread() == qApp->thread()) {
+        QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
+                              errormsg, QMessageBox::Abort);
+      } else {
+        qWarning() << "Failed to load file" << filename << ":" << errormsg;
+      }
       valid = false;
     }
   } else {
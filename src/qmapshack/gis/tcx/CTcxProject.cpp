@@ -70,8 +70,12 @@ void CTcxProject::loadTcx(const QString& filename) {
   try {
     loadTcx(filename, this);
   } catch (QString& errormsg) {
-    QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
-                          errormsg, QMessageBox::Abort);
+    if (QThread::currentThread() == qApp->thread()) {
+      QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed to load file %1...").arg(filename),
+                            errormsg, QMessageBox::Abort);
+    } else {
+      qWarning() << "Failed to load file" << filename << ":" << errormsg;
+    }
     valid = false;
   }
 }
@@ -92,26 +96,35 @@ void CTcxProject::loadTcx(const QString& filename, CTcxProject* project) {
     throw tr("Failed to open %1").arg(filename);
   }
 
-  QDomDocument xml;
-  QString msg;
-  int line;
-  int column;
-  if (!xml.setContent(&file, false, &msg, &line, &column)) {
-    file.close();
-    throw tr("Failed to read: %1\nline %2, column %3:\n %4").arg(filename).arg(line).arg(column).arg(msg);
-  }
-  file.close();
+  QXmlStreamReader xml(&file);
+  // like QDomDocument::setContent() without namespace processing
+  xml.setNamespaceProcessing(false);
+
+  auto throwOnError = [&]() {
+    if (xml.hasError()) {
+      throw tr("Failed to read: %1\nline %2, column %3:\n %4")
+          .arg(filename)
+          .arg(xml.lineNumber())
+          .arg(xml.columnNumber())
+          .arg(xml.errorString());
+    }
+  };
 
-  QDomElement xmlTcx = xml.documentElement();
-  if (xmlTcx.tagName() != "TrainingCenterDatabase") {
+  xml.readNextStartElement();
+  throwOnError();
+  if (xml.qualifiedName() != "TrainingCenterDatabase") {
     throw tr("Not a TCX file: %1").arg(filename);
   }
 
-  const QDomNodeList& tcxActivities = xmlTcx.elementsByTagName("Activity");
-  const QDomNodeList& tcxCourses = xmlTcx.elementsByTagName("Course");
+  qint32 nActivities = 0;
+  qint32 nCourses = 0;
+  bool hasWorkout = false;
+  project->loadSections(xml, nActivities, nCourses, hasWorkout);
+  file.close();
+  throwOnError();
 
-  if (!tcxActivities.item(0).isElement() && !tcxCourses.item(0).isElement()) {
-    if (xmlTcx.elementsByTagName("Workout").item(0).isElement()) {
+  if (nActivities == 0 && nCourses == 0) {
+    if (hasWorkout) {
       throw tr(
           "This TCX file contains at least 1 workout, but neither an activity nor a course. "
           "As workouts do not contain position data, they can not be imported to QMapShack.");
@@ -120,189 +133,163 @@ void CTcxProject::loadTcx(const QString& filename, CTcxProject* project) {
     }
   }
 
-  for (int i = 0; i < tcxActivities.count(); i++) {
-    project->loadActivity(tcxActivities.item(i));
-  }
-
-  for (int i = 0; i < tcxCourses.count(); i++) {
-    project->loadCourse(tcxCourses.item(i));
-  }
-
   project->sortItems();
   project->setupName(QFileInfo(filename).completeBaseName().replace("_", " "));
   project->setToolTip(CGisListWks::eColumnName, project->getInfo());
   project->valid = true;
 }
 
-void CTcxProject::loadActivity(const QDomNode& activityRootNode) {
-  if (activityRootNode.isElement()) {
-    CTrackData trk;
-
-    trk.name = activityRootNode.toElement()
-                   .elementsByTagName("Id")
-                   .item(0)
-                   .firstChild()
-                   .nodeValue();  // activities do not have a "Name" but an "Id" instead (containing start date-time)
-
-    const QDomNodeList& tcxLaps = activityRootNode.toElement().elementsByTagName("Lap");
-
-    trk.segs.resize(tcxLaps.count());
-    for (int i = 0; i < tcxLaps.count(); i++)  // browse laps
-    {
-      CTrackData::trkseg_t* seg = &(trk.segs[i]);
-
-      const QDomNodeList& tcxLapTrackpts = tcxLaps.item(i).toElement().elementsByTagName("Trackpoint");
-
-      for (int j = 0; j < tcxLapTrackpts.count(); j++)  // browse trackpoints
-      {
-        const QDomElement& positionElement =
-            tcxLapTrackpts.item(j).toElement().elementsByTagName("Position").item(0).toElement();
-
-        if (positionElement
-                .isElement())  // if this trackpoint contains position, i.e. GPSr was able to capture position
-        {
-          CTrackData::trkpt_t trkpt;
-
-          IUnit::parseTimestamp(
-              tcxLapTrackpts.item(j).toElement().elementsByTagName("Time").item(0).firstChild().nodeValue(),
-              trkpt.time);
-
-          trkpt.lat = positionElement.elementsByTagName("LatitudeDegrees").item(0).firstChild().nodeValue().toDouble();
-          trkpt.lon = positionElement.elementsByTagName("LongitudeDegrees").item(0).firstChild().nodeValue().toDouble();
-          trkpt.ele = tcxLapTrackpts.item(j)
-                          .toElement()
-                          .elementsByTagName("AltitudeMeters")
-                          .item(0)
-                          .firstChild()
-                          .nodeValue()
-                          .toDouble();
-
-          const QDomElement& HRElement =
-              tcxLapTrackpts.item(j).toElement().elementsByTagName("HeartRateBpm").item(0).toElement();
-          if (HRElement.isElement())  // if this trackpoint contains heartrate data, i.e. heartrate sensor data has been
-                                      // captured
-          {
-            trkpt.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] =
-                HRElement.elementsByTagName("Value").item(0).firstChild().nodeValue().toDouble();
-          }
+void CTcxProject::loadSections(QXmlStreamReader& xml, qint32& nActivities, qint32& nCourses, bool& hasWorkout) {
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "Activity") {
+      loadActivity(xml);
+      nActivities++;
+    } else if (tag == "Course") {
+      loadCourse(xml);
+      nCourses++;
+    } else {
+      hasWorkout = hasWorkout || (tag == "Workout");
+      loadSections(xml, nActivities, nCourses, hasWorkout);
+    }
+  }
+}
 
-          const QDomElement& CADElement =
-              tcxLapTrackpts.item(j).toElement().elementsByTagName("Cadence").item(0).toElement();
-          if (CADElement
-                  .isElement())  // if this trackpoint contains cadence data, i.e. cadence sensor data has been captured
-          {
-            trkpt.extensions["gpxtpx:TrackPointExtension|gpxtpx:cad"] = CADElement.firstChild().nodeValue().toDouble();
-          }
+static void loadPosition(QXmlStreamReader& xml, qreal& lat, qreal& lon) {
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "LatitudeDegrees") {
+      lat = xml.readElementText().toDouble();
+    } else if (tag == "LongitudeDegrees") {
+      lon = xml.readElementText().toDouble();
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+}
 
-          seg->pts.append(trkpt);  // 1 TCX lap gives 1 GPX track segment
+static void loadTrackpoint(QXmlStreamReader& xml, CTrackData::trkseg_t& seg) {
+  CTrackData::trkpt_t trkpt;
+  // a missing altitude has always been read as 0
+  trkpt.ele = 0;
+
+  bool hasPosition = false;
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "Time") {
+      IUnit::parseTimestamp(xml.readElementText(), trkpt.time);
+    } else if (tag == "Position") {
+      hasPosition = true;
+      trkpt.lat = 0;
+      trkpt.lon = 0;
+      loadPosition(xml, trkpt.lat, trkpt.lon);
+    } else if (tag == "AltitudeMeters") {
+      trkpt.ele = xml.readElementText().toDouble();
+    } else if (tag == "HeartRateBpm") {
+      // if this trackpoint contains heartrate data, i.e. heartrate sensor data has been captured
+      while (xml.readNextStartElement()) {
+        if (xml.qualifiedName() == "Value") {
+          trkpt.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] = xml.readElementText().toDouble();
+        } else {
+          xml.skipCurrentElement();
         }
       }
+    } else if (tag == "Cadence") {
+      // if this trackpoint contains cadence data, i.e. cadence sensor data has been captured
+      trkpt.extensions["gpxtpx:TrackPointExtension|gpxtpx:cad"] = xml.readElementText().toDouble();
+    } else {
+      xml.skipCurrentElement();
     }
+  }
 
-    CGisItemTrk* trkItem = new CGisItemTrk(trk, this);
-    trackTypes.insert(trkItem->getKey().item, eActivity);  // store the track type according to its key
+  // only if this trackpoint contains position, i.e. GPSr was able to capture position
+  if (hasPosition) {
+    seg.pts.append(trkpt);
   }
 }
 
-void CTcxProject::loadCourse(const QDomNode& courseRootNode) {
-  if (courseRootNode.isElement()) {
-    CTrackData trk;
-
-    trk.name = courseRootNode.toElement().elementsByTagName("Name").item(0).firstChild().nodeValue();
-    trk.segs.resize(1);
-    CTrackData::trkseg_t* seg = &(trk.segs[0]);
-
-    const QDomNodeList& tcxTrackpts = courseRootNode.toElement().elementsByTagName("Trackpoint");
+/// read all trackpoints within the current element of the stream
+static void loadTrackpoints(QXmlStreamReader& xml, CTrackData::trkseg_t& seg) {
+  while (xml.readNextStartElement()) {
+    if (xml.qualifiedName() == "Trackpoint") {
+      loadTrackpoint(xml, seg);
+    } else {
+      loadTrackpoints(xml, seg);
+    }
+  }
+}
 
-    for (int i = 0; i < tcxTrackpts.count(); i++)  // browse trackpoints
-    {
-      const QDomElement& positionElement =
-          tcxTrackpts.item(i).toElement().elementsByTagName("Position").item(0).toElement();
+void CTcxProject::loadActivity(QXmlStreamReader& xml) {
+  CTrackData trk;
+
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "Id") {
+      // activities do not have a "Name" but an "Id" instead (containing start date-time)
+      trk.name = xml.readElementText();
+    } else if (tag == "Lap") {
+      // 1 TCX lap gives 1 GPX track segment
+      trk.segs.append(CTrackData::trkseg_t());
+      loadTrackpoints(xml, trk.segs.last());
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
 
-      if (positionElement.isElement())  // if this trackpoint contains position, i.e. GPSr was able to capture position
-      {
-        CTrackData::trkpt_t trkpt;
-
-        IUnit::parseTimestamp(
-            tcxTrackpts.item(i).toElement().elementsByTagName("Time").item(0).firstChild().nodeValue(), trkpt.time);
-
-        trkpt.lat = positionElement.elementsByTagName("LatitudeDegrees").item(0).firstChild().nodeValue().toDouble();
-        trkpt.lon = positionElement.elementsByTagName("LongitudeDegrees").item(0).firstChild().nodeValue().toDouble();
-        trkpt.ele = tcxTrackpts.item(i)
-                        .toElement()
-                        .elementsByTagName("AltitudeMeters")
-                        .item(0)
-                        .firstChild()
-                        .nodeValue()
-                        .toDouble();
-
-        const QDomElement& HRElement =
-            tcxTrackpts.item(i).toElement().elementsByTagName("HeartRateBpm").item(0).toElement();
-        if (HRElement.isElement())  // if this trackpoint contains heartrate data, i.e. heartrate sensor data has been
-                                    // captured
-        {
-          trkpt.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] =
-              HRElement.elementsByTagName("Value").item(0).firstChild().nodeValue().toDouble();
-        }
+  CGisItemTrk* trkItem = new CGisItemTrk(trk, this);
+  trackTypes.insert(trkItem->getKey().item, eActivity);  // store the track type according to its key
+}
 
-        const QDomElement& CADElement =
-            tcxTrackpts.item(i).toElement().elementsByTagName("Cadence").item(0).toElement();
-        if (CADElement
-                .isElement())  // if this trackpoint contains cadence data, i.e. cadence sensor data has been captured
-        {
-          trkpt.extensions["gpxtpx:TrackPointExtension|gpxtpx:cad"] = CADElement.firstChild().nodeValue().toDouble();
+void CTcxProject::loadCourse(QXmlStreamReader& xml) {
+  CTrackData trk;
+  trk.segs.resize(1);
+
+  struct coursept_t {
+    QString name;
+    qreal lat = 0;
+    qreal lon = 0;
+    qreal ele = 0;
+    QString icon;
+  };
+  QList<coursept_t> coursePts;
+
+  while (xml.readNextStartElement()) {
+    const QStringRef& tag = xml.qualifiedName();
+    if (tag == "Name") {
+      trk.name = xml.readElementText();
+    } else if (tag == "CoursePoint") {
+      coursept_t pt;
+      while (xml.readNextStartElement()) {
+        const QStringRef& tagPt = xml.qualifiedName();
+        if (tagPt == "Name") {
+          pt.name = xml.readElementText();
+        } else if (tagPt == "Position") {
+          loadPosition(xml, pt.lat, pt.lon);
+        } else if (tagPt == "AltitudeMeters") {
+          pt.ele = xml.readElementText().toDouble();
+        } else if (tagPt == "PointType") {
+          // there is no "icon" in course points ;  "PointType" is used instead (can be
+          // "turn left", "turn right", etc... See list in
+          // http://www8.garmin.com/xmlschemas/TrainingCenterDatabasev2.xsd)
+          pt.icon = xml.readElementText();
+        } else {
+          xml.skipCurrentElement();
         }
-
-        seg->pts.append(trkpt);
       }
+      coursePts << pt;
+    } else if (tag == "Trackpoint") {
+      loadTrackpoint(xml, trk.segs[0]);
+    } else {
+      loadTrackpoints(xml, trk.segs[0]);
     }
+  }
 
-    CGisItemTrk* trkItem = new CGisItemTrk(trk, this);
-    trackTypes.insert(trkItem->getKey().item, eCourse);  // store the track type according to its key
-
-    const QDomNodeList& tcxCoursePts = courseRootNode.toElement().elementsByTagName("CoursePoint");
-    for (int i = 0; i < tcxCoursePts.count(); i++)  // browse course points
-    {
-      QString name = tcxCoursePts.item(i).toElement().elementsByTagName("Name").item(0).firstChild().nodeValue();
-      qreal lat = tcxCoursePts.item(i)
-                      .toElement()
-                      .elementsByTagName("Position")
-                      .item(0)
-                      .toElement()
-                      .elementsByTagName("LatitudeDegrees")
-                      .item(0)
-                      .firstChild()
-                      .nodeValue()
-                      .toDouble();
-      qreal lon = tcxCoursePts.item(i)
-                      .toElement()
-                      .elementsByTagName("Position")
-                      .item(0)
-                      .toElement()
-                      .elementsByTagName("LongitudeDegrees")
-                      .item(0)
-                      .firstChild()
-                      .nodeValue()
-                      .toDouble();
-      qreal ele = tcxCoursePts.item(i)
-                      .toElement()
-                      .elementsByTagName("AltitudeMeters")
-                      .item(0)
-                      .firstChild()
-                      .nodeValue()
-                      .toDouble();
-      QString icon = tcxCoursePts.item(i)
-                         .toElement()
-                         .elementsByTagName("PointType")
-                         .item(0)
-                         .firstChild()
-                         .nodeValue();  // there is no "icon" in course points ;  "PointType" is used instead (can be
-                                        // "turn left", "turn right", etc... See list in
-                                        // http://www8.garmin.com/xmlschemas/TrainingCenterDatabasev2.xsd)
-
-      new CGisItemWpt(QPointF(lon, lat), ele, QDateTime::currentDateTimeUtc(), name, icon,
-                      this);  // 1 TCX course point gives 1 GPX waypoint
-    }
+  CGisItemTrk* trkItem = new CGisItemTrk(trk, this);
+  trackTypes.insert(trkItem->getKey().item, eCourse);  // store the track type according to its key
+
+  for (const coursept_t& pt : qAsConst(coursePts)) {
+    new CGisItemWpt(QPointF(pt.lon, pt.lat), pt.ele, QDateTime::currentDateTimeUtc(), pt.name, pt.icon,
+                    this);  // 1 TCX course point gives 1 GPX waypoint
   }
 }
 
@@ -21,6 +21,8 @@
 
 #include "gis/prj/IGisProject.h"
 
+class QXmlStreamReader;
+
 class CTcxProject : public IGisProject {
   Q_DECLARE_TR_FUNCTIONS(CTcxProject)
  public:
@@ -42,8 +44,17 @@ class CTcxProject : public IGisProject {
  private:
   void setup();
   void loadTcx(const QString& filename);
-  void loadActivity(const QDomNode& activityRootNode);
-  void loadCourse(const QDomNode& courseRootNode);
+  /**
+     @brief Load all activities and courses within the current element of the stream
+
+     @param xml           the stream positioned at the start of an element
+     @param nActivities   incremented for each activity found
+     @param nCourses      incremented for each course found
+     @param hasWorkout    set true if a workout is found
+   */
+  void loadSections(QXmlStreamReader& xml, qint32& nActivities, qint32& nCourses, bool& hasWorkout);
+  void loadActivity(QXmlStreamReader& xml);
+  void loadCourse(QXmlStreamReader& xml);
 
   static void saveAuthor(QDomNode& nodeToAttachAuthor);
 
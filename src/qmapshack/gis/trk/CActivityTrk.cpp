@@ -126,7 +126,6 @@ void CActivityTrk::updateFlags() {
 void CActivityTrk::update() {
   allActivities.clear();
   activityRanges.clear();
-  activitySummary.clear();
 
   const CTrackData& data = trk->getTrackData();
   const CTrackData::trkpt_t* lastTrkpt = nullptr;
@@ -139,13 +138,6 @@ void CActivityTrk::update() {
     lastTrkpt = &pt;
     if (pt.getAct() != lastAct) {
       if (startTrkpt != nullptr) {
-        summary_t& summary = activitySummary[lastAct];
-        summary.distance += lastTrkpt->distance - startTrkpt->distance;
-        summary.ascent += lastTrkpt->ascent - startTrkpt->ascent;
-        summary.descent += lastTrkpt->descent - startTrkpt->descent;
-        summary.ellapsedSeconds += lastTrkpt->elapsedSeconds - startTrkpt->elapsedSeconds;
-        summary.ellapsedSecondsMoving += lastTrkpt->elapsedSecondsMoving - startTrkpt->elapsedSecondsMoving;
-
         activityRanges << range_t();
         range_t& activity = activityRanges.last();
 
@@ -159,34 +151,36 @@ void CActivityTrk::update() {
     }
   }
 
-  if (lastTrkpt == nullptr || startTrkpt == nullptr) {
-    return;
+  if (lastTrkpt != nullptr && startTrkpt != nullptr) {
+    activityRanges << range_t();
+    range_t& activity = activityRanges.last();
+
+    activity.idxTotalBeg = startTrkpt->idxTotal;
+    activity.idxTotalEnd = lastTrkpt->idxTotal;
+    activity.activity = lastAct;
   }
 
-  summary_t& summary = activitySummary[lastAct];
-  summary.distance += lastTrkpt->distance - startTrkpt->distance;
-  summary.ascent += lastTrkpt->ascent - startTrkpt->ascent;
-  summary.descent += lastTrkpt->descent - startTrkpt->descent;
-  summary.ellapsedSeconds += lastTrkpt->elapsedSeconds - startTrkpt->elapsedSeconds;
-  summary.ellapsedSecondsMoving += lastTrkpt->elapsedSecondsMoving - startTrkpt->elapsedSecondsMoving;
+  updateSummary();
+}
 
-  activityRanges << range_t();
-  range_t& activity = activityRanges.last();
+void CActivityTrk::updateSummary() {
+  activitySummary.clear();
 
-  activity.idxTotalBeg = startTrkpt->idxTotal;
-  activity.idxTotalEnd = lastTrkpt->idxTotal;
-  activity.activity = lastAct;
+  const CTrackData& data = trk->getTrackData();
+  for (const range_t& range : qAsConst(activityRanges)) {
+    const CTrackData::trkpt_t* startTrkpt = data.getTrkPtByTotalIndex(range.idxTotalBeg);
+    const CTrackData::trkpt_t* lastTrkpt = data.getTrkPtByTotalIndex(range.idxTotalEnd);
+    if (startTrkpt == nullptr || lastTrkpt == nullptr) {
+      continue;
+    }
 
-  //    for(int i = 0; i < 9; i++)
-  //    {
-  //        summary_t& stat   = summaries[i];
-  //        qDebug() << "--------------" << i << "--------------";
-  //        qDebug() << "stat.distance" << stat.distance;
-  //        qDebug() << "stat.ascent" << stat.ascent;
-  //        qDebug() << "stat.descent" << stat.descent;
-  //        qDebug() << "stat.timeMoving" << stat.ellapsedSecondsMoving;
-  //        qDebug() << "stat.timeTotal" << stat.ellapsedSeconds;
-  //    }
+    summary_t& summary = activitySummary[range.activity];
+    summary.distance += lastTrkpt->distance - startTrkpt->distance;
+    summary.ascent += lastTrkpt->ascent - startTrkpt->ascent;
+    summary.descent += lastTrkpt->descent - startTrkpt->descent;
+    summary.ellapsedSeconds += lastTrkpt->elapsedSeconds - startTrkpt->elapsedSeconds;
+    summary.ellapsedSecondsMoving += lastTrkpt->elapsedSecondsMoving - startTrkpt->elapsedSecondsMoving;
+  }
 }
 
 void CActivityTrk::printSummary(QString& str) const { printSummary(activitySummary, allActivities, str); }
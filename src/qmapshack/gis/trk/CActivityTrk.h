@@ -125,6 +125,14 @@ class CActivityTrk {
    */
   void update();
 
+  /**
+     @brief Update the summary of the known activity ranges only
+
+     Use this instead of update() if the activities of the track points did
+     not change but distance, ascent, descent or time did.
+   */
+  void updateSummary();
+
   /**
      @brief Update track point flags
 
@@ -21,6 +21,8 @@
 
 #include <QtWidgets>
 #include <QtXml>
+#include <algorithm>
+#include <numeric>
 
 #include "CMainWindow.h"
 #include "gis/CGisDraw.h"
@@ -38,6 +40,7 @@
 #include "gis/trk/CTrkToRteDialog.h"
 #include "gis/wpt/CGisItemWpt.h"
 #include "helpers/CDraw.h"
+#include "helpers/COccupancyGrid.h"
 #include "helpers/CProgressDialog.h"
 #include "misc.h"
 
@@ -48,6 +51,9 @@
 #define WPT_FOCUS_DIST_IN (50 * 50)
 #define WPT_FOCUS_DIST_OUT (200 * 200)
 
+// radius used to measure the level of detail in meters
+#define LOD_EARTH_RADIUS 6378137.0
+
 namespace {
 // helper to declutter and draw clusters of track info points
 class cluster {
@@ -190,6 +196,21 @@ CGisItemTrk::CGisItemTrk(const QDomNode& xml, IGisProject* project)
   checkForInvalidPoints();
 }
 
+CGisItemTrk::CGisItemTrk(const QDomNode& xml, QVector<CTrackData::trkseg_t>& segs, IGisProject* project)
+    : IGisItem(project, eTypeTrk, project->childCount()) {
+  // --- start read and process data ----
+  setColor(penForeground.color());
+  readTrkHead(xml, trk);
+  trk.segs.swap(segs);
+  deriveSecondaryData();
+  // --- stop read and process data ----
+
+  setupHistory();
+  updateDecoration(eMarkNone, eMarkNone);
+
+  checkForInvalidPoints();
+}
+
 CGisItemTrk::CGisItemTrk(const QString& filename, IGisProject* project)
     : IGisItem(project, eTypeTrk, project->childCount()) {
   // --- start read and process data ----
@@ -767,20 +788,19 @@ static inline void updateExtrema(CGisItemTrk::limits_t& extrema, qreal val, cons
   }
 }
 
-void CGisItemTrk::updateExtremaAndExtensions() {
+void CGisItemTrk::updateExtremaAndExtensions(const QVector<CTrackData::trkpt_t*>& lintrk) {
   extrema = QHash<QString, limits_t>();
-  limits_t extremaSpeed;
-  limits_t extremaSlope;
-  limits_t extremaEle;
-  limits_t extremaProgress;
-
   existingExtensions = QSet<QString>();
   QSet<QString> nonRealExtensions;
 
-  for (const CTrackData::trkpt_t& pt : trk) {
-    if (pt.isHidden()) {
-      continue;
-    }
+  const int N = lintrk.size();
+  QVector<qreal> speed(N);
+  QVector<qreal> ele(N);
+  QVector<qreal> slope(N);
+  QVector<qreal> progress(N);
+
+  for (int i = 0; i < N; i++) {
+    const CTrackData::trkpt_t& pt = *lintrk[i];
 
     const QStringList& keys = pt.extensions.keys();
     existingExtensions.unite({keys.begin(), keys.end()});
@@ -800,22 +820,56 @@ void CGisItemTrk::updateExtremaAndExtensions() {
       }
     }
 
-    updateExtrema(extremaSpeed, pt.speed, pos);
-    updateExtrema(extremaEle, pt.ele, pos);
-    updateExtrema(extremaSlope, pt.slope1, pos);
-    updateExtrema(extremaProgress, pt.distance, pos);
+    speed[i] = pt.speed;
+    ele[i] = pt.ele;
+    slope[i] = pt.slope1;
+    progress[i] = pt.distance;
+  }
+
+  extremaTreeSpeed.build(speed);
+  extremaTreeEle.build(ele);
+  extremaTreeSlope.build(slope);
+  extremaTreeProgress.build(progress);
+
+  updateExtremaInternal(lintrk);
+
+  existingExtensions.subtract(nonRealExtensions);
+}
+
+void CGisItemTrk::updateExtremaInternal(const QVector<CTrackData::trkpt_t*>& lintrk) {
+  auto getLimits = [&lintrk](const CMinMaxTree& tree) {
+    limits_t limits;
+    const int idxMin = tree.getIdxMin();
+    const int idxMax = tree.getIdxMax();
+    if (idxMin != NOIDX) {
+      limits.min = tree.value(idxMin);
+      limits.posMin = {lintrk[idxMin]->lon, lintrk[idxMin]->lat};
+      limits.max = tree.value(idxMax);
+      limits.posMax = {lintrk[idxMax]->lon, lintrk[idxMax]->lat};
+    }
+    return limits;
+  };
+
+  for (const QString& key : {CKnownExtension::internalEle, CKnownExtension::internalSlope,
+                             CKnownExtension::internalSpeedDist, CKnownExtension::internalSpeedTime,
+                             CKnownExtension::internalProgress}) {
+    existingExtensions.remove(key);
+    extrema.remove(key);
   }
 
+  const limits_t& extremaEle = getLimits(extremaTreeEle);
   if (extremaEle.min < extremaEle.max) {
     existingExtensions << CKnownExtension::internalEle;
     extrema[CKnownExtension::internalEle] = extremaEle;
   }
 
+  const limits_t& extremaSlope = getLimits(extremaTreeSlope);
   if (extremaSlope.min < extremaSlope.max) {
     existingExtensions << CKnownExtension::internalSlope;
     extrema[CKnownExtension::internalSlope] = extremaSlope;
   }
 
+  const limits_t& extremaSpeed = getLimits(extremaTreeSpeed);
   if (numeric_limits<qreal>::max() != extremaSpeed.min) {
     existingExtensions << CKnownExtension::internalSpeedDist;
     existingExtensions << CKnownExtension::internalSpeedTime;
@@ -823,12 +877,11 @@ void CGisItemTrk::updateExtremaAndExtensions() {
     extrema[CKnownExtension::internalSpeedTime] = extremaSpeed;
   }
 
+  const limits_t& extremaProgress = getLimits(extremaTreeProgress);
   if (numeric_limits<qreal>::max() != extremaProgress.min) {
     existingExtensions << CKnownExtension::internalProgress;
     extrema[CKnownExtension::internalProgress] = extremaProgress;
   }
-
-  existingExtensions.subtract(nonRealExtensions);
 }
 
 void CGisItemTrk::resetInternalData() {
@@ -876,6 +929,16 @@ void CGisItemTrk::consolidatePoints() {
 }
 
 void CGisItemTrk::deriveSecondaryData() {
+  qint32 idxDirty1, idxDirty2;
+  bool isDirtyActivity;
+  const bool isDirty = trk.getDirty(idxDirty1, idxDirty2, isDirtyActivity);
+  trk.clearDirty();
+  if (isDirty && deriveSecondaryDataRange(idxDirty1, idxDirty2, isDirtyActivity)) {
+    cntDeriveRange++;
+    return;
+  }
+  cntDeriveFull++;
+
   consolidatePoints();
 
   qreal north = -90;
@@ -885,6 +948,7 @@ void CGisItemTrk::deriveSecondaryData() {
 
   // reset all secondary data
   allValidFlags = 0;
+  cntValidFlags.fill(0);
   cntInvalidPoints = 0;
   cntTotalPoints = 0;
   cntVisiblePoints = 0;
@@ -895,6 +959,7 @@ void CGisItemTrk::deriveSecondaryData() {
   totalDescent = NOFLOAT;
   totalElapsedSeconds = NOTIME;
   totalElapsedSecondsMoving = NOTIME;
+  lod.clear();
 
   trk.removeEmptySegments();
 
@@ -976,46 +1041,131 @@ void CGisItemTrk::deriveSecondaryData() {
   }
 
   constexpr qreal kMargin = 0.0001 * DEG_TO_RAD;  // ~5m
-  boundingRect = QRectF(QPointF(west * DEG_TO_RAD - kMargin, north * DEG_TO_RAD + kMargin),
-                        QPointF(east * DEG_TO_RAD + kMargin, south * DEG_TO_RAD - kMargin));
+  setBoundingRect(QRectF(QPointF(west * DEG_TO_RAD - kMargin, north * DEG_TO_RAD + kMargin),
+                         QPointF(east * DEG_TO_RAD + kMargin, south * DEG_TO_RAD - kMargin)));
+
+  deriveSlopeAndSpeed(lintrk, 0, lintrk.size() - 1);
+
+  for (CTrackData::trkpt_t* trkpt : qAsConst(lintrk)) {
+    // verify data
+    verifyTrkPt(lastValid, *trkpt);
+    // add current status to allValidFlags
+    countValidFlags(trkpt->valid, 1);
+  }
+
+  if (nullptr != lastTrkpt) {
+    timeEnd = lastTrkpt->time;
+    totalDistance = lastTrkpt->distance;
+    totalAscent = lastTrkpt->ascent;
+    totalDescent = lastTrkpt->descent;
+    totalElapsedSeconds = lastTrkpt->elapsedSeconds;
+    totalElapsedSecondsMoving = lastTrkpt->elapsedSecondsMoving;
+  }
+
+  activities.update();
+
+  deriveLevelOfDetail(lintrk);
+
+  updateExtremaAndExtensions(lintrk);
+  // make sure we have a graph properties object by now
+  if (propHandler == nullptr) {
+    propHandler = new CPropertyTrk(*this);
+    limitsGraph1.setSource(CKnownExtension::internalEle);
+  } else {
+    propHandler->setupData();
+  }
+
+  setupInterpolation(interp.valid, interp.Q);
 
-  for (int p = 0; p < lintrk.size(); p++) {
+  energyCycling.compute();
+
+  updateVisuals(eVisualAll, "deriveSecondaryData()");
+
+  //    qDebug() << "--------------" << getName() << "------------------";
+  //    qDebug() << "allValidFlags" << Qt::hex << allValidFlags;
+  //    qDebug() << "totalDistance" << totalDistance;
+  //    qDebug() << "totalAscent" << totalAscent;
+  //    qDebug() << "totalDescent" << totalDescent;
+  //    qDebug() << "totalElapsedSeconds" << totalElapsedSeconds;
+  //    qDebug() << "totalElapsedSecondsMoving" << totalElapsedSecondsMoving;
+}
+
+void CGisItemTrk::deriveSlopeAndSpeed(const QVector<CTrackData::trkpt_t*>& lintrk, qint32 idx1, qint32 idx2) {
+  /*
+      Slope and speed are derived over a window of at least 25m around each point,
+      bounded by the closest points with valid elevation. As the distance never
+      decreases along the track both window bounds can only move forward. Thus
+      the window is slid over the list of points with valid elevation instead of
+      searching it for each point again.
+
+      Note: The lower bound never uses the very first point. This is kept for
+      compatibility with the values calculated so far.
+   */
+  const int N = lintrk.size();
+  QVector<qint32> withEle;
+  withEle.reserve(N);
+  for (int p = 0; p < N; p++) {
+    if (lintrk[p]->ele != NOINT) {
+      withEle << p;
+    }
+  }
+
+  auto distance = [&lintrk](qint32 p) { return lintrk[p]->distance; };
+  auto seconds = [&lintrk](qint32 p) { return lintrk[p]->time.toMSecsSinceEpoch() / 1000.0; };
+
+  // the candidates for the lower bound start at first1, cnt1 of them qualify for the current point
+  const int first1 = (!withEle.isEmpty() && withEle[0] == 0) ? 1 : 0;
+  int cnt1 = 0;
+  // the candidate for the upper bound
+  int cand2 = 0;
+
+  if (idx1 > 0) {
+    // the window of the first point is searched, all following ones are slid
+    const qreal d = distance(idx1);
+    cnt1 = std::partition_point(withEle.begin() + first1, withEle.end(),
+                                [&](qint32 n) { return n <= idx1 && d - distance(n) >= 25; }) -
+           (withEle.begin() + first1);
+    cand2 = std::partition_point(withEle.begin(), withEle.end(),
+                                 [&](qint32 n) { return n < idx1 || distance(n) - d < 25; }) -
+            withEle.begin();
+  }
+
+  for (int p = idx1; p <= idx2; p++) {
     CTrackData::trkpt_t& trkpt = *lintrk[p];
 
-    qreal d1 = trkpt.distance;
-    qreal e1 = trkpt.ele;
-    qreal t1 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
-    for (int n = p; n > 0; --n) {
-      CTrackData::trkpt_t& trkpt2 = *lintrk[n];
-      if (trkpt2.ele == NOINT) {
-        continue;
-      }
+    // the lower bound is the last point at least 25m back or the first point with elevation
+    while ((first1 + cnt1) < withEle.size() && withEle[first1 + cnt1] <= p &&
+           trkpt.distance - distance(withEle[first1 + cnt1]) >= 25) {
+      cnt1++;
+    }
 
-      d1 = trkpt2.distance;
-      e1 = trkpt2.ele;
-      t1 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
-      if (trkpt.distance - trkpt2.distance >= 25) {
-        break;
-      }
+    int n1 = p;
+    if (cnt1 > 0) {
+      n1 = withEle[first1 + cnt1 - 1];
+    } else if (first1 < withEle.size() && withEle[first1] <= p) {
+      n1 = withEle[first1];
     }
 
-    qreal d2 = trkpt.distance;
-    qreal e2 = trkpt.ele;
-    qreal t2 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
-    for (int n = p; n < lintrk.size(); ++n) {
-      CTrackData::trkpt_t& trkpt2 = *lintrk[n];
-      if (trkpt2.ele == NOINT) {
-        continue;
-      }
+    // the upper bound is the first point at least 25m ahead or the last point with elevation
+    while (cand2 < withEle.size() && (withEle[cand2] < p || distance(withEle[cand2]) - trkpt.distance < 25)) {
+      cand2++;
+    }
 
-      d2 = trkpt2.distance;
-      e2 = trkpt2.ele;
-      t2 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
-      if (trkpt2.distance - trkpt.distance >= 25) {
-        break;
-      }
+    int n2 = p;
+    if (cand2 < withEle.size()) {
+      n2 = withEle[cand2];
+    } else if (!withEle.isEmpty() && withEle.last() >= p) {
+      n2 = withEle.last();
     }
 
+    const qreal d1 = distance(n1);
+    const qreal e1 = lintrk[n1]->ele;
+    const qreal t1 = seconds(n1);
+
+    const qreal d2 = distance(n2);
+    const qreal e2 = lintrk[n2]->ele;
+    const qreal t2 = seconds(n2);
+
     if (d1 < d2) {
       qreal a = qAtan((e2 - e1) / (d2 - d1));
       trkpt.slope1 = a * 360.0 / (2 * M_PI);
@@ -1030,33 +1180,178 @@ void CGisItemTrk::deriveSecondaryData() {
     } else {
       trkpt.speed = NOFLOAT;
     }
+  }
+}
+
+void CGisItemTrk::countValidFlags(quint32 valid, qint32 inc) {
+  for (int bit = 0; bit < 32; bit++) {
+    const quint32 flag = quint32(1) << bit;
+    if ((valid & flag) == 0) {
+      continue;
+    }
 
-    // verify data
-    verifyTrkPt(lastValid, trkpt);
-    // add current status to allValidFlags
-    allValidFlags |= trkpt.valid;
-    if ((trkpt.valid & 0xFFFF0000) != 0) {
-      cntInvalidPoints++;
+    cntValidFlags[bit] += inc;
+    if (cntValidFlags[bit] > 0) {
+      allValidFlags |= flag;
+    } else {
+      allValidFlags &= ~flag;
     }
   }
 
-  if (nullptr != lastTrkpt) {
-    timeEnd = lastTrkpt->time;
-    totalDistance = lastTrkpt->distance;
-    totalAscent = lastTrkpt->ascent;
-    totalDescent = lastTrkpt->descent;
-    totalElapsedSeconds = lastTrkpt->elapsedSeconds;
-    totalElapsedSecondsMoving = lastTrkpt->elapsedSecondsMoving;
+  if ((valid & CTrackData::trkpt_t::eInvalidMask) != 0) {
+    cntInvalidPoints += inc;
   }
+}
 
-  activities.update();
+bool CGisItemTrk::deriveSecondaryDataRange(qint32 idxTotal1, qint32 idxTotal2, bool activity) {
+  if ((propHandler == nullptr) || trk.isEmpty()) {
+    return false;
+  }
 
-  updateExtremaAndExtensions();
-  // make sure we have a graph properties object by now
-  if (propHandler == nullptr) {
-    propHandler = new CPropertyTrk(*this);
-    limitsGraph1.setSource(CKnownExtension::internalEle);
+  consolidatePoints();
+  if (activity) {
+    activities.updateFlags();
+  }
+
+  /*
+      Collect the visible points and make sure nothing but the values of points
+      changed. Points inserted, removed, hidden or shown need a full update.
+   */
+  QVector<CTrackData::trkpt_t*> lintrk;
+  lintrk.reserve(cntVisiblePoints);
+  qint32 cntTotal = 0;
+  qint32 p1 = NOIDX;
+  qint32 p2 = NOIDX;
+
+  for (CTrackData::trkpt_t& trkpt : trk) {
+    if (trkpt.idxTotal != cntTotal++) {
+      return false;
+    }
+
+    if (trkpt.isHidden()) {
+      if (trkpt.idxVisible != NOIDX) {
+        return false;
+      }
+      continue;
+    }
+
+    if (trkpt.idxVisible != lintrk.size()) {
+      return false;
+    }
+
+    if ((idxTotal1 <= trkpt.idxTotal) && (trkpt.idxTotal <= idxTotal2)) {
+      if (p1 == NOIDX) {
+        p1 = lintrk.size();
+      }
+      p2 = lintrk.size();
+    }
+
+    lintrk << &trkpt;
+  }
+
+  const qint32 N = lintrk.size();
+  if ((cntTotal != cntTotalPoints) || (N != cntVisiblePoints) || (N != extremaTreeEle.size())) {
+    return false;
+  }
+
+  // the start point defines the reference for all others
+  if (p1 == 0) {
+    return false;
+  }
+
+  if (p1 != NOIDX) {
+    /*
+        Ascent and descent after the range. The last elevation used by the hysteresis
+        is not stored but it is always the start elevation plus the sum of all steps.
+     */
+    const qint32 ele0 = lintrk[0]->ele;
+    qint32 lastEle = NOINT;
+    if (ele0 != NOINT) {
+      const CTrackData::trkpt_t& prev = *lintrk[p1 - 1];
+      lastEle = ele0 + qint32(prev.ascent - prev.descent);
+    }
+
+    for (qint32 p = p1; (p < N) && (lastEle != NOINT); p++) {
+      CTrackData::trkpt_t& trkpt = *lintrk[p];
+      const CTrackData::trkpt_t& last = *lintrk[p - 1];
+      qint32 delta = trkpt.ele - lastEle;
+
+      trkpt.ascent = last.ascent;
+      trkpt.descent = last.descent;
+
+      if (qAbs(delta) >= ASCENT_THRESHOLD) {
+        const qint32 step = (delta / ASCENT_THRESHOLD) * ASCENT_THRESHOLD;
+
+        if (delta > 0) {
+          trkpt.ascent += step;
+        } else {
+          trkpt.descent -= step;
+        }
+        lastEle += step;
+      }
+    }
+
+    /*
+        Slope and speed of a point change if its window reaches into the range. Outside
+        of the range the window is bounded by the first point with elevation at least
+        25m away from the range.
+     */
+    qint32 lo = 0;
+    for (qint32 q = p1 - 1; q >= 0; q--) {
+      if (lintrk[q]->ele != NOINT) {
+        lo = q;
+        while ((lo > 0) && (lintrk[q]->distance - lintrk[lo - 1]->distance < 25)) {
+          lo--;
+        }
+        break;
+      }
+    }
+
+    qint32 hi = N - 1;
+    for (qint32 r = p2 + 1; r < N; r++) {
+      if (lintrk[r]->ele != NOINT) {
+        hi = r;
+        while ((hi < N - 1) && (lintrk[hi + 1]->distance - lintrk[r]->distance < 25)) {
+          hi++;
+        }
+        break;
+      }
+    }
+
+    deriveSlopeAndSpeed(lintrk, lo, hi);
+
+    CTrackData::trkpt_t* lastValid = nullptr;
+    for (qint32 q = lo - 1; q >= 0; q--) {
+      if (lintrk[q]->time.isValid()) {
+        lastValid = lintrk[q];
+        break;
+      }
+    }
+
+    for (qint32 p = lo; p <= hi; p++) {
+      CTrackData::trkpt_t& trkpt = *lintrk[p];
+      countValidFlags(trkpt.valid, -1);
+      verifyTrkPt(lastValid, trkpt);
+      countValidFlags(trkpt.valid, 1);
+
+      extremaTreeSpeed.set(p, trkpt.speed);
+      extremaTreeEle.set(p, trkpt.ele);
+      extremaTreeSlope.set(p, trkpt.slope1);
+    }
+
+    totalAscent = lintrk.last()->ascent;
+    totalDescent = lintrk.last()->descent;
+  }
+
+  if (activity) {
+    activities.update();
   } else {
+    activities.updateSummary();
+  }
+
+  const QSet<QString> extensions = existingExtensions;
+  updateExtremaInternal(lintrk);
+  if (extensions != existingExtensions) {
     propHandler->setupData();
   }
 
@@ -1065,14 +1360,64 @@ void CGisItemTrk::deriveSecondaryData() {
   energyCycling.compute();
 
   updateVisuals(eVisualAll, "deriveSecondaryData()");
+  return true;
+}
 
-  //    qDebug() << "--------------" << getName() << "------------------";
-  //    qDebug() << "allValidFlags" << Qt::hex << allValidFlags;
-  //    qDebug() << "totalDistance" << totalDistance;
-  //    qDebug() << "totalAscent" << totalAscent;
-  //    qDebug() << "totalDescent" << totalDescent;
-  //    qDebug() << "totalElapsedSeconds" << totalElapsedSeconds;
-  //    qDebug() << "totalElapsedSecondsMoving" << totalElapsedSecondsMoving;
+void CGisItemTrk::deriveLevelOfDetail(const QVector<CTrackData::trkpt_t*>& lintrk) {
+  lod.clear();
+
+  const qint32 N = lintrk.size();
+  if (N < 3) {
+    return;
+  }
+
+  // a local cartesian system in [m] is good enough to measure the deviation
+  const qreal cosLat = qCos(boundingRect.center().y());
+  QPolygonF line(N);
+  for (qint32 i = 0; i < N; i++) {
+    line[i] = QPointF(lintrk[i]->lon * cosLat, lintrk[i]->lat) * DEG_TO_RAD * LOD_EARTH_RADIUS;
+  }
+
+  QVector<qreal> tolerance;
+  GPS_Math_DouglasPeuckerTolerance(line, tolerance);
+
+  // each level is a subset of the previous one
+  QVector<qint32> candidates(N);
+  std::iota(candidates.begin(), candidates.end(), 0);
+
+  for (qreal tol = 1.0; (tol < 1e7) && (candidates.size() > 2); tol *= 2) {
+    QVector<qint32> idx;
+    idx.reserve(candidates.size());
+    for (qint32 i : qAsConst(candidates)) {
+      if (tolerance[i] > tol) {
+        idx << i;
+      }
+    }
+
+    // skip levels not worth the memory
+    if (idx.size() > (candidates.size() * 3) / 4) {
+      continue;
+    }
+
+    lod_t level;
+    level.tolerance = tol;
+    level.idx = idx;
+    level.line.reserve(idx.size());
+    for (qint32 i : qAsConst(idx)) {
+      level.line << QPointF(lintrk[i]->lon, lintrk[i]->lat) * DEG_TO_RAD;
+    }
+    lod << level;
+
+    candidates = idx;
+  }
+}
+
+qint32 CGisItemTrk::getIdxLineSimple(qint32 idxVisible) const {
+  if (idxLineSimple.isEmpty()) {
+    return idxVisible;
+  }
+
+  return std::lower_bound(idxLineSimple.begin(), idxLineSimple.end(), idxVisible) - idxLineSimple.begin();
 }
 
 void CGisItemTrk::findWaypointsCloseBy(CProgressDialog& progress, quint32& current) {
@@ -1562,11 +1907,12 @@ void CGisItemTrk::copySelectedPoints() const {
   new CGisItemTrk(name, idx1, idx2, trk, project);
 }
 
-void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
+void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
 
   lineSimple.clear();
   lineFull.clear();
+  idxLineSimple.clear();
 
   if (!isVisible(boundingRect, viewport, gis)) {
     return;
@@ -1583,7 +1929,28 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
   gis->convertRad2Px(p2);
   QRectF extViewport(p1, p2);
 
-  if (mode == eModeNormal) {
+  /*
+      Zoomed out, a simplified line deviating less than a pixel looks the same. Use
+      the coarsest level of detail suitable unless the full line is needed to colorize
+      the track or to interact with it.
+   */
+  const lod_t* level = nullptr;
+  if ((mode == eModeNormal) && getColorizeSource().isEmpty() && (key != keyUserFocus) && (extViewport.width() > 0)) {
+    const qreal metersPerPixel = qAbs(viewport[2].x() - viewport[0].x()) * LOD_EARTH_RADIUS *
+                                 qCos(boundingRect.center().y()) / qAbs(extViewport.width());
+
+    for (const lod_t& l : qAsConst(lod)) {
+      if (l.tolerance > metersPerPixel) {
+        break;
+      }
+      level = &l;
+    }
+  }
+
+  if (level != nullptr) {
+    lineSimple = level->line;
+    idxLineSimple = level->idx;
+  } else if (mode == eModeNormal) {
     // in normal mode the trackline without points marked as deleted is drawn
     for (const CTrackData::trkpt_t& pt : trk) {
       if (pt.isHidden()) {
@@ -1731,7 +2098,7 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
 }
 
 void CGisItemTrk::drawLimitLabels(limit_type_e type, const QString& label, const QPointF& pos, QPainter& p,
-                                  const QFontMetricsF& fm, QList<QRectF>& blockedAreas) {
+                                  const QFontMetricsF& fm, COccupancyGrid& blockedAreas) {
   const QString& fullLabel = (type == eLimitTypeMin ? tr("min.") : tr("max.")) + " " + label;
   QRectF rect = fm.boundingRect(fullLabel);
   rect.moveBottomLeft(pos.toPoint() + QPoint(10, -10));
@@ -2043,7 +2410,7 @@ void CGisItemTrk::drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis) {
   drawRange(p, gis);
 }
 
-void CGisItemTrk::drawLabel(QPainter& p, const QPolygonF&, QList<QRectF>& blockedAreas, const QFontMetricsF& fm,
+void CGisItemTrk::drawLabel(QPainter& p, const QPolygonF&, COccupancyGrid& blockedAreas, const QFontMetricsF& fm,
                             CGisDraw* gis) {
   if (!keyUserFocus.item.isEmpty() && (key != keyUserFocus)) {
     return;
@@ -2109,6 +2476,10 @@ void CGisItemTrk::drawRange(QPainter& p, CGisDraw* gis) {
   }
 
   const QPolygonF& line = (mode == eModeRange) ? lineFull : lineSimple;
+  if (mode != eModeRange) {
+    idx1 = getIdxLineSimple(idx1);
+    idx2 = getIdxLineSimple(idx2);
+  }
 
   QPolygonF seg = line.mid(idx1, idx2 - idx1 + 1);
 
@@ -2189,6 +2560,7 @@ void CGisItemTrk::setElevation(qint32 idx, qint32 ele) {
   CTrackData::trkpt_t* trkpt = trk.getTrkPtByTotalIndex(idx);
   if ((trkpt != nullptr) && (trkpt->ele != ele)) {
     trkpt->ele = ele;
+    trk.setDirty(idx, idx);
     deriveSecondaryData();
     changed(tr("Changed elevation of point %1 to %2 %3")
                 .arg(idx)
@@ -2238,6 +2610,7 @@ void CGisItemTrk::setActivityRange(trkact_t act) {
     }
   }
 
+  trk.setDirty(idx1, idx2 - 1, true);
   deriveSecondaryData();
   changed(tr("Changed activity to '%1' for range(%2..%3).").arg(desc.name).arg(idx1).arg(idx2), desc.iconLarge);
 }
@@ -2341,7 +2714,12 @@ QPointF CGisItemTrk::setMouseFocusByPoint(const QPoint& pt, focusmode_e fmode, c
      */
 
     idx = getIdxPointCloseBy(pt, line);
-    newPointOfFocus = (mode == eModeRange) ? trk.getTrkPtByTotalIndex(idx) : trk.getTrkPtByVisibleIndex(idx);
+    if (mode == eModeRange) {
+      newPointOfFocus = trk.getTrkPtByTotalIndex(idx);
+    } else {
+      // if a level of detail is drawn the index has to be mapped back to the visible index
+      newPointOfFocus = trk.getTrkPtByVisibleIndex(idxLineSimple.isEmpty() ? idx : idxLineSimple[idx]);
+    }
   }
 
   if (!publishMouseFocus(newPointOfFocus, fmode, owner)) {
@@ -2584,6 +2962,12 @@ void CGisItemTrk::updateHistory(quint32 visuals) {
 void CGisItemTrk::updateVisuals(quint32 visuals, const QString& who) {
   qDebug() << "CGisItemTrk::updateVisuals()" << getName() << who;
 
+  // A track loaded by a worker thread has no visuals yet. And the canvas must not be
+  // touched by any thread other than the GUI thread.
+  if (QThread::currentThread() != qApp->thread()) {
+    return;
+  }
+
   if (!dlgDetails.isNull() && (visuals & eVisualDetails)) {
     dlgDetails->updateData();
   }
@@ -2720,6 +3104,10 @@ bool CGisItemTrk::findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qi
 }
 
 void CGisItemTrk::checkForInvalidPoints() {
+  if (QThread::currentThread() != qApp->thread()) {
+    return;
+  }
+
   IGisProject* project = getParentProject();
   if (project && project->getInvalidDataOk()) {
     return;
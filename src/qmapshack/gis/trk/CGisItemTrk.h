@@ -35,11 +35,13 @@
 #include "gis/trk/filter/CFilterSpeedCycle.h"
 #include "gis/trk/filter/CFilterSpeedHike.h"
 #include "helpers/CLimit.h"
+#include "helpers/CMinMaxTree.h"
 #include "helpers/CValue.h"
 
 using std::numeric_limits;
 
 class QDomNode;
+class QXmlStreamReader;
 class IGisProject;
 class INotifyTrk;
 class CDetailsTrk;
@@ -57,6 +59,8 @@ class CCanvas;
 
 class CGisItemTrk : public IGisItem, public IGisLine {
   Q_DECLARE_TR_FUNCTIONS(CGisItemTrk)
+  friend class CWorkspaceLoader;
+
  public:
   enum focusmode_e { eFocusMouseMove, eFocusMouseClick };
 
@@ -96,6 +100,28 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   /** @brief Used to create track from GPX file */
   CGisItemTrk(const QDomNode& xml, IGisProject* project);
 
+  /**
+     @brief Used to create track from a GPX file read as stream
+
+     @param xml       The <trk> section without segments as returned by readTrk()
+     @param segs      The segments read by readTrk(). They are moved into the track.
+     @param project   The project to add the track to
+   */
+  CGisItemTrk(const QDomNode& xml, QVector<CTrackData::trkseg_t>& segs, IGisProject* project);
+
+  /**
+     @brief Read a <trk> section of a GPX file read as stream
+
+     The points are decoded directly from the stream. All other elements are small.
+     They are copied into a DOM to be read by the DOM based code.
+
+     @param xml   The stream positioned at the start of the <trk> section
+     @param doc   The document to create the DOM with
+     @param segs  The segments to fill
+     @return The <trk> section without the segments
+   */
+  static QDomElement readTrk(QXmlStreamReader& xml, QDomDocument& doc, QVector<CTrackData::trkseg_t>& segs);
+
   /** @brief Used to restore track from history structure */
   CGisItemTrk(const history_t& hist, const QString& dbHash, IGisProject* project);
 
@@ -236,6 +262,25 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   const CTrackData::trkpt_t* getMouseMoveFocusPoint() const { return mouseMoveFocus; }
   quint32 getAllValidFlags() const { return allValidFlags; }
 
+  /**
+     @brief Get the number of times the secondary data has been derived
+
+     @param full    receives the number of complete updates
+     @param range   receives the number of updates limited to a range of changed points
+   */
+  void getDeriveStatistics(quint32& full, quint32& range) const {
+    full = cntDeriveFull;
+    range = cntDeriveRange;
+  }
+
+  /**
+     @brief Ask the user what to do with invalid points of the track
+
+     Does nothing if called by a thread other than the GUI thread. Thus tracks loaded
+     by worker threads have to be checked by the GUI thread afterwards.
+   */
+  void checkForInvalidPoints();
+
   /// get the track as a simple coordinate polyline
   void getPolylineFromData(QPolygonF& l) const;
   /// get the track as polyline with elevation, pixel and GIS coordinates.
@@ -348,9 +393,9 @@ class CGisItemTrk : public IGisItem, public IGisLine {
 
   bool isWithin(const QRectF& area, selflags_t flags) override;
 
-  void drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) override;
+  void drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) override;
   void drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis) override;
-  void drawLabel(QPainter& p, const QPolygonF&, QList<QRectF>& blockedAreas, const QFontMetricsF& fm,
+  void drawLabel(QPainter& p, const QPolygonF&, COccupancyGrid& blockedAreas, const QFontMetricsF& fm,
                  CGisDraw* gis) override;
   void drawHighlight(QPainter& p) override;
   void drawRange(QPainter& p, CGisDraw* gis);
@@ -620,6 +665,12 @@ class CGisItemTrk : public IGisItem, public IGisLine {
      @param trk   The track structure to fill
    */
   void readTrk(const QDomNode& xml, CTrackData& trk);
+  /**
+     @brief Read all but the segments of a <trk> section
+     @param xml   The XML <trk> section
+     @param trk   The track structure to fill
+   */
+  void readTrkHead(const QDomNode& xml, CTrackData& trk);
 
   /**
      @brief Restore track from TwoNav *trk file
@@ -644,6 +695,60 @@ class CGisItemTrk : public IGisItem, public IGisLine {
    */
   void deriveSecondaryData();
 
+  /**
+     @brief Update the secondary data after the elevation or activity of some points changed
+
+     Called by deriveSecondaryData() if a range of points is marked as changed. Only the
+     slope, speed and validity around the range are updated. The extrema, the valid flags
+     and the activity summary are updated from their trees and counters.
+
+     Still linear in the number of points are the pointer pass verifying the structure of
+     the track and the ascent and descent after the range, as both are cumulative. The
+     activity flags are set again only if activities changed. The interpolation and the
+     cycling energy are global and recalculated only if enabled by the user.
+
+     @param idxTotal1   the total index of the first point changed
+     @param idxTotal2   the total index of the last point changed
+     @param activity    true if the activity of points in the range changed
+     @return False if the structure of the track changed and a full update is needed.
+   */
+  bool deriveSecondaryDataRange(qint32 idxTotal1, qint32 idxTotal2, bool activity);
+
+  /**
+     @brief Add or remove the valid flags of a point to the track statistics
+
+     @param valid     the valid flags of the point
+     @param inc       1 to add the point, -1 to remove it
+   */
+  void countValidFlags(quint32 valid, qint32 inc);
+
+  /**
+     @brief Derive slope and speed for a range of visible points
+
+     @param lintrk    linear list of all visible track points
+     @param idx1      the index of the first point into lintrk
+     @param idx2      the index of the last point into lintrk
+   */
+  void deriveSlopeAndSpeed(const QVector<CTrackData::trkpt_t*>& lintrk, qint32 idx1, qint32 idx2);
+
+  /**
+     @brief Build the level of detail pyramid from the visible points
+
+     Called by deriveSecondaryData(). Each level is a Douglas-Peucker simplification
+     of the visible track line with twice the tolerance of the previous one.
+
+     @param lintrk    linear list of all visible track points
+   */
+  void deriveLevelOfDetail(const QVector<CTrackData::trkpt_t*>& lintrk);
+
+  /**
+     @brief Get the position in lineSimple of a point by its visible index
+
+     If lineSimple holds a level of detail the position of the first point at or
+     after the visible index is returned.
+   */
+  qint32 getIdxLineSimple(qint32 idxVisible) const;
+
   /**
    * @brief Reset internal data like range selection and details dialog
    */
@@ -682,11 +787,19 @@ class CGisItemTrk : public IGisItem, public IGisLine {
  private:
   QSet<QString> existingExtensions;
   QHash<QString, limits_t> extrema;
-  void updateExtremaAndExtensions();
+  void updateExtremaAndExtensions(const QVector<CTrackData::trkpt_t*>& lintrk);
+  /// update the extrema of the internal values from the trees below
+  void updateExtremaInternal(const QVector<CTrackData::trkpt_t*>& lintrk);
+
+  // the internal values by visible index to update the extrema point by point
+  CMinMaxTree extremaTreeSpeed;
+  CMinMaxTree extremaTreeEle;
+  CMinMaxTree extremaTreeSlope;
+  CMinMaxTree extremaTreeProgress;
 
   enum limit_type_e { eLimitTypeMin, eLimitTypeMax };
   void drawLimitLabels(limit_type_e type, const QString& label, const QPointF& pos, QPainter& p,
-                       const QFontMetricsF& fm, QList<QRectF>& blockedAreas);
+                       const QFontMetricsF& fm, COccupancyGrid& blockedAreas);
 
   /**
      @brief Tell the point of focus to all plots and the detail dialog
@@ -781,6 +894,8 @@ class CGisItemTrk : public IGisItem, public IGisLine {
    */
   /**@{*/
   quint32 allValidFlags = 0;
+  /// the number of visible points per bit of the valid flags
+  QVector<qint32> cntValidFlags = QVector<qint32>(32, 0);
   qint32 cntInvalidPoints = 0;
   qint32 cntTotalPoints = 0;
   qint32 cntVisiblePoints = 0;
@@ -793,8 +908,10 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   qreal totalElapsedSecondsMoving = 0;
   quint32 numberOfAttachedWpt = 0;
   CEnergyCycling energyCycling{*this};
-
-  void checkForInvalidPoints();
+  /// the number of complete updates of the secondary data
+  quint32 cntDeriveFull = 0;
+  /// the number of updates limited to a range of changed points
+  quint32 cntDeriveRange = 0;
   /**@}*/
 
   /**
@@ -809,6 +926,16 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   QPolygonF lineSimple;  //< the current track line as screen pixel coordinates
   QPolygonF lineFull;    //< visible and invisible points
 
+  QVector<qint32> idxLineSimple;  //< visible index of each point in lineSimple, empty if all points are used
+
+  struct lod_t {
+    qreal tolerance;      //< maximum deviation from the visible track line [m]
+    QPolygonF line;       //< the remaining points [rad]
+    QVector<qint32> idx;  //< the visible index of each point in line
+  };
+  /// level of detail pyramid ordered by increasing tolerance
+  QVector<lod_t> lod;
+
   qint32 penWidthFg = 1;   //< inner trackline width
   qint32 penWidthBg = 3;   //< outer trackline width
   qint32 penWidthHi = 11;  //< highlighted trackline width
@@ -19,6 +19,7 @@
 #ifndef CKNOWNEXTENSION_H
 #define CKNOWNEXTENSION_H
 
+#include <QRecursiveMutex>
 #include <QSet>
 
 #include "gis/trk/CGisItemTrk.h"
@@ -98,6 +99,8 @@ class CKnownExtension {
  private:
   static bool registerNS(const QString& ns);
 
+  /// namespaces are registered by worker threads loading GPX files while others read the extensions
+  static QRecursiveMutex mutexKnownExtensions;
   static QHash<QString, CKnownExtension> knownExtensions;
   static QSet<QString> registeredNS;
 
@@ -249,3 +249,22 @@ bool CTrackData::delTrkPtDesc(const QList<int>& idxTotal) {
 
   return result;
 }
+
+void CTrackData::setDirty(qint32 idxTotal1, qint32 idxTotal2, bool activity) {
+  dirtyActivity = dirtyActivity || activity;
+
+  if (dirtyFirst == NOIDX) {
+    dirtyFirst = idxTotal1;
+    dirtyLast = idxTotal2;
+  } else {
+    dirtyFirst = qMin(dirtyFirst, idxTotal1);
+    dirtyLast = qMax(dirtyLast, idxTotal2);
+  }
+}
+
+bool CTrackData::getDirty(qint32& idxTotal1, qint32& idxTotal2, bool& activity) const {
+  idxTotal1 = dirtyFirst;
+  idxTotal2 = dirtyLast;
+  activity = dirtyActivity;
+  return dirtyFirst != NOIDX;
+}
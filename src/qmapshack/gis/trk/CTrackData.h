@@ -256,6 +256,36 @@ class CTrackData {
    */
   bool isTrkPtLastVisible(qint32 idxTotal) const;
 
+  /**
+     @brief Mark a range of points as changed
+
+     Use this if only the elevation or the activity of some points has been changed.
+     The next call of CGisItemTrk::deriveSecondaryData() will update the secondary data
+     around the range instead of recalculating the complete track. Any other change
+     must not mark a range. Several ranges are merged into one.
+
+     @param idxTotal1  the total index of the first point changed
+     @param idxTotal2  the total index of the last point changed
+     @param activity   true if the activity of the points has been changed
+   */
+  void setDirty(qint32 idxTotal1, qint32 idxTotal2, bool activity = false);
+
+  /**
+     @brief Get the range of points marked as changed
+
+     @param idxTotal1  the total index of the first point changed
+     @param idxTotal2  the total index of the last point changed
+     @param activity   set true if the activity of any point in the range has been changed
+     @return False if no range has been marked.
+   */
+  bool getDirty(qint32& idxTotal1, qint32& idxTotal2, bool& activity) const;
+
+  void clearDirty() {
+    dirtyFirst = NOIDX;
+    dirtyLast = NOIDX;
+    dirtyActivity = false;
+  }
+
   bool setTrkPtDesc(int idxTotal, const QString& desc);
 
   bool delTrkPtDesc(const QList<int>& idxTotal);
@@ -310,6 +340,11 @@ class CTrackData {
   iterator<const CTrackData, const trkpt_t> end() const {
     return iterator<const CTrackData, const trkpt_t>(*this, segs.count(), 0);
   }
+
+ private:
+  qint32 dirtyFirst = NOIDX;   //< the total index of the first point changed
+  qint32 dirtyLast = NOIDX;    //< the total index of the last point changed
+  bool dirtyActivity = false;  //< the activity of a point in the range has been changed
 };
 
 QDataStream& operator<<(QDataStream& stream, const CTrackData::trkpt_t& pt);
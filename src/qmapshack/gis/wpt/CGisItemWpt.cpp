@@ -36,6 +36,7 @@
 #include "gis/wpt/CScrOptWptRadius.h"
 #include "gis/wpt/CSetupIconAndName.h"
 #include "helpers/CDraw.h"
+#include "helpers/COccupancyGrid.h"
 #include "helpers/CSettings.h"
 #include "helpers/CWptIconManager.h"
 #include "mouse/IMouse.h"
@@ -507,14 +508,14 @@ bool CGisItemWpt::isCloseTo(const QPointF& pos) {
   }
 
   QPointF dist = (pos - posScreen);
-  if (dist.manhattanLength() < 22) {
+  if (dist.manhattanLength() < kCloseToTolerance) {
     return true;
   }
   if (radius == NOFLOAT) {
     return false;
   }
 
-  closeToRadius = abs(QPointF::dotProduct(dist, dist) / radius - radius) < 22;
+  closeToRadius = abs(QPointF::dotProduct(dist, dist) / radius - radius) < kCloseToTolerance;
   return closeToRadius;
 }
 
@@ -541,7 +542,7 @@ void CGisItemWpt::editInitial() {
   squashHistory();
 }
 
-void CGisItemWpt::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
+void CGisItemWpt::drawItem(QPainter& p, const QPolygonF& viewport, COccupancyGrid& blockedAreas, CGisDraw* gis) {
   posScreen = QPointF(wpt.lon * DEG_TO_RAD, wpt.lat * DEG_TO_RAD);
 
   if (proximity == NOFLOAT || proximity == 0. ? !isVisible(posScreen, viewport, gis)
@@ -597,7 +598,7 @@ void CGisItemWpt::drawItem(QPainter& p, const QRectF& /*viewport*/, CGisDraw* gi
   }
 }
 
-void CGisItemWpt::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, QList<QRectF>& blockedAreas,
+void CGisItemWpt::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, COccupancyGrid& blockedAreas,
                             const QFontMetricsF& fm, CGisDraw* /*gis*/) {
   if (flags & eFlagWptBubble) {
     return;
@@ -872,7 +873,7 @@ void CGisItemWpt::processMouseOverBubble(const QPoint& pos) {
 
 void CGisItemWpt::detBoundingRect() {
   if (proximity == NOFLOAT) {
-    boundingRect = QRectF(QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD, QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD);
+    setBoundingRect(QRectF(QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD, QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD));
   } else {
     qreal diag = proximity * 1.414213562;
     QPointF cent(wpt.lon * DEG_TO_RAD, wpt.lat * DEG_TO_RAD);
@@ -880,7 +881,7 @@ void CGisItemWpt::detBoundingRect() {
     QPointF pt1 = GPS_Math_Wpt_Projection(cent, diag, 225 * DEG_TO_RAD);
     QPointF pt2 = GPS_Math_Wpt_Projection(cent, diag, 45 * DEG_TO_RAD);
 
-    boundingRect = QRectF(pt1, pt2);
+    setBoundingRect(QRectF(pt1, pt2));
   }
 }
 
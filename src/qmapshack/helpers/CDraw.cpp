@@ -25,6 +25,8 @@
 #include <QPointF>
 #include <QtMath>
 
+#include "helpers/COccupancyGrid.h"
+
 QPen CDraw::penBorderBlue(QColor(10, 10, 150, 220), 2);
 QPen CDraw::penBorderGray(Qt::lightGray, 2);
 QPen CDraw::penBorderBlack(QColor(0, 0, 0, 200), 2);
@@ -240,6 +242,8 @@ bool CDraw::doesOverlap(const QList<QRectF>& blockedAreas, const QRectF& rect) {
   return false;
 }
 
+bool CDraw::doesOverlap(const COccupancyGrid& blockedAreas, const QRectF& rect) { return blockedAreas.intersects(rect); }
+
 void CDraw::number(int num, int size, QPainter& p, const QPointF& center, const QColor& color) {
   const qreal size_2 = (size - 1) / 2.0;
 
@@ -33,6 +33,8 @@ inline void USE_ANTI_ALIASING(QPainter& p, bool useAntiAliasing) {
 #define RECT_RADIUS 3
 #define PAINT_ROUNDED_RECT(p, r) p.drawRoundedRect(r, RECT_RADIUS, RECT_RADIUS)
 
+class COccupancyGrid;
+
 class CDraw {
  public:
   static QPen penBorderBlue;
@@ -105,6 +107,7 @@ class CDraw {
   static QPoint bubble(QPainter& p, const QRect& contentRect, const QPoint& pointerPos, const QColor& background);
 
   static bool doesOverlap(const QList<QRectF>& blockedAreas, const QRectF& rect);
+  static bool doesOverlap(const COccupancyGrid& blockedAreas, const QRectF& rect);
 
   /**
      @brief   Creates a new arrow using the brush specified
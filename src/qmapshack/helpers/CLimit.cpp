@@ -20,6 +20,7 @@
 
 #include "helpers/CSettings.h"
 
+QRecursiveMutex CLimit::mutexAllLimits;
 QSet<CLimit*> CLimit::allLimits;
 
 CLimit::CLimit(const QString& cfgPath, fGetLimit getMin, fGetLimit getMax, fGetLimit getMinAuto, fGetLimit getMaxAuto,
@@ -31,10 +32,14 @@ CLimit::CLimit(const QString& cfgPath, fGetLimit getMin, fGetLimit getMax, fGetL
       funcGetMaxAuto(getMaxAuto),
       funcGetUnit(getUnit),
       funcMarkChanged(markChanged) {
+  QMutexLocker lock(&mutexAllLimits);
   allLimits << this;
 }
 
-CLimit::~CLimit() { allLimits.remove(this); }
+CLimit::~CLimit() {
+  QMutexLocker lock(&mutexAllLimits);
+  allLimits.remove(this);
+}
 
 void CLimit::setMode(mode_e m) {
   bool markAsChanged = mode != m;
@@ -161,6 +166,7 @@ void CLimit::setMax(const qreal& val) {
 QString CLimit::getUnit() const { return funcGetUnit(source); }
 
 void CLimit::updateSys() {
+  QMutexLocker lock(&mutexAllLimits);
   for (CLimit* limit : qAsConst(allLimits)) {
     if (limit != this) {
       limit->updateSys(source);
@@ -20,6 +20,7 @@
 #define CLIMIT_H
 
 #include <QObject>
+#include <QRecursiveMutex>
 #include <QSet>
 #include <QString>
 #include <QVariant>
@@ -79,6 +80,8 @@ class CLimit : public QObject {
 
   QString source;
 
+  /// tracks and thus their limits are created by worker threads loading projects, too
+  static QRecursiveMutex mutexAllLimits;
   static QSet<CLimit*> allLimits;
 };
 
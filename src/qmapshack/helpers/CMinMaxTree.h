@@ -0,0 +1,119 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CMINMAXTREE_H
+#define CMINMAXTREE_H
+
+#include <QVector>
+
+#include "units/IUnit.h"
+
+/**
+   @brief A segment tree to keep track of the minimum and maximum of a list of values
+
+   Changing a single value costs O(log n) instead of scanning the complete list again.
+   Values equal to NOFLOAT are ignored. Of several equal extrema the one with the lowest
+   index is reported, just like a linear scan with a strict comparison would do.
+ */
+class CMinMaxTree {
+ public:
+  CMinMaxTree() = default;
+  virtual ~CMinMaxTree() = default;
+
+  void clear() {
+    values.clear();
+    nodes.clear();
+  }
+
+  int size() const { return values.size(); }
+
+  /// build the tree from scratch
+  void build(const QVector<qreal>& vals) {
+    values = vals;
+
+    const int N = values.size();
+    nodes.fill({NOIDX, NOIDX}, 2 * N);
+    for (int i = 0; i < N; i++) {
+      if (values[i] != NOFLOAT) {
+        nodes[N + i] = {i, i};
+      }
+    }
+    for (int i = N - 1; i > 0; i--) {
+      nodes[i] = combine(nodes[2 * i], nodes[2 * i + 1]);
+    }
+  }
+
+  /// change a single value and update all nodes up to the root
+  void set(int idx, qreal value) {
+    const int N = values.size();
+    values[idx] = value;
+
+    int i = N + idx;
+    nodes[i] = (value != NOFLOAT) ? node_t{idx, idx} : node_t{NOIDX, NOIDX};
+    for (i >>= 1; i > 0; i >>= 1) {
+      nodes[i] = combine(nodes[2 * i], nodes[2 * i + 1]);
+    }
+  }
+
+  qreal value(int idx) const { return values[idx]; }
+
+  /// @return the index of the minimum value or NOIDX if there is no valid value at all
+  int getIdxMin() const { return root().idxMin; }
+  /// @return the index of the maximum value or NOIDX if there is no valid value at all
+  int getIdxMax() const { return root().idxMax; }
+
+ private:
+  struct node_t {
+    int idxMin;
+    int idxMax;
+  };
+
+  node_t root() const { return values.isEmpty() ? node_t{NOIDX, NOIDX} : nodes[1]; }
+
+  /*
+      The leafs are not in order for sizes other than a power of two. That is
+      why ties are resolved by the index and not by the position in the tree.
+   */
+  node_t combine(const node_t& a, const node_t& b) const {
+    return {select(a.idxMin, b.idxMin, [](qreal v1, qreal v2) { return v1 < v2; }),
+            select(a.idxMax, b.idxMax, [](qreal v1, qreal v2) { return v1 > v2; })};
+  }
+
+  template <typename F>
+  int select(int idx1, int idx2, F isBetter) const {
+    if (idx1 == NOIDX) {
+      return idx2;
+    }
+    if (idx2 == NOIDX) {
+      return idx1;
+    }
+    if (isBetter(values[idx1], values[idx2])) {
+      return idx1;
+    }
+    if (isBetter(values[idx2], values[idx1])) {
+      return idx2;
+    }
+    return qMin(idx1, idx2);
+  }
+
+  QVector<qreal> values;
+  /// the root is nodes[1], the leafs start at nodes[size()]
+  QVector<node_t> nodes;
+};
+
+#endif  // CMINMAXTREE_H
@@ -0,0 +1,109 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "helpers/COccupancyGrid.h"
+
+#include <QtCore>
+
+#include "units/IUnit.h"
+
+// rectangles covering more cells in one direction are kept in the list of large areas
+constexpr qint32 kMaxCells = 16;
+
+COccupancyGrid::COccupancyGrid(qreal cellSize) : cellSize(cellSize) {}
+
+void COccupancyGrid::clear() {
+  rects.clear();
+  cells.clear();
+  large.clear();
+}
+
+bool COccupancyGrid::cellRange(const QRectF& rect, qint32& x1, qint32& y1, qint32& x2, qint32& y2) const {
+  const QRectF& r = rect.normalized();
+  const qreal left = r.left() / cellSize;
+  const qreal top = r.top() / cellSize;
+  const qreal right = r.right() / cellSize;
+  const qreal bottom = r.bottom() / cellSize;
+
+  // this is false for NaN, too
+  const qreal limit = std::numeric_limits<qint32>::max() / 2;
+  if (!(qAbs(left) < limit && qAbs(top) < limit && qAbs(right) < limit && qAbs(bottom) < limit)) {
+    return false;
+  }
+
+  x1 = qFloor(left);
+  y1 = qFloor(top);
+  x2 = qFloor(right);
+  y2 = qFloor(bottom);
+  return (x2 - x1 < kMaxCells) && (y2 - y1 < kMaxCells);
+}
+
+int COccupancyGrid::add(const QRectF& rect) {
+  const qint32 idx = rects.size();
+  rects << rect;
+
+  qint32 x1, y1, x2, y2;
+  if (!cellRange(rect, x1, y1, x2, y2)) {
+    large << idx;
+    return idx;
+  }
+
+  for (qint32 y = y1; y <= y2; y++) {
+    for (qint32 x = x1; x <= x2; x++) {
+      cells[cellKey(x, y)] << idx;
+    }
+  }
+  return idx;
+}
+
+int COccupancyGrid::findFirst(const QRectF& rect) const {
+  qint32 x1, y1, x2, y2;
+  if (!cellRange(rect, x1, y1, x2, y2)) {
+    // too large to look at the cells, test all areas
+    for (qint32 idx = 0; idx < rects.size(); idx++) {
+      if (rects[idx].intersects(rect)) {
+        return idx;
+      }
+    }
+    return NOIDX;
+  }
+
+  qint32 first = NOIDX;
+  auto test = [&](const QVector<qint32>& indices) {
+    for (qint32 idx : indices) {
+      if ((first != NOIDX) && (idx >= first)) {
+        return;
+      }
+      if (rects[idx].intersects(rect)) {
+        first = idx;
+        return;
+      }
+    }
+  };
+
+  test(large);
+  for (qint32 y = y1; y <= y2; y++) {
+    for (qint32 x = x1; x <= x2; x++) {
+      auto cell = cells.constFind(cellKey(x, y));
+      if (cell != cells.constEnd()) {
+        test(*cell);
+      }
+    }
+  }
+  return first;
+}
@@ -0,0 +1,89 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef COCCUPANCYGRID_H
+#define COCCUPANCYGRID_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+/**
+   @brief Areas on the screen already occupied by icons and labels
+
+   The rectangles are sorted into the cells of a uniform grid. An overlap test
+   only has to look at the rectangles of the cells covered by the tested
+   rectangle. Thus the time of a test does not depend on the number of
+   rectangles as long as they are small compared to the screen. Rectangles
+   covering a lot of cells are kept in a separate list that is always tested.
+
+   The overlap test is the one of QRectF::intersects().
+ */
+class COccupancyGrid {
+ public:
+  /// @param cellSize   the width and height of a cell in pixel
+  explicit COccupancyGrid(qreal cellSize = 64);
+  virtual ~COccupancyGrid() = default;
+
+  void clear();
+
+  bool isEmpty() const { return rects.isEmpty(); }
+
+  int size() const { return rects.size(); }
+
+  const QRectF& at(int idx) const { return rects[idx]; }
+
+  /**
+     @brief Mark an area as occupied
+
+     @param rect      the area in pixel
+     @return The index of the area. Areas are numbered in the order they are added.
+   */
+  int add(const QRectF& rect);
+
+  COccupancyGrid& operator<<(const QRectF& rect) {
+    add(rect);
+    return *this;
+  }
+
+  /// @return True if the rectangle overlaps with any occupied area
+  bool intersects(const QRectF& rect) const { return findFirst(rect) >= 0; }
+
+  /**
+     @brief Find the first occupied area that overlaps with the rectangle
+
+     @param rect      the rectangle in pixel
+     @return The smallest index of all overlapping areas or NOIDX.
+   */
+  int findFirst(const QRectF& rect) const;
+
+ private:
+  /// the range of cells covered by a rectangle, false if the rectangle is too large for the grid
+  bool cellRange(const QRectF& rect, qint32& x1, qint32& y1, qint32& x2, qint32& y2) const;
+  static quint64 cellKey(qint32 x, qint32 y) { return (quint64(quint32(x)) << 32) | quint32(y); }
+
+  qreal cellSize;
+
+  QVector<QRectF> rects;
+  /// the indices of the areas by cell, in ascending order
+  QHash<quint64, QVector<qint32>> cells;
+  /// the indices of all areas too large to be sorted into cells, in ascending order
+  QVector<qint32> large;
+};
+
+#endif  // COCCUPANCYGRID_H
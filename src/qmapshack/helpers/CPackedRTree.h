@@ -0,0 +1,209 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CPACKEDRTREE_H
+#define CPACKEDRTREE_H
+
+#include <QRectF>
+#include <QVarLengthArray>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+
+/**
+   @brief A static R-tree packed with the Sort-Tile-Recursive algorithm
+
+   The tree is built once from a list of bounding rectangles and their values. It can't
+   be altered afterwards. Rebuild it if the content changes. Rectangles with negative
+   width or height are normalized. All queries are inclusive, thus rectangles touching
+   the query area are reported, too. Use it as a pre-filter and apply the exact test
+   on the result.
+
+   @tparam T  the value stored with each rectangle, e.g. an index into another list.
+ */
+template <typename T>
+class CPackedRTree {
+ public:
+  CPackedRTree() = default;
+  virtual ~CPackedRTree() = default;
+
+  void clear() {
+    items.clear();
+    levels.clear();
+  }
+
+  bool isEmpty() const { return items.isEmpty(); }
+
+  int size() const { return items.size(); }
+
+  /**
+     @brief Build the tree from scratch
+
+     @param rects     the bounding rectangles
+     @param values    the value for each rectangle. Must have the same size as rects.
+   */
+  void build(const QVector<QRectF>& rects, const QVector<T>& values) {
+    clear();
+    Q_ASSERT(rects.size() == values.size());
+
+    const int N = rects.size();
+    if (N == 0) {
+      return;
+    }
+
+    items.reserve(N);
+    for (int i = 0; i < N; i++) {
+      const QRectF& r = rects[i].normalized();
+      items << item_t{{r.left(), r.top(), r.right(), r.bottom()}, values[i]};
+    }
+
+    // Sort-Tile-Recursive: sort by x, cut into vertical slices and sort each slice by y
+    const int nLeafs = (N + nodeSize - 1) / nodeSize;
+    const int nSlices = int(std::ceil(std::sqrt(qreal(nLeafs))));
+    const int sliceSize = nSlices * nodeSize;
+
+    std::sort(items.begin(), items.end(),
+              [](const item_t& a, const item_t& b) { return a.box.centerX() < b.box.centerX(); });
+    for (int i = 0; i < N; i += sliceSize) {
+      std::sort(items.begin() + i, items.begin() + qMin(i + sliceSize, N),
+                [](const item_t& a, const item_t& b) { return a.box.centerY() < b.box.centerY(); });
+    }
+
+    // build the node levels bottom up until a single root node is left
+    QVector<box_t> level;
+    level.reserve(nLeafs);
+    for (int i = 0; i < N; i += nodeSize) {
+      box_t box = items[i].box;
+      for (int j = i + 1; j < qMin(i + nodeSize, N); j++) {
+        box.unite(items[j].box);
+      }
+      level << box;
+    }
+    levels << level;
+
+    while (levels.last().size() > 1) {
+      const QVector<box_t>& children = levels.last();
+      const int M = children.size();
+
+      QVector<box_t> parents;
+      parents.reserve((M + nodeSize - 1) / nodeSize);
+      for (int i = 0; i < M; i += nodeSize) {
+        box_t box = children[i];
+        for (int j = i + 1; j < qMin(i + nodeSize, M); j++) {
+          box.unite(children[j]);
+        }
+        parents << box;
+      }
+      levels << parents;
+    }
+  }
+
+  /**
+     @brief Call a function for each value with a bounding rectangle intersecting the area
+
+     @param area      the query area. It does not need to be normalized.
+     @param func      a functor taking a const reference to the value
+   */
+  template <typename F>
+  void query(const QRectF& area, F func) const {
+    if (items.isEmpty()) {
+      return;
+    }
+
+    const QRectF& r = area.normalized();
+    const box_t box{r.left(), r.top(), r.right(), r.bottom()};
+
+    struct entry_t {
+      int level;
+      int index;
+    };
+
+    QVarLengthArray<entry_t, 64> stack;
+    stack.append({levels.size() - 1, 0});
+
+    while (!stack.isEmpty()) {
+      const entry_t entry = stack.last();
+      stack.removeLast();
+
+      if (!levels[entry.level][entry.index].intersects(box)) {
+        continue;
+      }
+
+      const int first = entry.index * nodeSize;
+      if (entry.level == 0) {
+        const int last = qMin(first + nodeSize, items.size());
+        for (int i = first; i < last; i++) {
+          if (items[i].box.intersects(box)) {
+            func(items[i].value);
+          }
+        }
+      } else {
+        const int last = qMin(first + nodeSize, levels[entry.level - 1].size());
+        for (int i = last - 1; i >= first; i--) {
+          stack.append({entry.level - 1, i});
+        }
+      }
+    }
+  }
+
+  /**
+     @brief Collect all values with a bounding rectangle intersecting the area
+
+     @param area      the query area. It does not need to be normalized.
+     @param result    the values found are appended to this list
+   */
+  void query(const QRectF& area, QVector<T>& result) const {
+    query(area, [&result](const T& value) { result << value; });
+  }
+
+ private:
+  enum { nodeSize = 16 };
+
+  struct box_t {
+    qreal left;
+    qreal top;
+    qreal right;
+    qreal bottom;
+
+    qreal centerX() const { return (left + right) / 2; }
+    qreal centerY() const { return (top + bottom) / 2; }
+
+    bool intersects(const box_t& b) const {
+      return !(b.left > right || b.right < left || b.top > bottom || b.bottom < top);
+    }
+
+    void unite(const box_t& b) {
+      left = qMin(left, b.left);
+      top = qMin(top, b.top);
+      right = qMax(right, b.right);
+      bottom = qMax(bottom, b.bottom);
+    }
+  };
+
+  struct item_t {
+    box_t box;
+    T value;
+  };
+
+  /// all items sorted in leaf order
+  QVector<item_t> items;
+  /// bounding boxes of all nodes, levels[0] holds the leaf nodes, the last level the root node
+  QVector<QVector<box_t> > levels;
+};
+
+#endif  // CPACKEDRTREE_H
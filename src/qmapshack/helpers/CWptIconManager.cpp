@@ -56,6 +56,7 @@ QPixmap CWptIconManager::createGrayscale(QString path) {
 }
 
 void CWptIconManager::init() {
+  QMutexLocker lock(&mutex);
   wptIcons.clear();
 
   wptIcons["Default"] = icon_t(wptDefault, 16, 16);
@@ -228,12 +229,11 @@ QPixmap CWptIconManager::getWptIconByName(const QString& name, QPointF& focus, Q
   QPixmap icon;
   QString path;
 
-  if (wptIcons.contains(name)) {
-    focus = wptIcons[name].focus;
-    path = wptIcons[name].path;
-  } else {
-    focus = wptIcons["Default"].focus;
-    path = wptIcons["Default"].path;
+  {
+    QMutexLocker lock(&mutex);
+    const icon_t& entry = wptIcons.contains(name) ? wptIcons.value(name) : wptIcons.value("Default");
+    focus = entry.focus;
+    path = entry.path;
   }
 
   if (path.isEmpty()) {
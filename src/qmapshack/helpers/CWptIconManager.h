@@ -23,6 +23,7 @@
 #include <QFont>
 #include <QMap>
 #include <QMenu>
+#include <QMutex>
 #include <QObject>
 #include <QPoint>
 #include <QString>
@@ -67,6 +68,8 @@ class CWptIconManager : public QObject {
 
   QFont lastFont;
 
+  /// waypoints are created by worker threads loading projects, too
+  mutable QMutex mutex;
   QMap<QString, icon_t> wptIcons;
 
   QMap<qint32, QString> mapNumberedBullets;
@@ -35,8 +35,9 @@
 
 QList<CMapDraw*> CMapDraw::maps;
 QString CMapDraw::cachePath = "";
+bool CMapDraw::cachePacked = true;
 QStringList CMapDraw::mapPaths;
-QStringList CMapDraw::supportedFormats = QString("*.vrt|*.jnx|*.img|*.rmap|*.wmts|*.tms|*.gemf").split('|');
+QStringList CMapDraw::supportedFormats = QString("*.vrt|*.jnx|*.img|*.rmap|*.wmts|*.tms|*.gemf|*.map").split('|');
 
 CMapDraw::CMapDraw(CCanvas* parent) : IDrawContext("map", CCanvas::eRedrawMap, parent) {
   mapList = new CMapList(canvas);
@@ -70,7 +71,7 @@ void CMapDraw::setupMapPath() {
   if (cachePath.isEmpty()) {
     cachePath = IAppSetup::getPlatformInstance()->defaultCachePath();
   }
-  CMapPathSetup dlg(paths, cachePath);
+  CMapPathSetup dlg(paths, cachePath, cachePacked);
   if (dlg.exec() != QDialog::Accepted) {
     return;
   }
@@ -100,11 +101,13 @@ void CMapDraw::setupMapPath(const QStringList& paths) {
 void CMapDraw::saveMapPath(QSettings& cfg) {
   cfg.setValue("mapPath", mapPaths);
   cfg.setValue("cachePath", cachePath);
+  cfg.setValue("cachePacked", cachePacked);
 }
 
 void CMapDraw::loadMapPath(QSettings& cfg) {
   mapPaths = cfg.value("mapPath", mapPaths).toStringList();
   cachePath = cfg.value("cachePath", cachePath).toString();
+  cachePacked = cfg.value("cachePacked", cachePacked).toBool();
 
   if (cachePath.isEmpty()) {
     cachePath = IAppSetup::getPlatformInstance()->defaultCachePath();
@@ -364,7 +367,7 @@ void CMapDraw::reportStatusToCanvas(const QString& key, const QString& msg) { ca
 
 void CMapDraw::drawt(IDrawContext::buffer_t& currentBuffer) /* override */
 {
-  bool seenActiveMap = false;
+  QList<IMap*> activeMaps;
   // iterate over all active maps and call the draw method
   CMapItem::mutexActiveMaps.lock();
   if (mapList && (mapList->count() != 0)) {
@@ -378,14 +381,53 @@ void CMapDraw::drawt(IDrawContext::buffer_t& currentBuffer) /* override */
         break;
       }
 
-      item->getMapfile()->draw(currentBuffer);
-      seenActiveMap = true;
+      activeMaps << item->getMapfile().data();
     }
   }
+
+  if (activeMaps.count() == 1) {
+    // no need for the overhead of layers
+    layers.clear();
+    activeMaps.first()->draw(currentBuffer);
+  } else if (activeMaps.count() > 1) {
+    drawLayers(activeMaps, currentBuffer);
+  }
   CMapItem::mutexActiveMaps.unlock();
 
+  bool seenActiveMap = !activeMaps.isEmpty();
   if (seenActiveMap != hasActiveMap) {
     hasActiveMap = seenActiveMap;
     emit sigActiveMapsChanged(!hasActiveMap);
   }
 }
+
+void CMapDraw::drawLayers(const QList<IMap*>& activeMaps, buffer_t& currentBuffer) {
+  const int N = activeMaps.count();
+  layers.resize(N);
+
+  for (int i = 0; i < N; i++) {
+    buffer_t& layer = layers[i];
+
+    // take all projection information from the current buffer but keep the layer's own image
+    QImage image = layer.image;
+    layer = currentBuffer;
+    if (image.size() != currentBuffer.image.size() || image.format() != currentBuffer.image.format()) {
+      image = QImage(currentBuffer.image.size(), currentBuffer.image.format());
+    }
+    image.fill(Qt::transparent);
+    layer.image = image;
+
+    IMap* mapfile = activeMaps[i];
+    threadPool.start([mapfile, &layer]() { mapfile->draw(layer); });
+  }
+  threadPool.waitForDone();
+
+  if (needsRedraw()) {
+    return;
+  }
+
+  QPainter p(&currentBuffer.image);
+  for (const buffer_t& layer : qAsConst(layers)) {
+    p.drawImage(0, 0, layer.image);
+  }
+}
@@ -20,6 +20,7 @@
 #define CMAPDRAW_H
 
 #include <QStringList>
+#include <QThreadPool>
 
 #include "canvas/IDrawContext.h"
 
@@ -28,6 +29,7 @@ class CCanvas;
 class CMapList;
 class QSettings;
 class CMapItem;
+class IMap;
 struct IPoiItem;
 
 class CMapDraw : public IDrawContext {
@@ -86,6 +88,7 @@ class CMapDraw : public IDrawContext {
   static void loadMapPath(QSettings& cfg);
   static const QStringList& getSupportedFormats() { return supportedFormats; }
   static const QString& getCacheRoot() { return cachePath; }
+  static bool getCachePacked() { return cachePacked; }
 
   /**
      @brief Forward messages to CCanvas::reportStatus()
@@ -167,6 +170,18 @@ class CMapDraw : public IDrawContext {
 
   void restoreActiveMapsList(const QStringList& keys, QSettings& cfg);
 
+  /**
+     @brief Render several maps in parallel and composite the result
+
+     Each map is drawn into it's own layer image by a task of threadPool. The layers
+     are drawn into the buffer in the order of the map list once all tasks are done.
+     The opacity of a map is already applied by the map's draw() method.
+
+     @param activeMaps    the maps to draw, in the order of the map list
+     @param currentBuffer the buffer to composite the layers into
+   */
+  void drawLayers(const QList<IMap*>& activeMaps, buffer_t& currentBuffer);
+
   /// the treewidget holding all active and inactive map items
   CMapList* mapList;
 
@@ -177,6 +192,8 @@ class CMapDraw : public IDrawContext {
   static QStringList mapPaths;
 
   static QString cachePath;
+  /// store the tiles of online maps in a single pack file per map
+  static bool cachePacked;
 
   /// all existing CMapDraw instances
   static QList<CMapDraw*> maps;
@@ -185,6 +202,11 @@ class CMapDraw : public IDrawContext {
   static QStringList supportedFormats;
 
   bool hasActiveMap = false;
+
+  /// thread pool to render multiple active maps in parallel
+  QThreadPool threadPool;
+  /// one buffer per active map, kept to avoid reallocating the images on each redraw
+  QVector<buffer_t> layers;
 };
 
 #endif  // CMAPDRAW_H
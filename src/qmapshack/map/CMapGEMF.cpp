@@ -23,8 +23,10 @@
 #include "map/CMapGEMF.h"
 
 #include <QDebug>
+#include <QtEndian>
 #include <QtGui>
 #include <QtWidgets>
+#include <algorithm>
 
 #include "CMainWindow.h"
 #include "helpers/CDraw.h"
@@ -47,7 +49,8 @@ inline double tile2lat(int y, int z) {
   return 180.0 / M_PI * qAtan(0.5 * (exp(n) - exp(-n)));
 }
 
-CMapGEMF::CMapGEMF(const QString& filename, CMapDraw* parent) : IMap(eFeatVisibility, parent), filename(filename) {
+CMapGEMF::CMapGEMF(const QString& filename, CMapDraw* parent)
+    : IMap(eFeatVisibility | eFeatDecodeCache, parent), filename(filename) {
   qDebug() << "CMapGEMF: try to open " << filename;
   proj.init(
       "EPSG:3857",
@@ -102,34 +105,46 @@ CMapGEMF::CMapGEMF(const QString& filename, CMapDraw* parent) : IMap(eFeatVisibi
   minZoom = MAX_ZOOM_LEVEL;
   maxZoom = MIN_ZOOM_LEVEL;
 
-  for (quint32 i = 0; i <= MAX_ZOOM_LEVEL; i++) {
-    QList<range_t> rangeZoom;
-    for (const range_t& range : qAsConst(ranges)) {
-      if (range.zoomlevel == i) {
-        rangeZoom << range;
-        minZoom = qMin(i, minZoom);
-        maxZoom = qMax(i, maxZoom);
-      }
-    }
-    if (!rangeZoom.empty()) {
-      rangesByZoom[i] = rangeZoom;
-      qDebug() << "CMapGEMF: Found " << rangeZoom.length() << " ranges for zoomlevel " << i;
+  for (const range_t& range : qAsConst(ranges)) {
+    if (range.zoomlevel > MAX_ZOOM_LEVEL) {
+      continue;
     }
+    zoomlevel_t& level = rangesByZoom[range.zoomlevel];
+    level.ranges << range;
+    level.maxWidth = qMax(level.maxWidth, range.maxX + 1 - range.minX);
+    minZoom = qMin(range.zoomlevel, minZoom);
+    maxZoom = qMax(range.zoomlevel, maxZoom);
+  }
+
+  for (auto level = rangesByZoom.begin(); level != rangesByZoom.end(); ++level) {
+    std::sort(level->ranges.begin(), level->ranges.end(),
+              [](const range_t& r1, const range_t& r2) { return r1.minX < r2.minX; });
+    qDebug() << "CMapGEMF: Found " << level->ranges.size() << " ranges for zoomlevel " << level.key();
   }
+
+  // keep all split files open and mapped to memory for the map's lifetime
   QString partfile = filename;
-  QFile f(partfile);
-  f.open(QIODevice::ReadOnly);
   quint32 i = 1;
-  do {
+  QFile* f = new QFile(partfile, this);
+  while (f->open(QIODevice::ReadOnly)) {
     gemffile_t gf;
     gf.filename = partfile;
-    gf.size = f.size();
-    f.close();
+    gf.size = f->size();
+    gf.file = f;
+    // if mapping fails, e.g. for lack of address space, the file is read instead
+    gf.data = f->map(0, gf.size);
+    if (gf.data == nullptr) {
+      qDebug() << "CMapGEMF: Failed to map" << partfile;
+    }
     files << gf;
+
     partfile = filename + "-" + QString::number(i);
     i++;
-    f.setFileName(partfile);
-  } while (f.open(QIODevice::ReadOnly));
+    f = new QFile(partfile, this);
+  }
+  delete f;
+
+  configureDecodeCache();
   isActivated = true;
 }
 
@@ -197,64 +212,94 @@ void CMapGEMF::draw(IDrawContext::buffer_t& buf) {
   }
 }
 
-quint64 CMapGEMF::getFilenameFromAddress(const quint64 offset, QString& filename) {
-  quint64 temp = offset;
+void CMapGEMF::configureDecodeCache() /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  decodeCache.setMaxCost(qMax(1, getDecodeCacheSize()) * 1024);
+}
+
+void CMapGEMF::getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  hits = decodeCacheHits;
+  misses = decodeCacheMisses;
+  usedKB = decodeCache.totalCost();
+}
+
+QByteArray CMapGEMF::readData(quint64 address, quint32 size) {
+  const quint64 offset = address;
 
-  for (const gemffile_t& gf : qAsConst(files)) {
-    if (temp < gf.size) {
-      filename = gf.filename;
+  for (gemffile_t& gf : files) {
+    if (address < gf.size) {
+      if (address + size > gf.size) {
+        break;
+      }
+      if (gf.data != nullptr) {
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(gf.data) + address, size);
+      }
 
-      return temp;
+      QMutexLocker lock(&mutexFiles);
+      gf.file->seek(address);
+      return gf.file->read(size);
     }
-    temp -= gf.size;
+    address -= gf.size;
   }
 
   qDebug() << "CMAPGemf: ImageAddress was wrong " << offset;
-  return 0;
+  return QByteArray();
 }
 
 QImage CMapGEMF::getTile(const quint32 row, const quint32 col, const quint32 z) {
-  if (!rangesByZoom.contains(z)) {
+  const quint64 key = (quint64(z) << 48) | (quint64(row) << 24) | quint64(col);
+  {
+    QMutexLocker lock(&mutexDecodeCache);
+    const QImage* img = decodeCache.object(key);
+    if (img != nullptr) {
+      ++decodeCacheHits;
+      return *img;
+    }
+    ++decodeCacheMisses;
+  }
+
+  const auto level = rangesByZoom.constFind(z);
+  if (level == rangesByZoom.constEnd()) {
     qDebug() << "CMapGEMF: getTile called for a zoomlevel not available";
     return QImage();
   }
-  QList<range_t> ranges = rangesByZoom[z];
-
-  for (const range_t& range : ranges) {
-    if (row >= range.minX && row <= range.maxX && col >= range.minY && col <= range.maxY) {
-      const quint32 Xidx = row - range.minX;
-      const quint32 Yidx = col - range.minY;
-      const quint32 nrYVals = range.maxY + 1 - range.minY;
-      const quint32 TileIdx = Xidx * nrYVals + Yidx;
-      const quint64 offsetRange = TileIdx * 12;  // 4 + 8
-
-      quint64 offsetGEMF = offsetRange + range.offset;
-      QString splitfile;
-      offsetGEMF = getFilenameFromAddress(offsetGEMF, splitfile);
-
-      QFile file(splitfile);
-      file.open(QIODevice::ReadOnly);
-      QDataStream dataFile(&file);
-
-      dataFile.skipRawData(offsetGEMF);
-
-      quint64 imageDataAddress;
-      dataFile >> imageDataAddress;
+  const QVector<range_t>& ranges = level->ranges;
+
+  QImage img;
+  // search backwards from the last range starting left of or at the tile. Ranges
+  // starting more than the widest range's width to the left can't contain the tile.
+  auto range = std::upper_bound(ranges.cbegin(), ranges.cend(), row,
+                                [](quint32 x, const range_t& r) { return x < r.minX; });
+  while (range != ranges.cbegin()) {
+    --range;
+    if (range->minX + level->maxWidth <= row) {
+      break;
+    }
 
-      quint32 size;
-      dataFile >> size;
+    if (row <= range->maxX && col >= range->minY && col <= range->maxY) {
+      const quint32 Xidx = row - range->minX;
+      const quint32 Yidx = col - range->minY;
+      const quint32 nrYVals = range->maxY + 1 - range->minY;
+      const quint64 TileIdx = quint64(Xidx) * nrYVals + Yidx;
+      const quint64 offsetRange = TileIdx * 12;  // 4 + 8
 
-      file.close();
+      const QByteArray& index = readData(offsetRange + range->offset, 12);
+      if (index.size() != 12) {
+        break;
+      }
+      const quint64 imageDataAddress = qFromBigEndian<quint64>(index.constData());
+      const quint32 size = qFromBigEndian<quint32>(index.constData() + 8);
 
-      quint64 imageDataOffset = getFilenameFromAddress(imageDataAddress, splitfile);
-      QFile imageFile(splitfile);
-      imageFile.open(QIODevice::ReadOnly);
-      imageFile.seek(imageDataOffset);
-      QByteArray imageData(size, 0);
-      imageFile.read(imageData.data(), size);
-      return QImage::fromData((uchar*)imageData.data(), size, 0);
+      const QByteArray& imageData = readData(imageDataAddress, size);
+      img = QImage::fromData(reinterpret_cast<const uchar*>(imageData.constData()), imageData.size());
+      break;
     }
   }
 
-  return QImage();
+  QMutexLocker lock(&mutexDecodeCache);
+  decodeCache.insert(key, new QImage(img), qMax(1, int(img.sizeInBytes() / 1024)));
+  return img;
 }
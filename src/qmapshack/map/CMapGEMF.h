@@ -19,20 +19,37 @@
 #ifndef CMAPGEMF_H
 #define CMAPGEMF_H
 
+#include <QCache>
+#include <QMutex>
+
 #include "IMap.h"
 
+class QFile;
+
 class CMapGEMF : public IMap {
   Q_OBJECT
  public:
   CMapGEMF(const QString& filename, CMapDraw* parent);
   void draw(IDrawContext::buffer_t& buf) override;
 
+  void getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const override;
+
+ protected:
+  void configureDecodeCache() override;
+
  private:
   const quint32 MAX_ZOOM_LEVEL = 21;
   const quint32 MIN_ZOOM_LEVEL = 0;
 
   QImage getTile(const quint32 col, const quint32 row, const quint32 z);
-  quint64 getFilenameFromAddress(const quint64 offset, QString& filename);
+  /**
+     @brief Read data from the split files
+
+     @param address   the address of the data in the concatenated split files
+     @param size      the number of bytes to read
+     @return The data. For memory mapped files it is a shallow copy of the mapped memory.
+   */
+  QByteArray readData(quint64 address, quint32 size);
 
   struct source_t {
     quint32 index;
@@ -42,6 +59,10 @@ class CMapGEMF : public IMap {
   struct gemffile_t {
     QString filename;
     quint64 size;
+    /// the file is kept open for the map's lifetime
+    QFile* file = nullptr;
+    /// the memory mapped file or nullptr if the file could not be mapped
+    const uchar* data = nullptr;
   };
   struct range_t {
     quint32 zoomlevel;
@@ -62,7 +83,22 @@ class CMapGEMF : public IMap {
   quint32 maxZoom;
   QList<source_t> sources;
   QList<gemffile_t> files;
-  QHash<quint32, QList<range_t> > rangesByZoom;
+  /// serialize reading files that could not be mapped
+  QMutex mutexFiles;
+
+  struct zoomlevel_t {
+    /// the ranges sorted by minX
+    QVector<range_t> ranges;
+    /// the maximum width of all ranges, to limit the search for a tile
+    quint32 maxWidth = 0;
+  };
+  QHash<quint32, zoomlevel_t> rangesByZoom;
+
+  /// LRU cache of decoded tiles, the cost is the image size in [kByte]
+  QCache<quint64, QImage> decodeCache;
+  mutable QMutex mutexDecodeCache;
+  quint64 decodeCacheHits = 0;
+  quint64 decodeCacheMisses = 0;
 };
 
 #endif  // CMAPGEMF_H
@@ -104,24 +104,24 @@ static inline QImage img2line(const QImage& img, int width) {
   return newImage;
 }
 
-static inline bool isCluttered(QVector<QRectF>& rectPois, const QRectF& rect) {
-  for (const QRectF& rectPoi : rectPois) {
-    if (rect.intersects(rectPoi)) {
-      return true;
-    }
+static inline bool isCluttered(COccupancyGrid& rectPois, const QRectF& rect) {
+  if (rectPois.intersects(rect)) {
+    return true;
   }
   rectPois << rect;
   return false;
 }
 
 CMapIMG::CMapIMG(const QString& filename, CMapDraw* parent)
-    : IMap(eFeatVisibility | eFeatVectorItems | eFeatTypFile, parent),
+    : IMap(eFeatVisibility | eFeatVectorItems | eFeatTypFile | eFeatDecodeCache, parent),
       filename(filename),
       fm(CMainWindow::self().getMapFont()),
       selectedLanguage(NOIDX) {
   qDebug() << "------------------------------";
   qDebug() << "IMG: try to open" << filename;
 
+  configureDecodeCache();
+
   try {
     readBasics();
     processPrimaryMapData();
@@ -934,6 +934,7 @@ void CMapIMG::readSubfileBasics(subfile_desc_t& subfile, CFileExt& file) {
   }
 
   subfile.subdivs = subdivs;
+  buildSubdivIndex(subfile);
 
 #ifdef DEBUG_SHOW_SUBDIV_DATA
   {
@@ -1020,6 +1021,23 @@ void CMapIMG::readSubfileBasics(subfile_desc_t& subfile, CFileExt& file) {
   }
 }
 
+void CMapIMG::buildSubdivIndex(subfile_desc_t& subfile) {
+  QMap<quint32, QVector<QRectF> > rectsByLevel;
+  QMap<quint32, QVector<qint32> > indicesByLevel;
+
+  const int N = subfile.subdivs.size();
+  for (int i = 0; i < N; i++) {
+    const subdiv_desc_t& subdiv = subfile.subdivs[i];
+    rectsByLevel[subdiv.level] << subdiv.area;
+    indicesByLevel[subdiv.level] << i;
+  }
+
+  subfile.subdivIndex.clear();
+  for (quint32 level : rectsByLevel.keys()) {
+    subfile.subdivIndex[level].build(rectsByLevel[level], indicesByLevel[level]);
+  }
+}
+
 void CMapIMG::processPrimaryMapData() {
   /*
    * Query all subfiles for possible maplevels.
@@ -1141,13 +1159,14 @@ void CMapIMG::draw(IDrawContext::buffer_t& buf) /* override */
   qreal v2 = qMin(buf.ref4.y(), buf.ref3.y());
 
   QRectF viewport(u1, v1, u2 - u1, v2 - v1);
-  QVector<QRectF> rectPois;
+  COccupancyGrid rectPois;
 
   polygons.clear();
   polylines.clear();
   pois.clear();
   points.clear();
   labels.clear();
+  rectLabels.clear();
 
   /**
      convertRad2Px() converts positions into screen coordinates. However the painter
@@ -1242,15 +1261,22 @@ void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polyl
     }
 #endif
 
+    // the RGN part is read on the first cache miss only
     QByteArray rgndata;
-    readFile(file, subfile.parts["RGN"].offset, subfile.parts["RGN"].size, rgndata);
+    bool rgnLoaded = false;
 
     // qDebug() << "rgn range" << Qt::hex << subfile.parts["RGN"].offset << (subfile.parts["RGN"].offset +
     // subfile.parts["RGN"].size);
 
+    // query the level's index for candidates and keep the file order to draw items in the same order
+    QVector<qint32> candidates;
+    subfile.subdivIndex.value(level).query(viewport, candidates);
+    std::sort(candidates.begin(), candidates.end());
+
     const QVector<subdiv_desc_t>& subdivs = subfile.subdivs;
     // collect polylines
-    for (const subdiv_desc_t& subdiv : subdivs) {
+    for (qint32 idx : qAsConst(candidates)) {
+      const subdiv_desc_t& subdiv = subdivs[idx];
       // if(subdiv.level == level) qDebug() << "subdiv:" << subdiv.level << level <<  subdiv.area << viewport <<
       // subdiv.area.intersects(viewport);
       if (subdiv.level != level || !subdiv.area.intersects(viewport)) {
@@ -1259,7 +1285,33 @@ void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polyl
       if (map->needsRedraw()) {
         break;
       }
-      loadSubDiv(file, subdiv, subfile.strtbl, rgndata, fast, viewport, polylines, polygons, points, pois);
+
+      const subdiv_key_t key = {subfile.name, subdiv.n, subdiv.level};
+
+      {
+        QMutexLocker lock(&mutexDecodeCache);
+        const subdiv_data_t* data = decodeCache.object(key);
+        if (data != nullptr) {
+          ++decodeCacheHits;
+          copyVisibleData(*data, fast, viewport, polylines, polygons, points, pois);
+          continue;
+        }
+        ++decodeCacheMisses;
+      }
+
+      if (!rgnLoaded) {
+        readFile(file, subfile.parts["RGN"].offset, subfile.parts["RGN"].size, rgndata);
+        rgnLoaded = true;
+      }
+
+      subdiv_data_t* data = new subdiv_data_t();
+      loadSubDiv(file, subdiv, subfile.strtbl, rgndata, *data);
+      copyVisibleData(*data, fast, viewport, polylines, polygons, points, pois);
+
+      {
+        QMutexLocker lock(&mutexDecodeCache);
+        decodeCache.insert(key, data, estimateDecodeCost(*data));
+      }
 
 #ifdef DEBUG_SHOW_SECTION_BORDERS
       const QRectF& a = subdiv.area;
@@ -1307,8 +1359,7 @@ void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polyl
 }
 
 void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStrTbl* strtbl, const QByteArray& rgndata,
-                         bool fast, const QRectF& viewport, polytype_t& polylines, polytype_t& polygons,
-                         pointtype_t& points, pointtype_t& pois) {
+                         subdiv_data_t& data) {
   if (subdiv.rgn_start == subdiv.rgn_end && !subdiv.lengthPolygons2 && !subdiv.lengthPolylines2 &&
       !subdiv.lengthPoints2) {
     return;
@@ -1370,74 +1421,59 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
   CGarminPolygon p;
 
   // decode points
-  if (subdiv.hasPoints && !fast && getShowPOIs()) {
+  if (subdiv.hasPoints) {
     const quint8* pData = pRawData + opnt;
     const quint8* pEnd = pRawData + (oidx ? oidx : opline ? opline : opgon ? opgon : subdiv.rgn_end);
     while (pData < pEnd) {
       CGarminPoint p;
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, pData);
 
-      // skip points outside our current viewport
-      if (!viewport.contains(p.pos)) {
-        continue;
-      }
-
       if (strtbl) {
         p.isLbl6 ? strtbl->get(file, p.lbl_ptr, IGarminStrTbl::poi, p.labels)
                  : strtbl->get(file, p.lbl_ptr, IGarminStrTbl::norm, p.labels);
       }
 
-      points.push_back(p);
+      data.points.push_back(p);
     }
   }
 
   // decode indexed points
-  if (subdiv.hasIdxPoints && !fast && getShowPOIs()) {
+  if (subdiv.hasIdxPoints) {
     const quint8* pData = pRawData + oidx;
     const quint8* pEnd = pRawData + (opline ? opline : opgon ? opgon : subdiv.rgn_end);
     while (pData < pEnd) {
       CGarminPoint p;
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, pData);
 
-      // skip points outside our current viewport
-      if (!viewport.contains(p.pos)) {
-        continue;
-      }
-
       if (strtbl) {
         p.isLbl6 ? strtbl->get(file, p.lbl_ptr, IGarminStrTbl::poi, p.labels)
                  : strtbl->get(file, p.lbl_ptr, IGarminStrTbl::norm, p.labels);
       }
 
-      pois.push_back(p);
+      data.pois.push_back(p);
     }
   }
 
   // decode polylines
-  if (subdiv.hasPolylines && !fast && getShowPolylines()) {
+  if (subdiv.hasPolylines) {
     CGarminPolygon::cnt = 0;
     const quint8* pData = pRawData + opline;
     const quint8* pEnd = pRawData + (opgon ? opgon : subdiv.rgn_end);
     while (pData < pEnd) {
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, true, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
       if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
       } else if (strtbl && p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::net, p.labels);
       }
 
-      polylines.push_back(p);
+      data.polylines.push_back(p);
     }
   }
 
   // decode polygons
-  if (subdiv.hasPolygons && getShowPolygons()) {
+  if (subdiv.hasPolygons) {
     CGarminPolygon::cnt = 0;
     const quint8* pData = pRawData + opgon;
     const quint8* pEnd = pRawData + subdiv.rgn_end;
@@ -1445,17 +1481,12 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
     while (pData < pEnd) {
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, false, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
-      if (strtbl && !p.lbl_in_NET && p.lbl_info && !fast) {
+      if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
-      } else if (strtbl && p.lbl_in_NET && p.lbl_info && !fast) {
+      } else if (strtbl && p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::net, p.labels);
       }
-      polygons.push_back(p);
+      data.polygons.push_back(p);
     }
   }
 
@@ -1471,47 +1502,37 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
   //         qDebug() << "point len: " << Qt::hex << subdiv.lengthPoints2 << dec << subdiv.lengthPoints2;
   //         qDebug() << "point end: " << Qt::hex << subdiv.lengthPoints2 + subdiv.offsetPoints2;
 
-  if (subdiv.lengthPolygons2 && getShowPolygons()) {
+  if (subdiv.lengthPolygons2) {
     const quint8* pData = pRawData + subdiv.offsetPolygons2;
     const quint8* pEnd = pData + subdiv.lengthPolygons2;
     while (pData < pEnd) {
       //             qDebug() << "rgn offset:" << Qt::hex << (rgnoff + (pData - pRawData));
       pData += p.decode2(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, false, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
-      if (strtbl && !p.lbl_in_NET && p.lbl_info && !fast) {
+      if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
       }
 
-      polygons.push_back(p);
+      data.polygons.push_back(p);
     }
   }
 
-  if (subdiv.lengthPolylines2 && !fast && getShowPolylines()) {
+  if (subdiv.lengthPolylines2) {
     const quint8* pData = pRawData + subdiv.offsetPolylines2;
     const quint8* pEnd = pData + subdiv.lengthPolylines2;
     while (pData < pEnd) {
       //             qDebug() << "rgn offset:" << Qt::hex << (rgnoff + (pData - pRawData));
       pData += p.decode2(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, true, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
       if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
       }
 
-      polylines.push_back(p);
+      data.polylines.push_back(p);
     }
   }
 
-  if (subdiv.lengthPoints2 && !fast && getShowPOIs()) {
+  if (subdiv.lengthPoints2) {
     const quint8* pData = pRawData + subdiv.offsetPoints2;
     const quint8* pEnd = pData + subdiv.lengthPoints2;
     while (pData < pEnd) {
@@ -1519,18 +1540,88 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
       //             qDebug() << "rgn offset:" << Qt::hex << (rgnoff + (pData - pRawData));
       pData += p.decode2(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (!viewport.contains(p.pos)) {
-        continue;
-      }
-
       if (strtbl) {
         p.isLbl6 ? strtbl->get(file, p.lbl_ptr, IGarminStrTbl::poi, p.labels)
                  : strtbl->get(file, p.lbl_ptr, IGarminStrTbl::norm, p.labels);
       }
-      pois.push_back(p);
+      data.pois.push_back(p);
+    }
+  }
+}
+
+void CMapIMG::copyVisibleData(const subdiv_data_t& data, bool fast, const QRectF& viewport, polytype_t& polylines,
+                              polytype_t& polygons, pointtype_t& points, pointtype_t& pois) const {
+  if (!fast && getShowPOIs()) {
+    for (const CGarminPoint& pt : data.points) {
+      // skip points outside our current viewport
+      if (viewport.contains(pt.pos)) {
+        points.push_back(pt);
+      }
+    }
+
+    for (const CGarminPoint& pt : data.pois) {
+      if (viewport.contains(pt.pos)) {
+        pois.push_back(pt);
+      }
+    }
+  }
+
+  if (!fast && getShowPolylines()) {
+    for (const CGarminPolygon& line : data.polylines) {
+      if (!isCompletelyOutside(line.pixel, viewport)) {
+        polylines.push_back(line);
+      }
+    }
+  }
+
+  if (getShowPolygons()) {
+    for (const CGarminPolygon& poly : data.polygons) {
+      if (!isCompletelyOutside(poly.pixel, viewport)) {
+        polygons.push_back(poly);
+      }
+    }
+  }
+}
+
+qint32 CMapIMG::estimateDecodeCost(const subdiv_data_t& data) {
+  qint64 bytes = sizeof(subdiv_data_t);
+
+  auto costOfLabels = [](const QStringList& labels) {
+    qint64 cost = 0;
+    for (const QString& label : labels) {
+      cost += sizeof(QString) + label.size() * sizeof(QChar);
+    }
+    return cost;
+  };
+
+  for (const polytype_t* items : {&data.polygons, &data.polylines}) {
+    for (const CGarminPolygon& item : *items) {
+      // pixel and coords share their data until the item is drawn
+      bytes += sizeof(CGarminPolygon) + item.coords.capacity() * sizeof(QPointF) + costOfLabels(item.labels);
+    }
+  }
+
+  for (const pointtype_t* items : {&data.points, &data.pois}) {
+    for (const CGarminPoint& item : *items) {
+      bytes += sizeof(CGarminPoint) + costOfLabels(item.labels);
     }
   }
+
+  return qint32(qMax(qint64(1), bytes >> 10));
+}
+
+void CMapIMG::configureDecodeCache() /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  decodeCache.setMaxCost(qMax(1, getDecodeCacheSize()) * 1024);
+}
+
+void CMapIMG::getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  hits = decodeCacheHits;
+  misses = decodeCacheMisses;
+  usedKB = decodeCache.totalCost();
 }
 
 void CMapIMG::drawPolygons(QPainter& p, polytype_t& lines) {
@@ -1811,15 +1902,7 @@ void CMapIMG::collectText(const CGarminPolygon& item, const QPolygonF& line, con
   textpaths << tp;
 }
 
-bool CMapIMG::intersectsWithExistingLabel(const QRect& rect) const {
-  for (const strlbl_t& label : labels) {
-    if (label.rect.intersects(rect)) {
-      return true;
-    }
-  }
-
-  return false;
-}
+bool CMapIMG::intersectsWithExistingLabel(const QRect& rect) const { return rectLabels.intersects(rect); }
 
 void CMapIMG::addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminTyp::point_property& property,
                        bool isNight) {
@@ -1828,6 +1911,7 @@ void CMapIMG::addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminT
     str = pt.getLabelText();
   }
 
+  rectLabels << rect;
   labels.push_back(strlbl_t());
   strlbl_t& strlbl = labels.last();
   strlbl.pt = pt.pos.toPoint();
@@ -1837,7 +1921,7 @@ void CMapIMG::addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminT
   strlbl.isNight = isNight;
 }
 
-void CMapIMG::drawPoints(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois) {
+void CMapIMG::drawPoints(QPainter& p, pointtype_t& pts, COccupancyGrid& rectPois) {
   pointtype_t::iterator pt = pts.begin();
   while (pt != pts.end()) {
     map->convertRad2Px(pt->pos);
@@ -1877,7 +1961,7 @@ void CMapIMG::drawPoints(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPoi
   }
 }
 
-void CMapIMG::drawPois(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois) {
+void CMapIMG::drawPois(QPainter& p, pointtype_t& pts, COccupancyGrid& rectPois) {
   for (CGarminPoint& pt : pts) {
     map->convertRad2Px(pt.pos);
 
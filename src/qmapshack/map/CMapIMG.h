@@ -19,8 +19,12 @@
 #ifndef CMAPIMG_H
 #define CMAPIMG_H
 
+#include <QCache>
 #include <QMap>
+#include <QMutex>
 
+#include "helpers/COccupancyGrid.h"
+#include "helpers/CPackedRTree.h"
 #include "map/IMap.h"
 #include "map/garmin/CGarminPoint.h"
 #include "map/garmin/CGarminPolygon.h"
@@ -103,6 +107,8 @@ class CMapIMG : public IMap {
 
     /// list of subdivisions
     QVector<subdiv_desc_t> subdivs;
+    /// spatial index of subdivision areas per map level, values are indices into subdivs
+    QMap<quint32, CPackedRTree<qint32> > subdivIndex;
     /// used maplevels
     QVector<maplevel_t> maplevels;
     /// bit 1 of POI_flags (TRE header @ 0x3F)
@@ -136,9 +142,14 @@ class CMapIMG : public IMap {
    */
   bool findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32 threshold, QPolygonF& polyline) override;
 
+  void getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const override;
+
  public slots:
   void slotSetTypeFile(const QString& filename) override;
 
+ protected:
+  void configureDecodeCache() override;
+
  private:
   enum exce_e { eErrOpen, eErrAccess, errFormat, errLock, errAbort };
   struct exce_t {
@@ -154,23 +165,49 @@ class CMapIMG : public IMap {
     bool isNight = false;
   };
 
+  /// key to identify a decoded subdivision in the decode cache
+  struct subdiv_key_t {
+    QString subfile;
+    quint32 subdiv;
+    quint32 level;
+
+    bool operator==(const subdiv_key_t& k) const {
+      return subdiv == k.subdiv && level == k.level && subfile == k.subfile;
+    }
+
+    friend uint qHash(const subdiv_key_t& k, uint seed = 0) {
+      return qHash(k.subfile, seed) ^ qHash(k.subdiv, seed) ^ (k.level << 24);
+    }
+  };
+
+  /// all items of a subdivision decoded into [rad] coordinates
+  struct subdiv_data_t {
+    polytype_t polygons;
+    polytype_t polylines;
+    pointtype_t points;
+    pointtype_t pois;
+  };
+
   quint8 scale2bits(const QPointF& scale);
   void setupTyp();
   void readBasics();
   void readSubfileBasics(subfile_desc_t& subfile, CFileExt& file);
+  void buildSubdivIndex(subfile_desc_t& subfile);
   void processPrimaryMapData();
   void readFile(CFileExt& file, quint32 offset, quint32 size, QByteArray& data);
   void loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polylines, pointtype_t& points, pointtype_t& pois,
                        unsigned level, const QRectF& viewport, QPainter& p);
   void loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStrTbl* strtbl, const QByteArray& rgndata,
-                  bool fast, const QRectF& viewport, polytype_t& polylines, polytype_t& polygons, pointtype_t& points,
-                  pointtype_t& pois);
+                  subdiv_data_t& data);
+  void copyVisibleData(const subdiv_data_t& data, bool fast, const QRectF& viewport, polytype_t& polylines,
+                       polytype_t& polygons, pointtype_t& points, pointtype_t& pois) const;
+  static qint32 estimateDecodeCost(const subdiv_data_t& data);
   bool intersectsWithExistingLabel(const QRect& rect) const;
   void addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminTyp::point_property& property, bool isDay);
   void drawPolygons(QPainter& p, polytype_t& lines);
   void drawPolylines(QPainter& p, polytype_t& lines, const QPointF& scale);
-  void drawPoints(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois);
-  void drawPois(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois);
+  void drawPoints(QPainter& p, pointtype_t& pts, COccupancyGrid& rectPois);
+  void drawPois(QPainter& p, pointtype_t& pts, COccupancyGrid& rectPois);
   void drawLabels(QPainter& p, const QVector<strlbl_t>& lbls);
   void drawText(QPainter& p);
 
@@ -471,6 +508,8 @@ class CMapIMG : public IMap {
   pointtype_t pois;
 
   QVector<strlbl_t> labels;
+  /// the rectangles of all labels for a fast overlap test
+  COccupancyGrid rectLabels;
 
   struct textpath_t {
     // QPainterPath path;
@@ -485,6 +524,18 @@ class CMapIMG : public IMap {
   QVector<textpath_t> textpaths;
   qint8 selectedLanguage;
   QSet<QString> copyrights;
+
+  /**
+     @brief LRU cache of decoded subdivisions
+
+     The cost of each entry is its estimated memory footprint in [kByte]. The
+     maximum cost is defined by decodeCacheSizeMB.
+   */
+  QCache<subdiv_key_t, subdiv_data_t> decodeCache;
+  /// serialize cache access between the draw thread and the GUI thread
+  mutable QMutex mutexDecodeCache;
+  quint64 decodeCacheHits = 0;
+  quint64 decodeCacheMisses = 0;
 };
 
 #endif  // CMAPIMG_H
@@ -73,7 +73,8 @@ static quint32 scale2jnx(qreal scale) {
       0.5 + 76437 * exp(log(2.000032708011) * qFloor(0.5 + log(scale * 10 * 130.2084 / 76437) / log(2.000032708011))));
 }
 
-CMapJNX::CMapJNX(const QString& filename, CMapDraw* parent) : IMap(eFeatVisibility, parent), filename(filename) {
+CMapJNX::CMapJNX(const QString& filename, CMapDraw* parent)
+    : IMap(eFeatVisibility | eFeatDecodeCache, parent), filename(filename) {
   qDebug() << "------------------------------";
   qDebug() << "JNX: try to open" << filename;
 
@@ -82,6 +83,7 @@ CMapJNX::CMapJNX(const QString& filename, CMapDraw* parent) : IMap(eFeatVisibili
 
   proj.init("EPSG:3857", "EPSG:4326");
 
+  configureDecodeCache();
   isActivated = true;
 }
 
@@ -217,6 +219,18 @@ void CMapJNX::readFile(const QString& fn, qint32& productId) {
     }
   }
 
+  // keep the file open and mapped to memory for the map's lifetime. If mapping
+  // fails, e.g. for lack of address space, the tiles are read from the file.
+  file.close();
+  mapFile.file = new QFile(fn, this);
+  if (mapFile.file->open(QIODevice::ReadOnly)) {
+    mapFile.size = mapFile.file->size();
+    mapFile.data = mapFile.file->map(0, mapFile.size);
+  }
+  if (mapFile.data == nullptr) {
+    qDebug() << "JNX: Failed to map" << fn;
+  }
+
   if (mapFile.lon1 < lon1) {
     lon1 = mapFile.lon1;
   }
@@ -246,6 +260,46 @@ qint32 CMapJNX::scale2level(qreal s, const file_t& file) {
   return idxLvl;
 }
 
+void CMapJNX::configureDecodeCache() /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  decodeCache.setMaxCost(qMax(1, getDecodeCacheSize()) * 1024);
+}
+
+void CMapJNX::getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  hits = decodeCacheHits;
+  misses = decodeCacheMisses;
+  usedKB = decodeCache.totalCost();
+}
+
+QImage CMapJNX::decodeTile(file_t& mapFile, const tile_t& tile) {
+  // the tiles are stored without the JPEG's SOI marker
+  QByteArray data(tile.size + 2, 0);
+  //(char) typecast needed to avoid MSVC compiler warning
+  // in MSVC, char is a signed type.
+  data[0] = (char)0xFF;
+  data[1] = (char)0xD8;
+  char* pData = data.data() + 2;
+
+  if (mapFile.data != nullptr) {
+    if (quint64(tile.offset) + tile.size > mapFile.size) {
+      return QImage();
+    }
+    memcpy(pData, mapFile.data + tile.offset, tile.size);
+  } else {
+    QMutexLocker lock(&mutexFiles);
+    if (!mapFile.file->seek(tile.offset) || mapFile.file->read(pData, tile.size) != qint64(tile.size)) {
+      return QImage();
+    }
+  }
+
+  QImage img;
+  img.loadFromData(data);
+  return img;
+}
+
 void CMapJNX::draw(IDrawContext::buffer_t& buf) /* override */
 {
   if (map->needsRedraw()) {
@@ -276,7 +330,8 @@ void CMapJNX::draw(IDrawContext::buffer_t& buf) /* override */
   p.setOpacity(getOpacity() / 100.0);
   p.translate(-pp);
 
-  for (const file_t& mapFile : qAsConst(files)) {
+  for (qint32 f = 0; f < files.size(); f++) {
+    file_t& mapFile = files[f];
     if (!viewport.intersects(mapFile.bbox)) {
       continue;
     }
@@ -313,44 +368,80 @@ void CMapJNX::draw(IDrawContext::buffer_t& buf) /* override */
       continue;
     }
 
-    QByteArray data(1024 * 1024 * 4, 0);
-    //(char) typecast needed to avoid MSVC compiler warning
-    // in MSVC, char is a signed type.
-    // Maybe the QByteArray declaration should be fixed ;-)
-    data[0] = (char)0xFF;
-    data[1] = (char)0xD8;
-    char* pData = data.data() + 2;
-
-    QFile file(mapFile.filename);
-    file.open(QIODevice::ReadOnly);
-
+    // collect the visible tiles, take the ones decoded before from the cache
     const QVector<tile_t>& tiles = mapFile.levels[level].tiles;
-    const quint32 M = tiles.size();
-    for (quint32 m = 0; m < M; m++) {
-      if (map->needsRedraw()) {
-        break;
+    QVector<qint32> visible;
+    for (qint32 m = 0; m < tiles.size(); m++) {
+      if (viewport.intersects(tiles[m].area)) {
+        visible << m;
+      }
+    }
+
+    const quint64 keyLevel = (quint64(f) << 40) | (quint64(level) << 32);
+    QVector<QImage> images(visible.size());
+    QVector<bool> isCached(visible.size(), false);
+    {
+      QMutexLocker lock(&mutexDecodeCache);
+      for (qint32 i = 0; i < visible.size(); i++) {
+        const QImage* img = decodeCache.object(keyLevel | visible[i]);
+        if (img != nullptr) {
+          images[i] = *img;
+          isCached[i] = true;
+          decodeCacheHits++;
+        } else {
+          decodeCacheMisses++;
+        }
       }
+    }
+
+    // decode missing tiles in parallel, each task takes every n-th tile
+    QImage* pImages = images.data();
+    const bool* pIsCached = isCached.constData();
+    const qint32* pVisible = visible.constData();
+    const qint32 nTiles = visible.size();
+    const qint32 nTasks = qMin(threadPool.maxThreadCount(), nTiles);
+    for (qint32 task = 0; task < nTasks; task++) {
+      threadPool.start([this, &mapFile, &tiles, pImages, pIsCached, pVisible, nTiles, nTasks, task]() {
+        for (qint32 i = task; i < nTiles; i += nTasks) {
+          if (map->needsRedraw()) {
+            return;
+          }
+          if (!pIsCached[i]) {
+            pImages[i] = decodeTile(mapFile, tiles[pVisible[i]]);
+          }
+        }
+      });
+    }
+    threadPool.waitForDone();
 
-      const tile_t& tile = tiles[m];
-
-      if (viewport.intersects(tile.area)) {
-        QImage img;
-        file.seek(tile.offset);
-        file.read(pData, tile.size);
-        img.loadFromData(data);
-
-        QPolygonF l(4);
-        l[0].rx() = tile.area.left() * DEG_TO_RAD;
-        l[0].ry() = tile.area.top() * DEG_TO_RAD;
-        l[1].rx() = tile.area.right() * DEG_TO_RAD;
-        l[1].ry() = tile.area.top() * DEG_TO_RAD;
-        l[2].rx() = tile.area.right() * DEG_TO_RAD;
-        l[2].ry() = tile.area.bottom() * DEG_TO_RAD;
-        l[3].rx() = tile.area.left() * DEG_TO_RAD;
-        l[3].ry() = tile.area.bottom() * DEG_TO_RAD;
-
-        drawTile(img, l, p);
+    if (map->needsRedraw()) {
+      break;
+    }
+
+    {
+      QMutexLocker lock(&mutexDecodeCache);
+      for (qint32 i = 0; i < nTiles; i++) {
+        if (!isCached[i] && !images[i].isNull()) {
+          decodeCache.insert(keyLevel | visible[i], new QImage(images[i]),
+                             qMax(1, int(images[i].sizeInBytes() / 1024)));
+        }
       }
     }
+
+    for (qint32 i = 0; i < nTiles; i++) {
+      const tile_t& tile = tiles[visible[i]];
+
+      QPolygonF l(4);
+      l[0].rx() = tile.area.left() * DEG_TO_RAD;
+      l[0].ry() = tile.area.top() * DEG_TO_RAD;
+      l[1].rx() = tile.area.right() * DEG_TO_RAD;
+      l[1].ry() = tile.area.top() * DEG_TO_RAD;
+      l[2].rx() = tile.area.right() * DEG_TO_RAD;
+      l[2].ry() = tile.area.bottom() * DEG_TO_RAD;
+      l[3].rx() = tile.area.left() * DEG_TO_RAD;
+      l[3].ry() = tile.area.bottom() * DEG_TO_RAD;
+
+      drawTile(images[i], l, p);
+    }
   }
 }
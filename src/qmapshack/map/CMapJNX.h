@@ -19,9 +19,14 @@
 #ifndef CMAPJNX_H
 #define CMAPJNX_H
 
+#include <QCache>
+#include <QMutex>
+#include <QThreadPool>
+
 #include "map/IMap.h"
 
 class CMapDraw;
+class QFile;
 
 class CMapJNX : public IMap {
  public:
@@ -29,6 +34,11 @@ class CMapJNX : public IMap {
 
   void draw(IDrawContext::buffer_t& buf) override;
 
+  void getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const override;
+
+ protected:
+  void configureDecodeCache() override;
+
  private:
   QString filename;
 
@@ -86,12 +96,36 @@ class CMapJNX : public IMap {
 
     QString filename;
     QVector<level_t> levels;
+
+    /// the file is kept open for the map's lifetime
+    QFile* file = nullptr;
+    quint64 size = 0;
+    /// the memory mapped file or nullptr if the file could not be mapped
+    const uchar* data = nullptr;
   };
 
   void readFile(const QString& fn, qint32& productId);
   qint32 scale2level(qreal s, const file_t& file);
+  /// read and decode the JPEG image of a tile, thread safe
+  QImage decodeTile(file_t& mapFile, const tile_t& tile);
 
   QList<file_t> files;
+  /// serialize reading files that could not be mapped
+  QMutex mutexFiles;
+
+  /// decode visible tiles in parallel
+  QThreadPool threadPool;
+
+  /**
+     @brief LRU cache of decoded tiles
+
+     The key combines the index of the file, the level and the tile. The cost of each
+     entry is the image size in [kByte]. The maximum cost is defined by decodeCacheSizeMB.
+   */
+  QCache<quint64, QImage> decodeCache;
+  mutable QMutex mutexDecodeCache;
+  quint64 decodeCacheHits = 0;
+  quint64 decodeCacheMisses = 0;
 
   qreal lon1 = 180.0;
   qreal lat1 = -90;
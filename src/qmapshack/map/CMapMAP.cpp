@@ -18,24 +18,131 @@
 
 #include "map/CMapMAP.h"
 
+#include <QPainterPath>
 #include <QtWidgets>
+#include <cmath>
 
 #include "CMainWindow.h"
 #include "gis/proj_x.h"
+#include "helpers/CDraw.h"
 #include "helpers/CFileExt.h"
+#include "helpers/COccupancyGrid.h"
 #include "map/CMapDraw.h"
+#include "units/IUnit.h"
 
 #define INT_TO_DEG(x) (qreal(x) / 1e6)
 
 #define INT_TO_RAD(x) (qreal(x) / (1e6 * RAD_TO_DEG))
 
+#define COLOR_LAND 0xFFF8F8F8
+#define COLOR_WATER 0xFFB5D6F1
+#define COLOR_RIVER 0xFF9FC4E6
+#define COLOR_ROAD_CASING 0xFFA0A0A0
+
+inline qint32 lon2tileX(qreal lon, quint8 z) {
+  const qint32 n = 1 << z;
+  return qBound(0, qint32(std::floor((lon + 180.0) / 360.0 * n)), n - 1);
+}
+
+inline qint32 lat2tileY(qreal lat, quint8 z) {
+  const qint32 n = 1 << z;
+  const qreal r = qBound(-85.0511, lat, 85.0511) * DEG_TO_RAD;
+  return qBound(0, qint32(std::floor((1.0 - std::log(std::tan(r) + 1.0 / std::cos(r)) / M_PI) / 2.0 * n)), n - 1);
+}
+
+inline qreal tileX2lon(qint32 x, quint8 z) { return x / qreal(1 << z) * 360.0 - 180.0; }
+
+inline qreal tileY2lat(qint32 y, quint8 z) {
+  return RAD_TO_DEG * std::atan(std::sinh(M_PI - 2.0 * M_PI * y / qreal(1 << z)));
+}
+
+inline quint64 tileKey(quint8 zoom, qint32 x, qint32 y) {
+  return (quint64(zoom) << 48) | (quint64(x) << 24) | quint64(y);
+}
+
+// clang-format off
+const CMapMAP::style_t CMapMAP::theme[] = {
+    // areas
+    {"landuse", "farmland",       eStyleArea,  12, 0xFFF4EFD8, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "meadow",         eStyleArea,  12, 0xFFE3EDCC, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "grass",          eStyleArea,  12, 0xFFE3EDCC, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "residential",    eStyleArea,  10, 0xFFE8E4E3, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "industrial",     eStyleArea,  12, 0xFFEBDBE8, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "commercial",     eStyleArea,  12, 0xFFEFC8C8, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "retail",         eStyleArea,  12, 0xFFEFC8C8, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "cemetery",       eStyleArea,  13, 0xFFBDE3CB, 0x00000000, 0.0, Qt::SolidLine},
+    {"natural", "heath",          eStyleArea,  12, 0xFFFFFFC0, 0x00000000, 0.0, Qt::SolidLine},
+    {"natural", "scrub",          eStyleArea,  12, 0xFFC8D7AB, 0x00000000, 0.0, Qt::SolidLine},
+    {"natural", "wetland",        eStyleArea,  12, 0xFFD6E4EA, 0x00000000, 0.0, Qt::SolidLine},
+    {"natural", "glacier",        eStyleArea,   8, 0xFFFAFAFF, COLOR_WATER, 0.0, Qt::SolidLine},
+    {"landuse", "forest",         eStyleArea,   8, 0xFFC5DCAE, 0x00000000, 0.0, Qt::SolidLine},
+    {"natural", "wood",           eStyleArea,   8, 0xFFC5DCAE, 0x00000000, 0.0, Qt::SolidLine},
+    {"leisure", "park",           eStyleArea,  12, 0xFFCFECA8, 0x00000000, 0.0, Qt::SolidLine},
+    {"leisure", "pitch",          eStyleArea,  14, 0xFFAAE0CB, 0xFF88C0A0, 0.0, Qt::SolidLine},
+    {"amenity", "parking",        eStyleArea,  15, 0xFFF6EEB6, 0xFFE0D890, 0.0, Qt::SolidLine},
+    {"natural", "sea",            eStyleArea,   0, COLOR_WATER, 0x00000000, 0.0, Qt::SolidLine},
+    {"natural", "water",          eStyleArea,   8, COLOR_WATER, 0x00000000, 0.0, Qt::SolidLine},
+    {"waterway", "riverbank",     eStyleArea,  10, COLOR_WATER, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "reservoir",      eStyleArea,  10, COLOR_WATER, 0x00000000, 0.0, Qt::SolidLine},
+    {"landuse", "basin",          eStyleArea,  12, COLOR_WATER, 0x00000000, 0.0, Qt::SolidLine},
+    {"building", "*",             eStyleArea,  15, 0xFFD9D0C9, 0xFFBCB0A6, 0.0, Qt::SolidLine},
+    // lines
+    {"natural", "coastline",      eStyleLine,   0, 0xFF8DB4D8, 0x00000000, 1.0, Qt::SolidLine},
+    {"waterway", "stream",        eStyleLine,  13, COLOR_RIVER, 0x00000000, 1.5, Qt::SolidLine},
+    {"waterway", "canal",         eStyleLine,  12, COLOR_RIVER, 0x00000000, 2.5, Qt::SolidLine},
+    {"waterway", "river",         eStyleLine,   8, COLOR_RIVER, 0x00000000, 3.0, Qt::SolidLine},
+    {"boundary", "national_park", eStyleLine,  10, 0xFF80B080, 0x00000000, 1.5, Qt::DashLine},
+    {"boundary", "administrative",eStyleLine,   6, 0xFF9E7BB5, 0x00000000, 1.0, Qt::DashDotLine},
+    {"railway", "rail",           eStyleLine,  10, 0xFF909090, 0x00000000, 1.5, Qt::SolidLine},
+    {"aerialway", "*",            eStyleLine,  12, 0xFF606060, 0x00000000, 1.0, Qt::SolidLine},
+    {"highway", "path",           eStyleLine,  14, 0xFF8C6E4A, 0x00000000, 1.0, Qt::DashLine},
+    {"highway", "footway",        eStyleLine,  14, 0xFFE07070, 0x00000000, 1.0, Qt::DotLine},
+    {"highway", "bridleway",      eStyleLine,  14, 0xFF70A070, 0x00000000, 1.0, Qt::DashLine},
+    {"highway", "cycleway",       eStyleLine,  14, 0xFF4040E0, 0x00000000, 1.0, Qt::DashLine},
+    {"highway", "steps",          eStyleLine,  15, 0xFFE07070, 0x00000000, 2.0, Qt::DotLine},
+    {"highway", "track",          eStyleLine,  13, 0xFFA0804A, 0x00000000, 1.5, Qt::DashLine},
+    {"highway", "service",        eStyleLine,  14, 0xFFFFFFFF, COLOR_ROAD_CASING, 2.0, Qt::SolidLine},
+    {"highway", "pedestrian",     eStyleLine,  13, 0xFFEDEDED, COLOR_ROAD_CASING, 3.0, Qt::SolidLine},
+    {"highway", "living_street",  eStyleLine,  13, 0xFFFFFFFF, COLOR_ROAD_CASING, 3.0, Qt::SolidLine},
+    {"highway", "road",           eStyleLine,  12, 0xFFFFFFFF, COLOR_ROAD_CASING, 3.0, Qt::SolidLine},
+    {"highway", "unclassified",   eStyleLine,  12, 0xFFFFFFFF, COLOR_ROAD_CASING, 3.0, Qt::SolidLine},
+    {"highway", "residential",    eStyleLine,  12, 0xFFFFFFFF, COLOR_ROAD_CASING, 3.0, Qt::SolidLine},
+    {"highway", "tertiary_link",  eStyleLine,  11, 0xFFFFFF90, 0xFFA09060, 3.0, Qt::SolidLine},
+    {"highway", "tertiary",       eStyleLine,  10, 0xFFFFFF90, 0xFFA09060, 4.0, Qt::SolidLine},
+    {"highway", "secondary_link", eStyleLine,  11, 0xFFFFD080, 0xFFA08040, 3.0, Qt::SolidLine},
+    {"highway", "secondary",      eStyleLine,   9, 0xFFFFD080, 0xFFA08040, 4.5, Qt::SolidLine},
+    {"highway", "primary_link",   eStyleLine,  11, 0xFFFCA87A, 0xFFA06040, 3.0, Qt::SolidLine},
+    {"highway", "primary",        eStyleLine,   8, 0xFFFCA87A, 0xFFA06040, 5.0, Qt::SolidLine},
+    {"highway", "trunk_link",     eStyleLine,  11, 0xFFF9A07C, 0xFFA05030, 3.0, Qt::SolidLine},
+    {"highway", "trunk",          eStyleLine,   6, 0xFFF9A07C, 0xFFA05030, 5.5, Qt::SolidLine},
+    {"highway", "motorway_link",  eStyleLine,  10, 0xFFE892A2, 0xFFB04050, 3.0, Qt::SolidLine},
+    {"highway", "motorway",       eStyleLine,   5, 0xFFE892A2, 0xFFB04050, 6.0, Qt::SolidLine},
+    // points, the width is the radius of the symbol. Places are labels only.
+    {"amenity", "shelter",        eStylePoint, 15, 0xFFA0804A, 0xFF604020, 3.0, Qt::SolidLine},
+    {"tourism", "viewpoint",      eStylePoint, 15, 0xFF40A040, 0xFF205020, 3.0, Qt::SolidLine},
+    {"tourism", "alpine_hut",     eStylePoint, 13, 0xFFA04040, 0xFF602020, 3.5, Qt::SolidLine},
+    {"natural", "peak",           eStylePoint, 12, 0xFF8C6E4A, 0xFF404040, 3.0, Qt::SolidLine},
+    {"place", "locality",         eStylePoint, 15, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {"place", "hamlet",           eStylePoint, 14, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {"place", "village",          eStylePoint, 12, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {"place", "suburb",           eStylePoint, 12, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {"place", "town",             eStylePoint,  9, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {"place", "city",             eStylePoint,  6, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {"place", "country",          eStylePoint,  3, 0xFF000000, 0x00000000, 0.0, Qt::SolidLine},
+    {nullptr, nullptr,            eStylePoint,  0, 0x00000000, 0x00000000, 0.0, Qt::NoPen}
+};
+// clang-format on
+
 CMapMAP::CMapMAP(const QString& filename, CMapDraw* parent)
-    : IMap(eFeatVisibility | eFeatVectorItems, parent), filename(filename) {
+    : IMap(eFeatVisibility | eFeatVectorItems | eFeatDecodeCache, parent), filename(filename) {
   qDebug() << "------------------------------";
   qDebug() << "MAP: try to open" << filename;
 
+  configureDecodeCache();
+
   try {
     readBasics();
+    setupTheme();
   } catch (const exce_t& e) {
     QMessageBox::critical(CMainWindow::getBestWidgetForParent(), tr("Failed ..."), e.msg, QMessageBox::Abort);
     return;
@@ -122,10 +229,696 @@ void CMapMAP::readBasics() {
     stream >> layer.offsetSubFile;
     stream >> layer.sizeSubFile;
 
+    layer.tileX1 = lon2tileX(INT_TO_DEG(header.minLon), layer.baseZoom);
+    layer.tileY1 = lat2tileY(INT_TO_DEG(header.maxLat), layer.baseZoom);
+    layer.tileX2 = lon2tileX(INT_TO_DEG(header.maxLon), layer.baseZoom);
+    layer.tileY2 = lat2tileY(INT_TO_DEG(header.minLat), layer.baseZoom);
+
     layers << layer;
   }
   // ---------- end file header ----------------------
+
+  if (stream.status() != QDataStream::Ok || layers.isEmpty()) {
+    throw exce_t(errFormat, tr("Bad file format: ") + filename);
+  }
+}
+
+void CMapMAP::setupTheme() {
+  auto resolve = [](const QStringList& tags, QVector<qint16>& styleOfTag, QVector<char>& wildcardOfTag,
+                    bool isPoi) {
+    styleOfTag.fill(-1, tags.size());
+    wildcardOfTag.fill(0, tags.size());
+
+    for (int i = 0; i < tags.size(); i++) {
+      const QString& key = tags[i].section('=', 0, 0);
+      const QString& value = tags[i].section('=', 1);
+
+      // version 5 stores values like "%i" in the item, the type follows the "%"
+      if ((value.size() == 2) && value.startsWith('%')) {
+        wildcardOfTag[i] = value[1].toLatin1();
+      }
+
+      for (qint16 n = 0; theme[n].key != nullptr; n++) {
+        const style_t& style = theme[n];
+        if ((style.type == eStylePoint) != isPoi) {
+          continue;
+        }
+        if ((key == style.key) && ((qstrcmp(style.value, "*") == 0) || (value == style.value))) {
+          styleOfTag[i] = n;
+        }
+      }
+    }
+  };
+
+  resolve(header.tagsWays, styleOfWayTag, wildcardOfWayTag, false);
+  resolve(header.tagsPOIs, styleOfPoiTag, wildcardOfPoiTag, true);
+}
+
+qint32 CMapMAP::selectLayer(quint8 zoom) const {
+  qint32 best = 0;
+  qint32 bestDist = NOINT;
+  for (int i = 0; i < layers.size(); i++) {
+    const layer_t& layer = layers[i];
+    const qint32 dist = zoom < layer.minZoom ? layer.minZoom - zoom : qMax(0, zoom - layer.maxZoom);
+    if (dist < bestDist) {
+      best = i;
+      bestDist = dist;
+    }
+  }
+  return best;
+}
+
+QString CMapMAP::cleanName(const QString& name) {
+  // names can have translations attached like "name\rlang\bname\r..."
+  return name.section('\r', 0, 0);
+}
+
+void CMapMAP::readTags(QDataStream& stream, quint8 nTags, const QVector<qint16>& styleOfTag,
+                       const QVector<char>& wildcardOfTag, qint16& style) {
+  style = -1;
+
+  QVarLengthArray<quint32, 16> ids;
+  for (int i = 0; i < nTags; i++) {
+    uintX id;
+    stream >> id;
+    if (id.val >= quint64(styleOfTag.size())) {
+      stream.setStatus(QDataStream::ReadCorruptData);
+      return;
+    }
+    ids.append(id.val);
+    style = qMax(style, styleOfTag[id.val]);
+  }
+
+  // the values of wildcard tags follow in the order of the tags
+  for (quint32 id : ids) {
+    switch (wildcardOfTag[id]) {
+      case 'b':
+        stream.skipRawData(1);
+        break;
+      case 'h':
+        stream.skipRawData(2);
+        break;
+      case 'i':
+      case 'f':
+        stream.skipRawData(4);
+        break;
+      case 's': {
+        utf8 value;
+        stream >> value;
+        break;
+      }
+    }
+  }
+}
+
+void CMapMAP::readCoordBlock(QDataStream& stream, const QPointF& origin, bool doubleDelta, QPolygonF& coords) {
+  uintX nNodes;
+  stream >> nNodes;
+
+  // each node takes at least 2 bytes
+  if (nNodes.val * 2 > quint64(stream.device()->bytesAvailable())) {
+    stream.setStatus(QDataStream::ReadCorruptData);
+    return;
+  }
+
+  coords.resize(nNodes.val);
+  if (nNodes.val == 0) {
+    return;
+  }
+
+  // the first node is relative to the tile's top left corner, all others relative to their predecessor
+  intX lat, lon;
+  stream >> lat >> lon;
+  qreal x = origin.x() + lon.val;
+  qreal y = origin.y() + lat.val;
+  coords[0] = QPointF(INT_TO_RAD(x), INT_TO_RAD(y));
+
+  qint64 deltaLat = 0;
+  qint64 deltaLon = 0;
+  for (quint64 i = 1; i < nNodes.val; i++) {
+    stream >> lat >> lon;
+    if (doubleDelta) {
+      deltaLat += lat.val;
+      deltaLon += lon.val;
+    } else {
+      deltaLat = lat.val;
+      deltaLon = lon.val;
+    }
+    x += deltaLon;
+    y += deltaLat;
+    coords[i] = QPointF(INT_TO_RAD(x), INT_TO_RAD(y));
+  }
+}
+
+void CMapMAP::decodeTile(QFile& file, const layer_t& layer, quint8 zoom, qint32 x, qint32 y, tile_t& tile) const {
+  const bool hasDebugInfo = header.flags & eHeaderFlagDebugInfo;
+  const qint32 nCols = layer.tileX2 - layer.tileX1 + 1;
+  const qint32 nTiles = nCols * (layer.tileY2 - layer.tileY1 + 1);
+  const qint32 idx = (y - layer.tileY1) * nCols + (x - layer.tileX1);
+
+  // ---------- tile index ----------------------
+  // each entry has 5 bytes: 1 bit water flag, 39 bit tile offset relative to the sub-file
+  file.seek(layer.offsetSubFile + (hasDebugInfo ? 16 : 0) + 5 * idx);
+  const QByteArray& entries = file.read(idx + 1 < nTiles ? 10 : 5);
+  if (entries.size() < 5) {
+    return;
+  }
+
+  auto entry = [&entries](int i) {
+    quint64 val = 0;
+    for (int n = 0; n < 5; n++) {
+      val = (val << 8) | quint8(entries[i * 5 + n]);
+    }
+    return val;
+  };
+
+  const quint64 offset = entry(0) & 0x7FFFFFFFFFull;
+  const quint64 next = entries.size() == 10 ? (entry(1) & 0x7FFFFFFFFFull) : layer.sizeSubFile;
+
+  tile.water = entry(0) & 0x8000000000ull;
+  tile.valid = true;
+
+  if ((next <= offset) || (next > layer.sizeSubFile)) {
+    // an empty tile
+    return;
+  }
+
+  // ---------- tile data ----------------------
+  file.seek(layer.offsetSubFile + offset);
+  const QByteArray& data = file.read(next - offset);
+
+  QDataStream stream(data);
+  stream.setByteOrder(QDataStream::BigEndian);
+
+  if (hasDebugInfo) {
+    stream.skipRawData(32);
+  }
+
+  // sum up the items of all zoom levels up to the requested one
+  const qint32 row = qBound(0, zoom - layer.minZoom, layer.maxZoom - layer.minZoom);
+  quint64 nPois = 0;
+  quint64 nWays = 0;
+  for (qint32 i = 0; i <= layer.maxZoom - layer.minZoom; i++) {
+    uintX pois, ways;
+    stream >> pois >> ways;
+    if (i <= row) {
+      nPois += pois.val;
+      nWays += ways.val;
+    }
+  }
+
+  uintX offsetWays;
+  stream >> offsetWays;
+  const qint64 posWays = stream.device()->pos() + offsetWays.val;
+
+  // all coordinates are relative to the tile's top left corner [µdeg]
+  const QPointF origin(tileX2lon(x, layer.baseZoom) * 1e6, tileY2lat(y, layer.baseZoom) * 1e6);
+
+  for (quint64 i = 0; (i < nPois) && (stream.status() == QDataStream::Ok); i++) {
+    if (hasDebugInfo) {
+      stream.skipRawData(32);
+    }
+
+    intX lat, lon;
+    quint8 special, flags;
+    stream >> lat >> lon >> special;
+
+    poi_t poi;
+    poi.layer = qint8(special >> 4) - 5;
+    readTags(stream, special & 0x0F, styleOfPoiTag, wildcardOfPoiTag, poi.style);
+
+    stream >> flags;
+    if (flags & 0x80) {
+      utf8 name;
+      stream >> name;
+      poi.label = cleanName(name.val);
+    }
+    if (flags & 0x40) {
+      utf8 houseNumber;
+      stream >> houseNumber;
+    }
+    if (flags & 0x20) {
+      intX ele;
+      stream >> ele;
+      poi.ele = ele.val;
+    }
+
+    if (poi.style < 0) {
+      continue;
+    }
+
+    poi.pos = QPointF(INT_TO_RAD(origin.x() + lon.val), INT_TO_RAD(origin.y() + lat.val));
+    tile.pois << poi;
+  }
+
+  stream.device()->seek(posWays);
+
+  for (quint64 i = 0; (i < nWays) && (stream.status() == QDataStream::Ok); i++) {
+    if (hasDebugInfo) {
+      stream.skipRawData(32);
+    }
+
+    uintX size;
+    stream >> size;
+    const qint64 posNext = stream.device()->pos() + size.val;
+
+    quint16 subTiles;
+    quint8 special, flags;
+    stream >> subTiles >> special;
+
+    way_t way;
+    way.layer = qint8(special >> 4) - 5;
+    readTags(stream, special & 0x0F, styleOfWayTag, wildcardOfWayTag, way.style);
+
+    if (way.style < 0) {
+      // nothing to draw, skip the rest of the way
+      stream.device()->seek(posNext);
+      continue;
+    }
+
+    stream >> flags;
+
+    QString name, ref;
+    if (flags & 0x80) {
+      utf8 tmp;
+      stream >> tmp;
+      name = cleanName(tmp.val);
+    }
+    if (flags & 0x40) {
+      utf8 houseNumber;
+      stream >> houseNumber;
+    }
+    if (flags & 0x20) {
+      utf8 tmp;
+      stream >> tmp;
+      ref = tmp.val;
+    }
+    if (flags & 0x10) {
+      intX labelLat, labelLon;
+      stream >> labelLat >> labelLon;
+    }
+
+    uintX nDataBlocks;
+    nDataBlocks.val = 1;
+    if (flags & 0x08) {
+      stream >> nDataBlocks;
+    }
+
+    way.label = name.isEmpty() ? ref : name;
+
+    for (quint64 n = 0; (n < nDataBlocks.val) && (stream.status() == QDataStream::Ok); n++) {
+      uintX nCoordBlocks;
+      stream >> nCoordBlocks;
+
+      way_t block = way;
+      for (quint64 m = 0; (m < nCoordBlocks.val) && (stream.status() == QDataStream::Ok); m++) {
+        QPolygonF coords;
+        readCoordBlock(stream, origin, flags & 0x04, coords);
+        block.blocks << coords;
+      }
+
+      if (!block.blocks.isEmpty() && (block.blocks.first().size() > 1)) {
+        block.boundingRect = block.blocks.first().boundingRect();
+        tile.ways << block;
+      }
+    }
+
+    stream.device()->seek(posNext);
+  }
+
+  if (stream.status() != QDataStream::Ok) {
+    qWarning() << "MAP: corrupt tile" << layer.baseZoom << x << y << "in" << filename;
+  }
+}
+
+qint32 CMapMAP::estimateDecodeCost(const tile_t& tile) {
+  qint64 bytes = sizeof(tile_t);
+
+  for (const way_t& way : tile.ways) {
+    bytes += sizeof(way_t) + way.label.size() * sizeof(QChar);
+    for (const QPolygonF& block : way.blocks) {
+      bytes += sizeof(QPolygonF) + block.capacity() * sizeof(QPointF);
+    }
+  }
+
+  for (const poi_t& poi : tile.pois) {
+    bytes += sizeof(poi_t) + poi.label.size() * sizeof(QChar);
+  }
+
+  return qint32(bytes / 1024) + 1;
+}
+
+void CMapMAP::configureDecodeCache() /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  decodeCache.setMaxCost(qMax(1, getDecodeCacheSize()) * 1024);
+}
+
+void CMapMAP::getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const /* override */
+{
+  QMutexLocker lock(&mutexDecodeCache);
+  hits = decodeCacheHits;
+  misses = decodeCacheMisses;
+  usedKB = decodeCache.totalCost();
+}
+
+bool CMapMAP::needsRedraw() const { return map->needsRedraw(); }
+
+bool CMapMAP::getTiles(const layer_t& layer, quint8 zoom, qint32 x1, qint32 y1, qint32 nCols, qint32 nRows,
+                       QVector<tile_t>& tiles) {
+  tiles = QVector<tile_t>(nCols * nRows);
+  QVector<bool> isCached(nCols * nRows, false);
+
+  {
+    QMutexLocker lock(&mutexDecodeCache);
+    for (qint32 i = 0; i < tiles.size(); i++) {
+      const tile_t* tile = decodeCache.object(tileKey(zoom, x1 + i % nCols, y1 + i / nCols));
+      if (tile != nullptr) {
+        tiles[i] = *tile;
+        isCached[i] = true;
+        decodeCacheHits++;
+      } else {
+        decodeCacheMisses++;
+      }
+    }
+  }
+
+  // decode missing tiles in parallel, one task for each row of tiles
+  tile_t* data = tiles.data();
+  for (qint32 row = 0; row < nRows; row++) {
+    bool isComplete = true;
+    for (qint32 col = 0; col < nCols; col++) {
+      isComplete = isComplete && isCached[row * nCols + col];
+    }
+    if (isComplete) {
+      continue;
+    }
+
+    threadPool.start([this, &layer, data, row, nCols, x1, y1, zoom]() {
+      QFile file(filename);
+      if (!file.open(QIODevice::ReadOnly)) {
+        return;
+      }
+
+      for (qint32 col = 0; col < nCols; col++) {
+        if (needsRedraw()) {
+          return;
+        }
+
+        tile_t& tile = data[row * nCols + col];
+        if (tile.valid) {
+          continue;
+        }
+
+        try {
+          decodeTile(file, layer, zoom, x1 + col, y1 + row, tile);
+        } catch (const std::bad_alloc&) {
+          qWarning() << "MAP: Allocation error. Abort tile decoding.";
+          tile = tile_t();
+          return;
+        }
+      }
+    });
+  }
+  threadPool.waitForDone();
+
+  {
+    QMutexLocker lock(&mutexDecodeCache);
+    for (qint32 i = 0; i < tiles.size(); i++) {
+      if (!isCached[i] && tiles[i].valid) {
+        decodeCache.insert(tileKey(zoom, x1 + i % nCols, y1 + i / nCols), new tile_t(tiles[i]),
+                           estimateDecodeCost(tiles[i]));
+      }
+    }
+  }
+
+  return !needsRedraw();
 }
 
 void CMapMAP::draw(IDrawContext::buffer_t& buf) /* override */
-{}
+{
+  if (map->needsRedraw() || layers.isEmpty()) {
+    return;
+  }
+
+  QPointF bufferScale = buf.scale * buf.zoomFactor;
+
+  if (isOutOfScale(bufferScale)) {
+    return;
+  }
+
+  // find the zoom level matching the scale best, the same way it's done for tile servers
+  qint32 z = 20;
+  qreal d = NOFLOAT;
+  for (qint32 i = 0; i < 21; i++) {
+    qreal s = 0.055 * (1 << i);
+    if (qAbs(s - bufferScale.x()) < d) {
+      z = i;
+      d = qAbs(s - bufferScale.x());
+    }
+  }
+  const quint8 zoom = qBound(0, 21 - z + getAdjustDetailLevel(), 22);
+
+  const layer_t& layer = layers[selectLayer(zoom)];
+
+  qreal u1 = qMin(buf.ref1.x(), buf.ref4.x());
+  qreal u2 = qMax(buf.ref2.x(), buf.ref3.x());
+  qreal v1 = qMax(buf.ref1.y(), buf.ref2.y());
+  qreal v2 = qMin(buf.ref4.y(), buf.ref3.y());
+
+  QRectF viewport(u1, v1, u2 - u1, v2 - v1);
+
+  const qint32 x1 = qMax(layer.tileX1, lon2tileX(u1 * RAD_TO_DEG, layer.baseZoom));
+  const qint32 x2 = qMin(layer.tileX2, lon2tileX(u2 * RAD_TO_DEG, layer.baseZoom));
+  const qint32 y1 = qMax(layer.tileY1, lat2tileY(v1 * RAD_TO_DEG, layer.baseZoom));
+  const qint32 y2 = qMin(layer.tileY2, lat2tileY(v2 * RAD_TO_DEG, layer.baseZoom));
+
+  if ((x1 > x2) || (y1 > y2)) {
+    return;
+  }
+
+  const qint32 nCols = x2 - x1 + 1;
+  const qint32 nRows = y2 - y1 + 1;
+
+  QVector<QRectF> areas(nCols * nRows);
+  for (qint32 row = 0; row < nRows; row++) {
+    for (qint32 col = 0; col < nCols; col++) {
+      const qint32 x = x1 + col;
+      const qint32 y = y1 + row;
+      QRectF& area = areas[row * nCols + col];
+
+      area = QRectF(QPointF(tileX2lon(x, layer.baseZoom), tileY2lat(y, layer.baseZoom)),
+                    QPointF(tileX2lon(x + 1, layer.baseZoom), tileY2lat(y + 1, layer.baseZoom)));
+      area = QRectF(area.topLeft() * DEG_TO_RAD, area.bottomRight() * DEG_TO_RAD);
+    }
+  }
+
+  QVector<tile_t> tiles;
+  if (!getTiles(layer, zoom, x1, y1, nCols, nRows, tiles)) {
+    return;
+  }
+
+  /**
+     convertRad2Px() converts positions into screen coordinates. However the painter
+     devices paints into the buffer which is a little bit larger than the screen.
+     Thus we need the offset of the buffer's top left corner to the top left corner
+     of the screen to adjust all drawings.
+   */
+  QPointF pp = buf.ref1;
+  map->convertRad2Px(pp);
+
+  QPainter p(&buf.image);
+  USE_ANTI_ALIASING(p, true);
+  p.setOpacity(getOpacity() / 100.0);
+  p.translate(-pp);
+
+  drawTiles(p, tiles, areas, zoom, viewport);
+}
+
+void CMapMAP::drawTiles(QPainter& p, const QVector<tile_t>& tiles, const QVector<QRectF>& areas, quint8 zoom,
+                        const QRectF& viewport) {
+  // ---------- background ----------------------
+  p.setPen(Qt::NoPen);
+  for (int i = 0; i < tiles.size(); i++) {
+    const QRectF& a = areas[i];
+    QPolygonF poly;
+    poly << a.topLeft() << a.topRight() << a.bottomRight() << a.bottomLeft();
+    map->convertRad2Px(poly);
+
+    p.setBrush(QColor(tiles[i].water ? COLOR_WATER : COLOR_LAND));
+    p.drawPolygon(poly);
+  }
+
+  // collect all visible ways sorted by their OSM layer and the draw order of the theme
+  QVector<const way_t*> ways;
+  QVector<const poi_t*> pois;
+  for (const tile_t& tile : tiles) {
+    for (const way_t& way : tile.ways) {
+      if ((theme[way.style].minZoom <= zoom) && way.boundingRect.intersects(viewport)) {
+        ways << &way;
+      }
+    }
+    for (const poi_t& poi : tile.pois) {
+      if (theme[poi.style].minZoom <= zoom) {
+        pois << &poi;
+      }
+    }
+  }
+
+  std::stable_sort(ways.begin(), ways.end(), [](const way_t* a, const way_t* b) {
+    return a->layer == b->layer ? a->style < b->style : a->layer < b->layer;
+  });
+
+  if (map->needsRedraw()) {
+    return;
+  }
+
+  // ---------- areas ----------------------
+  QVector<line_t> lines;
+  for (const way_t* way : qAsConst(ways)) {
+    const style_t& style = theme[way->style];
+    if (style.type == eStyleLine) {
+      line_t line{way, way->blocks};
+      for (QPolygonF& poly : line.pixel) {
+        map->convertRad2Px(poly);
+      }
+      lines << line;
+      continue;
+    }
+
+    QPainterPath path;
+    path.setFillRule(Qt::OddEvenFill);
+    for (QPolygonF poly : way->blocks) {
+      map->convertRad2Px(poly);
+      path.addPolygon(poly);
+    }
+
+    p.setPen(qAlpha(style.border) ? QPen(QColor(style.border), 1) : QPen(Qt::NoPen));
+    p.setBrush(QColor(style.fill));
+    p.drawPath(path);
+  }
+
+  if (map->needsRedraw()) {
+    return;
+  }
+
+  // ---------- lines ----------------------
+  // scale line widths relative to zoom level 16
+  const qreal f = qBound(0.25, std::pow(1.4, zoom - 16), 4.0);
+
+  p.setBrush(Qt::NoBrush);
+  for (int i = 0; i < lines.size();) {
+    // draw the casings of all lines of a layer first to get proper junctions
+    int j = i;
+    while ((j < lines.size()) && (lines[j].way->layer == lines[i].way->layer)) {
+      const style_t& style = theme[lines[j].way->style];
+      if (qAlpha(style.border)) {
+        p.setPen(QPen(QColor(style.border), style.width * f + 2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        for (const QPolygonF& poly : lines[j].pixel) {
+          p.drawPolyline(poly);
+        }
+      }
+      j++;
+    }
+
+    for (; i < j; i++) {
+      const style_t& style = theme[lines[i].way->style];
+      p.setPen(QPen(QColor(style.fill), style.width * f, style.penStyle, Qt::RoundCap, Qt::RoundJoin));
+      for (const QPolygonF& poly : lines[i].pixel) {
+        p.drawPolyline(poly);
+      }
+    }
+  }
+
+  if (map->needsRedraw()) {
+    return;
+  }
+
+  // ---------- points and labels ----------------------
+  QFont font = CMainWindow::self().getMapFont();
+  QFontMetricsF fm(font);
+  COccupancyGrid blockedAreas;
+
+  // the last entries of the theme are the most important ones, they get their label placed first
+  std::stable_sort(pois.begin(), pois.end(), [](const poi_t* a, const poi_t* b) { return a->style > b->style; });
+
+  for (const poi_t* poi : qAsConst(pois)) {
+    const style_t& style = theme[poi->style];
+
+    QPointF pt = poi->pos;
+    map->convertRad2Px(pt);
+
+    if (style.width > 0) {
+      p.setPen(QColor(style.border));
+      p.setBrush(QColor(style.fill));
+      p.drawEllipse(pt, style.width, style.width);
+    }
+
+    QString label = poi->label;
+    if (label.isEmpty()) {
+      continue;
+    }
+
+    if (poi->ele != NOINT) {
+      QString val, unit;
+      IUnit::self().meter2elevation(poi->ele, val, unit);
+      label += QString(" (%1%2)").arg(val, unit);
+    }
+
+    QRectF rect = fm.boundingRect(label);
+    rect.moveCenter(pt + QPointF(0, style.width > 0 ? -(style.width + rect.height() / 2) : 0));
+    if (CDraw::doesOverlap(blockedAreas, rect)) {
+      continue;
+    }
+    blockedAreas << rect;
+
+    CDraw::text(label, p, rect.center(), QColor(style.fill).darker(), font);
+  }
+
+  if (zoom < 15) {
+    return;
+  }
+
+  // place the names of lines on their longest segment
+  for (const line_t& line : qAsConst(lines)) {
+    if (line.way->label.isEmpty() || line.pixel.isEmpty()) {
+      continue;
+    }
+
+    const QPolygonF& poly = line.pixel.first();
+    QLineF segment;
+    for (int i = 1; i < poly.size(); i++) {
+      const QLineF l(poly[i - 1], poly[i]);
+      if (l.length() > segment.length()) {
+        segment = l;
+      }
+    }
+
+    const qreal width = fm.horizontalAdvance(line.way->label);
+    if (segment.length() < width + 10) {
+      continue;
+    }
+
+    // keep text upright
+    qreal angle = segment.angle();
+    if ((angle > 90) && (angle < 270)) {
+      angle -= 180;
+    }
+
+    QTransform trans;
+    trans.translate(segment.center().x(), segment.center().y());
+    trans.rotate(-angle);
+
+    QRectF rect(-width / 2, -fm.height() / 2, width, fm.height());
+    const QRectF& bbox = trans.mapRect(rect);
+    if (CDraw::doesOverlap(blockedAreas, bbox)) {
+      continue;
+    }
+    blockedAreas << bbox;
+
+    p.save();
+    p.setTransform(trans, true);
+    CDraw::text(line.way->label, p, QPointF(0, 0), Qt::black, font);
+    p.restore();
+  }
+}
@@ -19,7 +19,11 @@
 #ifndef CMAPMAP_H
 #define CMAPMAP_H
 
+#include <QCache>
 #include <QList>
+#include <QMutex>
+#include <QPolygonF>
+#include <QThreadPool>
 
 #include "map/IMap.h"
 #include "map/mapsforge/types.h"
@@ -34,7 +38,11 @@ class CMapMAP : public IMap {
 
   void draw(IDrawContext::buffer_t& buf) override;
 
- private:
+  void getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const override;
+
+ protected:
+  void configureDecodeCache() override;
+
   enum exce_e { eErrOpen, eErrAccess, errFormat, errAbort };
   struct exce_t {
     exce_t(exce_e err, const QString& msg) : err(err), msg(msg) {}
@@ -48,6 +56,11 @@ class CMapMAP : public IMap {
     quint8 maxZoom;
     quint64 offsetSubFile;
     quint64 sizeSubFile;
+    // tile range covered by the sub-file at baseZoom
+    qint32 tileX1;
+    qint32 tileY1;
+    qint32 tileX2;
+    qint32 tileY2;
   };
 
   enum header_flags_e {
@@ -85,9 +98,99 @@ class CMapMAP : public IMap {
     QStringList tagsWays;
   };
 
+  enum style_type_e { eStyleArea, eStyleLine, eStylePoint };
+
+  /**
+     @brief An entry of the built-in render theme
+
+     A tag "key=value" of a way or POI matches if key is equal and value is
+     either equal or "*". If several tags of an item match, the entry listed last
+     in the theme wins. The theme's order is the draw order, too.
+   */
+  struct style_t {
+    const char* key;
+    const char* value;
+    style_type_e type;
+    quint8 minZoom;
+    QRgb fill;    //< area fill, line color or symbol color
+    QRgb border;  //< area border or line casing. Fully transparent for none.
+    qreal width;  //< line width at zoom level 16 [pixel]
+    Qt::PenStyle penStyle;
+  };
+
+  static const style_t theme[];
+
+  /// a decoded way data block, all coordinates in [rad]
+  struct way_t {
+    qint16 style = -1;
+    qint8 layer = 0;
+    QString label;
+    /// first block is the outer ring/line, following ones are inner rings
+    QVector<QPolygonF> blocks;
+    QRectF boundingRect;
+  };
+
+  /// a decoded point of interest, position in [rad]
+  struct poi_t {
+    qint16 style = -1;
+    qint8 layer = 0;
+    QString label;
+    qint32 ele = NOINT;
+    QPointF pos;
+  };
+
+  /// all items of a tile needed for a particular zoom level
+  struct tile_t {
+    bool valid = false;
+    bool water = false;
+    QVector<way_t> ways;
+    QVector<poi_t> pois;
+  };
+
+  /// a visible line converted to screen coordinates
+  struct line_t {
+    const way_t* way;
+    QVector<QPolygonF> pixel;
+  };
+
+  /**
+     @brief Get the tiles of a range at a zoom level
+
+     Tiles found in the decode cache are copied. All others are decoded in parallel, one
+     task per row of tiles. All tiles decoded are added to the cache, even if decoding is
+     aborted because the map needs a redraw. When panning the next draw() will need most
+     of them again.
+
+     @param layer     the sub-file to read the tiles from
+     @param zoom      the zoom level
+     @param x1        the column of the top left tile
+     @param y1        the row of the top left tile
+     @param nCols     the number of columns
+     @param nRows     the number of rows
+     @param tiles     the tiles row by row. Tiles not decoded are invalid.
+     @return False if decoding has been aborted.
+   */
+  bool getTiles(const layer_t& layer, quint8 zoom, qint32 x1, qint32 y1, qint32 nCols, qint32 nRows,
+                QVector<tile_t>& tiles);
+
+  /// @return True if drawing has to be aborted as the map needs a redraw
+  virtual bool needsRedraw() const;
+
   QList<layer_t> layers;
 
+ private:
   void readBasics();
+  void setupTheme();
+  qint32 selectLayer(quint8 zoom) const;
+  void decodeTile(QFile& file, const layer_t& layer, quint8 zoom, qint32 x, qint32 y, tile_t& tile) const;
+  static void readTags(QDataStream& stream, quint8 nTags, const QVector<qint16>& styleOfTag,
+                       const QVector<char>& wildcardOfTag, qint16& style);
+  static void readCoordBlock(QDataStream& stream, const QPointF& origin, bool doubleDelta, QPolygonF& coords);
+  static qint32 estimateDecodeCost(const tile_t& tile);
+  static QString cleanName(const QString& name);
+
+  void drawTiles(QPainter& p, const QVector<tile_t>& tiles, const QVector<QRectF>& areas, quint8 zoom,
+                 const QRectF& viewport);
 
   QString filename;
 
@@ -97,6 +200,29 @@ class CMapMAP : public IMap {
   QPointF ref1;
   /// bottom right point of the map
   QPointF ref2;
+
+  /// the theme entry for each way tag of the header, -1 if no entry matches
+  QVector<qint16> styleOfWayTag;
+  /// the theme entry for each POI tag of the header, -1 if no entry matches
+  QVector<qint16> styleOfPoiTag;
+  /// the value type of wildcard tags (version 5), 0 for regular tags
+  QVector<char> wildcardOfWayTag;
+  QVector<char> wildcardOfPoiTag;
+
+  /// decode visible tiles in parallel
+  QThreadPool threadPool;
+
+  /**
+     @brief LRU cache of decoded tiles
+
+     The key combines zoom level and tile coordinates. The cost of each entry is its
+     estimated memory footprint in [kByte]. The maximum cost is defined by decodeCacheSizeMB.
+   */
+  QCache<quint64, tile_t> decodeCache;
+  /// serialize cache access between the draw thread and the GUI thread
+  mutable QMutex mutexDecodeCache;
+  quint64 decodeCacheHits = 0;
+  quint64 decodeCacheMisses = 0;
 };
 
 #endif  // CMAPMAP_H
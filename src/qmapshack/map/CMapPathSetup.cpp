@@ -24,8 +24,8 @@
 #include "map/CMapDraw.h"
 #include "map/CMapList.h"
 
-CMapPathSetup::CMapPathSetup(QStringList& paths, QString& pathCache)
-    : QDialog(CMainWindow::getBestWidgetForParent()), paths(paths), pathCache(pathCache) {
+CMapPathSetup::CMapPathSetup(QStringList& paths, QString& pathCache, bool& cachePacked)
+    : QDialog(CMainWindow::getBestWidgetForParent()), paths(paths), pathCache(pathCache), cachePacked(cachePacked) {
   setupUi(this);
 
   connect(toolAdd, &QToolButton::clicked, this, &CMapPathSetup::slotAddPath);
@@ -40,6 +40,7 @@ CMapPathSetup::CMapPathSetup(QStringList& paths, QString& pathCache)
 
   labelCacheRoot->setText(pathCache);
   connect(toolCacheRoot, &QToolButton::clicked, this, &CMapPathSetup::slotChangeCachePath);
+  checkCachePacked->setChecked(cachePacked);
 
   labelHelp->setText(tr("Add or remove paths containing maps. There can be multiple maps in a path but no sub-path is "
                         "parsed. Supported formats are: %1")
@@ -90,6 +91,7 @@ void CMapPathSetup::accept() {
   }
 
   pathCache = QDir(labelCacheRoot->text()).absolutePath();
+  cachePacked = checkCachePacked->isChecked();
 
   QDialog::accept();
 }
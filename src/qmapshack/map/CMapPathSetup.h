@@ -26,7 +26,7 @@
 class CMapPathSetup : public QDialog, private Ui::IMapPathSetup {
   Q_OBJECT
  public:
-  CMapPathSetup(QStringList& paths, QString& pathCache);
+  CMapPathSetup(QStringList& paths, QString& pathCache, bool& cachePacked);
   virtual ~CMapPathSetup();
 
  public slots:
@@ -42,6 +42,7 @@ class CMapPathSetup : public QDialog, private Ui::IMapPathSetup {
  private:
   QStringList& paths;
   QString& pathCache;
+  bool& cachePacked;
 };
 
 #endif  // CMAPPATHSETUP_H
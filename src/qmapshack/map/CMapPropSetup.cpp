@@ -23,7 +23,9 @@
 #include "helpers/CSettings.h"
 #include "helpers/Signals.h"
 #include "map/CMapDraw.h"
+#include "map/CMapTileSeed.h"
 #include "map/IMap.h"
+#include "map/IMapOnline.h"
 #include "units/IUnit.h"
 QPointF CMapPropSetup::scale;
 
@@ -49,6 +51,9 @@ CMapPropSetup::CMapPropSetup(IMap* mapfile, CMapDraw* map) : IMapProp(mapfile, m
   connect(spinAdjustDetails, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), map,
           &CMapDraw::emitSigCanvasUpdate);
 
+  connect(spinDecodeCacheSize, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), mapfile,
+          &IMap::slotSetDecodeCacheSize);
+
   connect(spinCacheSize, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), mapfile,
           &IMap::slotSetCacheSize);
   connect(spinCacheExpiration, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), mapfile,
@@ -56,9 +61,12 @@ CMapPropSetup::CMapPropSetup(IMap* mapfile, CMapDraw* map) : IMapProp(mapfile, m
 
   connect(toolOpenTypFile, &QToolButton::pressed, this, &CMapPropSetup::slotLoadTypeFile);
   connect(toolClearTypFile, &QToolButton::pressed, this, &CMapPropSetup::slotClearTypeFile);
+  connect(pushSeedTiles, &QPushButton::clicked, this, &CMapPropSetup::slotSeedTiles);
 
   frameVectorItems->setVisible(mapfile->hasFeatureVectorItems());
+  frameDecodeCache->setVisible(mapfile->hasFeatureDecodeCache());
   frameTileCache->setVisible(mapfile->hasFeatureTileCache());
+  pushSeedTiles->setVisible(dynamic_cast<IMapOnline*>(mapfile) != nullptr);
 
   if (mapfile->hasFeatureLayers()) {
     frameLayers->show();
@@ -92,6 +100,14 @@ void CMapPropSetup::slotPropertiesChanged() /* override */
   checkPoints->setChecked(mapfile->getShowPOIs());
   spinAdjustDetails->setValue(mapfile->getAdjustDetailLevel());
 
+  // decoded vector data cache
+  spinDecodeCacheSize->setValue(mapfile->getDecodeCacheSize());
+  quint64 hits, misses;
+  qint32 usedKB;
+  mapfile->getDecodeCacheStatistics(hits, misses, usedKB);
+  labelDecodeCacheStats->setText(
+      tr("%1 MB used, %2 hits, %3 misses").arg(usedKB / 1024.0, 0, 'f', 1).arg(hits).arg(misses));
+
   // streaming map properties
   QString lbl = mapfile->getCachePath();
   labelCachePath->setText(lbl.size() < 20 ? lbl : "..." + lbl.right(17));
@@ -146,3 +162,13 @@ void CMapPropSetup::slotClearTypeFile() {
   mapfile->slotSetTypeFile("");
   slotPropertiesChanged();
 }
+
+void CMapPropSetup::slotSeedTiles() {
+  IMapOnline* online = dynamic_cast<IMapOnline*>(mapfile);
+  if (online == nullptr) {
+    return;
+  }
+
+  CMapTileSeed dlg(online, this);
+  dlg.exec();
+}
@@ -37,6 +37,7 @@ class CMapPropSetup : public IMapProp, private Ui::IMapPropSetup {
   void slotSetMaxScale(bool checked);
   void slotLoadTypeFile();
   void slotClearTypeFile();
+  void slotSeedTiles();
 
  private:
   static QPointF scale;
@@ -27,7 +27,7 @@
 #include "gis/proj_x.h"
 #include "helpers/CDraw.h"
 #include "map/CMapDraw.h"
-#include "map/cache/CDiskCache.h"
+#include "map/cache/IDiskCache.h"
 #include "units/IUnit.h"
 
 inline int lon2tile(double lon, int z) { return (int)(qRound(256 * (lon + 180.0) / 360.0 * qPow(2.0, z))); }
@@ -270,12 +270,40 @@ QString CMapTMS::createUrl(const layer_t& layer, int x, int y, int z) {
   return layer.strUrl.arg(z).arg(x).arg(y);
 }
 
+void CMapTMS::getTileUrls(const QList<QRectF>& areas, qint32 zoom, QSet<QString>& urls) /* override */
+{
+  QMutexLocker lock(&mutex);
+
+  const qint32 maxTile = (1 << zoom) - 1;
+
+  for (const layer_t& layer : qAsConst(layers)) {
+    // the layer's zoom levels are counted from the highest resolution, see draw()
+    if (!layer.enabled || ((21 - zoom) < layer.minZoomLevel) || ((21 - zoom) > layer.maxZoomLevel)) {
+      continue;
+    }
+
+    for (const QRectF& area : areas) {
+      const qint32 col1 = qBound(0, lon2tile(area.left(), zoom) / 256, maxTile);
+      const qint32 col2 = qBound(0, lon2tile(area.right(), zoom) / 256, maxTile);
+      // the Mercator projection ends at +/-85.0511°
+      const qint32 row1 = qBound(0, lat2tile(qMin(area.bottom(), 85.0511), zoom) / 256, maxTile);
+      const qint32 row2 = qBound(0, lat2tile(qMax(area.top(), -85.0511), zoom) / 256, maxTile);
+
+      for (qint32 row = row1; row <= row2; row++) {
+        for (qint32 col = col1; col <= col2; col++) {
+          urls << createUrl(layer, col, row, zoom);
+        }
+      }
+    }
+  }
+}
+
 void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
 {
   QMutexLocker lock(&mutex);
 
   timeLastUpdate.start();
-  urlQueue.clear();
+  tileQueue.clear();
 
   if (map->needsRedraw()) {
     return;
@@ -284,6 +312,7 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
   QPointF bufferScale = buf.scale * buf.zoomFactor;
 
   if (isOutOfScale(bufferScale)) {
+    requestTiles();
     return;
   }
 
@@ -311,6 +340,8 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
     x2 = 180 * DEG_TO_RAD;
   }
 
+  areaLastDraw = QRectF(QPointF(x1, y2) * RAD_TO_DEG, QPointF(x2, y1) * RAD_TO_DEG);
+
   // draw layers
   for (const layer_t& layer : qAsConst(layers)) {
     if (!layer.enabled) {
@@ -345,6 +376,10 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
     //        qDebug() << col1 << col2 << row1 << row2 << (col2 - col1) << (row2 - row1) << ((col2 - col1) * (row2 -
     //        row1));
 
+    // the viewport's center in tiles, to request the central tiles first
+    const qreal colCenter = (lon2tile(x1 * RAD_TO_DEG, z) + lon2tile(x2 * RAD_TO_DEG, z)) / 512.0;
+    const qreal rowCenter = (lat2tile(y1 * RAD_TO_DEG, z) + lat2tile(y2 * RAD_TO_DEG, z)) / 512.0;
+
     // start to request tiles. draw tiles in cache, queue urls of tile yet to be requested
     for (qint32 row = row1; row <= row2; row++) {
       for (qint32 col = col1; col <= col2; col++) {
@@ -365,11 +400,11 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
           l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
           drawTile(img, l, p);
         } else {
-          urlQueue << url;
+          queueTile(url, std::hypot(col + 0.5 - colCenter, row + 0.5 - rowCenter));
         }
       }
     }
-
-    emit sigQueueChanged();
   }
+
+  requestTiles();
 }
@@ -21,7 +21,7 @@
 
 #include "map/IMapOnline.h"
 
-class CDiskCache;
+class IDiskCache;
 class QListWidgetItem;
 class QNetworkAccessManager;
 class QNetworkReply;
@@ -39,6 +39,8 @@ class CMapTMS : public IMapOnline {
   void saveConfig(QSettings& cfg) override;
   void loadConfig(QSettings& cfg) override;
 
+  void getTileUrls(const QList<QRectF>& areas, qint32 zoom, QSet<QString>& urls) override;
+
  private slots:
   void slotLayersChanged(QListWidgetItem* item);
 
@@ -0,0 +1,191 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/CMapTileSeed.h"
+
+#include <QtWidgets>
+
+#include "gis/CGisWorkspace.h"
+#include "gis/proj_x.h"
+#include "map/IMapOnline.h"
+#include "map/cache/CTileLoader.h"
+
+// the maximum number of tiles to download at once
+#define MAX_TILES 100000
+
+/// @return the y coordinate of a latitude [°] in Mercator tiles of zoom level 0
+static qreal mercatorY(qreal lat) {
+  lat = qBound(-85.0511, lat, 85.0511) * DEG_TO_RAD;
+  return (1.0 - qLn(qTan(lat) + 1.0 / qCos(lat)) / M_PI) / 2.0;
+}
+
+CMapTileSeed::CMapTileSeed(IMapOnline* map, QWidget* parent) : QDialog(parent), map(map) {
+  setupUi(this);
+
+  seeder = map->createSeeder(this);
+  connect(seeder, &CTileSeeder::sigProgress, this, &CMapTileSeed::slotProgress);
+  connect(seeder, &CTileSeeder::sigFinished, this, &CMapTileSeed::slotFinished);
+
+  areaVisible = map->getAreaLastDraw();
+  radioVisibleArea->setEnabled(!areaVisible.isEmpty());
+
+  QList<QPair<QString, QString>> projects;
+  CGisWorkspace::self().getProjectNames(projects);
+  for (const QPair<QString, QString>& project : qAsConst(projects)) {
+    comboProject->addItem(project.second, project.first);
+  }
+  radioProject->setEnabled(!projects.isEmpty());
+  radioCorridor->setEnabled(!projects.isEmpty());
+  if (areaVisible.isEmpty() && !projects.isEmpty()) {
+    radioProject->setChecked(true);
+  }
+
+  connect(radioVisibleArea, &QRadioButton::toggled, this, &CMapTileSeed::slotUpdateTiles);
+  connect(radioProject, &QRadioButton::toggled, this, &CMapTileSeed::slotUpdateTiles);
+  connect(radioCorridor, &QRadioButton::toggled, this, &CMapTileSeed::slotUpdateTiles);
+  connect(comboProject, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+          &CMapTileSeed::slotUpdateTiles);
+  connect(spinCorridor, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &CMapTileSeed::slotUpdateTiles);
+  connect(spinZoomMin, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &CMapTileSeed::slotUpdateTiles);
+  connect(spinZoomMax, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &CMapTileSeed::slotUpdateTiles);
+
+  connect(pushStart, &QPushButton::clicked, this, &CMapTileSeed::slotStart);
+  connect(pushStop, &QPushButton::clicked, this, &CMapTileSeed::slotStop);
+  connect(pushClose, &QPushButton::clicked, this, &CMapTileSeed::reject);
+
+  labelStatus->clear();
+  setRunning(false);
+  slotUpdateTiles();
+}
+
+void CMapTileSeed::reject() {
+  seeder->cancel();
+  QDialog::reject();
+}
+
+void CMapTileSeed::getAreas(QList<QRectF>& areas) {
+  if (radioVisibleArea->isChecked()) {
+    areas << areaVisible;
+    return;
+  }
+
+  QRectF extent;
+  QList<QPolygonF> lines;
+  if (!CGisWorkspace::self().getProjectGeometry(comboProject->currentData().toString(), extent, lines)) {
+    return;
+  }
+
+  if (radioProject->isChecked()) {
+    if (extent.isValid()) {
+      areas << extent;
+    }
+  } else {
+    for (const QPolygonF& line : qAsConst(lines)) {
+      CTileSeeder::corridor(line, spinCorridor->value(), areas);
+    }
+  }
+}
+
+void CMapTileSeed::slotUpdateTiles() {
+  spinCorridor->setEnabled(radioCorridor->isChecked());
+  comboProject->setEnabled(!radioVisibleArea->isChecked());
+
+  urls.clear();
+
+  QList<QRectF> areas;
+  getAreas(areas);
+
+  const qint32 zoomMin = qMin(spinZoomMin->value(), spinZoomMax->value());
+  const qint32 zoomMax = qMax(spinZoomMin->value(), spinZoomMax->value());
+
+  // a quick estimate of the tiles needed before collecting them. The estimate
+  // is too high for overlapping areas, like the squares covering a corridor.
+  qreal estimate = 0;
+  for (const QRectF& area : qAsConst(areas)) {
+    const qreal w = area.width() / 360.0;
+    const qreal h = mercatorY(area.top()) - mercatorY(area.bottom());
+    for (qint32 zoom = zoomMin; zoom <= zoomMax; zoom++) {
+      estimate += (w * (1 << zoom) + 1) * (h * (1 << zoom) + 1);
+    }
+  }
+
+  bool tooMany = estimate > 4 * MAX_TILES;
+  if (!tooMany) {
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QSet<QString> set;
+    for (qint32 zoom = zoomMin; (zoom <= zoomMax) && !tooMany; zoom++) {
+      map->getTileUrls(areas, zoom, set);
+      tooMany = set.size() > MAX_TILES;
+    }
+    QApplication::restoreOverrideCursor();
+
+    if (!tooMany) {
+      urls = set.values();
+    }
+  }
+
+  if (tooMany) {
+    labelTiles->setText(tr("More than %1 tiles. Reduce the area or the zoom levels.").arg(MAX_TILES));
+  } else {
+    labelTiles->setText(tr("%1 tiles").arg(urls.size()));
+  }
+  pushStart->setEnabled(!urls.isEmpty());
+}
+
+void CMapTileSeed::setRunning(bool yes) {
+  groupArea->setEnabled(!yes);
+  groupDownload->setEnabled(!yes);
+  pushStart->setEnabled(!yes && !urls.isEmpty());
+  pushStop->setEnabled(yes);
+}
+
+void CMapTileSeed::slotStart() {
+  CTileLoader& loader = seeder->getLoader();
+  loader.setMaxRequests(spinRequests->value());
+  loader.setRateLimit(spinRate->value());
+
+  progressBar->setRange(0, urls.size());
+  progressBar->setValue(0);
+
+  setRunning(true);
+  seeder->start(urls);
+}
+
+void CMapTileSeed::slotStop() { seeder->cancel(); }
+
+void CMapTileSeed::slotProgress(const CTileSeeder::stats_t& stats) {
+  progressBar->setValue(stats.done());
+  labelStatus->setText(tr("%1 of %2 tiles: %3 in cache, %4 downloaded, %5 failed")
+                           .arg(stats.done())
+                           .arg(stats.total)
+                           .arg(stats.cached)
+                           .arg(stats.loaded)
+                           .arg(stats.failed));
+}
+
+void CMapTileSeed::slotFinished(const CTileSeeder::stats_t& stats) {
+  slotProgress(stats);
+  setRunning(false);
+  if (stats.done() < stats.total) {
+    labelStatus->setText(labelStatus->text() + "<br/>" +
+                         tr("Stopped. Start again to download the remaining tiles."));
+  }
+}
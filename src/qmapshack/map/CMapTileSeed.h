@@ -0,0 +1,61 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CMAPTILESEED_H
+#define CMAPTILESEED_H
+
+#include <QDialog>
+
+#include "map/cache/CTileSeeder.h"
+#include "ui_IMapTileSeed.h"
+
+class IMapOnline;
+
+/**
+   @brief Dialog to download the tiles of an online map for offline use
+ */
+class CMapTileSeed : public QDialog, private Ui::IMapTileSeed {
+  Q_OBJECT
+ public:
+  CMapTileSeed(IMapOnline* map, QWidget* parent);
+  virtual ~CMapTileSeed() = default;
+
+ public slots:
+  void reject() override;
+
+ private slots:
+  void slotUpdateTiles();
+  void slotStart();
+  void slotStop();
+  void slotProgress(const CTileSeeder::stats_t& stats);
+  void slotFinished(const CTileSeeder::stats_t& stats);
+
+ private:
+  void getAreas(QList<QRectF>& areas);
+  void setRunning(bool yes);
+
+  IMapOnline* map;
+  CTileSeeder* seeder;
+
+  /// the visible area of the map when the dialog was opened
+  QRectF areaVisible;
+  /// the urls of all tiles to download
+  QStringList urls;
+};
+
+#endif  // CMAPTILESEED_H
@@ -27,7 +27,7 @@
 #include "CMainWindow.h"
 #include "helpers/CDraw.h"
 #include "map/CMapDraw.h"
-#include "map/cache/CDiskCache.h"
+#include "map/cache/IDiskCache.h"
 #include "units/IUnit.h"
 
 CMapWMTS::CMapWMTS(const QString& filename, CMapDraw* parent) : IMapOnline(parent) {
@@ -337,12 +337,117 @@ void CMapWMTS::slotLayersChanged(QListWidgetItem* item) {
   map->emitSigCanvasUpdate();
 }
 
+void CMapWMTS::getTileUrls(const QList<QRectF>& areas, qint32 zoom, QSet<QString>& urls) /* override */
+{
+  QMutexLocker lock(&mutex);
+
+  for (const layer_t& layer : qAsConst(layers)) {
+    if (!layer.enabled) {
+      continue;
+    }
+
+    const tileset_t& tileset = tilesets[layer.tileMatrixSet];
+
+    // search matrix ID of tile level with the resolution best matching the zoom level
+    const qreal s1 = (tileset.proj.isSrcLatLong() ? 360.0 : 40075016.686) / (256.0 * (1 << zoom));
+    QString tileMatrixId;
+    qreal d = NOFLOAT;
+    const QStringList& keys = tileset.tilematrix.keys();
+    for (const QString& key : keys) {
+      qreal s2 = tileset.tilematrix[key].scale * 0.28e-3;
+
+      if (qAbs(qLn(s2 / s1)) < d) {
+        tileMatrixId = key;
+        d = qAbs(qLn(s2 / s1));
+      }
+    }
+    const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
+
+    for (const QRectF& area : areas) {
+      if (!layer.boundingBox.intersects(QRectF(area.bottomLeft(), area.topRight()))) {
+        continue;
+      }
+
+      // convert area to layer's coordinate system
+      QPointF pt1 = area.bottomLeft() * DEG_TO_RAD;
+      QPointF pt2 = area.topRight() * DEG_TO_RAD;
+
+      tileset.proj.transform(pt1, PJ_INV);
+      tileset.proj.transform(pt2, PJ_INV);
+
+      if (tileset.proj.isSrcLatLong()) {
+        pt1 *= RAD_TO_DEG;
+        pt2 *= RAD_TO_DEG;
+      }
+
+      qint32 col1, row1, col2, row2;
+      if (!getTileRange(layer, tilematrix, tileMatrixId, pt1, pt2, col1, row1, col2, row2)) {
+        break;
+      }
+
+      for (qint32 row = row1; row <= row2; row++) {
+        for (qint32 col = col1; col <= col2; col++) {
+          urls << createUrl(layer, tileMatrixId, col, row);
+        }
+      }
+    }
+  }
+}
+
+QString CMapWMTS::createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 col, qint32 row) const {
+  QString url = layer.resourceURL;
+  url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
+  url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
+  url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+  return url;
+}
+
+bool CMapWMTS::getTileRange(const layer_t& layer, const tilematrix_t& tilematrix, const QString& tileMatrixId,
+                            const QPointF& pt1, const QPointF& pt2, qint32& col1, qint32& row1, qint32& col2,
+                            qint32& row2) const {
+  const QMap<QString, limit_t>& limits = layer.limits;
+
+  // get min/max col/row values for that level
+  qint32 minRow, maxRow, minCol, maxCol;
+  if (!limits.isEmpty()) {
+    if (limits.contains(tileMatrixId)) {
+      const limit_t& limit = limits[tileMatrixId];
+      minCol = limit.minTileCol;
+      maxCol = limit.maxTileCol;
+      minRow = limit.minTileRow;
+      maxRow = limit.maxTileRow;
+    } else {
+      return false;
+    }
+  } else {
+    minCol = 0;
+    maxCol = tilematrix.matrixWidth;
+    minRow = 0;
+    maxRow = tilematrix.matrixHeight;
+  }
+
+  // derive range of col/row to request tiles
+  qreal xscale = tilematrix.scale * 0.28e-3;
+  qreal yscale = -tilematrix.scale * 0.28e-3;
+
+  col1 = qFloor((pt1.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
+  row1 = qFloor((pt1.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
+  col2 = qFloor((pt2.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
+  row2 = qFloor((pt2.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
+
+  col1 = qBound(minCol, col1, maxCol);
+  row1 = qBound(minRow, row1, maxRow);
+  col2 = qBound(minCol, col2, maxCol);
+  row2 = qBound(minRow, row2, maxRow);
+  return true;
+}
+
 void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 {
   QMutexLocker lock(&mutex);
 
   timeLastUpdate.start();
-  urlQueue.clear();
+  tileQueue.clear();
 
   if (map->needsRedraw()) {
     return;
@@ -351,6 +456,7 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
   QPointF bufferScale = buf.scale * buf.zoomFactor;
 
   if (isOutOfScale(bufferScale)) {
+    requestTiles();
     return;
   }
 
@@ -378,6 +484,8 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
     x2 = 180 * DEG_TO_RAD;
   }
 
+  areaLastDraw = QRectF(QPointF(x1, y2) * RAD_TO_DEG, QPointF(x2, y1) * RAD_TO_DEG);
+
   QRectF viewport(QPointF(x1, y1) * RAD_TO_DEG, QPointF(x2, y2) * RAD_TO_DEG);
 
   // draw layers
@@ -387,7 +495,6 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
     }
 
     const tileset_t& tileset = tilesets[layer.tileMatrixSet];
-    const QMap<QString, limit_t>& limits = layer.limits;
 
     // convert viewport to layer's coordinate system
     QPointF pt1(x1, y1);
@@ -416,69 +523,24 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
       }
     }
 
-    // get min/max col/row values for that level
-    qint32 minRow, maxRow, minCol, maxCol;
     const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
-    if (!limits.isEmpty()) {
-      if (limits.contains(tileMatrixId)) {
-        const limit_t& limit = limits[tileMatrixId];
-        minCol = limit.minTileCol;
-        maxCol = limit.maxTileCol;
-        minRow = limit.minTileRow;
-        maxRow = limit.maxTileRow;
-      } else {
-        // layer has limits but not for the selected tileMatrixId -> skip layer
-        continue;
-      }
-    } else {
-      minCol = 0;
-      maxCol = tilematrix.matrixWidth;
-      minRow = 0;
-      maxRow = tilematrix.matrixHeight;
+    qint32 col1, row1, col2, row2;
+    if (!getTileRange(layer, tilematrix, tileMatrixId, pt1, pt2, col1, row1, col2, row2)) {
+      // layer has limits but not for the selected tileMatrixId -> skip layer
+      continue;
     }
 
-    // derive range of col/row to request tiles
     qreal xscale = tilematrix.scale * 0.28e-3;
     qreal yscale = -tilematrix.scale * 0.28e-3;
 
-    qint32 col1 = qFloor((pt1.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
-    qint32 row1 = qFloor((pt1.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
-    qint32 col2 = qFloor((pt2.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
-    qint32 row2 = qFloor((pt2.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
-
-    if (col1 < minCol) {
-      col1 = minCol;
-    }
-    if (col1 > maxCol) {
-      col1 = maxCol;
-    }
-    if (row1 < minRow) {
-      row1 = minRow;
-    }
-    if (row1 > maxRow) {
-      row1 = maxRow;
-    }
-
-    if (col2 < minCol) {
-      col2 = minCol;
-    }
-    if (col2 > maxCol) {
-      col2 = maxCol;
-    }
-    if (row2 < minRow) {
-      row2 = minRow;
-    }
-    if (row2 > maxRow) {
-      row2 = maxRow;
-    }
+    // the viewport's center in tiles, to request the central tiles first
+    const qreal colCenter = ((pt1.x() + pt2.x()) / 2 - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth);
+    const qreal rowCenter = ((pt1.y() + pt2.y()) / 2 - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight);
 
     // start to request tiles. draw tiles in cache, queue urls of tile yet to be requested
     for (qint32 row = row1; row <= row2; row++) {
       for (qint32 col = col1; col <= col2; col++) {
-        QString url = layer.resourceURL;
-        url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
-        url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
-        url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+        const QString& url = createUrl(layer, tileMatrixId, col, row);
 
         if (diskCache->contains(url)) {
           QImage img;
@@ -497,11 +559,11 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 
           drawTile(img, l, p);
         } else {
-          urlQueue << url;
+          queueTile(url, std::hypot(col + 0.5 - colCenter, row + 0.5 - rowCenter));
         }
       }
     }
-
-    emit sigQueueChanged();
   }
+
+  requestTiles();
 }
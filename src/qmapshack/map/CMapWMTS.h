@@ -23,7 +23,7 @@
 #include "map/IMapOnline.h"
 
 class CMapDraw;
-class CDiskCache;
+class IDiskCache;
 class QNetworkAccessManager;
 class QNetworkReply;
 class QListWidgetItem;
@@ -41,6 +41,8 @@ class CMapWMTS : public IMapOnline {
   void saveConfig(QSettings& cfg) override;
   void loadConfig(QSettings& cfg) override;
 
+  void getTileUrls(const QList<QRectF>& areas, qint32 zoom, QSet<QString>& urls) override;
+
  private slots:
   void slotLayersChanged(QListWidgetItem* item);
 
@@ -79,6 +81,18 @@ class CMapWMTS : public IMapOnline {
   };
 
   QMap<QString, tileset_t> tilesets;
+
+  QString createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 col, qint32 row) const;
+  /**
+     @brief Get the range of tiles covering an area
+
+     @param pt1   the top left corner in the tile set's coordinate system
+     @param pt2   the bottom right corner in the tile set's coordinate system
+     @return False if the layer has limits but not for the tile matrix.
+   */
+  bool getTileRange(const layer_t& layer, const tilematrix_t& tilematrix, const QString& tileMatrixId,
+                    const QPointF& pt1, const QPointF& pt2, qint32& col1, qint32& row1, qint32& col2,
+                    qint32& row2) const;
 };
 
 #endif  // CMAPWMTS_H
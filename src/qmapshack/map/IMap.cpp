@@ -46,6 +46,10 @@ void IMap::saveConfig(QSettings& cfg) /* override */
   if (hasFeatureTypFile()) {
     cfg.setValue("typeFile", typeFile);
   }
+
+  if (hasFeatureDecodeCache()) {
+    cfg.setValue("decodeCacheSizeMB", decodeCacheSizeMB);
+  }
 }
 
 void IMap::loadConfig(QSettings& cfg) /* override */
@@ -59,6 +63,7 @@ void IMap::loadConfig(QSettings& cfg) /* override */
   slotSetCacheSize(cfg.value("cacheSizeMB", getCacheSize()).toInt());
   slotSetCacheExpiration(cfg.value("cacheExpiration", getCacheExpiration()).toInt());
   slotSetTypeFile(cfg.value("typeFile", getTypeFile()).toString());
+  slotSetDecodeCacheSize(cfg.value("decodeCacheSizeMB", getDecodeCacheSize()).toInt());
 }
 
 IMapProp* IMap::getSetup() {
@@ -46,7 +46,8 @@ class IMap : public IDrawObject {
     eFeatVectorItems = 0x00000002,
     eFeatTileCache = 0x00000004,
     eFeatLayers = 0x00000008,
-    eFeatTypFile = 0x00000010
+    eFeatTypFile = 0x00000010,
+    eFeatDecodeCache = 0x00000020
   };
 
   virtual void draw(IDrawContext::buffer_t& buf) = 0;
@@ -86,6 +87,8 @@ class IMap : public IDrawObject {
 
   bool hasFeatureTypFile() const { return flagsFeature & eFeatTypFile; }
 
+  bool hasFeatureDecodeCache() const { return flagsFeature & eFeatDecodeCache; }
+
   bool getShowPolygons() const { return showPolygons; }
 
   bool getShowPolylines() const { return showPolylines; }
@@ -100,6 +103,24 @@ class IMap : public IDrawObject {
 
   qint32 getAdjustDetailLevel() const { return adjustDetailLevel; }
 
+  qint32 getDecodeCacheSize() const { return decodeCacheSizeMB; }
+
+  /**
+     @brief Get usage statistics of the cache for decoded map data
+
+     The default implementation reports an empty cache. Maps with eFeatDecodeCache
+     override it to report their cache's state.
+
+     @param hits      number of lookups served by the cache
+     @param misses    number of lookups that needed decoding
+     @param usedKB    memory currently occupied by the cache [kByte]
+   */
+  virtual void getDecodeCacheStatistics(quint64& hits, quint64& misses, qint32& usedKB) const {
+    hits = 0;
+    misses = 0;
+    usedKB = 0;
+  }
+
   const QString& getTypeFile() const { return typeFile; }
 
   /**
@@ -136,6 +157,11 @@ class IMap : public IDrawObject {
 
   void slotSetAdjustDetailLevel(qint32 level) { adjustDetailLevel = level; }
 
+  void slotSetDecodeCacheSize(qint32 size) {
+    decodeCacheSizeMB = size;
+    configureDecodeCache();
+  }
+
   virtual void slotSetTypeFile(const QString& filename) { typeFile = filename; }
 
  protected:
@@ -158,6 +184,14 @@ class IMap : public IDrawObject {
    */
   void drawTile(const QImage& img, QPolygonF& l, QPainter& p);
 
+  /**
+     @brief Setup the cache for decoded map data using decodeCacheSizeMB
+
+     The default implementation does nothing. Maps with eFeatDecodeCache
+     override it to apply the new memory budget.
+   */
+  virtual void configureDecodeCache() {}
+
  protected:
   /// the drawcontext this map belongs to
   CMapDraw* map;
@@ -179,10 +213,11 @@ class IMap : public IDrawObject {
   /// flag field for features defined in features_e
   quint32 flagsFeature;
 
-  bool showPolygons = true;      //< vector maps only: hide/show polygons
-  bool showPolylines = true;     //< vector maps only: hide/show polylines
-  bool showPOIs = true;          //< vector maps only: hide/show point of interest
-  qint32 adjustDetailLevel = 0;  //< vector maps only: alter threshold to show details.
+  bool showPolygons = true;       //< vector maps only: hide/show polygons
+  bool showPolylines = true;      //< vector maps only: hide/show polylines
+  bool showPOIs = true;           //< vector maps only: hide/show point of interest
+  qint32 adjustDetailLevel = 0;   //< vector maps only: alter threshold to show details.
+  qint32 decodeCacheSizeMB = 64;  //< maps with eFeatDecodeCache only: memory budget for decoded map data [MByte]
 
   QString cachePath;           //< streaming map only: path to cached tiles
   qint32 cacheSizeMB = 100;    //< streaming map only: maximum size of all tiles in cache [MByte]
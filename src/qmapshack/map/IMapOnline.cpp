@@ -25,12 +25,14 @@
 #include "CMainWindow.h"
 #include "map/CMapDraw.h"
 #include "map/cache/CDiskCache.h"
+#include "map/cache/CDiskCachePack.h"
+#include "map/cache/CTileSeeder.h"
 
 IMapOnline::IMapOnline(CMapDraw* parent) : IMap(eFeatVisibility | eFeatTileCache, parent) {
-  accessManager = new QNetworkAccessManager(parent->thread());
-  connect(accessManager, &QNetworkAccessManager::finished, this, &IMapOnline::slotRequestFinished);
-
-  connect(this, &IMapOnline::sigQueueChanged, this, &IMapOnline::slotQueueChanged);
+  tileLoader = new CTileLoader(this);
+  connect(tileLoader, &CTileLoader::sigQueueChanged, this, &IMapOnline::slotQueueChanged);
+  // if all tiles are received the map layer can be redrawn with all tiles from cache
+  connect(tileLoader, &CTileLoader::sigFinished, map, &CMapDraw::emitSigCanvasUpdate);
 }
 
 bool IMapOnline::httpsCheck(const QString& url) {
@@ -47,46 +49,13 @@ bool IMapOnline::httpsCheck(const QString& url) {
 }
 
 void IMapOnline::slotQueueChanged() {
-  QMutexLocker lock(&mutex);
-
-  if (!urlQueue.isEmpty() && urlPending.size() < 6) {
-    // request up to 6 pending request
-    for (int i = 0; i < (6 - urlPending.size()); i++) {
-      QString url = urlQueue.dequeue();
-      // remove all remaining duplicates from queue
-      urlQueue.removeAll(url);
-      lastRequest = urlQueue.isEmpty();
-
-      if (!urlPending.contains(url)) {
-        QNetworkRequest request;
-        request.setUrl(url);
-        for (const rawHeaderItem_t& item : qAsConst(rawHeaderItems)) {
-          request.setRawHeader(item.name.toLatin1(), item.value.toLatin1());
-        }
-	// allow http(s) redirects
-	request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,QNetworkRequest::NoLessSafeRedirectPolicy);
-
-        accessManager->get(request);
-        urlPending << url;
-      }
-
-      if (lastRequest) {
-        break;
-      }
-    }
-  } else if (lastRequest && urlPending.isEmpty()) {
-    lastRequest = false;
-    // if all tiles are received the map layer can be redrawn with all tiles from cache
-    map->emitSigCanvasUpdate();
-  }
-
   if (timeLastUpdate.elapsed() > 2000) {
     timeLastUpdate.start();
     map->emitSigCanvasUpdate();
   }
 
   // report status of pending tiles
-  int pending = urlQueue.size() + urlPending.size();
+  int pending = tileLoader->getPending();
   if (pending) {
     map->reportStatusToCanvas(name, tr("<b>%1</b>: %2 tiles pending<br/>").arg(name).arg(pending));
   } else {
@@ -94,39 +63,28 @@ void IMapOnline::slotQueueChanged() {
   }
 }
 
-void IMapOnline::slotRequestFinished(QNetworkReply* reply) {
+CTileSeeder* IMapOnline::createSeeder(QObject* parent) {
   QMutexLocker lock(&mutex);
 
-  // use originally requested url due to possible redirects
-  QString url = reply->request().url().toString();
-  if (urlPending.contains(url)) {
-    QImage img;
-    // only take good responses
-    if (!reply->error()) {
-      // read image data
-      img.loadFromData(reply->readAll());
-    }
-    // always store image to cache, the cache will take care of NULL images
-    diskCache->store(url, img);
-
-    urlPending.removeAll(url);
-  }
-
-  // debug output any error
-  if (reply->error()) {
-    qDebug() << "Request to" << url << "failed:" << reply->errorString();
-  }
-
-  // delete reply object
-  reply->deleteLater();
+  CTileSeeder* seeder = new CTileSeeder(diskCache, parent);
+  seeder->getLoader().registerHeaderItems(*tileLoader);
+  return seeder;
+}
 
-  // check for more items to be queued
-  slotQueueChanged();
+QRectF IMapOnline::getAreaLastDraw() {
+  QMutexLocker lock(&mutex);
+  return areaLastDraw;
 }
 
 void IMapOnline::configureCache() {
   QMutexLocker lock(&mutex);
 
+  tileLoader->setCache(nullptr);
   delete diskCache;
-  diskCache = new CDiskCache(getCachePath(), getCacheSize(), getCacheExpiration(), this);
+  if (CMapDraw::getCachePacked()) {
+    diskCache = new CDiskCachePack(getCachePath(), getCacheSize(), getCacheExpiration(), this);
+  } else {
+    diskCache = new CDiskCache(getCachePath(), getCacheSize(), getCacheExpiration(), this);
+  }
+  tileLoader->setCache(diskCache);
 }
@@ -21,13 +21,12 @@
 #define IMAPONLINE_H
 #include <QElapsedTimer>
 #include <QMutex>
-#include <QQueue>
 
 #include "map/IMap.h"
+#include "map/cache/CTileLoader.h"
 
-class CDiskCache;
-class QNetworkAccessManager;
-class QNetworkReply;
+class CTileSeeder;
+class IDiskCache;
 
 class IMapOnline : public IMap {
   Q_OBJECT
@@ -35,44 +34,58 @@ class IMapOnline : public IMap {
   IMapOnline(CMapDraw* parent);
   virtual ~IMapOnline() {}
 
- signals:
-  void sigQueueChanged();
+  /**
+     @brief Get the urls of all tiles of the enabled layers covering the areas
 
- protected:
-  struct rawHeaderItem_t {
-    QString name;
-    QString value;
-  };
+     @param areas   the areas as normalized rectangles in [°], x is the longitude, y the latitude
+     @param zoom    the zoom level as used by TMS (OSM), 0 for a single tile covering the world
+     @param urls    the urls are added to this set
+   */
+  virtual void getTileUrls(const QList<QRectF>& areas, qint32 zoom, QSet<QString>& urls) = 0;
+
+  /// @return a seeder storing the tiles to the map's cache
+  CTileSeeder* createSeeder(QObject* parent);
 
-  QList<rawHeaderItem_t> rawHeaderItems;
+  /// @return the area of the last draw as normalized rectangle in [°]
+  QRectF getAreaLastDraw();
 
-  /// Mutex to control access to url queue
+ protected:
+  /// Mutex to control access to tile queue
   QRecursiveMutex mutex;
-  /// a queue with all tile urls to request
-  QQueue<QString> urlQueue;
+  /// the tiles missing in the cache, collected while drawing
+  QVector<CTileLoader::tile_t> tileQueue;
   /// the tile cache
-  CDiskCache* diskCache = nullptr;
-  /// access manager to request tiles
-  QNetworkAccessManager* accessManager = nullptr;
-  QList<QString> urlPending;
+  IDiskCache* diskCache = nullptr;
+  /// request the tiles and store them to the cache
+  CTileLoader* tileLoader = nullptr;
 
-  bool lastRequest = false;
   QElapsedTimer timeLastUpdate;
   QString name;
+  QRectF areaLastDraw;
 
   static bool httpsCheck(const QString& url);
 
-  void registerHeaderItem(const QString& name, const QString& value) {
-    struct rawHeaderItem_t item;
-    item.name = name;
-    item.value = value;
-    rawHeaderItems << item;
+  void registerHeaderItem(const QString& name, const QString& value) { tileLoader->registerHeaderItem(name, value); }
+
+  /**
+     @brief Add a tile missing in the cache to the queue
+
+     @param url       the tile's url
+     @param distance  the distance of the tile to the viewport's center [tiles]
+   */
+  void queueTile(const QString& url, qreal distance) {
+    CTileLoader::tile_t tile;
+    tile.url = url;
+    tile.distance = distance;
+    tileQueue << tile;
   }
 
+  /// pass all tiles queued while drawing to the loader
+  void requestTiles() { tileLoader->setTiles(tileQueue); }
+
   void configureCache() override;
 
   void slotQueueChanged();
-  void slotRequestFinished(QNetworkReply* reply);
 };
 
 #endif  // IMAPONLINE_H
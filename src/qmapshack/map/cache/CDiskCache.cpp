@@ -24,7 +24,7 @@
 #include "version.h"
 
 CDiskCache::CDiskCache(const QString& path, qint32 maxSizeMB, qint32 expirationDays, QObject* parent)
-    : QObject(parent), dir(path), maxSizeMB(maxSizeMB), expirationDays(expirationDays) {
+    : IDiskCache(parent), dir(path), maxSizeMB(maxSizeMB), expirationDays(expirationDays) {
   dummy.fill(Qt::transparent);
 
   dir.mkpath(dir.path());
@@ -48,7 +48,7 @@ CDiskCache::CDiskCache(const QString& path, qint32 maxSizeMB, qint32 expirationD
   connect(timer, &QTimer::timeout, this, &CDiskCache::slotCleanup);
 }
 
-void CDiskCache::store(const QString& key, QImage& img) {
+void CDiskCache::store(const QString& key, const QByteArray& /*data*/, QImage& img) {
   QMutexLocker lock(&mutex);
 
   QCryptographicHash md5(QCryptographicHash::Md5);
@@ -96,6 +96,16 @@ bool CDiskCache::contains(const QString& key) const {
   return table.contains(hash) || cache.contains(hash);
 }
 
+bool CDiskCache::hasTile(const QString& key) const {
+  QMutexLocker lock(&mutex);
+
+  QCryptographicHash md5(QCryptographicHash::Md5);
+  md5.addData(key.toLatin1());
+
+  // failed requests are kept in memory only
+  return table.contains(md5.result().toHex());
+}
+
 void CDiskCache::removeCacheFile(const QFileInfo& fileinfo) {
   QString hash = fileinfo.baseName();
   table.remove(hash);
@@ -24,17 +24,23 @@
 #include <QImage>
 #include <QMutex>
 
+#include "map/cache/IDiskCache.h"
+
 class QTimer;
 
-class CDiskCache : public QObject {
+/**
+   @brief Tile cache storing each tile as PNG file
+ */
+class CDiskCache : public IDiskCache {
   Q_OBJECT
  public:
   CDiskCache(const QString& path, qint32 size, qint32 days, QObject* parent);
   virtual ~CDiskCache() = default;
 
-  void store(const QString& key, QImage& img);
-  void restore(const QString& key, QImage& img);
-  bool contains(const QString& key) const;
+  void store(const QString& key, const QByteArray& data, QImage& img) override;
+  void restore(const QString& key, QImage& img) override;
+  bool contains(const QString& key) const override;
+  bool hasTile(const QString& key) const override;
 
   static void cleanupRemovedMaps(const QSet<QString>& maps);
 
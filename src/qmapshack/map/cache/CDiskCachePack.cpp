@@ -0,0 +1,526 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCachePack.h"
+
+#include <QtWidgets>
+#include <algorithm>
+
+#include "version.h"
+
+// the first bytes of the log and the pack file, followed by the generation
+#define INDEX_MAGIC "QMSPACK2"
+// the size of the magic and the generation
+#define HEADER_SIZE (8 + 8)
+// the maximum memory used by decoded tiles [KB]
+#define MEMORY_CACHE_SIZE (32 * 1024)
+// the number of PNG files moved into the pack file per cleanup
+#define MIGRATION_BATCH 500
+// the minimum time between two usage records of a tile [s]
+#define TOUCH_INTERVAL 3600
+
+CDiskCachePack::CDiskCachePack(const QString& path, qint32 maxSizeMB, qint32 expirationDays, QObject* parent)
+    : IDiskCache(parent), dir(path), maxSizeMB(maxSizeMB), expirationDays(expirationDays) {
+  dummy.fill(Qt::transparent);
+  cache.setMaxCost(MEMORY_CACHE_SIZE);
+  threadPool.setMaxThreadCount(1);
+
+  dir.mkpath(dir.path());
+
+  QFile IDfile(dir.absoluteFilePath("QMS_cache"));
+  if (!IDfile.exists()) {
+    if (IDfile.open(QIODevice::ReadWrite)) {
+      QTextStream(&IDfile) << "QMapShack " << VER_STR;
+    }
+  }
+
+  if (!open()) {
+    qWarning() << "Failed to open tile pack in" << dir.path() << "Tiles are cached in memory only.";
+  }
+
+  // tiles of the PNG file cache are moved into the pack file step by step
+  const QStringList& files = dir.entryList(QStringList("*.png"), QDir::Files);
+  for (const QString& file : files) {
+    pendingPng << QFileInfo(file).completeBaseName();
+  }
+
+  timer = new QTimer(this);
+  timer->setSingleShot(false);
+  timer->start(20000);
+  connect(timer, &QTimer::timeout, this, &CDiskCachePack::slotCleanup);
+}
+
+CDiskCachePack::~CDiskCachePack() {
+  threadPool.waitForDone();
+
+  QMutexLocker lock(&mutex);
+  pack.close();
+  index.close();
+}
+
+QByteArray CDiskCachePack::hash(const QString& key) {
+  // the same hash as used by CDiskCache to be able to migrate its files
+  return QCryptographicHash::hash(key.toLatin1(), QCryptographicHash::Md5);
+}
+
+QByteArray CDiskCachePack::createHeader() {
+  QByteArray header(INDEX_MAGIC);
+  QDataStream stream(&header, QIODevice::Append);
+  stream << quint64(QRandomGenerator::global()->generate64());
+  return header;
+}
+
+bool CDiskCachePack::open() {
+  pack.setFileName(dir.absoluteFilePath("tiles.pack"));
+  index.setFileName(dir.absoluteFilePath("tiles.idx"));
+
+  if (!pack.open(QIODevice::ReadWrite)) {
+    return false;
+  }
+
+  readIndex();
+
+  if (!index.open(QIODevice::WriteOnly | QIODevice::Append)) {
+    pack.close();
+    return false;
+  }
+
+  if (index.size() == 0) {
+    // readIndex() has emptied the pack file, too
+    const QByteArray& header = createHeader();
+    pack.seek(0);
+    pack.write(header);
+    pack.flush();
+    index.write(header);
+    index.flush();
+  }
+  return true;
+}
+
+void CDiskCachePack::readIndex() {
+  entries.clear();
+  sizeLive = 0;
+  cntRecords = 0;
+
+  qint64 sizeValid = 0;
+  if (index.open(QIODevice::ReadOnly)) {
+    const QByteArray& header = index.read(HEADER_SIZE);
+    pack.seek(0);
+
+    // the log is only valid for the pack file of the same generation
+    if ((header.size() == HEADER_SIZE) && header.startsWith(INDEX_MAGIC) && (pack.read(HEADER_SIZE) == header)) {
+      sizeValid = index.pos();
+
+      QDataStream stream(&index);
+      while (!stream.atEnd()) {
+        quint8 type;
+        QByteArray hash(16, 0);
+
+        stream >> type;
+        if (stream.readRawData(hash.data(), hash.size()) != hash.size()) {
+          stream.setStatus(QDataStream::ReadPastEnd);
+        }
+
+        entry_t entry;
+        switch (type) {
+          case eRecordStore:
+            stream >> entry.offset >> entry.size >> entry.created;
+            entry.used = entry.usedLogged = entry.created;
+            if (stream.status() == QDataStream::Ok) {
+              entries[hash] = entry;
+            }
+            break;
+
+          case eRecordTouch:
+            stream >> entry.used;
+            if ((stream.status() == QDataStream::Ok) && entries.contains(hash)) {
+              entries[hash].used = entries[hash].usedLogged = entry.used;
+            }
+            break;
+
+          case eRecordRemove:
+            if (stream.status() == QDataStream::Ok) {
+              entries.remove(hash);
+            }
+            break;
+
+          default:
+            stream.setStatus(QDataStream::ReadCorruptData);
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+          // most likely the last record was not written completely
+          qWarning() << "Tile pack index" << index.fileName() << "is corrupt at" << sizeValid;
+          break;
+        }
+
+        sizeValid = index.pos();
+        cntRecords++;
+      }
+    }
+    index.close();
+  }
+
+  // drop the broken tail of the log and all tiles not written completely to the pack
+  if (sizeValid == 0) {
+    entries.clear();
+    cntRecords = 0;
+    pack.resize(0);
+  }
+  index.resize(sizeValid);
+
+  const qint64 sizePack = pack.size();
+  for (auto entry = entries.begin(); entry != entries.end();) {
+    if ((entry->offset + entry->size) > sizePack) {
+      entry = entries.erase(entry);
+    } else {
+      sizeLive += entry->size;
+      ++entry;
+    }
+  }
+  sizeDead = qMax(qint64(0), sizePack - HEADER_SIZE - sizeLive);
+}
+
+void CDiskCachePack::writeRecord(record_e type, const QByteArray& hash, const entry_t& entry) {
+  if (!index.isOpen()) {
+    return;
+  }
+
+  QByteArray record;
+  QDataStream stream(&record, QIODevice::WriteOnly);
+  stream << quint8(type);
+  stream.writeRawData(hash.constData(), hash.size());
+
+  switch (type) {
+    case eRecordStore:
+      stream << entry.offset << entry.size << entry.created;
+      break;
+
+    case eRecordTouch:
+      stream << entry.used;
+      break;
+
+    case eRecordRemove:
+      break;
+  }
+
+  index.write(record);
+  index.flush();
+  cntRecords++;
+}
+
+bool CDiskCachePack::append(const QByteArray& hash, const QByteArray& data, qint64 created) {
+  if (!pack.isOpen()) {
+    return false;
+  }
+
+  entry_t entry;
+  entry.offset = pack.size();
+  entry.size = data.size();
+  entry.created = entry.used = entry.usedLogged = created;
+
+  if (!pack.seek(entry.offset) || (pack.write(data) != data.size()) || !pack.flush()) {
+    return false;
+  }
+
+  // a tile stored again replaces the old one
+  if (entries.contains(hash)) {
+    const qint32 size = entries[hash].size;
+    sizeLive -= size;
+    sizeDead += size;
+  }
+
+  entries[hash] = entry;
+  sizeLive += entry.size;
+  writeRecord(eRecordStore, hash, entry);
+  return true;
+}
+
+void CDiskCachePack::remove(const QByteArray& hash) {
+  const entry_t& entry = entries.take(hash);
+  sizeLive -= entry.size;
+  sizeDead += entry.size;
+  cache.remove(hash);
+  writeRecord(eRecordRemove, hash, entry);
+}
+
+void CDiskCachePack::migrate(const QString& hex) {
+  pendingPng.remove(hex);
+
+  QFile file(dir.absoluteFilePath(hex + ".png"));
+  if (file.open(QIODevice::ReadOnly)) {
+    const QByteArray& data = file.readAll();
+    const qint64 created = QFileInfo(file).lastModified().toSecsSinceEpoch();
+    file.close();
+
+    if (!append(QByteArray::fromHex(hex.toLatin1()), data, created)) {
+      // keep the file if the pack is not usable
+      return;
+    }
+  }
+  file.remove();
+}
+
+void CDiskCachePack::store(const QString& key, const QByteArray& data, QImage& img) {
+  QMutexLocker lock(&mutex);
+
+  const QByteArray& h = hash(key);
+  if (img.isNull() || data.isEmpty()) {
+    failed << h;
+    return;
+  }
+
+  failed.remove(h);
+  append(h, data, QDateTime::currentSecsSinceEpoch());
+  cache.insert(h, new QImage(img), qMax(1, int(img.sizeInBytes() / 1024)));
+}
+
+void CDiskCachePack::restore(const QString& key, QImage& img) {
+  QMutexLocker lock(&mutex);
+
+  const QByteArray& h = hash(key);
+  if (failed.contains(h)) {
+    img = dummy;
+    return;
+  }
+
+  if (!entries.contains(h)) {
+    const QString& hex = h.toHex();
+    if (pendingPng.contains(hex)) {
+      migrate(hex);
+    }
+  }
+
+  auto entry = entries.find(h);
+  if (entry != entries.end()) {
+    // keep track of the usage for the least recently used eviction
+    entry->used = QDateTime::currentSecsSinceEpoch();
+    if ((entry->used - entry->usedLogged) > TOUCH_INTERVAL) {
+      entry->usedLogged = entry->used;
+      writeRecord(eRecordTouch, h, *entry);
+    }
+  }
+
+  const QImage* cached = cache.object(h);
+  if (cached != nullptr) {
+    img = *cached;
+    return;
+  }
+
+  if ((entry != entries.end()) && pack.seek(entry->offset)) {
+    img.loadFromData(pack.read(entry->size));
+  } else {
+    img = QImage();
+  }
+
+  if (!img.isNull()) {
+    cache.insert(h, new QImage(img), qMax(1, int(img.sizeInBytes() / 1024)));
+  }
+}
+
+bool CDiskCachePack::contains(const QString& key) const {
+  QMutexLocker lock(&mutex);
+
+  const QByteArray& h = hash(key);
+  return entries.contains(h) || cache.contains(h) || failed.contains(h) || pendingPng.contains(h.toHex());
+}
+
+bool CDiskCachePack::hasTile(const QString& key) const {
+  QMutexLocker lock(&mutex);
+
+  const QByteArray& h = hash(key);
+  return entries.contains(h) || cache.contains(h) || pendingPng.contains(h.toHex());
+}
+
+qint64 CDiskCachePack::getSize() const {
+  QMutexLocker lock(&mutex);
+  return sizeLive;
+}
+
+qint32 CDiskCachePack::getCount() const {
+  QMutexLocker lock(&mutex);
+  return entries.size();
+}
+
+void CDiskCachePack::waitForCleanup() { threadPool.waitForDone(); }
+
+void CDiskCachePack::slotCleanup() {
+  // the timer fires in the GUI thread, the cleanup may take a while
+  if (threadPool.activeThreadCount() == 0) {
+    threadPool.start([this]() { cleanup(); });
+  }
+}
+
+void CDiskCachePack::cleanup() {
+  // move a few PNG files into the pack file, release the lock after each one
+  QStringList pending;
+  {
+    QMutexLocker lock(&mutex);
+    pending = pendingPng.values().mid(0, MIGRATION_BATCH);
+  }
+  for (const QString& hex : qAsConst(pending)) {
+    QMutexLocker lock(&mutex);
+    if (pendingPng.contains(hex)) {
+      migrate(hex);
+    }
+  }
+
+  QMutexLocker lock(&mutex);
+
+  // expire old tiles
+  const qint64 expired = QDateTime::currentSecsSinceEpoch() - qint64(expirationDays) * 24 * 3600;
+  QList<QByteArray> hashes;
+  for (auto entry = entries.constBegin(); entry != entries.constEnd(); ++entry) {
+    if (entry->created < expired) {
+      hashes << entry.key();
+    }
+  }
+  for (const QByteArray& h : qAsConst(hashes)) {
+    remove(h);
+  }
+
+  // if the cache is still too large remove the least recently used tiles
+  const qint64 maxSizeBytes = qint64(maxSizeMB) * 1024 * 1024;
+  if (sizeLive > maxSizeBytes) {
+    hashes = entries.keys();
+    std::sort(hashes.begin(), hashes.end(), [this](const QByteArray& h1, const QByteArray& h2) {
+      return entries[h1].used < entries[h2].used;
+    });
+
+    for (const QByteArray& h : qAsConst(hashes)) {
+      if (sizeLive <= maxSizeBytes) {
+        break;
+      }
+      remove(h);
+    }
+  }
+
+  // get rid of the holes in the pack file and obsolete records in the log
+  if (((sizeDead > sizeLive) && (sizeDead > 4 * 1024 * 1024)) || (cntRecords > (2 * entries.size() + 10000))) {
+    lock.unlock();
+    compact();
+  }
+}
+
+void CDiskCachePack::compact() {
+  QHash<QByteArray, entry_t> snapshot;
+  {
+    QMutexLocker lock(&mutex);
+    if (!pack.isOpen() || !index.isOpen()) {
+      return;
+    }
+    snapshot = entries;
+  }
+
+  QFile packOld(pack.fileName());
+  QFile packNew(dir.absoluteFilePath("tiles.pack.tmp"));
+  QFile indexNew(dir.absoluteFilePath("tiles.idx.tmp"));
+  if (!packOld.open(QIODevice::ReadOnly) || !packNew.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+      !indexNew.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return;
+  }
+
+  const QByteArray& header = createHeader();
+  packNew.write(header);
+
+  // tiles are only appended to the pack file. Thus the tiles known so far can be copied unlocked
+  QHash<QByteArray, qint64> offsets;
+  for (auto entry = snapshot.constBegin(); entry != snapshot.constEnd(); ++entry) {
+    if (!packOld.seek(entry->offset)) {
+      continue;
+    }
+
+    const QByteArray& data = packOld.read(entry->size);
+    if (data.size() != entry->size) {
+      continue;
+    }
+
+    offsets[entry.key()] = packNew.pos();
+    packNew.write(data);
+  }
+  packOld.close();
+
+  QMutexLocker lock(&mutex);
+  if (!pack.isOpen() || !index.isOpen()) {
+    packNew.remove();
+    indexNew.remove();
+    return;
+  }
+
+  QByteArray records(header);
+  QDataStream stream(&records, QIODevice::Append);
+
+  for (auto entry = entries.constBegin(); entry != entries.constEnd(); ++entry) {
+    entry_t entryNew = *entry;
+
+    auto copied = snapshot.constFind(entry.key());
+    if ((copied != snapshot.constEnd()) && (copied->offset == entry->offset) && offsets.contains(entry.key())) {
+      entryNew.offset = offsets[entry.key()];
+    } else {
+      // the tile has been stored while copying the others
+      if (!pack.seek(entry->offset)) {
+        continue;
+      }
+
+      const QByteArray& data = pack.read(entry->size);
+      if (data.size() != entry->size) {
+        continue;
+      }
+
+      entryNew.offset = packNew.pos();
+      packNew.write(data);
+    }
+
+    stream << quint8(eRecordStore);
+    stream.writeRawData(entry.key().constData(), entry.key().size());
+    stream << entryNew.offset << entryNew.size << entryNew.created;
+    if (entryNew.used != entryNew.created) {
+      stream << quint8(eRecordTouch);
+      stream.writeRawData(entry.key().constData(), entry.key().size());
+      stream << entryNew.used;
+    }
+  }
+
+  indexNew.write(records);
+
+  if (!packNew.flush() || !indexNew.flush()) {
+    packNew.remove();
+    indexNew.remove();
+    return;
+  }
+  packNew.close();
+  indexNew.close();
+
+  pack.close();
+  index.close();
+
+  /*
+      The new files carry a new generation. If anything fails between the renames,
+      the log and the pack file of different generations are dropped at the next start.
+   */
+  QFile::remove(index.fileName());
+  indexNew.rename(index.fileName());
+  QFile::remove(pack.fileName());
+  packNew.rename(pack.fileName());
+
+  entries.clear();
+  cache.clear();
+  if (!open()) {
+    qWarning() << "Failed to reopen tile pack in" << dir.path();
+  }
+}
@@ -0,0 +1,152 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDISKCACHEPACK_H
+#define CDISKCACHEPACK_H
+
+#include <QCache>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+
+#include "map/cache/IDiskCache.h"
+
+class QTimer;
+
+/**
+   @brief Tile cache storing all tiles of a map in a single pack file
+
+   The tiles are stored as sent by the server, without decoding and encoding
+   them again. New tiles are appended to the pack file "tiles.pack". Each change
+   is appended as record to the log "tiles.idx":
+
+   - eRecordStore: a tile was appended to the pack file
+   - eRecordTouch: a tile was used (written at most once per hour per tile)
+   - eRecordRemove: a tile expired or was evicted
+
+   At startup the log is replayed into an in-memory index. That index holds the
+   position, size, age and last usage of each tile. Thus the size of the cache
+   is known at any time and the least recently used tiles are evicted without
+   touching the file system. Evicted tiles leave holes in the pack file. They
+   are removed by compacting the pack file if they waste more space than the
+   remaining tiles use.
+
+   The log and the pack file start with the same header holding a random
+   generation. Compacting creates a new generation. If a log and a pack file of
+   different generations are found at startup, both are dropped.
+
+   Tiles of the PNG based CDiskCache found in the cache directory are moved into
+   the pack file, a few at a time, or immediately if they are requested.
+
+   Moving PNG files, expiring tiles and compacting is done by a worker thread.
+ */
+class CDiskCachePack : public IDiskCache {
+  Q_OBJECT
+ public:
+  CDiskCachePack(const QString& path, qint32 size, qint32 days, QObject* parent);
+  virtual ~CDiskCachePack();
+
+  void store(const QString& key, const QByteArray& data, QImage& img) override;
+  void restore(const QString& key, QImage& img) override;
+  bool contains(const QString& key) const override;
+  bool hasTile(const QString& key) const override;
+
+  /// @return the sum of the size of all tiles in the pack [bytes]
+  qint64 getSize() const;
+  /// @return the number of tiles in the pack
+  qint32 getCount() const;
+
+  /**
+     @brief Remove the holes in the pack file and the obsolete records in the log
+
+     Called by the cleanup if the holes waste more space than the tiles use. The
+     tiles are copied without locking the cache. Only tiles stored meanwhile and
+     the switch to the new files are done with the cache locked.
+   */
+  void compact();
+
+  /// wait for a cleanup started by slotCleanup() to finish
+  void waitForCleanup();
+
+ public slots:
+  /// start a cleanup in a worker thread if none is running
+  void slotCleanup();
+
+ private:
+  enum record_e : quint8 { eRecordStore = 1, eRecordTouch = 2, eRecordRemove = 3 };
+
+  struct entry_t {
+    qint64 offset = 0;      //< offset in the pack file
+    qint32 size = 0;        //< size of the tile [bytes]
+    qint64 created = 0;     //< time the tile was stored [s since epoch]
+    qint64 used = 0;        //< time the tile was used last [s since epoch]
+    qint64 usedLogged = 0;  //< the last usage written to the log
+  };
+
+  /// @return the MD5 hash of the key, used as key into the index
+  static QByteArray hash(const QString& key);
+
+  /// @return the header of the log and the pack file for a new generation
+  static QByteArray createHeader();
+
+  bool open();
+  void readIndex();
+  void cleanup();
+  void writeRecord(record_e type, const QByteArray& hash, const entry_t& entry);
+  bool append(const QByteArray& hash, const QByteArray& data, qint64 created);
+  void remove(const QByteArray& hash);
+  void migrate(const QString& hex);
+
+  QDir dir;
+
+  const qint32 maxSizeMB;       //< maximum cache size in MB
+  const qint32 expirationDays;  //< expiration time in days
+
+  QFile pack;
+  QFile index;
+
+  /// all tiles in the pack file by hash
+  QHash<QByteArray, entry_t> entries;
+  /// the sum of the size of all tiles in the pack file
+  qint64 sizeLive = 0;
+  /// the size of the holes in the pack file
+  qint64 sizeDead = 0;
+  /// the number of records in the log
+  qint32 cntRecords = 0;
+
+  /// decoded tiles, the cost is in KB
+  QCache<QByteArray, QImage> cache;
+  /// hashes of failed requests, they are not requested again as long as the cache exists
+  QSet<QByteArray> failed;
+  /// the hex hashes of PNG files of the old cache not yet moved into the pack file
+  QSet<QString> pendingPng;
+
+  QTimer* timer;
+
+  QImage dummy{256, 256, QImage::Format_ARGB32};
+
+  mutable QMutex mutex;
+
+  /// the worker thread for the cleanup
+  QThreadPool threadPool;
+};
+
+#endif  // CDISKCACHEPACK_H
@@ -0,0 +1,204 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CTileLoader.h"
+
+#include <QtNetwork>
+#include <algorithm>
+
+#include "map/cache/IDiskCache.h"
+
+CTileLoader::CTileLoader(QObject* parent) : QObject(parent) {
+  accessManager = new QNetworkAccessManager(this);
+  connect(accessManager, &QNetworkAccessManager::finished, this, &CTileLoader::slotRequestFinished);
+
+  connect(this, &CTileLoader::sigSchedule, this, &CTileLoader::slotSchedule, Qt::QueuedConnection);
+  connect(this, &CTileLoader::sigDecoded, this, &CTileLoader::slotDecoded, Qt::QueuedConnection);
+
+  timerRate = new QTimer(this);
+  timerRate->setSingleShot(true);
+  connect(timerRate, &QTimer::timeout, this, &CTileLoader::slotSchedule);
+  timeRate.start();
+}
+
+CTileLoader::~CTileLoader() {
+  // pending replies are aborted when the access manager is destroyed
+  disconnect(accessManager, nullptr, this, nullptr);
+  threadPool.waitForDone();
+}
+
+void CTileLoader::setCache(IDiskCache* cache) {
+  threadPool.waitForDone();
+
+  QMutexLocker lock(&mutex);
+  diskCache = cache;
+}
+
+void CTileLoader::registerHeaderItem(const QString& name, const QString& value) {
+  QMutexLocker lock(&mutex);
+  rawHeaderItems << qMakePair(name.toLatin1(), value.toLatin1());
+}
+
+void CTileLoader::registerHeaderItems(const CTileLoader& other) {
+  QMutexLocker lock1(&other.mutex);
+  QMutexLocker lock2(&mutex);
+  rawHeaderItems = other.rawHeaderItems;
+}
+
+void CTileLoader::setTiles(const QVector<tile_t>& tiles) {
+  QMutexLocker lock(&mutex);
+  tilesNew = tiles;
+  hasTilesNew = true;
+  emit sigSchedule();
+}
+
+qint32 CTileLoader::getPending() const {
+  QMutexLocker lock(&mutex);
+  return queue.size() + requests.size() + decoding.size();
+}
+
+void CTileLoader::updateQueue(const QVector<tile_t>& tiles, QList<QNetworkReply*>& aborted) {
+  QSet<QString> urls;
+  queue.clear();
+  queue.reserve(tiles.size());
+
+  for (const tile_t& tile : tiles) {
+    if (urls.contains(tile.url)) {
+      continue;
+    }
+    urls << tile.url;
+
+    if (!requests.contains(tile.url) && !decoding.contains(tile.url)) {
+      queue << tile;
+    }
+  }
+
+  // the nearest tile is requested first, thus it has to be the last one
+  std::sort(queue.begin(), queue.end(), [](const tile_t& t1, const tile_t& t2) { return t1.distance > t2.distance; });
+
+  // abort requests for tiles no longer visible
+  for (auto request = requests.begin(); request != requests.end();) {
+    if (urls.contains(request.key())) {
+      ++request;
+    } else {
+      aborted << request.value();
+      request = requests.erase(request);
+    }
+  }
+}
+
+void CTileLoader::request(const tile_t& tile) {
+  QNetworkRequest request;
+  request.setUrl(tile.url);
+  for (const QPair<QByteArray, QByteArray>& item : qAsConst(rawHeaderItems)) {
+    request.setRawHeader(item.first, item.second);
+  }
+  // allow http(s) redirects
+  request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+
+  requests[tile.url] = accessManager->get(request);
+}
+
+void CTileLoader::slotSchedule() {
+  QList<QNetworkReply*> aborted;
+  {
+    QMutexLocker lock(&mutex);
+    if (hasTilesNew) {
+      hasTilesNew = false;
+      updateQueue(tilesNew, aborted);
+      tilesNew.clear();
+    }
+
+    while (!queue.isEmpty() && (requests.size() < maxRequests)) {
+      if (rateLimit > 0) {
+        const qint64 now = timeRate.elapsed();
+        if (now < timeNextRequest) {
+          timerRate->start(timeNextRequest - now);
+          break;
+        }
+        timeNextRequest = now + qRound64(1000 / rateLimit);
+      }
+      request(queue.takeLast());
+    }
+  }
+
+  // abort() emits finished() immediately, thus do it without holding the mutex
+  for (QNetworkReply* reply : qAsConst(aborted)) {
+    reply->abort();
+  }
+
+  emit sigQueueChanged();
+}
+
+void CTileLoader::slotRequestFinished(QNetworkReply* reply) {
+  reply->deleteLater();
+
+  // use originally requested url due to possible redirects
+  const QString& url = reply->request().url().toString();
+  {
+    QMutexLocker lock(&mutex);
+    if (requests.value(url) != reply) {
+      // the request has been aborted
+      return;
+    }
+    requests.remove(url);
+    decoding << url;
+  }
+
+  QByteArray data;
+  // only take good responses
+  if (!reply->error()) {
+    data = reply->readAll();
+  } else {
+    qDebug() << "Request to" << url << "failed:" << reply->errorString();
+  }
+
+  threadPool.start([this, url, data]() {
+    QImage img;
+    img.loadFromData(data);
+
+    IDiskCache* cache;
+    {
+      QMutexLocker lock(&mutex);
+      cache = diskCache;
+    }
+
+    // always store image to cache, the cache will take care of NULL images
+    if (cache != nullptr) {
+      cache->store(url, img.isNull() ? QByteArray() : data, img);
+    }
+    emit sigDecoded(url, !img.isNull());
+  });
+
+  slotSchedule();
+}
+
+void CTileLoader::slotDecoded(const QString& url, bool ok) {
+  bool finished;
+  {
+    QMutexLocker lock(&mutex);
+    decoding.remove(url);
+    finished = queue.isEmpty() && requests.isEmpty() && decoding.isEmpty();
+  }
+
+  emit sigTileLoaded(url, ok);
+  emit sigQueueChanged();
+  if (finished) {
+    emit sigFinished();
+  }
+}
@@ -0,0 +1,133 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILELOADER_H
+#define CTILELOADER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+
+class IDiskCache;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+/**
+   @brief Request tiles of online maps and store them in a tile cache
+
+   The map's draw thread passes all tiles of the viewport missing in the cache by
+   setTiles(). The new list replaces the previous one. Thus only tiles of the
+   current view and zoom level are queued. Queued tiles scrolled out of view are
+   dropped and running requests for them are aborted.
+
+   The tiles are requested nearest to the viewport's center first. Only a limited
+   number of requests is running at any time. Optionally the rate of requests is
+   limited, too. The replies are decoded and stored to the cache by a thread pool,
+   not by the thread the loader lives in.
+
+   All network operations are done by the thread the loader lives in. setTiles()
+   and getPending() can be called from any thread.
+ */
+class CTileLoader : public QObject {
+  Q_OBJECT
+ public:
+  struct tile_t {
+    QString url;
+    qreal distance = 0;  //< distance of the tile to the viewport's center [tiles]
+  };
+
+  CTileLoader(QObject* parent);
+  virtual ~CTileLoader();
+
+  /**
+     @brief Set the cache to store the tiles to
+
+     Waits for all tiles currently decoded to be stored to the old cache. Pass
+     nullptr before deleting the old cache.
+   */
+  void setCache(IDiskCache* cache);
+  void setMaxRequests(qint32 n) { maxRequests = n; }
+  /// limit the number of requests per second, 0 for no limit
+  void setRateLimit(qreal tilesPerSecond) { rateLimit = tilesPerSecond; }
+  void registerHeaderItem(const QString& name, const QString& value);
+  /// copy the raw header items of another loader
+  void registerHeaderItems(const CTileLoader& other);
+
+  /// replace the list of tiles to load
+  void setTiles(const QVector<tile_t>& tiles);
+  /// @return the number of tiles queued, requested or decoded
+  qint32 getPending() const;
+
+ signals:
+  /// the queue changed, e.g. a tile has been loaded or new tiles were set
+  void sigQueueChanged();
+  /// a tile has been stored to the cache, ok is false if the request failed
+  void sigTileLoaded(const QString& url, bool ok);
+  /// the last pending tile has been stored to the cache
+  void sigFinished();
+
+  /// internal: process new tiles in the loader's thread
+  void sigSchedule();
+  /// internal: a tile has been stored by the thread pool
+  void sigDecoded(const QString& url, bool ok);
+
+ private slots:
+  void slotSchedule();
+  void slotRequestFinished(QNetworkReply* reply);
+  void slotDecoded(const QString& url, bool ok);
+
+ private:
+  void updateQueue(const QVector<tile_t>& tiles, QList<QNetworkReply*>& aborted);
+  void request(const tile_t& tile);
+
+  mutable QMutex mutex;
+
+  QNetworkAccessManager* accessManager;
+  QList<QPair<QByteArray, QByteArray>> rawHeaderItems;
+  IDiskCache* diskCache = nullptr;
+
+  qint32 maxRequests = 6;
+  qreal rateLimit = 0;
+
+  /// the time base of the rate limit
+  QElapsedTimer timeRate;
+  /// the earliest time of the next request [ms]
+  qint64 timeNextRequest = 0;
+  /// schedule the next request if the rate limit is hit
+  QTimer* timerRate;
+
+  /// the tiles of the last call to setTiles() not yet processed by slotSchedule()
+  QVector<tile_t> tilesNew;
+  bool hasTilesNew = false;
+
+  /// tiles to request, sorted by priority, the next one last
+  QVector<tile_t> queue;
+  /// running requests by url
+  QHash<QString, QNetworkReply*> requests;
+  /// urls of tiles in the thread pool
+  QSet<QString> decoding;
+
+  QThreadPool threadPool;
+};
+
+#endif  // CTILELOADER_H
@@ -0,0 +1,107 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CTileSeeder.h"
+
+#include <QtCore>
+
+#include "gis/proj_x.h"
+#include "map/cache/CTileLoader.h"
+#include "map/cache/IDiskCache.h"
+
+CTileSeeder::CTileSeeder(IDiskCache* cache, QObject* parent) : QObject(parent), diskCache(cache) {
+  loader = new CTileLoader(this);
+  loader->setCache(cache);
+  connect(loader, &CTileLoader::sigTileLoaded, this, &CTileSeeder::slotTileLoaded);
+}
+
+void CTileSeeder::start(const QStringList& urls) {
+  stats = stats_t();
+
+  QVector<CTileLoader::tile_t> tiles;
+  tiles.reserve(urls.size());
+  for (const QString& url : urls) {
+    stats.total++;
+    // failed requests are tried again
+    if (diskCache->hasTile(url)) {
+      stats.cached++;
+      continue;
+    }
+
+    // keep the order of the urls
+    CTileLoader::tile_t tile;
+    tile.url = url;
+    tile.distance = tiles.size();
+    tiles << tile;
+  }
+
+  running = !tiles.isEmpty();
+  loader->setTiles(tiles);
+
+  emit sigProgress(stats);
+  if (!running) {
+    emit sigFinished(stats);
+  }
+}
+
+void CTileSeeder::cancel() {
+  if (!running) {
+    return;
+  }
+  running = false;
+  loader->setTiles(QVector<CTileLoader::tile_t>());
+  emit sigFinished(stats);
+}
+
+void CTileSeeder::slotTileLoaded(const QString& /*url*/, bool ok) {
+  if (!running) {
+    return;
+  }
+
+  if (ok) {
+    stats.loaded++;
+  } else {
+    stats.failed++;
+  }
+
+  emit sigProgress(stats);
+  if (stats.done() == stats.total) {
+    running = false;
+    emit sigFinished(stats);
+  }
+}
+
+void CTileSeeder::corridor(const QPolygonF& line, qreal width, QList<QRectF>& areas) {
+  // the corridor is covered by squares of the corridor's width centered
+  // on the line. Long segments are subdivided to leave no gaps.
+  const qreal dLat = width / 2 / 111320.0;
+
+  for (int i = 0; i < line.size(); i++) {
+    const QPointF& pt2 = line[i];
+    const QPointF& pt1 = i ? line[i - 1] : pt2;
+
+    const qreal dLon = dLat / qMax(0.01, qCos(pt2.y() * DEG_TO_RAD));
+    const qint32 steps = qCeil(qMax(qAbs(pt2.x() - pt1.x()) / dLon, qAbs(pt2.y() - pt1.y()) / dLat));
+
+    // the first point of the segment is covered by the previous one
+    for (qint32 s = i ? 1 : 0; s <= steps; s++) {
+      const QPointF& pt = steps ? pt1 + (pt2 - pt1) * s / steps : pt2;
+      areas << QRectF(pt.x() - dLon, pt.y() - dLat, 2 * dLon, 2 * dLat);
+    }
+  }
+}
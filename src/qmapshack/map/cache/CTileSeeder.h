@@ -0,0 +1,90 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESEEDER_H
+#define CTILESEEDER_H
+
+#include <QObject>
+#include <QPolygonF>
+#include <QRectF>
+
+class CTileLoader;
+class IDiskCache;
+
+/**
+   @brief Download all tiles of an area into a tile cache for offline use
+
+   The seeder uses its own CTileLoader. Thus it does not interfere with the tiles
+   requested by drawing the map. Tiles already in the cache are skipped. Therefore
+   an interrupted seeding is resumed by starting it again with the same tiles. Tiles
+   failed before are requested again.
+ */
+class CTileSeeder : public QObject {
+  Q_OBJECT
+ public:
+  struct stats_t {
+    qint32 total = 0;   //< the number of tiles to seed
+    qint32 cached = 0;  //< tiles found in the cache
+    qint32 loaded = 0;  //< tiles downloaded
+    qint32 failed = 0;  //< tiles failed to download
+
+    qint32 done() const { return cached + loaded + failed; }
+  };
+
+  CTileSeeder(IDiskCache* cache, QObject* parent);
+  virtual ~CTileSeeder() = default;
+
+  /// @return the loader to apply settings like the number of parallel requests or the rate limit
+  CTileLoader& getLoader() { return *loader; }
+
+  /**
+     @brief Start to download all tiles not in the cache
+
+     @param urls  the urls of all tiles
+   */
+  void start(const QStringList& urls);
+  /// stop all requests
+  void cancel();
+
+  bool isRunning() const { return running; }
+  const stats_t& getStats() const { return stats; }
+
+  /**
+     @brief Cover a line by rectangles
+
+     @param line    the line in [°]
+     @param width   the width of the corridor [m]
+     @param areas   the rectangles in [°] are appended to this list
+   */
+  static void corridor(const QPolygonF& line, qreal width, QList<QRectF>& areas);
+
+ signals:
+  void sigProgress(const CTileSeeder::stats_t& stats);
+  void sigFinished(const CTileSeeder::stats_t& stats);
+
+ private slots:
+  void slotTileLoaded(const QString& url, bool ok);
+
+ private:
+  IDiskCache* diskCache;
+  CTileLoader* loader;
+  stats_t stats;
+  bool running = false;
+};
+
+#endif  // CTILESEEDER_H
@@ -0,0 +1,52 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef IDISKCACHE_H
+#define IDISKCACHE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QObject>
+
+/**
+   @brief Interface of all tile caches used by online maps
+
+   All methods are called from the GUI thread and the map's draw thread.
+   Thus the implementations have to be thread safe.
+ */
+class IDiskCache : public QObject {
+ public:
+  IDiskCache(QObject* parent) : QObject(parent) {}
+  virtual ~IDiskCache() = default;
+
+  /**
+     @brief Store a tile
+
+     @param key     the tile's key, usually the url
+     @param data    the tile as sent by the server, empty if the request failed
+     @param img     the decoded tile, a null image if the request failed
+   */
+  virtual void store(const QString& key, const QByteArray& data, QImage& img) = 0;
+  virtual void restore(const QString& key, QImage& img) = 0;
+  /// @return True if the tile is stored or its request failed before.
+  virtual bool contains(const QString& key) const = 0;
+  /// @return True if the tile is stored. Failed requests do not count.
+  virtual bool hasTile(const QString& key) const = 0;
+};
+
+#endif  // IDISKCACHE_H
@@ -25,7 +25,7 @@ QDataStream& operator>>(QDataStream& s, uintX& v) {
 
   s >> tmp;
   while (tmp & 0x80) {
-    v.val |= (tmp & 0x7F) << shift;
+    v.val |= quint64(tmp & 0x7F) << shift;
     shift += 7;
     s >> tmp;
   }
@@ -42,13 +42,13 @@ QDataStream& operator>>(QDataStream& s, intX& v) {
 
   s >> tmp;
   while (tmp & 0x80) {
-    v.val |= (tmp & 0x7F) << shift;
+    v.val |= quint64(tmp & 0x7F) << shift;
     shift += 7;
     s >> tmp;
   }
 
   if (tmp & 0x40) {
-    v.val = -(v.val | ((tmp & 0x3f) << shift));
+    v.val = -qint64(v.val | (quint64(tmp & 0x3f) << shift));
   } else {
     v.val |= quint64(tmp) << shift;
   }
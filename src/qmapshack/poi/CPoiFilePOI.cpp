@@ -111,6 +111,7 @@ void CPoiFilePOI::draw(IDrawContext::buffer_t& buf) {
   // draw POI
   QMutexLocker lock(&mutex);
   displayedPois.clear();
+  displayedIcons.clear();
   QRectF freeSpaceRect(QPointF(), IPoiFile::iconSize() * 2);
   // Find POIs in view
   const QList<quint64>& keys = categoryActivated.keys();
@@ -134,16 +135,10 @@ void CPoiFilePOI::draw(IDrawContext::buffer_t& buf) {
 
           freeSpaceRect.moveCenter(pt);
 
-          bool foundIntersection = false;
-          for (poiGroup_t& poiGroup : displayedPois) {
-            if (poiGroup.iconLocation.intersects(freeSpaceRect)) {
-              foundIntersection = true;
-              poiGroup.pois.insert(poiToDrawID);
-              break;
-            }
-          }
-
-          if (!foundIntersection) {
+          const qint32 idx = displayedIcons.findFirst(freeSpaceRect);
+          if (idx != NOIDX) {
+            displayedPois[idx].pois.insert(poiToDrawID);
+          } else {
             poiGroup_t poiGroup;
             QRectF iconRect(QPointF(), IPoiFile::iconSize());
             iconRect.moveCenter(pt);
@@ -151,6 +146,7 @@ void CPoiFilePOI::draw(IDrawContext::buffer_t& buf) {
             poiGroup.iconCenter = poiToDraw.getCoordinates();
             poiGroup.pois.insert(poiToDrawID);
             displayedPois.append(poiGroup);
+            displayedIcons << iconRect;
           }
         }
       }
@@ -392,14 +388,7 @@ void CPoiFilePOI::getPoiIcon(QPixmap& icon, const CPoiItemPOI& poi, const QStrin
   icon = QPixmap("://icons/poi/SJJB/png/poi_point_of_interest.n.32.png");
 }
 
-bool CPoiFilePOI::overlapsWithIcon(const QRectF& rect) const {
-  for (const poiGroup_t& poiGroup : displayedPois) {
-    if (poiGroup.iconLocation.intersects(rect)) {
-      return true;
-    }
-  }
-  return false;
-}
+bool CPoiFilePOI::overlapsWithIcon(const QRectF& rect) const { return displayedIcons.intersects(rect); }
 
 bool CPoiFilePOI::getPoiGroupCloseBy(const QPoint& px, CPoiFilePOI::poiGroup_t& poiItem) const {
   for (const poiGroup_t& poiGroup : displayedPois) {
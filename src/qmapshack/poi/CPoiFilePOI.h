@@ -24,6 +24,7 @@
 #include <QMutex>
 #include <QTimer>
 
+#include "helpers/COccupancyGrid.h"
 #include "poi/CPoiIconCategory.h"
 #include "poi/CPoiItemPOI.h"
 #include "poi/IPoiFile.h"
@@ -89,6 +90,8 @@ class CPoiFilePOI : public IPoiFile {
   QMap<quint64, QMap<int, QMap<int, QList<quint64> > > > loadedPoisByArea;
   QMap<quint64, CPoiItemPOI> loadedPois;
   QList<poiGroup_t> displayedPois;
+  /// the icon locations of displayedPois by the same index
+  COccupancyGrid displayedIcons;
   QRectF bbox;
 
   static QMap<QString, CPoiIconCategory> tagMap;
@@ -0,0 +1,391 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "dem/CDemShading.h"
+#include "gis/proj_x.h"
+#include "units/IUnit.h"
+
+#include <QtCore>
+#include <cstring>
+
+static const float noData = -32768;
+
+/*
+    A synthetic DEM tile with hills, a rough area, a steady
+    ascent and a few holes of no data.
+ */
+static QVector<float> createDemTile(int w, int h)
+{
+    const int wp2 = w + 2;
+    const int hp2 = h + 2;
+
+    QVector<float> data(wp2 * hp2);
+    for(int y = 0; y < hp2; y++)
+    {
+        for(int x = 0; x < wp2; x++)
+        {
+            float ele = 1000 + 600 * qSin(x / 47.0) * qCos(y / 31.0) + 0.8 * x;
+            if((x / 100 + y / 100) % 2)
+            {
+                ele += 30 * qSin(x * 0.9) * qSin(y * 1.3);
+            }
+            if((x > 300 && x < 320 && y > 500 && y < 700) || ((x * 7 + y * 13) % 997 == 0))
+            {
+                ele = noData;
+            }
+            data[x + y * wp2] = ele;
+        }
+    }
+    return data;
+}
+
+/*
+    The shading as it was done before the fused kernels: pixel by
+    pixel with a 3x3 window and double precision trigonometry.
+ */
+class CDemShadingReference
+{
+public:
+    CDemShadingReference(const CDemShading::params_t &params) : p(params) {}
+
+    void hillshading(const QVector<float> &data, int w, int h, QImage &img) const
+    {
+        for(int m = 1; m <= h; m++)
+        {
+            uchar *scan = img.scanLine(m - 1);
+            for(int n = 1; n <= w; n++)
+            {
+                float win[9];
+                fillWindow(data, n, m, w + 2, win);
+
+                if(p.hasNoData && win[4] == p.noData)
+                {
+                    scan[n - 1] = 255;
+                    continue;
+                }
+
+                qreal dx = ((win[0] + win[3] + win[3] + win[6]) - (win[2] + win[5] + win[5] + win[8])) / (p.xscale * p.factorHillshading);
+                qreal dy = ((win[6] + win[7] + win[7] + win[8]) - (win[0] + win[1] + win[1] + win[2])) / (p.yscale * p.factorHillshading);
+                qreal aspect = qAtan2(dy, dx);
+                qreal xx_plus_yy = dx * dx + dy * dy;
+                qreal cang = (qSin(45 * DEG_TO_RAD) - 0.125 * qCos(45 * DEG_TO_RAD) * qSqrt(xx_plus_yy) * qSin(aspect - 315 * DEG_TO_RAD))
+                             / qSqrt(1 + 0.125 * 0.125 * xx_plus_yy);
+
+                scan[n - 1] = (cang <= 0.0) ? 1.0 : 1.0 + (254.0 * cang);
+            }
+        }
+    }
+
+    void slopeShading(const QVector<float> &data, int w, int h, QImage &img) const
+    {
+        for(int m = 1; m <= h; m++)
+        {
+            uchar *scan = img.scanLine(m - 1);
+            for(int n = 1; n <= w; n++)
+            {
+                float win[9];
+                fillWindow(data, n, m, w + 2, win);
+
+                const qreal slope = slopeOfWindow(win);
+                if((p.hasNoData && win[4] == p.noData) || slope == NOFLOAT)
+                {
+                    scan[n - 1] = 0;
+                    continue;
+                }
+                int alphaValue = slope * 255. / 90. * p.factorSlopeShading;
+                scan[n - 1] = qMin(alphaValue, 255);
+            }
+        }
+    }
+
+    void slopeColor(const QVector<float> &data, int w, int h, QImage &img) const
+    {
+        for(int m = 1; m <= h; m++)
+        {
+            uchar *scan = img.scanLine(m - 1);
+            for(int n = 1; n <= w; n++)
+            {
+                float win[9];
+                fillWindow(data, n, m, w + 2, win);
+
+                const qreal slope = slopeOfWindow(win);
+                const qreal *steps = p.slopeSteps;
+                if(slope > steps[4])
+                {
+                    scan[n - 1] = 5;
+                }
+                else if(slope > steps[3])
+                {
+                    scan[n - 1] = 4;
+                }
+                else if(slope > steps[2])
+                {
+                    scan[n - 1] = 3;
+                }
+                else if(slope > steps[1])
+                {
+                    scan[n - 1] = 2;
+                }
+                else if(slope > steps[0])
+                {
+                    scan[n - 1] = 1;
+                }
+                else
+                {
+                    scan[n - 1] = 0;
+                }
+            }
+        }
+    }
+
+    void elevationLimit(const QVector<float> &data, int w, int h, QImage &img) const
+    {
+        for(int m = 1; m <= h; m++)
+        {
+            uchar *scan = img.scanLine(m - 1);
+            for(int n = 1; n <= w; n++)
+            {
+                scan[n - 1] = (elevation(data, n, m, w + 2) >= p.elevationLimit) ? 1 : 0;
+            }
+        }
+    }
+
+    void elevationShading(const QVector<float> &data, int w, int h, QImage &img) const
+    {
+        const qreal limitLow = qMin(p.elevationShadeLow, p.elevationShadeHi);
+        const qreal limitHi = qMax(p.elevationShadeLow, p.elevationShadeHi);
+
+        for(int m = 1; m <= h; m++)
+        {
+            uchar *scan = img.scanLine(m - 1);
+            for(int n = 1; n <= w; n++)
+            {
+                const qreal ele = elevation(data, n, m, w + 2);
+                if(ele < limitLow)
+                {
+                    scan[n - 1] = 0;
+                }
+                else if(ele < limitHi)
+                {
+                    scan[n - 1] = 1 + (ele - limitLow) / (limitHi - limitLow) * 253;
+                }
+                else
+                {
+                    scan[n - 1] = 255;
+                }
+            }
+        }
+    }
+
+private:
+    static void fillWindow(const QVector<float> &data, int x, int y, int dx, float *win)
+    {
+        int i = 0;
+        for(int r = y - 1; r <= y + 1; r++)
+        {
+            for(int c = x - 1; c <= x + 1; c++)
+            {
+                win[i++] = data[c + r * dx];
+            }
+        }
+    }
+
+    qreal slopeOfWindow(const float *win) const
+    {
+        for(int i = 0; i < 9; i++)
+        {
+            if(p.hasNoData && win[i] == p.noData)
+            {
+                return NOFLOAT;
+            }
+        }
+
+        qreal dx = ((win[0] + win[3] + win[3] + win[6]) - (win[2] + win[5] + win[5] + win[8])) / p.xscale;
+        qreal dy = ((win[6] + win[7] + win[7] + win[8]) - (win[0] + win[1] + win[1] + win[2])) / p.yscale;
+        return qAtan(qSqrt(dx * dx + dy * dy) / 8) * 180.0 / M_PI;
+    }
+
+    qreal elevation(const QVector<float> &data, int x, int y, int dx) const
+    {
+        float win[9];
+        fillWindow(data, x, y, dx, win);
+
+        qreal meters = -2.0;
+        for(int i = 0; i < 9; i++)
+        {
+            if(win[i] != p.noData && win[i] > meters)
+            {
+                meters = win[i];
+            }
+        }
+        return meters * p.elevationFactor;
+    }
+
+    const CDemShading::params_t p;
+};
+
+static void verifySimilar(const QString &name, const QImage &exp, const QImage &act)
+{
+    int cntDiff = 0;
+    for(int y = 0; y < exp.height(); y++)
+    {
+        const uchar *e = exp.constScanLine(y);
+        const uchar *a = act.constScanLine(y);
+        for(int x = 0; x < exp.width(); x++)
+        {
+            const int diff = qAbs(int(e[x]) - int(a[x]));
+            SUBVERIFY(diff <= 1, QString("%1: pixel %2/%3 differs by %4").arg(name).arg(x).arg(y).arg(diff));
+            cntDiff += diff;
+        }
+    }
+
+    // single precision and the approximated arc tangent shift a few values at the rounding border
+    const int cntMax = exp.width() * exp.height() / 100;
+    SUBVERIFY(cntDiff <= cntMax, QString("%1: %2 pixels differ").arg(name).arg(cntDiff));
+}
+
+void test_QMapShack::_shadeDemTile()
+{
+    const int w = 512;
+    const int h = 384;
+    const QVector<float> &data = createDemTile(w, h);
+
+    const qreal stepsSorted[5] = {27.0, 31.0, 34.0, 39.0, 50.0};
+    const qreal stepsUnsorted[5] = {30.0, 10.0, 45.0, 20.0, 5.0};
+
+    for(int cfg = 0; cfg < 4; cfg++)
+    {
+        CDemShading::params_t params;
+        params.xscale = (cfg == 2) ? 30 : 10;
+        params.yscale = (cfg == 2) ? 31 : 12;
+        params.factorHillshading = (cfg == 0) ? 1.0 / 6 : cfg;
+        params.factorSlopeShading = (cfg == 0) ? 0.25 : cfg;
+        params.hasNoData = cfg != 3;
+        params.noData = noData;
+        for(int i = 0; i < 5; i++)
+        {
+            params.slopeSteps[i] = (cfg == 1) ? stepsUnsorted[i] : stepsSorted[i];
+        }
+        params.elevationFactor = (cfg % 2) ? 3.28084 : 1.0;
+        params.elevationLimit = 1500;
+        // the limits may be swapped
+        params.elevationShadeLow = (cfg == 3) ? 1800 : 800;
+        params.elevationShadeHi = (cfg == 3) ? 800 : 1800;
+
+        QImage exp[5];
+        QImage act[5];
+        for(int i = 0; i < 5; i++)
+        {
+            exp[i] = QImage(w, h, QImage::Format_Indexed8);
+            act[i] = QImage(w, h, QImage::Format_Indexed8);
+        }
+
+        CDemShadingReference reference(params);
+        reference.hillshading(data, w, h, exp[0]);
+        reference.slopeShading(data, w, h, exp[1]);
+        reference.slopeColor(data, w, h, exp[2]);
+        reference.elevationLimit(data, w, h, exp[3]);
+        reference.elevationShading(data, w, h, exp[4]);
+
+        CDemShading::output_t output;
+        output.hillshading = &act[0];
+        output.slopeShading = &act[1];
+        output.slopeColor = &act[2];
+        output.elevationLimit = &act[3];
+        output.elevationShading = &act[4];
+        CDemShading::shade(data, w, h, params, output);
+
+        const QString &name = QString("config %1").arg(cfg);
+        verifySimilar(name + " hillshading", exp[0], act[0]);
+        verifySimilar(name + " slope shading", exp[1], act[1]);
+        verifySimilar(name + " slope color", exp[2], act[2]);
+        verifySimilar(name + " elevation limit", exp[3], act[3]);
+        verifySimilar(name + " elevation shading", exp[4], act[4]);
+
+        // a single mode yields the same as all modes at once
+        QImage single(w, h, QImage::Format_Alpha8);
+        CDemShading::output_t outputSingle;
+        outputSingle.slopeShading = &single;
+        CDemShading::shade(data, w, h, params, outputSingle);
+        for(int y = 0; y < h; y++)
+        {
+            SUBVERIFY(memcmp(single.constScanLine(y), act[1].constScanLine(y), w) == 0, "Single mode differs from fused modes");
+        }
+    }
+}
+
+void test_QMapShack::_benchmarkDemShading()
+{
+    const int w = 1024;
+    const int h = 1024;
+    const QVector<float> &data = createDemTile(w, h);
+
+    CDemShading::params_t params;
+    params.xscale = 10;
+    params.yscale = 12;
+    params.hasNoData = true;
+    params.noData = noData;
+    params.slopeSteps[0] = 27.0;
+    params.slopeSteps[1] = 31.0;
+    params.slopeSteps[2] = 34.0;
+    params.slopeSteps[3] = 39.0;
+    params.slopeSteps[4] = 50.0;
+    params.elevationLimit = 1500;
+    params.elevationShadeLow = 800;
+    params.elevationShadeHi = 1800;
+
+    QImage img[5];
+    for(int i = 0; i < 5; i++)
+    {
+        img[i] = QImage(w, h, QImage::Format_Indexed8);
+    }
+
+    auto report = [w, h](const QString &name, const std::function<void()> &func)
+                  {
+                      QElapsedTimer timer;
+                      timer.start();
+                      func();
+                      const qreal sec = qMax(qint64(1), timer.nsecsElapsed()) / 1e9;
+                      qDebug().noquote() << QString("%1: %2 Mpx/s").arg(name, -32).arg(w * h / sec / 1e6, 0, 'f', 1);
+                  };
+
+    CDemShadingReference reference(params);
+    report("per pixel, all modes", [&](){
+        reference.hillshading(data, w, h, img[0]);
+        reference.slopeShading(data, w, h, img[1]);
+        reference.slopeColor(data, w, h, img[2]);
+        reference.elevationLimit(data, w, h, img[3]);
+        reference.elevationShading(data, w, h, img[4]);
+    });
+    report("per pixel, hillshading", [&](){ reference.hillshading(data, w, h, img[0]); });
+
+    CDemShading::output_t outputAll;
+    outputAll.hillshading = &img[0];
+    outputAll.slopeShading = &img[1];
+    outputAll.slopeColor = &img[2];
+    outputAll.elevationLimit = &img[3];
+    outputAll.elevationShading = &img[4];
+    report("fused rows, all modes", [&](){ CDemShading::shade(data, w, h, params, outputAll); });
+
+    CDemShading::output_t outputHillshading;
+    outputHillshading.hillshading = &img[0];
+    report("fused rows, hillshading", [&](){ CDemShading::shade(data, w, h, params, outputHillshading); });
+}
@@ -0,0 +1,194 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/cache/CDiskCachePack.h"
+
+#include <QtGui>
+
+/*
+    A tile of random noise. It does not compress well, thus
+    a few tiles are enough to exceed the cache size of 1MB.
+ */
+static QImage createTile(quint32 seed, QByteArray& data)
+{
+    QRandomGenerator rand(seed);
+    QImage img(256, 256, QImage::Format_ARGB32);
+    for(int y = 0; y < img.height(); y++)
+    {
+        QRgb* line = reinterpret_cast<QRgb*>(img.scanLine(y));
+        for(int x = 0; x < img.width(); x++)
+        {
+            line[x] = rand.generate() | 0xFF000000;
+        }
+    }
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    img.save(&buffer, "PNG");
+    return img;
+}
+
+static QString tileUrl(int n)
+{
+    return QString("https://tile.example.org/15/%1/%2.png").arg(17000 + n).arg(11000);
+}
+
+void test_QMapShack::_storeRestoreTilePack()
+{
+    QTemporaryDir tmpDir;
+    SUBVERIFY(tmpDir.isValid(), "Failed to create temporary directory");
+
+    // a tile of the old PNG file cache
+    QByteArray data;
+    const QImage& tile0 = createTile(0, data);
+    const QString& hash0 = QCryptographicHash::hash(tileUrl(0).toLatin1(), QCryptographicHash::Md5).toHex();
+    const QString& file0 = QDir(tmpDir.path()).absoluteFilePath(hash0 + ".png");
+    tile0.save(file0);
+
+    QList<QImage> tiles;
+    tiles << tile0;
+
+    CDiskCachePack* cache = new CDiskCachePack(tmpDir.path(), 1, 30, nullptr);
+    SUBVERIFY(cache->contains(tileUrl(0)), "Tile of PNG cache not found");
+
+    QImage img;
+    cache->restore(tileUrl(0), img);
+    SUBVERIFY(img.convertToFormat(QImage::Format_ARGB32) == tile0, "Restored PNG tile differs");
+    SUBVERIFY(!QFile::exists(file0), "PNG tile was not moved into the pack file");
+
+    for(int n = 1; n < 8; n++)
+    {
+        tiles << createTile(n, data);
+        cache->store(tileUrl(n), data, tiles[n]);
+    }
+
+    // a failed request
+    QImage failed;
+    cache->store(tileUrl(100), QByteArray(), failed);
+    SUBVERIFY(cache->contains(tileUrl(100)), "Failed request not cached");
+    cache->restore(tileUrl(100), img);
+    SUBVERIFY(!img.isNull() && img.pixelColor(0, 0).alpha() == 0, "Failed request does not restore a transparent tile");
+
+    SUBVERIFY(!cache->contains(tileUrl(200)), "Unknown tile found");
+    VERIFY_EQUAL(8, cache->getCount());
+    delete cache;
+
+    // all tiles are restored from the pack file after a restart
+    cache = new CDiskCachePack(tmpDir.path(), 1, 30, nullptr);
+    VERIFY_EQUAL(8, cache->getCount());
+    for(int n = 0; n < 8; n++)
+    {
+        SUBVERIFY(cache->contains(tileUrl(n)), QString("Tile %1 not found after restart").arg(n));
+        cache->restore(tileUrl(n), img);
+        SUBVERIFY(img.convertToFormat(QImage::Format_ARGB32) == tiles[n], QString("Tile %1 differs after restart").arg(n));
+    }
+
+    // evict tiles until the pack is below 1MB
+    cache->slotCleanup();
+    cache->waitForCleanup();
+    const qint32 count = cache->getCount();
+    SUBVERIFY(cache->getSize() <= 1024 * 1024, "Cache exceeds its maximum size");
+    SUBVERIFY(count > 0 && count < 8, "No tiles evicted");
+    delete cache;
+
+    // the log replays to the same state and the kept tiles are intact
+    cache = new CDiskCachePack(tmpDir.path(), 1, 30, nullptr);
+    VERIFY_EQUAL(count, cache->getCount());
+    for(int n = 0; n < 8; n++)
+    {
+        if(cache->contains(tileUrl(n)))
+        {
+            cache->restore(tileUrl(n), img);
+            SUBVERIFY(img.convertToFormat(QImage::Format_ARGB32) == tiles[n], QString("Tile %1 differs after eviction").arg(n));
+        }
+    }
+    delete cache;
+}
+
+void test_QMapShack::_compactTilePack()
+{
+    QTemporaryDir tmpDir;
+    SUBVERIFY(tmpDir.isValid(), "Failed to create temporary directory");
+    const QDir dir(tmpDir.path());
+
+    QByteArray data;
+    QList<QImage> tiles;
+    CDiskCachePack* cache = new CDiskCachePack(tmpDir.path(), 1, 30, nullptr);
+    for(int n = 0; n < 8; n++)
+    {
+        tiles << createTile(n, data);
+        cache->store(tileUrl(n), data, tiles[n]);
+    }
+
+    // evicted tiles leave holes in the pack file
+    cache->slotCleanup();
+    cache->waitForCleanup();
+    const qint32 count = cache->getCount();
+    SUBVERIFY(count > 0 && count < 8, "No tiles evicted");
+
+    const qint64 sizeBefore = QFileInfo(dir.absoluteFilePath("tiles.pack")).size();
+    const QByteArray packBefore = [&dir]()
+    {
+        QFile file(dir.absoluteFilePath("tiles.pack"));
+        file.open(QIODevice::ReadOnly);
+        return file.readAll();
+    }();
+
+    cache->compact();
+    const qint64 sizeAfter = QFileInfo(dir.absoluteFilePath("tiles.pack")).size();
+    SUBVERIFY(sizeAfter < sizeBefore, "Pack file not compacted");
+    SUBVERIFY(sizeAfter - cache->getSize() < 1024, "Holes left in the pack file");
+    VERIFY_EQUAL(count, cache->getCount());
+
+    // the survivors are intact before and after a restart
+    for(int pass = 0; pass < 2; pass++)
+    {
+        VERIFY_EQUAL(count, cache->getCount());
+        for(int n = 0; n < 8; n++)
+        {
+            if(cache->hasTile(tileUrl(n)))
+            {
+                QImage img;
+                cache->restore(tileUrl(n), img);
+                SUBVERIFY(img.convertToFormat(QImage::Format_ARGB32) == tiles[n], QString("Tile %1 differs after compaction").arg(n));
+            }
+        }
+
+        delete cache;
+        cache = new CDiskCachePack(tmpDir.path(), 1, 30, nullptr);
+    }
+    delete cache;
+
+    // the new log with the old pack file, as left by a crash between the renames, is dropped
+    {
+        QFile file(dir.absoluteFilePath("tiles.pack"));
+        SUBVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate), "Failed to restore old pack file");
+        file.write(packBefore);
+    }
+
+    cache = new CDiskCachePack(tmpDir.path(), 1, 30, nullptr);
+    VERIFY_EQUAL(0, cache->getCount());
+    for(int n = 0; n < 8; n++)
+    {
+        SUBVERIFY(!cache->hasTile(tileUrl(n)), QString("Tile %1 found in mismatched pack file").arg(n));
+    }
+    delete cache;
+}
@@ -21,8 +21,10 @@
 
 #include "gis/gpx/CGpxProject.h"
 #include "gis/trk/CGisItemTrk.h"
+#include "gis/trk/CKnownExtension.h"
 
 #include <QtCore>
+#include <cstring>
 
 void test_QMapShack::_filterDeleteExtension()
 {
@@ -54,3 +56,244 @@ void test_QMapShack::_filterDeleteExtension()
     }
 }
 
+
+/*
+    The algorithm used to derive slope and speed up to now. It scans the track
+    forward and backward from every point. Kept as a reference.
+ */
+static void deriveSlopeAndSpeedReference(const CTrackData &data, QVector<qreal> &slope1, QVector<qreal> &slope2, QVector<qreal> &speed)
+{
+    QVector<const CTrackData::trkpt_t*> lintrk;
+    for(const CTrackData::trkpt_t &trkpt : data)
+    {
+        if(!trkpt.isHidden())
+        {
+            lintrk << &trkpt;
+        }
+    }
+
+    for(int p = 0; p < lintrk.size(); p++)
+    {
+        const CTrackData::trkpt_t &trkpt = *lintrk[p];
+
+        qreal d1 = trkpt.distance;
+        qreal e1 = trkpt.ele;
+        qreal t1 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
+        for(int n = p; n > 0; --n)
+        {
+            const CTrackData::trkpt_t &trkpt2 = *lintrk[n];
+            if(trkpt2.ele == NOINT)
+            {
+                continue;
+            }
+
+            d1 = trkpt2.distance;
+            e1 = trkpt2.ele;
+            t1 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
+            if(trkpt.distance - trkpt2.distance >= 25)
+            {
+                break;
+            }
+        }
+
+        qreal d2 = trkpt.distance;
+        qreal e2 = trkpt.ele;
+        qreal t2 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
+        for(int n = p; n < lintrk.size(); ++n)
+        {
+            const CTrackData::trkpt_t &trkpt2 = *lintrk[n];
+            if(trkpt2.ele == NOINT)
+            {
+                continue;
+            }
+
+            d2 = trkpt2.distance;
+            e2 = trkpt2.ele;
+            t2 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
+            if(trkpt2.distance - trkpt.distance >= 25)
+            {
+                break;
+            }
+        }
+
+        if(d1 < d2)
+        {
+            qreal a = qAtan((e2 - e1) / (d2 - d1));
+            slope1 << a * 360.0 / (2 * M_PI);
+            slope2 << qTan(slope1.last() * DEG_TO_RAD) * 100;
+        }
+        else
+        {
+            slope1 << NOFLOAT;
+            slope2 << NOFLOAT;
+        }
+
+        speed << ((t1 < t2) ? (d2 - d1) / (t2 - t1) : NOFLOAT);
+    }
+}
+
+static bool isBitIdentical(qreal a, qreal b)
+{
+    return std::memcmp(&a, &b, sizeof(qreal)) == 0;
+}
+
+static void verifySlopeAndSpeed(const CGisItemTrk &trk)
+{
+    QVector<qreal> slope1, slope2, speed;
+    deriveSlopeAndSpeedReference(trk.getTrackData(), slope1, slope2, speed);
+
+    int p = 0;
+    for(const CTrackData::trkpt_t &trkpt : trk.getTrackData())
+    {
+        if(trkpt.isHidden())
+        {
+            continue;
+        }
+
+        SUBVERIFY(isBitIdentical(slope1[p], trkpt.slope1), QString("%1: slope1 of point %2 differs").arg(trk.getName()).arg(p));
+        SUBVERIFY(isBitIdentical(slope2[p], trkpt.slope2), QString("%1: slope2 of point %2 differs").arg(trk.getName()).arg(p));
+        SUBVERIFY(isBitIdentical(speed[p], trkpt.speed), QString("%1: speed of point %2 differs").arg(trk.getName()).arg(p));
+        p++;
+    }
+    VERIFY_EQUAL(slope1.size(), p);
+}
+
+void test_QMapShack::_deriveSlopeAndSpeed()
+{
+    for(const QString &file : inputFiles)
+    {
+        IGisProject *proj = readProjFile(file);
+
+        const int N = proj->childCount();
+        for(int i = 0; i < N; i++)
+        {
+            CGisItemTrk *trk = dynamic_cast<CGisItemTrk*>(proj->child(i));
+            if(nullptr == trk)
+            {
+                continue;
+            }
+
+            verifySlopeAndSpeed(*trk);
+
+            // the same track with runs of missing elevation and stationary points
+            CTrackData data = trk->getTrackData();
+            int cnt = 0;
+            for(CTrackData::trkseg_t &seg : data.segs)
+            {
+                for(int n = 0; n < seg.pts.size(); n++)
+                {
+                    if((cnt++ % 11) < 6)
+                    {
+                        seg.pts[n].ele = NOINT;
+                    }
+                }
+
+                if(!seg.pts.isEmpty())
+                {
+                    seg.pts.insert(seg.pts.size() / 2, 5, seg.pts[seg.pts.size() / 2]);
+                }
+            }
+
+            // the new track is owned by the project
+            CGisItemTrk *trk2 = new CGisItemTrk(trk->getName() + "_noele", 0, NOINT, data, proj);
+            verifySlopeAndSpeed(*trk2);
+        }
+
+        delete proj;
+    }
+}
+
+static void verifySecondaryData(const CGisItemTrk &exp, const CGisItemTrk &act)
+{
+    const CTrackData &expData = exp.getTrackData();
+    const CTrackData &actData = act.getTrackData();
+
+    CTrackData::iterator<const CTrackData, const CTrackData::trkpt_t> it = expData.begin();
+    for(const CTrackData::trkpt_t &pt : actData)
+    {
+        const CTrackData::trkpt_t &expPt = *it;
+        const QString &msg = QString("%1: %3 of point %2 differs").arg(act.getName()).arg(pt.idxTotal);
+
+        SUBVERIFY(isBitIdentical(expPt.distance, pt.distance), msg.arg("distance"));
+        SUBVERIFY(isBitIdentical(expPt.ascent, pt.ascent), msg.arg("ascent"));
+        SUBVERIFY(isBitIdentical(expPt.descent, pt.descent), msg.arg("descent"));
+        SUBVERIFY(isBitIdentical(expPt.slope1, pt.slope1), msg.arg("slope1"));
+        SUBVERIFY(isBitIdentical(expPt.slope2, pt.slope2), msg.arg("slope2"));
+        SUBVERIFY(isBitIdentical(expPt.speed, pt.speed), msg.arg("speed"));
+        SUBVERIFY(expPt.valid == pt.valid, msg.arg("valid"));
+        ++it;
+    }
+    SUBVERIFY(it == expData.end(), "Number of points differs");
+
+    SUBVERIFY(isBitIdentical(exp.getTotalAscent(), act.getTotalAscent()), "Total ascent differs");
+    SUBVERIFY(isBitIdentical(exp.getTotalDescent(), act.getTotalDescent()), "Total descent differs");
+    VERIFY_EQUAL(exp.getAllValidFlags(), act.getAllValidFlags());
+    VERIFY_EQUAL(exp.getNumberOfInvalidPoints(), act.getNumberOfInvalidPoints());
+
+    QString expSummary, actSummary;
+    exp.getActivities().printSummary(expSummary);
+    act.getActivities().printSummary(actSummary);
+    VERIFY_EQUAL(expSummary, actSummary);
+
+    for(const QString &source : {CKnownExtension::internalEle, CKnownExtension::internalSlope, CKnownExtension::internalSpeedDist, CKnownExtension::internalProgress})
+    {
+        SUBVERIFY(isBitIdentical(exp.getMin(source), act.getMin(source)), QString("Minimum of %1 differs").arg(source));
+        SUBVERIFY(isBitIdentical(exp.getMax(source), act.getMax(source)), QString("Maximum of %1 differs").arg(source));
+    }
+}
+
+void test_QMapShack::_deriveSecondaryDataRange()
+{
+    for(const QString &file : inputFiles)
+    {
+        IGisProject *proj = readProjFile(file);
+
+        const int N = proj->childCount();
+        for(int i = 0; i < N; i++)
+        {
+            CGisItemTrk *trk = dynamic_cast<CGisItemTrk*>(proj->child(i));
+            if(nullptr == trk)
+            {
+                continue;
+            }
+
+            const int cnt = trk->getCntTotalPoints();
+            const QList<int> indices = {cnt / 2, cnt - 1, 1, cnt / 3, cnt / 2 + 1};
+            for(int idx : indices)
+            {
+                if(idx < 0 || idx >= cnt)
+                {
+                    continue;
+                }
+
+                // the start point is the reference of all others and needs a full update
+                const CTrackData::trkpt_t *trkpt = trk->getTrackData().getTrkPtByTotalIndex(idx);
+                const bool isStart = (trkpt != nullptr) && (trkpt->idxVisible == 0);
+
+                for(qint32 ele : {1234, NOINT, 100})
+                {
+                    quint32 full1, range1, full2, range2;
+                    trk->getDeriveStatistics(full1, range1);
+                    const bool isChange = (trkpt != nullptr) && (trkpt->ele != ele);
+
+                    // the track updates the range around the point only
+                    trk->setElevation(idx, ele);
+
+                    trk->getDeriveStatistics(full2, range2);
+                    if(isChange)
+                    {
+                        VERIFY_EQUAL(full1 + (isStart ? 1 : 0), full2);
+                        VERIFY_EQUAL(range1 + (isStart ? 0 : 1), range2);
+                    }
+
+                    // a copy is updated from scratch
+                    CGisItemTrk *ref = new CGisItemTrk(trk->getName(), 0, NOINT, trk->getTrackData(), proj);
+                    verifySecondaryData(*ref, *trk);
+                    delete ref;
+                }
+            }
+        }
+
+        delete proj;
+    }
+}
@@ -20,6 +20,10 @@
 #include "test_QMapShack.h"
 
 #include "gis/gpx/CGpxProject.h"
+#include "gis/trk/CGisItemTrk.h"
+
+#include <QtXml>
+#include <functional>
 
 void test_QMapShack::writeReadGpxFile(const QString &file)
 {
@@ -47,3 +51,100 @@ void test_QMapShack::_writeReadGpxFile()
     writeReadGpxFile("V1.6.0_file2.qms");
 }
 
+
+static CGpxProject* loadGpx(const QString &file)
+{
+    CGpxProject *proj = new CGpxProject("a very random string to prevent loading via constructor", (CGisListWks*) nullptr);
+    proj->blockUpdateItems(true);
+    CGpxProject::loadGpx(file, proj);
+    proj->blockUpdateItems(false);
+    return proj;
+}
+
+static CGisItemTrk* getTrack(IGisProject *proj)
+{
+    for(int i = 0; i < proj->childCount(); i++)
+    {
+        CGisItemTrk *trk = dynamic_cast<CGisItemTrk*>(proj->child(i));
+        if(trk != nullptr)
+        {
+            return trk;
+        }
+    }
+    return nullptr;
+}
+
+void test_QMapShack::_benchmarkGpxLoad()
+{
+    // the examples shipped with QMapShack
+    const QDir dirExamples(testInput + "/GpxExamples");
+    const QStringList &examples = dirExamples.entryList({"*.gpx"}, QDir::Files);
+    SUBVERIFY(!examples.isEmpty(), "No GPX examples found");
+    for(const QString &example : examples)
+    {
+        IGisProject *proj = loadGpx(dirExamples.filePath(example));
+        SUBVERIFY(proj->isValid(), QString("Failed to load %1").arg(example));
+        SUBVERIFY(getTrack(proj) != nullptr, QString("No track in %1").arg(example));
+        delete proj;
+    }
+
+    // a large recording with Garmin TPX1 extensions, text split by an entity and CDATA
+    const int N = 100000;
+    const QString &tmpFile = TestHelper::getTempFileName("gpx");
+    {
+        QFile file(tmpFile);
+        SUBVERIFY(file.open(QIODevice::WriteOnly), "Failed to create GPX file");
+        QTextStream out(&file);
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<gpx version=\"1.1\" creator=\"test\" xmlns=\"http://www.topografix.com/GPX/1/1\" "
+            << "xmlns:gpxtpx=\"http://www.garmin.com/xmlschemas/TrackPointExtension/v1\">\n"
+            << "<trk><name>Season &amp; more</name><desc><![CDATA[<b>bold</b>]]></desc><trkseg>\n";
+        const QDateTime &start = QDateTime(QDate(2026, 5, 1), QTime(8, 0), Qt::UTC);
+        for(int n = 0; n < N; n++)
+        {
+            out << QString("<trkpt lat=\"%1\" lon=\"%2\"><ele>%3</ele><time>%4</time>")
+                   .arg(47.0 + n * 1e-5, 0, 'f', 8).arg(11.0 + n * 1e-5, 0, 'f', 8)
+                   .arg(500 + n % 100).arg(start.addSecs(n).toString(Qt::ISODate))
+                << QString("<extensions><gpxtpx:TrackPointExtension><gpxtpx:hr>%1</gpxtpx:hr>"
+                           "<gpxtpx:cad>%2</gpxtpx:cad></gpxtpx:TrackPointExtension></extensions></trkpt>\n")
+                   .arg(100 + n % 50).arg(80 + n % 10);
+        }
+        out << "</trkseg></trk>\n</gpx>\n";
+    }
+
+    auto report = [](const QString &name, const std::function<void()> &func)
+                  {
+                      QElapsedTimer timer;
+                      timer.start();
+                      func();
+                      qDebug().noquote() << QString("%1: %2 ms").arg(name, -32).arg(timer.elapsed());
+                  };
+
+    report("DOM, parsing only", [&](){
+        QFile file(tmpFile);
+        file.open(QIODevice::ReadOnly);
+        QDomDocument xml;
+        xml.setContent(&file, false);
+    });
+
+    IGisProject *proj = nullptr;
+    report("stream, complete project", [&](){ proj = loadGpx(tmpFile); });
+    QFile(tmpFile).remove();
+
+    SUBVERIFY(proj->isValid(), "Failed to load large GPX file");
+    const CGisItemTrk *trk = getTrack(proj);
+    SUBVERIFY(trk != nullptr, "No track in large GPX file");
+
+    const CTrackData &data = trk->getTrackData();
+    VERIFY_EQUAL(QString("Season & more"), data.name);
+    VERIFY_EQUAL(QString("<b>bold</b>"), data.desc);
+    VERIFY_EQUAL(1, data.segs.size());
+    VERIFY_EQUAL(N, data.segs[0].pts.size());
+
+    const CTrackData::trkpt_t &pt = data.segs[0].pts[1234];
+    VERIFY_EQUAL(534, pt.ele);
+    SUBVERIFY(QDateTime(QDate(2026, 5, 1), QTime(8, 20, 34), Qt::UTC) == pt.time, "Wrong time of track point");
+    VERIFY_EQUAL(QString("134"), pt.extensions.value("gpxtpx:TrackPointExtension|gpxtpx:hr").toString());
+    VERIFY_EQUAL(QString("84"), pt.extensions.value("gpxtpx:TrackPointExtension|gpxtpx:cad").toString());
+    delete proj;
+}
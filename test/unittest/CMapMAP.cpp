@@ -0,0 +1,151 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/CMapMAP.h"
+
+#include <QtCore>
+
+// abort drawing after a given number of tiles
+class CMapMAPTest : public CMapMAP
+{
+public:
+    CMapMAPTest(const QString &filename) : CMapMAP(filename, nullptr)
+    {
+    }
+
+    bool decode(qint32 nCols, qint32 nRows, qint32 maxTiles, qint32 &nValid)
+    {
+        limit = maxTiles;
+        count = 0;
+
+        const layer_t &layer = layers.first();
+        QVector<tile_t> tiles;
+        const bool success = getTiles(layer, layer.baseZoom, layer.tileX1, layer.tileY1, nCols, nRows, tiles);
+
+        nValid = 0;
+        for(const tile_t &tile : tiles)
+        {
+            nValid += tile.valid ? 1 : 0;
+        }
+        return success;
+    }
+
+    qint32 getColumns() const
+    {
+        return layers.first().tileX2 - layers.first().tileX1 + 1;
+    }
+
+    qint32 getRows() const
+    {
+        return layers.first().tileY2 - layers.first().tileY1 + 1;
+    }
+
+protected:
+    bool needsRedraw() const override
+    {
+        // called before each tile decoded and once after all are done
+        return count.fetchAndAddOrdered(1) >= limit;
+    }
+
+private:
+    qint32 limit = NOINT;
+    mutable QAtomicInt count = 0;
+};
+
+// a Mapsforge file with a single sub-file of empty tiles
+static void writeMapFile(const QString &filename)
+{
+    const quint64 offsetSubFile = 256;
+    const quint64 nEntries = 100;
+
+    QFile file(filename);
+    file.open(QIODevice::WriteOnly);
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    stream.writeRawData("mapsforge binary OSM", 20);
+    stream << quint32(0) << quint32(3) << quint64(0) << quint64(0);
+    stream << qint32(48000000) << qint32(11000000) << qint32(48050000) << qint32(11100000);
+    stream << quint16(256);
+    stream << quint8(8);
+    stream.writeRawData("Mercator", 8);
+    stream << quint8(0);
+    stream << quint16(0) << quint16(0);
+    stream << quint8(1);
+    stream << quint8(14) << quint8(12) << quint8(16) << offsetSubFile << quint64(5 * nEntries);
+
+    while(quint64(file.pos()) < offsetSubFile)
+    {
+        stream << quint8(0);
+    }
+
+    // all entries point to the end of the sub-file: all tiles are empty
+    for(quint64 n = 0; n < nEntries; n++)
+    {
+        stream << quint8(0) << quint32(5 * nEntries);
+    }
+}
+
+void test_QMapShack::_cacheDecodedMapTiles()
+{
+    const QString &filename = TestHelper::getTempFileName("map");
+    writeMapFile(filename);
+
+    {
+        CMapMAPTest map(filename);
+        SUBVERIFY(map.getColumns() >= 3 && map.getRows() >= 2, "Map too small");
+
+        quint64 hits, misses;
+        qint32 usedKB;
+        qint32 nValid;
+
+        // drawing is aborted after two tiles of three, e.g. while panning
+        SUBVERIFY(!map.decode(3, 1, 2, nValid), "Decoding not aborted");
+        VERIFY_EQUAL(2, nValid);
+        map.getDecodeCacheStatistics(hits, misses, usedKB);
+        VERIFY_EQUAL(quint64(0), hits);
+        VERIFY_EQUAL(quint64(3), misses);
+
+        // the tiles decoded before the abort are taken from the cache
+        SUBVERIFY(map.decode(3, 1, NOINT, nValid), "Decoding aborted");
+        VERIFY_EQUAL(3, nValid);
+        map.getDecodeCacheStatistics(hits, misses, usedKB);
+        VERIFY_EQUAL(quint64(2), hits);
+        VERIFY_EQUAL(quint64(4), misses);
+
+        // the view grows by a row
+        SUBVERIFY(map.decode(3, 2, NOINT, nValid), "Decoding aborted");
+        VERIFY_EQUAL(6, nValid);
+        map.getDecodeCacheStatistics(hits, misses, usedKB);
+        VERIFY_EQUAL(quint64(5), hits);
+        VERIFY_EQUAL(quint64(7), misses);
+
+        // everything is cached now, the only check for a redraw is the final one
+        SUBVERIFY(map.decode(3, 2, 1, nValid), "Decoding aborted");
+        VERIFY_EQUAL(6, nValid);
+        map.getDecodeCacheStatistics(hits, misses, usedKB);
+        VERIFY_EQUAL(quint64(11), hits);
+        VERIFY_EQUAL(quint64(7), misses);
+        SUBVERIFY(usedKB > 0, "Cache is empty");
+    }
+
+    QFile(filename).remove();
+}
@@ -0,0 +1,106 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "test_QMapShack.h"
+
+#include "helpers/COccupancyGrid.h"
+#include "units/IUnit.h"
+
+#include <QtTest>
+
+// the first rectangle of the list intersecting with rect, like the placement of labels did before
+static int findFirstLinear(const QList<QRectF> &rects, const QRectF &rect)
+{
+    for(int i = 0; i < rects.size(); i++)
+    {
+        if(rects[i].intersects(rect))
+        {
+            return i;
+        }
+    }
+    return NOIDX;
+}
+
+void test_QMapShack::_placeLabels()
+{
+    QRandomGenerator rnd(42);
+    auto randomRect = [&rnd](qreal maxSize)
+    {
+        return QRectF(rnd.bounded(2200.0) - 200, rnd.bounded(1400.0) - 200, rnd.bounded(maxSize), rnd.bounded(maxSize));
+    };
+
+    // place labels like the workspace does, plus some large and degenerated areas
+    COccupancyGrid grid;
+    QList<QRectF> rects;
+    for(int n = 0; n < 20000; n++)
+    {
+        QRectF rect = randomRect(80);
+        if(n % 1000 == 0)
+        {
+            rect = randomRect(3000);
+        }
+        else if(n % 1000 == 1)
+        {
+            rect.setWidth(0);
+        }
+        else if(n % 1000 == 2)
+        {
+            rect = QRectF(rect.bottomRight(), rect.topLeft());
+        }
+
+        const int idx = findFirstLinear(rects, rect);
+        VERIFY_EQUAL(idx, grid.findFirst(rect));
+        SUBVERIFY((idx != NOIDX) == grid.intersects(rect), "intersects() does not match findFirst()");
+
+        if(idx == NOIDX || n % 3 == 0)
+        {
+            VERIFY_EQUAL(rects.size(), grid.add(rect));
+            rects << rect;
+        }
+    }
+    VERIFY_EQUAL(rects.size(), grid.size());
+
+    // areas far outside the screen
+    for(const QRectF &rect : {QRectF(-1e12, -1e12, 10, 10), QRectF(1e12, 0, 1e13, 10), QRectF(0, 0, 1e6, 1e6)})
+    {
+        VERIFY_EQUAL(findFirstLinear(rects, rect), grid.findFirst(rect));
+    }
+
+    // the time of a test must not depend on the number of labels
+    const int N = 10000;
+    QElapsedTimer timer;
+    timer.start();
+    for(int n = 0; n < N; n++)
+    {
+        grid.intersects(randomRect(80));
+    }
+    const qint64 nsGrid = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int n = 0; n < N; n++)
+    {
+        findFirstLinear(rects, randomRect(80));
+    }
+    const qint64 nsLinear = timer.nsecsElapsed();
+
+    qDebug() << "Testing" << N << "labels against" << rects.size() << "placed ones took" << nsGrid / 1000 << "us with the grid and" << nsLinear / 1000 << "us with a list";
+
+    grid.clear();
+    SUBVERIFY(grid.isEmpty(), "Grid not empty after clear()");
+    SUBVERIFY(!grid.intersects(rects.first()), "Area found after clear()");
+}
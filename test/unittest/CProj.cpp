@@ -0,0 +1,149 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/proj_x.h"
+
+#include <QtCore>
+
+// the same as EPSG:4326 but not detected as such, thus always handled by libproj
+static const QString strLonLatProj = "+proj=longlat +datum=WGS84 +no_defs";
+
+static QPolygonF createLonLatGrid(int N)
+{
+    QPolygonF line;
+    line.reserve(N * N);
+    for(int i = 0; i < N; i++)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            line << QPointF((-179.9 + 359.8 * i / (N - 1)) * DEG_TO_RAD, (-85.0 + 170.0 * j / (N - 1)) * DEG_TO_RAD);
+        }
+    }
+    return line;
+}
+
+static void verifyClose(const QPolygonF &exp, const QPolygonF &act, qreal tolerance)
+{
+    VERIFY_EQUAL(exp.size(), act.size());
+    for(int i = 0; i < exp.size(); i++)
+    {
+        const QPointF &d = exp[i] - act[i];
+        SUBVERIFY(qAbs(d.x()) <= tolerance && qAbs(d.y()) <= tolerance,
+                  QString("Point %1 differs by %2/%3").arg(i).arg(d.x()).arg(d.y()));
+    }
+}
+
+void test_QMapShack::_projectWebMercator()
+{
+    CProj projFast("EPSG:3857", "EPSG:4326");
+    CProj projLib("EPSG:3857", strLonLatProj);
+
+    SUBVERIFY(projFast.hasFastPath(), "EPSG:3857 -> EPSG:4326 has to use the analytic path");
+    SUBVERIFY(!projLib.hasFastPath(), "Other projections have to use libproj");
+
+    const QPolygonF &lonlat = createLonLatGrid(100);
+
+    // [rad] -> [m]
+    QPolygonF fastM = lonlat;
+    QPolygonF libM = lonlat;
+    projFast.transform(fastM, PJ_INV);
+    projLib.transform(libM, PJ_INV);
+    verifyClose(libM, fastM, 1e-6);
+
+    // [m] -> [rad]
+    QPolygonF fastRad = libM;
+    QPolygonF libRad = libM;
+    projFast.transform(fastRad, PJ_FWD);
+    projLib.transform(libRad, PJ_FWD);
+    verifyClose(libRad, fastRad, 1e-12);
+    verifyClose(lonlat, fastRad, 1e-12);
+
+    // the longitude is wrapped around like libproj does
+    QPointF east(190 * DEG_TO_RAD, 45 * DEG_TO_RAD);
+    QPointF west(-170 * DEG_TO_RAD, 45 * DEG_TO_RAD);
+    projFast.transform(east, PJ_INV);
+    projFast.transform(west, PJ_INV);
+    verifyClose(QPolygonF() << west, QPolygonF() << east, 1e-6);
+
+    // the date line itself is not wrapped
+    QPointF dateLine(180 * DEG_TO_RAD, 0);
+    projFast.transform(dateLine, PJ_INV);
+    SUBVERIFY(dateLine.x() > 0, "Longitude of 180° must not be wrapped");
+
+    // the reverse pair is detected, too
+    CProj projFastRev("EPSG:4326", "EPSG:3857");
+    SUBVERIFY(projFastRev.hasFastPath(), "EPSG:4326 -> EPSG:3857 has to use the analytic path");
+    QPolygonF revM = lonlat;
+    projFastRev.transform(revM, PJ_FWD);
+    verifyClose(fastM, revM, 1e-9);
+}
+
+void test_QMapShack::_projectBatch()
+{
+    // the batch has to yield the very same result as transforming point by point
+    CProj proj("+proj=utm +zone=32 +datum=WGS84 +units=m +no_defs", "EPSG:4326");
+    SUBVERIFY(!proj.hasFastPath(), "UTM must not use the analytic path");
+
+    QPolygonF lonlat;
+    for(int i = 0; i < 1000; i++)
+    {
+        lonlat << QPointF((6.0 + 6.0 * i / 1000) * DEG_TO_RAD, (30.0 + 40.0 * i / 1000) * DEG_TO_RAD);
+    }
+
+    QPolygonF batch = lonlat;
+    proj.transform(batch, PJ_INV);
+
+    QPolygonF single = lonlat;
+    for(QPointF &pt : single)
+    {
+        proj.transform(pt, PJ_INV);
+    }
+
+    verifyClose(single, batch, 0);
+}
+
+void test_QMapShack::_benchmarkProjection()
+{
+    const QPolygonF &lonlat = createLonLatGrid(1000);
+    const int N = lonlat.size();
+
+    CProj projFast("EPSG:3857", "EPSG:4326");
+    CProj projLib("EPSG:3857", strLonLatProj);
+
+    auto report = [N](const QString &name, const std::function<void(QPolygonF&)> &func, const QPolygonF &input)
+                  {
+                      QPolygonF line = input;
+                      QElapsedTimer timer;
+                      timer.start();
+                      func(line);
+                      const qreal sec = qMax(qint64(1), timer.nsecsElapsed()) / 1e9;
+                      qDebug().noquote() << QString("%1: %2 points/s").arg(name, -32).arg(N / sec, 0, 'f', 0);
+                  };
+
+    report("libproj point by point", [&](QPolygonF &line){
+        for(QPointF &pt : line)
+        {
+            projLib.transform(pt, PJ_INV);
+        }
+    }, lonlat);
+    report("libproj batch", [&](QPolygonF &line){ projLib.transform(line, PJ_INV); }, lonlat);
+    report("analytic Web Mercator", [&](QPolygonF &line){ projFast.transform(line, PJ_INV); }, lonlat);
+}
@@ -0,0 +1,170 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/CGisListWks.h"
+#include "gis/prj/CProjectLoader.h"
+#include "gis/prj/IGisProject.h"
+#include "gis/trk/CGisItemTrk.h"
+#include "gis/wpt/CGisItemWpt.h"
+
+#include <QtTest>
+
+/*
+    Compare a project loaded by a worker thread with the same project
+    loaded by the GUI thread item by item.
+ */
+static void compareProjects(const IGisProject &exp, const IGisProject &act)
+{
+    VERIFY_EQUAL(exp.getName(), act.getName());
+    VERIFY_EQUAL(exp.childCount(), act.childCount());
+    VERIFY_EQUAL(exp.getItemCountByType(IGisItem::eTypeTrk), act.getItemCountByType(IGisItem::eTypeTrk));
+    VERIFY_EQUAL(exp.getItemCountByType(IGisItem::eTypeWpt), act.getItemCountByType(IGisItem::eTypeWpt));
+    VERIFY_EQUAL(exp.getTotalDistance(), act.getTotalDistance());
+
+    for(int i = 0; i < exp.childCount(); i++)
+    {
+        const IGisItem *expItem = dynamic_cast<const IGisItem*>(exp.child(i));
+        const IGisItem *actItem = dynamic_cast<const IGisItem*>(act.child(i));
+        SUBVERIFY((expItem != nullptr) == (actItem != nullptr), QString("Item %1 differs").arg(i));
+        if(expItem == nullptr)
+        {
+            continue;
+        }
+
+        const QString &msg = QString("%1: %3 of item %2 differs").arg(act.getName()).arg(i);
+        SUBVERIFY(expItem->getName() == actItem->getName(), msg.arg("name"));
+        SUBVERIFY(expItem->getKey().item == actItem->getKey().item, msg.arg("key"));
+        SUBVERIFY(expItem->getBoundingRect() == actItem->getBoundingRect(), msg.arg("bounding box"));
+        SUBVERIFY(expItem->getIcon().size() == actItem->getIcon().size(), msg.arg("icon"));
+
+        const CGisItemTrk *expTrk = dynamic_cast<const CGisItemTrk*>(expItem);
+        const CGisItemTrk *actTrk = dynamic_cast<const CGisItemTrk*>(actItem);
+        if(expTrk != nullptr && actTrk != nullptr)
+        {
+            SUBVERIFY(expTrk->getCntTotalPoints() == actTrk->getCntTotalPoints(), msg.arg("number of points"));
+            SUBVERIFY(expTrk->getTotalDistance() == actTrk->getTotalDistance(), msg.arg("distance"));
+            SUBVERIFY(expTrk->getTotalAscent() == actTrk->getTotalAscent(), msg.arg("ascent"));
+            SUBVERIFY(expTrk->getTotalDescent() == actTrk->getTotalDescent(), msg.arg("descent"));
+        }
+
+        const CGisItemWpt *expWpt = dynamic_cast<const CGisItemWpt*>(expItem);
+        const CGisItemWpt *actWpt = dynamic_cast<const CGisItemWpt*>(actItem);
+        if(expWpt != nullptr && actWpt != nullptr)
+        {
+            SUBVERIFY(expWpt->getPosition() == actWpt->getPosition(), msg.arg("position"));
+            SUBVERIFY(expWpt->getIconName() == actWpt->getIconName(), msg.arg("icon name"));
+        }
+    }
+}
+
+void test_QMapShack::_loadProjectsInParallel()
+{
+    // the input files with expected results and the examples shipped with QMapShack
+    QStringList filenames;
+    QStringList expected;
+    for(const QString &suffix : {"gpx", "fit", "slf", "qms"})
+    {
+        const QDir dir(testInput + "/" + suffix);
+        for(const QString &file : dir.entryList({"*." + suffix}, QDir::Files))
+        {
+            filenames << dir.filePath(file);
+            expected << file;
+        }
+    }
+
+    const QDir dirExamples(testInput + "/GpxExamples");
+    for(const QString &file : dirExamples.entryList({"*.gpx"}, QDir::Files))
+    {
+        filenames << dirExamples.filePath(file);
+        expected << QString();
+    }
+
+    // a file that fails to load
+    const QString &tmpFile = TestHelper::getTempFileName("gpx");
+    {
+        QFile file(tmpFile);
+        SUBVERIFY(file.open(QIODevice::WriteOnly), "Failed to create GPX file");
+        file.write("<gpx><trk><trkseg><trkpt lat=\"47\" lon=\"11\"></trk></gpx>");
+    }
+    filenames << tmpFile;
+    expected << QString();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<CProjectLoader::result_t> results;
+    {
+        CProjectLoader loader(filenames);
+        bool finished = false;
+        while(!finished)
+        {
+            finished = loader.waitForDone(10);
+            results << loader.takeResults();
+        }
+        SUBVERIFY(loader.takeResults().isEmpty(), "Results left after all files are done");
+    }
+    const qint64 msParallel = timer.elapsed();
+
+    VERIFY_EQUAL(filenames.size(), results.size());
+
+    qint64 msSequential = 0;
+    for(int n = 0; n < results.size(); n++)
+    {
+        const CProjectLoader::result_t &result = results[n];
+        VERIFY_EQUAL(filenames[n], result.filename);
+
+        IGisProject *project = result.project;
+        if(!CProjectLoader::isThreadSafe(result.filename))
+        {
+            SUBVERIFY(!result.loaded && (project == nullptr), QString("%1 loaded by a thread").arg(result.filename));
+            continue;
+        }
+        SUBVERIFY(result.loaded, QString("%1 not loaded").arg(result.filename));
+
+        if(result.filename == tmpFile)
+        {
+            SUBVERIFY(project == nullptr, "Invalid file loaded");
+            continue;
+        }
+        SUBVERIFY(project != nullptr, QString("Failed to load %1").arg(result.filename));
+
+        if(!expected[n].isEmpty())
+        {
+            verify(expected[n], *project);
+        }
+
+        // compare with the project loaded by the GUI thread
+        timer.restart();
+        IGisProject *reference = IGisProject::create(result.filename, (CGisListWks*) nullptr);
+        msSequential += timer.elapsed();
+
+        SUBVERIFY(reference != nullptr, QString("Failed to load %1").arg(result.filename));
+        compareProjects(*reference, *project);
+
+        delete reference;
+        delete project;
+    }
+
+    qDebug() << "Loading" << filenames.size() << "files took" << msParallel << "ms in parallel";
+    qDebug() << "Loading the same files one after another took" << msSequential << "ms";
+
+    QFile::remove(tmpFile);
+}
@@ -23,6 +23,7 @@
 
 #include "gis/gpx/CGpxProject.h"
 #include "gis/qms/CQmsProject.h"
+#include "gis/qms/CTrackCodec.h"
 
 void test_QMapShack::_readQmsFile_1_6_0()
 {
@@ -55,3 +56,285 @@ void test_QMapShack::_writeReadQmsFile()
     }
 }
 
+
+void test_QMapShack::_writeReadQmsFileCompression()
+{
+    const IGisItem::compression_e previous = IGisItem::getCompression();
+    const QList<IGisItem::compression_e> levels = {
+        IGisItem::eCompressionNone, IGisItem::eCompressionFast, IGisItem::eCompressionBest
+    };
+
+    // keys and hashes of items by file, they must not depend on the compression
+    QHash<QString, QStringList> keysByFile;
+    QHash<QString, QStringList> hashesByFile;
+
+    for(IGisItem::compression_e level : levels)
+    {
+        IGisItem::setCompression(level);
+
+        for(const QString &file : inputFiles)
+        {
+            IGisProject *proj = readProjFile(file);
+
+            QStringList keys, hashes;
+            const int N = proj->childCount();
+            for(int i = 0; i < N; i++)
+            {
+                IGisItem *item = dynamic_cast<IGisItem*>(proj->child(i));
+                if(nullptr != item)
+                {
+                    keys << item->getKey().item;
+                    hashes << item->getHash();
+                }
+            }
+
+            if(keysByFile.contains(file))
+            {
+                SUBVERIFY(keysByFile[file] == keys, QString("%1: keys depend on the compression").arg(file));
+                SUBVERIFY(hashesByFile[file] == hashes, QString("%1: hashes depend on the compression").arg(file));
+            }
+            else
+            {
+                keysByFile[file] = keys;
+                hashesByFile[file] = hashes;
+            }
+
+            QString tmpFile = TestHelper::getTempFileName("qms");
+            CQmsProject::saveAs(tmpFile, *proj);
+
+            delete proj;
+
+            proj = readProjFile(tmpFile, true, false);
+            verify(file, *proj);
+
+            delete proj;
+
+            QFile(tmpFile).remove();
+        }
+    }
+
+    IGisItem::setCompression(previous);
+}
+
+static QByteArray encode(const QVector<CTrackData::trkseg_t> &segs)
+{
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setVersion(QDataStream::Qt_5_2);
+    CTrackCodec::encode(segs, stream);
+    return buffer;
+}
+
+static bool decode(const QByteArray &buffer, QVector<CTrackData::trkseg_t> &segs)
+{
+    QDataStream stream(buffer);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setVersion(QDataStream::Qt_5_2);
+    return CTrackCodec::decode(stream, segs);
+}
+
+static void verifyTrkpt(const CTrackData::trkpt_t &exp, const CTrackData::trkpt_t &act, const QString &msg)
+{
+    SUBVERIFY(exp.flags == act.flags, msg);
+    SUBVERIFY(exp.activity == act.activity, msg);
+    SUBVERIFY(exp.lon == act.lon, msg);
+    SUBVERIFY(exp.lat == act.lat, msg);
+    VERIFY_EQUAL(exp.ele, act.ele);
+    SUBVERIFY(exp.time == act.time, msg);
+    SUBVERIFY(exp.time.timeSpec() == act.time.timeSpec(), msg);
+    VERIFY_EQUAL(exp.magvar, act.magvar);
+    VERIFY_EQUAL(exp.geoidheight, act.geoidheight);
+    VERIFY_EQUAL(exp.name, act.name);
+    VERIFY_EQUAL(exp.cmt, act.cmt);
+    VERIFY_EQUAL(exp.desc, act.desc);
+    VERIFY_EQUAL(exp.src, act.src);
+    VERIFY_EQUAL(exp.sym, act.sym);
+    VERIFY_EQUAL(exp.type, act.type);
+    VERIFY_EQUAL(exp.fix, act.fix);
+    VERIFY_EQUAL(exp.sat, act.sat);
+    VERIFY_EQUAL(exp.hdop, act.hdop);
+    VERIFY_EQUAL(exp.vdop, act.vdop);
+    VERIFY_EQUAL(exp.pdop, act.pdop);
+    VERIFY_EQUAL(exp.ageofdgpsdata, act.ageofdgpsdata);
+    VERIFY_EQUAL(exp.dgpsid, act.dgpsid);
+
+    VERIFY_EQUAL(exp.links.size(), act.links.size());
+    for(int i = 0; i < exp.links.size(); i++)
+    {
+        SUBVERIFY(exp.links[i].uri == act.links[i].uri, msg);
+        VERIFY_EQUAL(exp.links[i].text, act.links[i].text);
+        VERIFY_EQUAL(exp.links[i].type, act.links[i].type);
+    }
+
+    SUBVERIFY(exp.extensions == act.extensions, msg);
+    for(const QString &key : exp.extensions.keys())
+    {
+        SUBVERIFY(exp.extensions[key].userType() == act.extensions[key].userType(), msg);
+    }
+}
+
+void test_QMapShack::_encodeDecodeTrack()
+{
+    using trkpt_t = CTrackData::trkpt_t;
+
+    QVector<CTrackData::trkseg_t> segs(3);
+
+    // decimal coordinates, UTC time and elevation as read from a GPX file
+    trkpt_t pt1;
+    pt1.lon = 11.1234567;
+    pt1.lat = 48.7654321;
+    pt1.ele = 512;
+    pt1.time = QDateTime(QDate(2020, 5, 17), QTime(10, 15, 30, 250), Qt::UTC);
+    segs[0].pts << pt1;
+
+    // coordinates converted from semicircles, local time, no elevation and all GPX tags
+    trkpt_t pt2;
+    pt2.lon = 11.0 + 1.0 / 3.0;
+    pt2.lat = 568205123 * (180.0 / 2147483648.0);
+    pt2.time = QDateTime(QDate(2020, 5, 17), QTime(12, 0), Qt::LocalTime);
+    pt2.magvar = 3;
+    pt2.geoidheight = 47;
+    pt2.name = "name";
+    pt2.cmt = "comment";
+    pt2.desc = "description";
+    pt2.src = "source";
+    pt2.links << IGisItem::link_t{QUrl("https://www.qmapshack.org"), "QMapShack", "text/html"};
+    pt2.links << IGisItem::link_t{QUrl("file:///tmp/image.jpg"), "", "image/jpeg"};
+    pt2.sym = "Flag, Blue";
+    pt2.type = "type";
+    pt2.fix = "3d";
+    pt2.sat = 9;
+    pt2.hdop = 1;
+    pt2.vdop = 2;
+    pt2.pdop = 3;
+    pt2.ageofdgpsdata = 4;
+    pt2.dgpsid = 5;
+    segs[0].pts << pt2;
+
+    // no time, start of an activity and extensions of all kinds of types
+    trkpt_t pt3;
+    pt3.lon = -122.4194;
+    pt3.lat = 37.7749;
+    pt3.ele = -20;
+    pt3.setAct(trkpt_t::eAct20Cycle);
+    pt3.setActivityFlag();
+    pt3.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] = 120;
+    pt3.extensions["gpxdata:temp"] = 21.5;
+    pt3.extensions["gpxtpx:TrackPointExtension|gpxtpx:cad"] = QString("85");
+    pt3.extensions["ext:date"] = QDate(2020, 5, 17);
+    segs[0].pts << pt3;
+
+    // the second segment is empty, the third one goes back in time and hides a point
+    const QDateTime start = QDateTime(QDate(2021, 1, 1), QTime(0, 0), Qt::UTC);
+    for(int i = 0; i < 100; i++)
+    {
+        trkpt_t pt;
+        pt.lon = -0.5 + 0.00001 * i;
+        pt.lat = 51.5 - 0.0001 * i;
+        pt.ele = (i % 3) ? 10 + i : NOINT;
+        pt.time = start.addMSecs(-1000 * i);
+        if(i == 50)
+        {
+            pt.setFlag(trkpt_t::eFlagHidden);
+        }
+        pt.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] = 100 + i;
+        segs[2].pts << pt;
+    }
+
+    const QByteArray buffer = encode(segs);
+
+    QVector<CTrackData::trkseg_t> result;
+    SUBVERIFY(decode(buffer, result), "Failed to decode track");
+    VERIFY_EQUAL(segs.size(), result.size());
+    for(int s = 0; s < segs.size(); s++)
+    {
+        VERIFY_EQUAL(segs[s].pts.size(), result[s].pts.size());
+        for(int i = 0; i < segs[s].pts.size(); i++)
+        {
+            verifyTrkpt(segs[s].pts[i], result[s].pts[i], QString("Point %1 of segment %2 differs").arg(i).arg(s));
+        }
+    }
+
+    // truncated data is rejected without crashing
+    for(int size = 0; size < buffer.size(); size += 7)
+    {
+        SUBVERIFY(!decode(buffer.left(size), result), QString("Track truncated to %1 bytes decoded").arg(size));
+        SUBVERIFY(result.isEmpty(), "Segments of corrupt track not cleared");
+    }
+
+}
+
+void test_QMapShack::_benchmarkTrackCodec()
+{
+    const int N = 100000;
+
+    QVector<CTrackData::trkseg_t> segs(1);
+    QVector<CTrackData::trkpt_t> &pts = segs.first().pts;
+    pts.reserve(N);
+
+    const QDateTime start = QDateTime(QDate(2021, 1, 1), QTime(0, 0), Qt::UTC);
+    for(int i = 0; i < N; i++)
+    {
+        CTrackData::trkpt_t pt;
+        // coordinates with 7 decimals as in a typical GPX file
+        pt.lon = (110000000 + 100 * i + qRound(30 * qCos(i / 50.0))) / 1e7;
+        pt.lat = (480000000 + qRound(10000 * qSin(i / 100.0))) / 1e7;
+        pt.ele = 500 + i % 100;
+        pt.time = start.addSecs(i);
+        pt.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] = QString::number(120 + i % 50);
+        pts << pt;
+    }
+
+    QElapsedTimer timer;
+
+    // the track points as VER_TRK 7 writes them
+    timer.start();
+    QByteArray bufferOld;
+    {
+        QDataStream stream(&bufferOld, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setVersion(QDataStream::Qt_5_2);
+        stream << pts;
+    }
+    const QByteArray compressedOld = qCompress(bufferOld, IGisItem::eCompressionBest);
+    const qint64 nsecWriteOld = timer.nsecsElapsed();
+
+    timer.restart();
+    QVector<CTrackData::trkpt_t> ptsOld;
+    {
+        QDataStream stream(qUncompress(compressedOld));
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setVersion(QDataStream::Qt_5_2);
+        stream >> ptsOld;
+    }
+    const qint64 nsecReadOld = timer.nsecsElapsed();
+
+    // the track points as VER_TRK 8 writes them by default
+    timer.restart();
+    const QByteArray compressedNew = qCompress(encode(segs), IGisItem::eCompressionFast);
+    const qint64 nsecWriteNew = timer.nsecsElapsed();
+
+    timer.restart();
+    QVector<CTrackData::trkseg_t> segsNew;
+    const bool success = decode(qUncompress(compressedNew), segsNew);
+    const qint64 nsecReadNew = timer.nsecsElapsed();
+
+    SUBVERIFY(success, "Failed to decode track");
+    VERIFY_EQUAL(N, ptsOld.size());
+    VERIFY_EQUAL(N, segsNew.first().pts.size());
+
+    auto report = [](const QString &name, qint64 bytes, qint64 nsecWrite, qint64 nsecRead)
+                  {
+                      qDebug().noquote() << QString("%1: %2 bytes/point, write %3 points/s, read %4 points/s")
+                          .arg(name, -12)
+                          .arg(qreal(bytes) / N, 0, 'f', 2)
+                          .arg(N / (qMax(qint64(1), nsecWrite) / 1e9), 0, 'f', 0)
+                          .arg(N / (qMax(qint64(1), nsecRead) / 1e9), 0, 'f', 0);
+                  };
+
+    report("records", compressedOld.size(), nsecWriteOld, nsecReadOld);
+    report("columns", compressedNew.size(), nsecWriteNew, nsecReadNew);
+
+    SUBVERIFY(compressedNew.size() < compressedOld.size(), "Encoded track is larger than the records");
+}
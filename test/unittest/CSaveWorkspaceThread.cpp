@@ -0,0 +1,184 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "test_QMapShack.h"
+
+#include "gis/CSaveWorkspaceThread.h"
+
+#include <QtSql>
+#include <QtTest>
+
+typedef CSaveWorkspaceThread::project_t project_t;
+typedef CSaveWorkspaceThread::snapshot_t snapshot_t;
+
+// a row of the workspace table
+struct row_t
+{
+    QString key;
+    qint32 pos;
+    QByteArray data;
+};
+
+// the tables of workspace.db as created by CGisListWks::initDB()
+static void createWorkspace(QSqlDatabase &db)
+{
+    SUBVERIFY(db.open(), "Failed to open workspace database");
+    QSqlQuery query(db);
+    SUBVERIFY(query.exec("CREATE TABLE workspace (id INTEGER PRIMARY KEY AUTOINCREMENT, type INTEGER NOT NULL, name TEXT NOT NULL, "
+                         "keyqms TEXT NOT NULL, changed BOOLEAN DEFAULT FALSE, visible BOOLEAN DEFAULT TRUE, pos INTEGER DEFAULT 0, "
+                         "data BLOB NOT NULL)"), query.lastError().text());
+    SUBVERIFY(query.exec("CREATE TABLE userfocus ( focus TEXT )"), query.lastError().text());
+    SUBVERIFY(query.exec("INSERT INTO userfocus (focus) VALUES('')"), query.lastError().text());
+
+    // a project closed before the first save and one not restored yet
+    SUBVERIFY(query.exec("INSERT INTO workspace (type, keyqms, name, pos, data) VALUES (0, 'X', 'X', 0, 'closed')"), query.lastError().text());
+    SUBVERIFY(query.exec("INSERT INTO workspace (type, keyqms, name, pos, data) VALUES (0, 'K', 'K', 100, 'kept')"), query.lastError().text());
+    db.close();
+}
+
+// all rows in the order of the workspace, the database must not be used by a CSaveWorkspaceThread
+static QList<row_t> readWorkspace(QSqlDatabase &db, QString &focus)
+{
+    SUBVERIFY(db.open(), "Failed to open workspace database");
+    QList<row_t> rows;
+    QSqlQuery query(db);
+    SUBVERIFY(query.exec("SELECT keyqms, pos, data FROM workspace ORDER BY pos"), query.lastError().text());
+    while(query.next())
+    {
+        rows << row_t{query.value(0).toString(), query.value(1).toInt(), query.value(2).toByteArray()};
+    }
+    SUBVERIFY(query.exec("SELECT focus FROM userfocus") && query.next(), "No user focus");
+    focus = query.value(0).toString();
+    query.finish();
+    db.close();
+    return rows;
+}
+
+static void verifyWorkspace(QSqlDatabase &db, const QList<row_t> &expected, const QString &expectedFocus)
+{
+    QString focus;
+    const QList<row_t> &rows = readWorkspace(db, focus);
+    VERIFY_EQUAL(expectedFocus, focus);
+    VERIFY_EQUAL(expected.size(), rows.size());
+    for(int n = 0; n < rows.size(); n++)
+    {
+        VERIFY_EQUAL(expected[n].key, rows[n].key);
+        VERIFY_EQUAL(expected[n].pos, rows[n].pos);
+        SUBVERIFY(expected[n].data == rows[n].data, QString("Wrong data of project %1").arg(rows[n].key));
+    }
+}
+
+// the entry of a snapshot like CGisListWks::slotSaveWorkspace() creates it
+static project_t createProject(const CSaveWorkspaceThread &saver, const QString &key, const QByteArray &data)
+{
+    project_t project;
+    project.key = key;
+    project.name = key;
+    project.fingerprint = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+    if(!saver.isSaved(project.key, project.fingerprint))
+    {
+        project.data = data;
+    }
+    return project;
+}
+
+void test_QMapShack::_saveWorkspaceSnapshots()
+{
+    QTemporaryDir tmpDir;
+    SUBVERIFY(tmpDir.isValid(), "Failed to create temporary directory");
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "TestWorkspace");
+        db.setDatabaseName(QDir(tmpDir.path()).absoluteFilePath("workspace.db"));
+        createWorkspace(db);
+
+        // a full write replaces all rows but the ones to keep
+        CSaveWorkspaceThread *saver = new CSaveWorkspaceThread(db, nullptr);
+        snapshot_t snapshot;
+        snapshot.full = true;
+        snapshot.keep = {"K"};
+        snapshot.userFocus = "B";
+        snapshot.projects << createProject(*saver, "A", "data A") << createProject(*saver, "B", "data B") << createProject(*saver, "C", "data C");
+        saver->save(snapshot);
+        // the data is in the database as soon as the queued snapshot has been written
+        SUBVERIFY(saver->isSaved("A", snapshot.projects[0].fingerprint), "Project of queued snapshot not saved");
+        saver->flush();
+        delete saver;
+        verifyWorkspace(db, {{"A", 0, "data A"}, {"B", 1, "data B"}, {"C", 2, "data C"}, {"K", 100, "kept"}}, "B");
+
+        // only changed projects are written, closed ones are deleted and all others are moved to their position
+        saver = new CSaveWorkspaceThread(db, nullptr);
+        saver->setSaved("A", QCryptographicHash::hash("data A", QCryptographicHash::Md5));
+        saver->setSaved("B", QCryptographicHash::hash("data B", QCryptographicHash::Md5));
+        saver->setSaved("C", QCryptographicHash::hash("data C", QCryptographicHash::Md5));
+        snapshot = snapshot_t();
+        snapshot.keep = {"K"};
+        snapshot.userFocus = "A";
+        snapshot.projects << createProject(*saver, "C", "data C2") << createProject(*saver, "A", "data A");
+        SUBVERIFY(!snapshot.projects[0].data.isEmpty(), "Data of changed project missing");
+        SUBVERIFY(snapshot.projects[1].data.isEmpty(), "Unchanged project serialized");
+        saver->save(snapshot);
+        saver->flush();
+        delete saver;
+        verifyWorkspace(db, {{"C", 0, "data C2"}, {"A", 1, "data A"}, {"K", 100, "kept"}}, "A");
+
+        // a failed write leaves the database as it has been and all projects are written again
+        saver = new CSaveWorkspaceThread(db, nullptr);
+        saver->setSaved("A", QCryptographicHash::hash("data A", QCryptographicHash::Md5));
+        saver->setSaved("C", QCryptographicHash::hash("data C2", QCryptographicHash::Md5));
+        snapshot = snapshot_t();
+        snapshot.keep = {"K"};
+        snapshot.userFocus = "C";
+        snapshot.projects << createProject(*saver, "A", "data A") << createProject(*saver, "C", "data C3");
+        // a project without data missing in the database fails the write
+        snapshot.projects << createProject(*saver, "D", "data D");
+        snapshot.projects.last().data.clear();
+        saver->save(snapshot);
+        saver->flush();
+        SUBVERIFY(!saver->isSaved("A", snapshot.projects[0].fingerprint), "Project saved after failed write");
+        SUBVERIFY(!saver->isSaved("C", snapshot.projects[1].fingerprint), "Project saved after failed write");
+        delete saver;
+        verifyWorkspace(db, {{"C", 0, "data C2"}, {"A", 1, "data A"}, {"K", 100, "kept"}}, "A");
+
+        // the data of a snapshot replaced or still being written is not serialized again
+        saver = new CSaveWorkspaceThread(db, nullptr);
+        snapshot = snapshot_t();
+        snapshot.keep = {"K"};
+        snapshot.userFocus = "C";
+        snapshot.projects << createProject(*saver, "A", "data A") << createProject(*saver, "C", "data C3");
+        saver->save(snapshot);
+        SUBVERIFY(saver->isSaved("C", snapshot.projects[1].fingerprint), "Project of queued snapshot not saved");
+        snapshot.projects.clear();
+        snapshot.projects << createProject(*saver, "C", "data C3") << createProject(*saver, "A", "data A");
+        SUBVERIFY(snapshot.projects[0].data.isEmpty() && snapshot.projects[1].data.isEmpty(), "Queued project serialized again");
+        saver->save(snapshot);
+
+        // the data of a snapshot failed to be written is passed on to the next one
+        snapshot.projects.clear();
+        snapshot.projects << createProject(*saver, "C", "data C4") << createProject(*saver, "D", "data D");
+        snapshot.projects.last().data.clear();
+        saver->save(snapshot);
+        snapshot.projects.clear();
+        snapshot.projects << createProject(*saver, "A", "data A") << createProject(*saver, "C", "data C4");
+        saver->save(snapshot);
+        saver->flush();
+        delete saver;
+        verifyWorkspace(db, {{"A", 0, "data A"}, {"C", 1, "data C4"}, {"K", 100, "kept"}}, "C");
+    }
+    QSqlDatabase::removeDatabase("TestWorkspace");
+}
@@ -0,0 +1,126 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "CTileServer.h"
+#include "map/cache/CDiskCachePack.h"
+#include "map/cache/CTileLoader.h"
+
+#include <QtTest>
+
+static CTileLoader::tile_t createTile(const QString &url, qreal distance)
+{
+    CTileLoader::tile_t tile;
+    tile.url = url;
+    tile.distance = distance;
+    return tile;
+}
+
+void test_QMapShack::_loadTilesByPriority()
+{
+    QTemporaryDir tmpDir;
+    SUBVERIFY(tmpDir.isValid(), "Failed to create temporary directory");
+
+    CTileServer server;
+    CDiskCachePack cache(tmpDir.path(), 100, 30, nullptr);
+    CTileLoader loader(nullptr);
+    loader.setCache(&cache);
+    // one request at a time to see the order
+    loader.setMaxRequests(1);
+
+    // tiles scrolled out of view before the loader had a chance to request them
+    QVector<CTileLoader::tile_t> tiles;
+    for(int n = 100; n < 105; n++)
+    {
+        tiles << createTile(server.url(QString("tile/%1.png").arg(n)), 0);
+    }
+    loader.setTiles(tiles);
+
+    // the current view: the tiles are not ordered by distance, one tile is listed twice
+    tiles.clear();
+    for(int n = 0; n < 10; n++)
+    {
+        tiles << createTile(server.url(QString("tile/%1.png").arg(n)), (n * 7) % 10);
+    }
+    tiles << createTile(server.url("missing"), 10);
+    tiles << tiles[3];
+
+    QSignalSpy spy(&loader, &CTileLoader::sigFinished);
+    loader.setTiles(tiles);
+    SUBVERIFY(spy.wait(10000), "Loading tiles timed out");
+    VERIFY_EQUAL(0, loader.getPending());
+
+    // each tile of the current view is requested once, the nearest first
+    VERIFY_EQUAL(11, server.log.size());
+    for(int i = 0; i < 10; i++)
+    {
+        // tile n has the distance (n * 7) % 10, thus distance i is tile (i * 3) % 10
+        VERIFY_EQUAL(QString("/tile/%1.png").arg((i * 3) % 10), server.log[i]);
+    }
+    VERIFY_EQUAL(QString("/missing"), server.log[10]);
+
+    // the tiles scrolled out of view are never requested
+    for(int n = 100; n < 105; n++)
+    {
+        SUBVERIFY(!server.log.contains(QString("/tile/%1.png").arg(n)), QString("Stale tile %1 requested").arg(n));
+    }
+
+    // all tiles are stored to the cache, the missing one as transparent tile
+    for(int n = 0; n < 10; n++)
+    {
+        const QString &url = server.url(QString("tile/%1.png").arg(n));
+        SUBVERIFY(cache.contains(url), QString("Tile %1 not in cache").arg(n));
+
+        QImage img;
+        cache.restore(url, img);
+        SUBVERIFY(img.pixelColor(128, 128) == CTileServer::tileColor(n), QString("Tile %1 has wrong color").arg(n));
+    }
+
+    SUBVERIFY(cache.contains(server.url("missing")), "Failed request not cached");
+    QImage img;
+    cache.restore(server.url("missing"), img);
+    SUBVERIFY(img.pixelColor(0, 0).alpha() == 0, "Failed request does not restore a transparent tile");
+
+    // an outdated tile in the cache is served until it is loaded again
+    const QString &url = server.url("tile/12.png");
+    {
+        QImage stale(256, 256, QImage::Format_ARGB32);
+        stale.fill(CTileServer::tileColor(3));
+
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        stale.save(&buffer, "PNG");
+
+        cache.store(url, data, stale);
+    }
+
+    cache.restore(url, img);
+    SUBVERIFY(img.pixelColor(128, 128) == CTileServer::tileColor(3), "Outdated tile not served");
+
+    server.log.clear();
+    spy.clear();
+    loader.setTiles({createTile(url, 0)});
+    SUBVERIFY(spy.wait(10000), "Refreshing tile timed out");
+    VERIFY_EQUAL(1, server.log.size());
+
+    cache.restore(url, img);
+    SUBVERIFY(img.pixelColor(128, 128) == CTileServer::tileColor(12), "Outdated tile not replaced");
+}
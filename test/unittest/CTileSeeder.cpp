@@ -0,0 +1,121 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "CTileServer.h"
+#include "map/cache/CDiskCachePack.h"
+#include "map/cache/CTileLoader.h"
+#include "map/cache/CTileSeeder.h"
+
+#include <QtTest>
+
+void test_QMapShack::_seedTiles()
+{
+    QTemporaryDir tmpDir;
+    SUBVERIFY(tmpDir.isValid(), "Failed to create temporary directory");
+
+    CTileServer server;
+    CDiskCachePack cache(tmpDir.path(), 100, 30, nullptr);
+
+    // 13 tiles and 2 missing ones, the first 5 tiles are already in the cache
+    QStringList urls;
+    for(int n = 0; n < 13; n++)
+    {
+        urls << server.url(QString("tile/%1.png").arg(n));
+    }
+    urls << server.url("missing1") << server.url("missing2");
+
+    for(int n = 0; n < 5; n++)
+    {
+        QImage img(256, 256, QImage::Format_ARGB32);
+        img.fill(CTileServer::tileColor(n));
+
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        img.save(&buffer, "PNG");
+
+        cache.store(urls[n], data, img);
+    }
+
+    CTileSeeder seeder(&cache, nullptr);
+    seeder.getLoader().setMaxRequests(2);
+    seeder.getLoader().setRateLimit(20);
+
+    QSignalSpy spy(&seeder, &CTileSeeder::sigFinished);
+    QElapsedTimer timer;
+    timer.start();
+    seeder.start(urls);
+    SUBVERIFY(seeder.isRunning(), "Seeder did not start");
+    SUBVERIFY(spy.wait(10000), "Seeding tiles timed out");
+    SUBVERIFY(!seeder.isRunning(), "Seeder still running");
+
+    const CTileSeeder::stats_t &stats = seeder.getStats();
+    VERIFY_EQUAL(15, stats.total);
+    VERIFY_EQUAL(5, stats.cached);
+    VERIFY_EQUAL(8, stats.loaded);
+    VERIFY_EQUAL(2, stats.failed);
+
+    // cached tiles are not requested again, the others in the order given
+    VERIFY_EQUAL(10, server.log.size());
+    for(int n = 5; n < 13; n++)
+    {
+        VERIFY_EQUAL(QString("/tile/%1.png").arg(n), server.log[n - 5]);
+        SUBVERIFY(cache.contains(urls[n]), QString("Tile %1 not in cache").arg(n));
+    }
+
+    // 10 requests at 20 requests/s take at least 9 intervals of 50 ms
+    SUBVERIFY(timer.elapsed() >= 450, QString("Rate limit not applied: %1 ms").arg(timer.elapsed()));
+
+    // failed requests are known to the cache but are no tiles
+    SUBVERIFY(cache.contains(urls[13]), "Failed request not known to the cache");
+    SUBVERIFY(!cache.hasTile(urls[13]), "Failed request stored as tile");
+
+    // seeding again requests the failed tiles only
+    server.log.clear();
+    spy.clear();
+    seeder.start(urls);
+    SUBVERIFY(seeder.isRunning(), "Seeder did not retry the failed tiles");
+    SUBVERIFY(spy.wait(10000), "Seeding tiles timed out");
+    VERIFY_EQUAL(13, seeder.getStats().cached);
+    VERIFY_EQUAL(0, seeder.getStats().loaded);
+    VERIFY_EQUAL(2, seeder.getStats().failed);
+    VERIFY_EQUAL(2, server.log.size());
+    VERIFY_EQUAL(QString("/missing1"), server.log[0]);
+    VERIFY_EQUAL(QString("/missing2"), server.log[1]);
+
+    // a corridor covers each point of the line
+    const QPolygonF line({QPointF(8.0, 48.0), QPointF(8.5, 48.2), QPointF(8.5, 48.2), QPointF(9.0, 47.5)});
+    QList<QRectF> areas;
+    CTileSeeder::corridor(line, 2000, areas);
+    for(int i = 0; i <= 100; i++)
+    {
+        const QPointF &pt1 = i <= 50 ? line[0] : line[2];
+        const QPointF &pt2 = i <= 50 ? line[1] : line[3];
+        const QPointF &pt = pt1 + (pt2 - pt1) * ((i % 51) / 50.0);
+
+        bool covered = false;
+        for(const QRectF &area : areas)
+        {
+            covered |= area.contains(pt);
+        }
+        SUBVERIFY(covered, QString("Point %1 not covered by corridor").arg(i));
+    }
+}
@@ -0,0 +1,103 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESERVER_H
+#define CTILESERVER_H
+
+#include <QtGui>
+#include <QtNetwork>
+
+/*
+    A minimal HTTP server on localhost standing in for a tile server.
+    It logs the path of each request. "/tile/<n>.png" is answered with
+    a tile of color <n>, everything else with 404.
+ */
+class CTileServer
+{
+public:
+    CTileServer()
+    {
+        server.listen(QHostAddress::LocalHost);
+        QObject::connect(&server, &QTcpServer::newConnection, [this]()
+        {
+            while(server.hasPendingConnections())
+            {
+                QTcpSocket* socket = server.nextPendingConnection();
+                QObject::connect(socket, &QTcpSocket::readyRead, [this, socket](){ serve(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, [this, socket]()
+                {
+                    buffers.remove(socket);
+                    socket->deleteLater();
+                });
+            }
+        });
+    }
+
+    QString url(const QString &path) const
+    {
+        return QString("http://127.0.0.1:%1/%2").arg(server.serverPort()).arg(path);
+    }
+
+    static QColor tileColor(int n)
+    {
+        return QColor(n * 20, 255 - n * 20, 128);
+    }
+
+    QStringList log;
+
+private:
+    void serve(QTcpSocket* socket)
+    {
+        QByteArray &buffer = buffers[socket];
+        buffer += socket->readAll();
+
+        int idx;
+        while((idx = buffer.indexOf("\r\n\r\n")) >= 0)
+        {
+            const QList<QByteArray> &request = buffer.left(idx).split(' ');
+            buffer.remove(0, idx + 4);
+
+            const QString path = request.size() > 1 ? QString(request[1]) : QString();
+            log << path;
+
+            QRegularExpressionMatch match = QRegularExpression("^/tile/(\\d+)\\.png$").match(path);
+            if(match.hasMatch())
+            {
+                QImage img(256, 256, QImage::Format_ARGB32);
+                img.fill(tileColor(match.captured(1).toInt()));
+
+                QByteArray data;
+                QBuffer buf(&data);
+                buf.open(QIODevice::WriteOnly);
+                img.save(&buf, "PNG");
+
+                socket->write(QString("HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nContent-Length: %1\r\n\r\n").arg(data.size()).toLatin1());
+                socket->write(data);
+            }
+            else
+            {
+                socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+            }
+        }
+    }
+
+    QTcpServer server;
+    QHash<QTcpSocket*, QByteArray> buffers;
+};
+
+#endif // CTILESERVER_H
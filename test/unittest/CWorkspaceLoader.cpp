@@ -0,0 +1,147 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "test_QMapShack.h"
+
+#include "gis/CGisListWks.h"
+#include "gis/CWorkspaceLoader.h"
+#include "gis/gpx/CGpxProject.h"
+#include "gis/trk/CGisItemTrk.h"
+#include "gis/wpt/CGisItemWpt.h"
+#include "units/IUnit.h"
+
+#include <QtTest>
+
+// the secondary data of the track in a project as created by createEntry()
+struct expected_trk_t
+{
+    qreal distance = 0;
+    qreal ascent = 0;
+    QRectF boundingRect;
+};
+
+// a row of the workspace table like CGisListWks::slotSaveWorkspace() writes it
+static CWorkspaceLoader::entry_t createEntry(int idx, int count, expected_trk_t &expected)
+{
+    IGisProject *project = new CGpxProject(QString("workspace project %1").arg(idx), (CGisListWks*) nullptr);
+    const QDateTime time = QDateTime::currentDateTimeUtc();
+    for(int n = 0; n < count; n++)
+    {
+        new CGisItemWpt(QPointF(10.0 + n * 0.001, 47.0 + idx * 0.001), NOFLOAT, time, QString("wpt %1").arg(n), "", project);
+    }
+
+    CTrackData data;
+    data.name = QString("trk %1").arg(idx);
+    data.segs.resize(1);
+    for(int n = 0; n < count; n++)
+    {
+        CTrackData::trkpt_t trkpt;
+        trkpt.lon = 10.0 + n * 0.001;
+        trkpt.lat = 47.0 + idx * 0.001 + (n % 7) * 0.0005;
+        trkpt.ele = 500 + (n % 11) * 10;
+        trkpt.time = time.addSecs(n * 10);
+        data.segs[0].pts << trkpt;
+    }
+
+    const CGisItemTrk *trk = new CGisItemTrk(data, project);
+    expected.distance = trk->getTotalDistance();
+    expected.ascent = trk->getTotalAscent();
+    expected.boundingRect = trk->getBoundingRect();
+
+    CWorkspaceLoader::entry_t entry;
+    entry.type = project->getType();
+    entry.key = project->getKey();
+    entry.name = project->getName();
+
+    QDataStream stream(&entry.data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    project->IGisProject::operator>>(stream);
+
+    delete project;
+    return entry;
+}
+
+void test_QMapShack::_restoreWorkspaceInParallel()
+{
+    QList<CWorkspaceLoader::entry_t> entries;
+    QList<expected_trk_t> expected;
+    for(int n = 0; n < 20; n++)
+    {
+        expected << expected_trk_t();
+        entries << createEntry(n, 100 + n, expected.last());
+    }
+
+    // a project named like an existing file has to be restored by the GUI thread
+    CWorkspaceLoader::entry_t entryFile = entries[5];
+    entryFile.name = testInput + "/gpx/gpx_ext_GarminTPX1_gpxtpx.gpx";
+    entries[5] = entryFile;
+    SUBVERIFY(!CWorkspaceLoader::isThreadSafe(entryFile), "Project named like a file restored by a thread");
+
+    QList<CWorkspaceLoader::result_t> results;
+    {
+        CWorkspaceLoader loader;
+        for(const CWorkspaceLoader::entry_t &entry : entries)
+        {
+            loader.add(entry);
+        }
+        VERIFY_EQUAL(entries.size(), loader.getCountInProgress());
+
+        bool finished = false;
+        while(!finished)
+        {
+            finished = loader.waitForDone(10);
+            results << loader.takeResults();
+        }
+        VERIFY_EQUAL(0, loader.getCountInProgress());
+    }
+
+    VERIFY_EQUAL(entries.size(), results.size());
+    for(int n = 0; n < results.size(); n++)
+    {
+        const CWorkspaceLoader::result_t &result = results[n];
+        VERIFY_EQUAL(entries[n].key, result.entry.key);
+
+        if(n == 5)
+        {
+            SUBVERIFY(!result.loaded && result.project == nullptr, "Project named like a file restored by a thread");
+            SUBVERIFY(result.entry.data == entryFile.data, "Data of project not restored is missing");
+            continue;
+        }
+
+        SUBVERIFY(result.loaded && result.project != nullptr, QString("Failed to restore project %1").arg(n));
+        SUBVERIFY(result.entry.data.isEmpty(), "Data of restored project not released");
+        VERIFY_EQUAL(entries[n].key, result.project->getKey());
+        VERIFY_EQUAL(100 + n + 1, result.project->childCount());
+
+        // the secondary data of the track is derived by the loader
+        const CGisItemTrk *trk = nullptr;
+        for(int i = 0; i < result.project->childCount(); i++)
+        {
+            trk = trk != nullptr ? trk : dynamic_cast<const CGisItemTrk*>(result.project->child(i));
+        }
+        SUBVERIFY(trk != nullptr, QString("Track of project %1 not restored").arg(n));
+        VERIFY_EQUAL(100 + n, trk->getCntTotalPoints());
+        SUBVERIFY(expected[n].distance > 0, "Track without distance");
+        VERIFY_EQUAL(expected[n].distance, trk->getTotalDistance());
+        VERIFY_EQUAL(expected[n].ascent, trk->getTotalAscent());
+        SUBVERIFY(expected[n].boundingRect == trk->getBoundingRect(), QString("Bounding box of track %1 differs").arg(n));
+
+        delete result.project;
+    }
+}
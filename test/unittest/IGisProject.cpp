@@ -0,0 +1,196 @@
+/**********************************************************************************************
+    Copyright (C) 2026 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "test_QMapShack.h"
+
+#include "gis/CGisListWks.h"
+#include "gis/gpx/CGpxProject.h"
+#include "gis/wpt/CGisItemWpt.h"
+#include "units/IUnit.h"
+
+#include <QtTest>
+
+// waypoints on a grid with a spacing of 0.001° starting at 10°E 47°N
+static QPointF gridPos(int n)
+{
+    return QPointF(10.0 + (n % 316) * 0.001, 47.0 + (n / 316) * 0.001);
+}
+
+static IGisProject * createGridProject(int count)
+{
+    IGisProject *project = new CGpxProject("a very random string to prevent loading via constructor", (CGisListWks*) nullptr);
+    const QDateTime time = QDateTime::currentDateTimeUtc();
+    for(int n = 0; n < count; n++)
+    {
+        new CGisItemWpt(gridPos(n), NOFLOAT, time, QString("wpt %1").arg(n), "", project);
+    }
+    return project;
+}
+
+void test_QMapShack::_queryItemsByArea()
+{
+    QList<qint64> nsPerQuery;
+    for(int count : {1000, 100000})
+    {
+        IGisProject *project = createGridProject(count);
+        VERIFY_EQUAL(count, project->childCount());
+
+        // an area the size of the hit test around some waypoints
+        const QPointF center = gridPos(count / 2);
+        const QRectF area(center - QPointF(0.0015, 0.0015), QSizeF(0.003, 0.003));
+
+        int expected = 0;
+        for(int n = 0; n < count; n++)
+        {
+            expected += area.contains(gridPos(n)) ? 1 : 0;
+        }
+
+        QList<IGisItem*> items;
+        project->getItemsByArea(area, IGisItem::eSelectionWpt, items);
+        VERIFY_EQUAL(expected, items.size());
+        for(IGisItem *item : items)
+        {
+            SUBVERIFY(area.contains(dynamic_cast<CGisItemWpt*>(item)->getPosition()), "Waypoint outside of area");
+        }
+
+        // items added or deleted have to be found by the next query
+        CGisItemWpt *wpt = new CGisItemWpt(center, NOFLOAT, QDateTime::currentDateTimeUtc(), "new", "", project);
+        items.clear();
+        project->getItemsByArea(area, IGisItem::eSelectionWpt, items);
+        VERIFY_EQUAL(expected + 1, items.size());
+        SUBVERIFY(items.contains(wpt), "New waypoint not found");
+
+        delete wpt;
+        items.clear();
+        project->getItemsByArea(area, IGisItem::eSelectionWpt, items);
+        VERIFY_EQUAL(expected, items.size());
+
+        // the latency of a query must not depend on the number of items
+        const int N = 1000;
+        QElapsedTimer timer;
+        timer.start();
+        for(int n = 0; n < N; n++)
+        {
+            items.clear();
+            project->getItemsByArea(area, IGisItem::eSelectionWpt, items);
+        }
+        nsPerQuery << timer.nsecsElapsed() / N;
+        qDebug() << "Query of" << count << "waypoints took" << nsPerQuery.last() << "ns";
+
+        delete project;
+    }
+
+    // generous to be stable on a busy machine, a linear scan is ~100 times slower
+    SUBVERIFY(nsPerQuery[1] < nsPerQuery[0] * 10 + 10000, "Query latency depends on the number of items");
+}
+
+void test_QMapShack::_queryItemsByKey()
+{
+    const int count = 100000;
+    IGisProject *project = createGridProject(count);
+
+    QList<IGisItem::key_t> keys;
+    for(int n = 0; n < count; n += 1000)
+    {
+        keys << dynamic_cast<IGisItem*>(project->child(n))->getKey();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for(const IGisItem::key_t &key : keys)
+    {
+        IGisItem *item = project->getItemByKey(key);
+        SUBVERIFY(item != nullptr && item->getKey() == key, "Item not found by key");
+    }
+    qDebug() << "Lookup of" << keys.size() << "keys took" << timer.nsecsElapsed() / 1000 << "us";
+
+    // keys of other projects do not match
+    IGisItem::key_t keyOther = keys.first();
+    keyOther.project = "other project";
+    SUBVERIFY(project->getItemByKey(keyOther) == nullptr, "Item found by key of other project");
+
+    QList<IGisItem*> items;
+    project->getItemsByKeys(keys + QList<IGisItem::key_t>({keyOther, keys.first()}), items);
+    VERIFY_EQUAL(keys.size(), items.size());
+    for(int n = 0; n < items.size(); n++)
+    {
+        SUBVERIFY(items[n]->getKey() == keys[n], "Items not in order of project");
+    }
+
+    // deleted and added items
+    const IGisItem::key_t keyDeleted = keys.takeLast();
+    delete project->getItemByKey(keyDeleted);
+    SUBVERIFY(project->getItemByKey(keyDeleted) == nullptr, "Deleted item found by key");
+
+    CGisItemWpt *wpt = new CGisItemWpt(gridPos(count), NOFLOAT, QDateTime::currentDateTimeUtc(), "new", "", project);
+    SUBVERIFY(project->getItemByKey(wpt->getKey()) == wpt, "New item not found by key");
+
+    items.clear();
+    project->getItemsByKeys(keys + QList<IGisItem::key_t>({keyDeleted, wpt->getKey()}), items);
+    VERIFY_EQUAL(keys.size() + 1, items.size());
+    SUBVERIFY(items.last() == wpt, "New item not found by key");
+
+    delete project;
+}
+
+void test_QMapShack::_fingerprintProject()
+{
+    IGisProject *project = createGridProject(1000);
+    const QByteArray fingerprint = project->getFingerprint();
+    SUBVERIFY(!fingerprint.isEmpty(), "No fingerprint");
+    SUBVERIFY(fingerprint == project->getFingerprint(), "Fingerprint of an unchanged project differs");
+
+    // anything written to the workspace changes the fingerprint
+    CGisItemWpt *wpt = new CGisItemWpt(gridPos(0), NOFLOAT, QDateTime::currentDateTimeUtc(), "new", "", project);
+    const QByteArray fingerprintAdded = project->getFingerprint();
+    SUBVERIFY(fingerprintAdded != fingerprint, "Fingerprint unchanged by added item");
+
+    wpt->setName("renamed");
+    SUBVERIFY(project->getFingerprint() != fingerprintAdded, "Fingerprint unchanged by edited item");
+
+    delete wpt;
+    SUBVERIFY(project->getFingerprint() == fingerprint, "Fingerprint differs after item has been removed again");
+
+    project->setName("renamed");
+    SUBVERIFY(project->getFingerprint() != fingerprint, "Fingerprint unchanged by edited project");
+
+    // the fingerprint has to be cheap compared to the serialization, the best of some runs to be stable on a busy machine
+    qint64 nsFingerprint = std::numeric_limits<qint64>::max();
+    qint64 nsSerialize = std::numeric_limits<qint64>::max();
+    QByteArray data;
+    for(int n = 0; n < 10; n++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        project->getFingerprint();
+        nsFingerprint = qMin(nsFingerprint, timer.nsecsElapsed());
+
+        timer.restart();
+        data.clear();
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_2);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        project->IGisProject::operator>>(stream);
+        nsSerialize = qMin(nsSerialize, timer.nsecsElapsed());
+    }
+
+    qDebug() << "Fingerprint took" << nsFingerprint / 1000 << "us, serialization of" << data.size() << "bytes took" << nsSerialize / 1000 << "us";
+    SUBVERIFY(nsFingerprint < nsSerialize, "Fingerprint is not cheaper than the serialization");
+
+    delete project;
+}
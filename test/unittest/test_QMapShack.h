@@ -53,6 +53,7 @@ class test_QMapShack : public QObject
     // CGpxProject
     void writeReadGpxFile(const QString &file);
     void _writeReadGpxFile();
+    void _benchmarkGpxLoad();
 
     // CKnownExtension
     void _readExtGarminTPX1_tp1();
@@ -63,12 +64,56 @@ class test_QMapShack : public QObject
     // CQmsProject
     void _readQmsFile_1_6_0();
     void _writeReadQmsFile();
+    void _writeReadQmsFileCompression();
+    void _encodeDecodeTrack();
+    void _benchmarkTrackCodec();
 
     // CFitProject
     void _readValidFitFiles();
 
     // CGisItemTrk
     void _filterDeleteExtension();
+    void _deriveSlopeAndSpeed();
+    void _deriveSecondaryDataRange();
+
+    // CProj
+    void _projectWebMercator();
+    void _projectBatch();
+    void _benchmarkProjection();
+
+    // CDemShading
+    void _shadeDemTile();
+    void _benchmarkDemShading();
+
+    // CMapMAP
+    void _cacheDecodedMapTiles();
+
+    // CDiskCachePack
+    void _storeRestoreTilePack();
+    void _compactTilePack();
+
+    // CTileLoader
+    void _loadTilesByPriority();
+
+    // CTileSeeder
+    void _seedTiles();
+
+    // CProjectLoader
+    void _loadProjectsInParallel();
+
+    // IGisProject
+    void _queryItemsByArea();
+    void _queryItemsByKey();
+    void _fingerprintProject();
+
+    // COccupancyGrid
+    void _placeLabels();
+
+    // CWorkspaceLoader
+    void _restoreWorkspaceInParallel();
+
+    // CSaveWorkspaceThread
+    void _saveWorkspaceSnapshots();
 
 private slots:
     void initTestCase();
@@ -76,10 +121,33 @@ private slots:
     void testreadValidSLFFile()         { TCWRAPPER( _readValidSLFFile()         ) }
     void testreadNonExistingSLFFile()   { TCWRAPPER( _readNonExistingSLFFile()   ) }
     void testwriteReadGpxFile()         { TCWRAPPER( _writeReadGpxFile()         ) }
+    void testbenchmarkGpxLoad()         { TCWRAPPER( _benchmarkGpxLoad()         ) }
     void testreadQmsFile_1_6_0()        { TCWRAPPER( _readQmsFile_1_6_0()        ) }
     void testwriteReadQmsFile()         { TCWRAPPER( _writeReadQmsFile()         ) }
+    void testwriteReadQmsFileCompression() { TCWRAPPER( _writeReadQmsFileCompression() ) }
+    void testencodeDecodeTrack()        { TCWRAPPER( _encodeDecodeTrack()        ) }
+    void testbenchmarkTrackCodec()      { TCWRAPPER( _benchmarkTrackCodec()      ) }
     void testreadExtGarminTPX1_gpxtpx() { TCWRAPPER( _readExtGarminTPX1_gpxtpx() ) }
     void testreadExtGarminTPX1_tp1()    { TCWRAPPER( _readExtGarminTPX1_tp1()    ) }
     void testreadValidFitFiles()        { TCWRAPPER( _readValidFitFiles()        ) }
     void testfilterDeleteExtension()    { TCWRAPPER( _filterDeleteExtension()    ) }
+    void testderiveSlopeAndSpeed()      { TCWRAPPER( _deriveSlopeAndSpeed()       ) }
+    void testderiveSecondaryDataRange() { TCWRAPPER( _deriveSecondaryDataRange()  ) }
+    void testprojectWebMercator()       { TCWRAPPER( _projectWebMercator()       ) }
+    void testprojectBatch()             { TCWRAPPER( _projectBatch()             ) }
+    void testbenchmarkProjection()      { TCWRAPPER( _benchmarkProjection()      ) }
+    void testshadeDemTile()             { TCWRAPPER( _shadeDemTile()             ) }
+    void testbenchmarkDemShading()      { TCWRAPPER( _benchmarkDemShading()      ) }
+    void testcacheDecodedMapTiles()     { TCWRAPPER( _cacheDecodedMapTiles()     ) }
+    void teststoreRestoreTilePack()     { TCWRAPPER( _storeRestoreTilePack()     ) }
+    void testcompactTilePack()          { TCWRAPPER( _compactTilePack()          ) }
+    void testloadTilesByPriority()      { TCWRAPPER( _loadTilesByPriority()      ) }
+    void testseedTiles()                { TCWRAPPER( _seedTiles()                ) }
+    void testloadProjectsInParallel()   { TCWRAPPER( _loadProjectsInParallel()   ) }
+    void testqueryItemsByArea()         { TCWRAPPER( _queryItemsByArea()         ) }
+    void testqueryItemsByKey()          { TCWRAPPER( _queryItemsByKey()          ) }
+    void testfingerprintProject()       { TCWRAPPER( _fingerprintProject()       ) }
+    void testplaceLabels()              { TCWRAPPER( _placeLabels()              ) }
+    void testrestoreWorkspaceInParallel() { TCWRAPPER( _restoreWorkspaceInParallel() ) }
+    void testsaveWorkspaceSnapshots()   { TCWRAPPER( _saveWorkspaceSnapshots()   ) }
 };